@@ -21,7 +21,15 @@ SERVICE_SOURCES += \
     ../src/core/service/DegradationPolicy.cpp \
     ../src/core/service/FailoverManager.cpp \
     ../src/core/service/LoadBalancer.cpp \
-    ../src/core/service/AsyncServiceCall.cpp
+    ../src/core/service/AsyncServiceCall.cpp \
+    ../src/core/service/ServiceCallFuture.cpp \
+    ../src/core/service/WorkStealingExecutor.cpp \
+    ../src/core/service/AsyncResultStore.cpp \
+    ../src/core/service/ConcurrencyLimiter.cpp \
+    ../src/core/service/HedgingPolicy.cpp \
+    ../src/core/service/Bulkhead.cpp \
+    ../src/core/service/StaleResultCache.cpp \
+    ../src/core/service/StateReplication.cpp
 
 # 配置模块
 CONFIG_SOURCES += \
@@ -40,7 +48,11 @@ SECURITY_SOURCES += \
     ../src/core/security/ApiKeyManager.cpp \
     ../src/core/security/SessionManager.cpp \
     ../src/core/security/RateLimiter.cpp \
-    ../src/core/security/PermissionChangeNotification.cpp
+    ../src/core/security/RateLimiterBackend.cpp \
+    ../src/core/security/RateLimitCoordinator.cpp \
+    ../src/core/security/PermissionChangeNotification.cpp \
+    ../src/core/security/PrincipalResolver.cpp \
+    ../src/core/security/SessionStore.cpp
 
 # 监控模块
 MONITORING_SOURCES += \
@@ -119,10 +131,17 @@ HEADERS += \
     ../src/core/monitoring/AlertSystem_p.h \
     ../include/eagle/core/RateLimiter.h \
     ../src/core/security/RateLimiter_p.h \
+    ../include/eagle/core/RateLimiterBackend.h \
+    ../src/core/security/RateLimiterBackend_p.h \
+    ../include/eagle/core/RateLimitCoordinator.h \
     ../include/eagle/core/ApiKeyManager.h \
     ../src/core/security/ApiKeyManager_p.h \
     ../include/eagle/core/SessionManager.h \
     ../src/core/security/SessionManager_p.h \
+    ../include/eagle/core/PrincipalResolver.h \
+    ../src/core/security/PrincipalResolver_p.h \
+    ../include/eagle/core/SessionStore.h \
+    ../src/core/security/SessionStore_p.h \
     ../include/eagle/core/ApiServer.h \
     ../src/core/api/ApiServer_p.h \
     ../include/eagle/core/ApiRoutes.h \
@@ -135,6 +154,23 @@ HEADERS += \
     ../include/eagle/core/LoadBalancer.h \
     ../src/core/service/LoadBalancer_p.h \
     ../include/eagle/core/AsyncServiceCall.h \
+    ../include/eagle/core/ServiceCallFuture.h \
+    ../include/eagle/core/ServiceTask.h \
+    ../include/eagle/core/WorkStealingExecutor.h \
+    ../src/core/service/WorkStealingExecutor_p.h \
+    ../include/eagle/core/AsyncResultStore.h \
+    ../src/core/service/AsyncResultStore_p.h \
+    ../include/eagle/core/ConcurrencyLimiter.h \
+    ../src/core/service/ConcurrencyLimiter_p.h \
+    ../include/eagle/core/HedgingPolicy.h \
+    ../src/core/service/HedgingPolicy_p.h \
+    ../include/eagle/core/Bulkhead.h \
+    ../src/core/service/Bulkhead_p.h \
+    ../include/eagle/core/StaleResultCache.h \
+    ../src/core/service/StaleResultCache_p.h \
+    ../include/eagle/core/StateReplication.h \
+    ../src/core/service/StateReplication_p.h \
+    ../src/core/service/ServiceCallFuture_p.h \
     ../include/eagle/core/ConfigVersion.h \
     ../src/core/config/ConfigVersion_p.h \
     ../include/eagle/core/ConfigFormat.h \
@@ -16,7 +16,7 @@ namespace Core {
  */
 struct ApiKey {
     QString keyId;              // 密钥ID
-    QString keyValue;            // 密钥值
+    QString keyValue;            // 密钥值（仅createKey返回完整值，查询结果中为掩码）
     QString userId;              // 关联用户ID
     QString description;         // 描述
     QDateTime createdAt;         // 创建时间
@@ -44,6 +44,9 @@ struct ApiKey {
 
 /**
  * @brief API密钥管理器
+ *
+ * 密钥值格式为eagle_<keyId前缀>_<随机部分>，只保存其HMAC摘要。验证时按前缀
+ * 在写时复制的索引中无锁查找，再以常量时间比较摘要。
  */
 class ApiKeyManager : public QObject {
     Q_OBJECT
@@ -86,7 +89,7 @@ private:
     inline Private* d_func() { return d; }
     inline const Private* d_func() const { return d; }
     
-    QString generateKeyValue() const;
+    QString generateKeyValue(const QString& keyId) const;
 };
 
 } // namespace Core
@@ -12,7 +12,9 @@
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonArray>
+#include <QtCore/QPointer>
 #include <functional>
+#include <memory>
 #include "SslConfig.h"
 
 namespace Eagle {
@@ -24,12 +26,19 @@ class ApiServerPrivate;
 class Framework;
 class HttpRequest;
 class HttpResponse;
+class HttpResponder;
+struct AuthPrincipal;
 
 /**
  * @brief HTTP请求处理器函数类型
  */
 typedef std::function<void(const HttpRequest&, HttpResponse&)> RequestHandler;
 
+/**
+ * @brief 延迟响应的HTTP请求处理器函数类型（长轮询、服务器推送）
+ */
+typedef std::function<void(const HttpRequest&, HttpResponder)> AsyncRequestHandler;
+
 /**
  * @brief HTTP中间件函数类型
  */
@@ -48,6 +57,7 @@ public:
     QMap<QString, QString> queryParams;  // 查询参数
     QMap<QString, QString> pathParams;    // 路径参数（如{id}）
     QString remoteAddress;        // 客户端IP地址
+    mutable std::shared_ptr<const AuthPrincipal> principal;  // 认证中间件解析出的主体（中间件只拿到const引用）
     
     // 解析请求
     static HttpRequest parse(const QByteArray& rawRequest, const QString& remoteAddress = QString());
@@ -90,6 +100,43 @@ public:
     void setHeader(const QString& name, const QString& value);
 };
 
+/**
+ * @brief 延迟响应句柄
+ * 
+ * 异步路由处理器持有该句柄，在结果就绪后再写回响应，或以
+ * Server-Sent Events流的形式持续推送事件。可复制，可在任意线程调用，
+ * 写操作会投递到连接所在线程；连接断开后所有写操作被忽略。
+ */
+class HttpResponder {
+public:
+    HttpResponder();
+    HttpResponder(ApiServer* server, QAbstractSocket* socket, const HttpRequest& request);
+    
+    // 连接是否仍然打开且未完成响应
+    bool isOpen() const;
+    
+    // 连接对象（用于信号连接的生命周期绑定）
+    QObject* context() const;
+    
+    // 发送完整响应（只能发送一次）
+    bool send(const HttpResponse& response);
+    
+    // 开始Server-Sent Events流
+    bool beginStream();
+    
+    // 推送一个事件（需先调用beginStream）
+    bool sendEvent(const QString& event, const QJsonObject& data, const QString& id = QString());
+    
+    // 结束流并关闭连接
+    void close();
+    
+private:
+    struct State;
+    std::shared_ptr<State> state;
+    
+    bool write(const QByteArray& data, bool closeAfter = false);
+};
+
 /**
  * @brief REST API服务器
  * 
@@ -121,6 +168,9 @@ public:
     void put(const QString& path, RequestHandler handler);
     void delete_(const QString& path, RequestHandler handler);
     
+    // 延迟响应路由注册（处理器返回后不立即发送响应）
+    void getAsync(const QString& path, AsyncRequestHandler handler);
+    
     // 中间件
     void use(Middleware middleware);
     
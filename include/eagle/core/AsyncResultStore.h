@@ -0,0 +1,95 @@
+#ifndef EAGLE_CORE_ASYNCRESULTSTORE_H
+#define EAGLE_CORE_ASYNCRESULTSTORE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+#include "ServiceCallFuture.h"
+
+namespace Eagle {
+namespace Core {
+
+class AsyncResultStorePrivate;
+
+/**
+ * @brief 异步结果存储配置
+ */
+struct AsyncResultStoreConfig {
+    int maxEntries = 10000;          // 最大条目数
+    int ttlMs = 300000;              // 过期时间（毫秒），完成后重新计时
+    int purgeIntervalMs = 10000;     // 过期清理间隔（毫秒）
+
+    AsyncResultStoreConfig() = default;
+};
+
+/**
+ * @brief 异步调用结果存储
+ *
+ * 以不可猜测的不透明ID登记进行中的异步调用，供REST/CLI按ID查询结果。
+ * 条目数有上限，并在完成后按TTL过期；存储满时优先淘汰最早完成的条目，
+ * 全部条目都未完成时拒绝登记。
+ */
+class AsyncResultStore : public QObject {
+    Q_OBJECT
+
+public:
+    explicit AsyncResultStore(QObject* parent = nullptr);
+    ~AsyncResultStore();
+
+    void setConfig(const AsyncResultStoreConfig& config);
+    AsyncResultStoreConfig config() const;
+
+    /**
+     * @brief 登记异步调用
+     * @param owner 所属用户ID，查询时用于隔离
+     * @return 不透明ID，存储已满时返回空字符串
+     */
+    QString add(const ServiceCallFuture& future,
+                const QString& serviceName,
+                const QString& method,
+                const QString& owner = QString());
+
+    /**
+     * @brief 按ID查找（不存在或已过期时返回无效Future）
+     */
+    ServiceCallFuture find(const QString& id) const;
+
+    /**
+     * @brief 获取条目的所属用户ID（不存在时返回空字符串）
+     */
+    QString owner(const QString& id) const;
+
+    /**
+     * @brief 获取条目的元信息（serviceName、method、owner、finished）
+     */
+    QVariantMap info(const QString& id) const;
+
+    bool remove(const QString& id);
+    int size() const;
+
+    /**
+     * @brief 清理过期条目
+     * @return 清理的条目数
+     */
+    int purgeExpired();
+
+signals:
+    /**
+     * @brief 结果就绪（在存储所在线程中发出）
+     */
+    void resultReady(const QString& id, const QString& owner);
+
+private:
+    Q_DISABLE_COPY(AsyncResultStore)
+    AsyncResultStorePrivate* d_ptr;
+
+    inline AsyncResultStorePrivate* d_func() { return d_ptr; }
+    inline const AsyncResultStorePrivate* d_func() const { return d_ptr; }
+
+    void markFinished(const QString& id);
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // EAGLE_CORE_ASYNCRESULTSTORE_H
@@ -5,11 +5,10 @@
 #include <QtCore/QString>
 #include <QtCore/QVariant>
 #include <QtCore/QVariantList>
-#include <QtCore/QFuture>
-#include <QtCore/QFutureWatcher>
 #include <QtCore/QThread>
-#include <QtCore/QMutex>
-#include <QtCore/QWaitCondition>
+#include "ServiceCallFuture.h"
+#include "WorkStealingExecutor.h"
+#include "AsyncResultStore.h"
 #include <functional>
 
 namespace Eagle {
@@ -18,42 +17,16 @@ namespace Core {
 class ServiceRegistry;
 
 /**
- * @brief 服务调用结果
- */
-struct ServiceCallResult {
-    bool success;           // 是否成功
-    QVariant result;        // 返回结果
-    QString error;          // 错误信息
-    int elapsedMs;          // 耗时（毫秒）
-    
-    ServiceCallResult()
-        : success(false)
-        , elapsedMs(0)
-    {}
-    
-    ServiceCallResult(const QVariant& res)
-        : success(true)
-        , result(res)
-        , elapsedMs(0)
-    {}
-    
-    ServiceCallResult(const QString& err)
-        : success(false)
-        , error(err)
-        , elapsedMs(0)
-    {}
-};
-
-/**
- * @brief 服务Future类（Promise/Future模式）
+ * @brief 服务Future类（Promise/Future模式的QObject适配器）
  * 
- * 提供异步服务调用的结果获取和链式操作
+ * 包装轻量级的ServiceCallFuture，仅供需要信号/槽的调用方使用；
+ * 信号和链式回调都在本对象所在线程的事件循环中触发
  */
 class ServiceFuture : public QObject {
     Q_OBJECT
     
 public:
-    explicit ServiceFuture(QObject* parent = nullptr);
+    explicit ServiceFuture(const ServiceCallFuture& future, QObject* parent = nullptr);
     ~ServiceFuture();
     
     /**
@@ -88,6 +61,11 @@ public:
      */
     int elapsedMs() const;
     
+    /**
+     * @brief 获取底层的轻量级Future
+     */
+    ServiceCallFuture callFuture() const;
+    
     /**
      * @brief 链式操作：成功后执行
      * @param callback 回调函数
@@ -115,14 +93,8 @@ signals:
     void failed(const QString& error);
     
 private:
-    friend class AsyncServiceCall;
-    
-    void setResult(const ServiceCallResult& result);
-    
-    mutable QMutex mutex;
-    mutable QWaitCondition condition;
-    ServiceCallResult callResult;
-    bool finishedFlag;
+    ServiceCallFuture future;
+    quint64 subscription;  // 信号转发续体的订阅ID，析构时取消
     
     Q_DISABLE_COPY(ServiceFuture)
 };
@@ -139,6 +111,19 @@ public:
     explicit AsyncServiceCall(ServiceRegistry* serviceRegistry, QObject* parent = nullptr);
     ~AsyncServiceCall();
     
+    /**
+     * @brief 异步调用服务（返回轻量级Future，不分配QObject）
+     * @param serviceName 服务名称
+     * @param method 方法名
+     * @param args 参数列表
+     * @param timeout 超时时间（毫秒）
+     * @return ServiceCallFuture对象
+     */
+    ServiceCallFuture call(const QString& serviceName,
+                           const QString& method,
+                           const QVariantList& args = QVariantList(),
+                           int timeout = 5000);
+    
     /**
      * @brief 异步调用服务（返回Future）
      * @param serviceName 服务名称
@@ -176,7 +161,7 @@ public:
     QList<ServiceFuture*> callBatch(const QList<QPair<QString, QPair<QString, QVariantList>>>& calls);
     
     /**
-     * @brief 等待所有调用完成
+     * @brief 等待所有调用完成（阻塞，非阻塞场景请使用whenAll）
      * @param futures Future列表
      * @param timeoutMs 超时时间（毫秒）
      * @return 是否全部成功
@@ -184,20 +169,31 @@ public:
     bool waitForAll(const QList<ServiceFuture*>& futures, int timeoutMs = -1);
     
     /**
-     * @brief 等待任意一个调用完成
+     * @brief 等待任意一个调用完成（阻塞，非阻塞场景请使用whenAny）
      * @param futures Future列表
      * @param timeoutMs 超时时间（毫秒）
      * @return 完成的Future，如果超时返回nullptr
      */
     ServiceFuture* waitForAny(const QList<ServiceFuture*>& futures, int timeoutMs = -1);
     
+    /**
+     * @brief 获取执行器（用于配置服务优先级通道和并发上限）
+     */
+    WorkStealingExecutor* executor() const;
+    
+    /**
+     * @brief 获取异步结果存储（按不透明ID查询进行中的调用）
+     */
+    AsyncResultStore* resultStore() const;
+    
 signals:
     void callStarted(const QString& serviceName, const QString& method);
     void callFinished(const QString& serviceName, const QString& method, const ServiceCallResult& result);
     
 private:
     ServiceRegistry* serviceRegistry;
-    QThreadPool* threadPool;
+    WorkStealingExecutor* workExecutor;
+    AsyncResultStore* results;
     
     // 执行异步调用
     ServiceCallResult executeCall(const QString& serviceName, 
@@ -0,0 +1,98 @@
+#ifndef EAGLE_CORE_BULKHEAD_H
+#define EAGLE_CORE_BULKHEAD_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariantMap>
+
+namespace Eagle {
+namespace Core {
+
+class BulkheadManagerPrivate;
+
+/**
+ * @brief 舱壁配置
+ */
+struct BulkheadConfig {
+    int maxConcurrentCalls = 10;     // 同时执行的最大调用数（同步和异步共享）
+    int maxWaitMs = 0;               // 同步调用等待执行名额的最长时间（毫秒），0表示立即拒绝
+    int maxQueueDepth = 100;         // 异步调用专用等待队列容量，队列满时拒绝
+
+    BulkheadConfig() = default;
+};
+
+/**
+ * @brief 舱壁管理器
+ *
+ * 按服务或插件划分相互隔离的执行名额：每个舱壁有独立的并发信号量和异步等待队列，
+ * 一个服务或插件耗尽自己的名额时只会被拒绝，不会占满共享的工作线程。
+ *
+ * 服务的舱壁按以下顺序确定：与服务同名的舱壁；通过assignService指定的舱壁
+ * （插件注册的服务默认指定为"plugin:<插件ID>"）。都不存在时不受舱壁约束。
+ */
+class BulkheadManager : public QObject {
+    Q_OBJECT
+
+public:
+    explicit BulkheadManager(QObject* parent = nullptr);
+    ~BulkheadManager();
+
+    void setBulkhead(const QString& name, const BulkheadConfig& config);
+    void removeBulkhead(const QString& name);
+    bool hasBulkhead(const QString& name) const;
+    BulkheadConfig bulkheadConfig(const QString& name) const;
+    QStringList bulkheads() const;
+
+    /**
+     * @brief 将服务归入指定舱壁（如同一插件的所有服务共享一个舱壁）
+     */
+    void assignService(const QString& serviceName, const QString& bulkheadName);
+    void unassignService(const QString& serviceName);
+
+    /**
+     * @brief 获取服务所属的舱壁名称，不受舱壁约束时返回空字符串
+     */
+    QString bulkheadFor(const QString& serviceName) const;
+
+    /**
+     * @brief 获取执行名额（最多等待maxWaitMs）
+     * @return 获取成功时返回true，调用结束后必须调用release
+     */
+    bool tryAcquire(const QString& name, const QString& serviceName);
+    void release(const QString& name);
+
+    /**
+     * @brief 登记舱壁执行器通道中的异步调用：不等待也不拒绝，只计入active
+     *
+     * 通道已限制异步调用的并发，计入active使同步调用能看到异步负载。调用结束后同样调用release
+     */
+    void acquireForLane(const QString& name);
+
+    /**
+     * @brief 记录异步队列已满导致的拒绝
+     */
+    void recordQueueRejection(const QString& name, const QString& serviceName);
+
+    /**
+     * @brief 获取舱壁统计（active、waiting、peakActive、rejected、queueRejected等）
+     */
+    QVariantMap getStatistics(const QString& name) const;
+
+signals:
+    void callRejected(const QString& bulkhead, const QString& serviceName, const QString& reason);
+
+private:
+    Q_DISABLE_COPY(BulkheadManager)
+    BulkheadManagerPrivate* d_ptr;
+
+    inline BulkheadManagerPrivate* d_func() { return d_ptr; }
+    inline const BulkheadManagerPrivate* d_func() const { return d_ptr; }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+Q_DECLARE_METATYPE(Eagle::Core::BulkheadConfig)
+
+#endif // EAGLE_CORE_BULKHEAD_H
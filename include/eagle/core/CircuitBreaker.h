@@ -4,8 +4,10 @@
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QDateTime>
-#include <QtCore/QTimer>
-#include <QtCore/QMutex>
+#include <QtCore/QVariantMap>
+#include <QtCore/QElapsedTimer>
+#include <atomic>
+#include <memory>
 
 namespace Eagle {
 namespace Core {
@@ -23,10 +25,15 @@ enum class CircuitState {
  * @brief 熔断器配置
  */
 struct CircuitBreakerConfig {
-    int failureThreshold = 5;        // 失败阈值
-    int successThreshold = 2;          // 半开状态下的成功阈值
-    int timeoutMs = 60000;            // 熔断超时时间（毫秒）
-    int halfOpenTimeoutMs = 5000;     // 半开状态超时时间（毫秒）
+    double failureRateThreshold = 50.0;    // 失败率阈值（百分比）
+    double slowCallRateThreshold = 100.0;  // 慢调用率阈值（百分比）
+    int slowCallDurationMs = 60000;        // 超过该耗时的调用计为慢调用（毫秒）
+    int minimumCalls = 20;                 // 统计窗口内的最小调用数，不足时不熔断
+    int windowMs = 10000;                  // 滚动统计窗口长度（毫秒）
+    int windowBuckets = 10;                // 滚动窗口分桶数
+    int successThreshold = 2;              // 半开状态下的探测调用数，全部成功后恢复
+    int timeoutMs = 60000;                 // 熔断超时时间（毫秒）
+    int halfOpenTimeoutMs = 5000;          // 半开状态超时时间（毫秒）
     
     CircuitBreakerConfig() = default;
 };
@@ -34,7 +41,9 @@ struct CircuitBreakerConfig {
 /**
  * @brief 熔断器
  * 
- * 用于服务调用的熔断保护
+ * 用于服务调用的熔断保护。状态保存在单个原子字中，调用结果计入分桶的滚动窗口，
+ * 窗口内调用数达到最小吞吐量后按失败率或慢调用率触发熔断。
+ * 状态转换在调用路径上按需完成，不依赖定时器和事件循环，可在任意线程使用。
  */
 class CircuitBreaker : public QObject {
     Q_OBJECT
@@ -43,22 +52,34 @@ public:
     explicit CircuitBreaker(const QString& serviceName, 
                            const CircuitBreakerConfig& config = CircuitBreakerConfig(),
                            QObject* parent = nullptr);
+    ~CircuitBreaker();
     
     /**
      * @brief 尝试调用（检查是否允许调用）
+     * @param probe 输出本次放行是否占用了半开状态的探测名额
      * @return 是否允许调用
+     *
+     * 占用探测名额的调用必须以recordSuccess/recordFailure结束，
+     * 未产生结果（重试、调用前被拒绝等）时应调用releaseProbe归还名额。
      */
-    bool allowCall();
+    bool allowCall(bool* probe = nullptr);
+    
+    /**
+     * @brief 归还allowCall占用但没有记录结果的探测名额（不再处于半开状态时忽略）
+     */
+    void releaseProbe();
     
     /**
      * @brief 记录成功调用
+     * @param durationMs 调用耗时（毫秒），用于慢调用统计
      */
-    void recordSuccess();
+    void recordSuccess(qint64 durationMs = 0);
     
     /**
      * @brief 记录失败调用
+     * @param durationMs 调用耗时（毫秒），用于慢调用统计
      */
-    void recordFailure();
+    void recordFailure(qint64 durationMs = 0);
     
     /**
      * @brief 获取当前状态
@@ -70,6 +91,16 @@ public:
      */
     QString serviceName() const;
     
+    /**
+     * @brief 获取配置
+     */
+    CircuitBreakerConfig config() const;
+    
+    /**
+     * @brief 获取滚动窗口统计（调用数、失败率、慢调用率）
+     */
+    QVariantMap getStatistics() const;
+    
     /**
      * @brief 重置熔断器
      */
@@ -78,23 +109,41 @@ public:
 signals:
     void stateChanged(const QString& serviceName, CircuitState oldState, CircuitState newState);
     
-private slots:
-    void onTimeout();
-    void onHalfOpenTimeout();
-    
 private:
-    void setState(CircuitState newState);
-    void checkHalfOpen();
+    Q_DISABLE_COPY(CircuitBreaker)
+    
+    /**
+     * @brief 滚动窗口中的一个时间桶
+     *
+     * counts 打包为 [慢调用:21][失败:21][调用:21]，一次fetch_add同时更新三个计数。
+     */
+    struct Bucket {
+        std::atomic<qint64> epoch{-1};     // 桶对应的时间片序号
+        std::atomic<quint64> counts{0};
+    };
+    
+    struct WindowTotals {
+        qint64 calls = 0;
+        qint64 failures = 0;
+        qint64 slowCalls = 0;
+    };
+    
+    qint64 nowMs() const;
+    void recordCall(bool failed, qint64 durationMs);
+    WindowTotals windowTotals() const;
+    void clearWindow();
+    void evaluateThresholds();
+    bool transition(quint64 expectedWord, CircuitState newState);
     
     QString m_serviceName;
     CircuitBreakerConfig m_config;
-    CircuitState m_state;
-    int m_failureCount;
-    int m_successCount;
-    QDateTime m_lastFailureTime;
-    QTimer* m_timeoutTimer;
-    QTimer* m_halfOpenTimer;
-    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;                          // 单调时钟
+    std::atomic<quint64> m_stateWord;               // [进入状态的时间(ms)][状态:2]
+    std::atomic<int> m_halfOpenPermits;             // 半开状态剩余探测名额
+    std::atomic<int> m_halfOpenSuccesses;
+    qint64 m_bucketMs;
+    int m_bucketCount;
+    std::unique_ptr<Bucket[]> m_buckets;
 };
 
 } // namespace Core
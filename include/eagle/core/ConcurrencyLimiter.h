@@ -0,0 +1,112 @@
+#ifndef EAGLE_CORE_CONCURRENCYLIMITER_H
+#define EAGLE_CORE_CONCURRENCYLIMITER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariantMap>
+
+namespace Eagle {
+namespace Core {
+
+class ConcurrencyLimiterPrivate;
+
+/**
+ * @brief 并发上限调整算法
+ */
+enum class ConcurrencyLimitAlgorithm {
+    Aimd,       // 加性增、乘性减：超时或失败时按比例收缩，否则逐步+1
+    Gradient    // 梯度：按长期平均延迟与当前延迟之比调整上限
+};
+
+/**
+ * @brief 自适应并发限制配置
+ */
+struct ConcurrencyLimiterConfig {
+    ConcurrencyLimitAlgorithm algorithm = ConcurrencyLimitAlgorithm::Gradient;
+    int initialLimit = 20;           // 初始并发上限
+    int minLimit = 1;                // 最小并发上限
+    int maxLimit = 1000;             // 最大并发上限
+    double backoffRatio = 0.9;       // 失败/超时时的收缩比例
+    int latencyThresholdMs = 5000;   // AIMD：超过该延迟视为过载信号
+    double tolerance = 1.5;          // 梯度：允许当前延迟超出长期平均的倍数
+    double smoothing = 0.2;          // 梯度：上限平滑系数
+    int longWindow = 600;            // 梯度：长期平均延迟的样本窗口
+
+    ConcurrencyLimiterConfig() = default;
+};
+
+/**
+ * @brief 自适应并发限制器
+ *
+ * 按服务维护并发上限和在途调用数，根据实际测得的调用延迟自动调整上限。
+ * 在途数达到上限时立即拒绝，使过载在排队和超时之前就被快速削减。
+ * 默认关闭（setEnabled(true)启用），启用后对所有服务生效，初始上限为initialLimit。
+ */
+class ConcurrencyLimiter : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ConcurrencyLimiter(QObject* parent = nullptr);
+    ~ConcurrencyLimiter();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * @brief 设置默认配置（对尚未单独配置的服务生效）
+     */
+    void setDefaultConfig(const ConcurrencyLimiterConfig& config);
+    ConcurrencyLimiterConfig defaultConfig() const;
+
+    void setServiceConfig(const QString& serviceName, const ConcurrencyLimiterConfig& config);
+    ConcurrencyLimiterConfig serviceConfig(const QString& serviceName) const;
+
+    /**
+     * @brief 尝试占用一个并发名额
+     * @return 在途数未达上限时返回true，调用结束后必须调用release
+     */
+    bool tryAcquire(const QString& serviceName);
+
+    /**
+     * @brief 释放并发名额并提交延迟样本
+     * @param latencyUs 调用耗时（微秒）
+     * @param dropped 调用是否超时或服务提供者异常（视为过载信号）；参数不匹配等调用方错误不应计入
+     */
+    void release(const QString& serviceName, qint64 latencyUs, bool dropped = false);
+
+    /**
+     * @brief 释放并发名额但不提交样本（调用未真正执行）
+     */
+    void cancel(const QString& serviceName);
+
+    int limit(const QString& serviceName) const;
+    int inFlight(const QString& serviceName) const;
+
+    /**
+     * @brief 获取服务的限制统计（limit、inFlight、rejected、minRttUs、longRttUs等）
+     */
+    QVariantMap getStatistics(const QString& serviceName) const;
+    QStringList services() const;
+
+    /**
+     * @brief 重置服务的上限和统计
+     */
+    void reset(const QString& serviceName);
+
+signals:
+    void limitChanged(const QString& serviceName, int oldLimit, int newLimit);
+    void requestRejected(const QString& serviceName, int limit, int inFlight);
+
+private:
+    Q_DISABLE_COPY(ConcurrencyLimiter)
+    ConcurrencyLimiterPrivate* d_ptr;
+
+    inline ConcurrencyLimiterPrivate* d_func() { return d_ptr; }
+    inline const ConcurrencyLimiterPrivate* d_func() const { return d_ptr; }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // EAGLE_CORE_CONCURRENCYLIMITER_H
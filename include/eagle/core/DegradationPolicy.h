@@ -20,7 +20,9 @@ enum class DegradationTrigger {
     Timeout,               // 超时
     ErrorRate,             // 错误率过高
     Manual,                // 手动触发
-    Always                 // 总是降级（用于测试）
+    Always,                // 总是降级（用于测试）
+    Overload,              // 并发上限已满，请求被快速拒绝
+    BulkheadFull           // 所属舱壁的执行名额或异步队列已满
 };
 
 /**
@@ -46,6 +48,11 @@ struct DegradationPolicyConfig {
     QString simplifiedServiceName;          // 简化服务名称（SimplifiedService时使用）
     double errorRateThreshold;              // 错误率阈值（0.0-1.0，ErrorRate时使用）
     int errorRateWindowMs;                  // 错误率统计窗口（毫秒）
+    bool serveStale;                         // 熔断开启或超时时优先返回最近一次成功结果
+    int staleCacheCapacity;                  // 每个服务缓存的成功结果条数上限
+    int maxStaleMs;                          // 旧结果最长可用时间（毫秒），0表示不限制
+    QStringList idempotentMethods;           // 幂等方法：服务恢复后可在后台重新调用以刷新旧结果，
+                                             // 未列出的方法只返回旧结果，不会被自动重新调用
     bool enabled;                            // 是否启用降级
     
     DegradationPolicyConfig()
@@ -53,12 +60,20 @@ struct DegradationPolicyConfig {
         , strategy(DegradationStrategy::DefaultValue)
         , errorRateThreshold(0.5)
         , errorRateWindowMs(60000)
+        , serveStale(false)
+        , staleCacheCapacity(256)
+        , maxStaleMs(0)
         , enabled(true)
     {
     }
     
+    bool isIdempotent(const QString& method) const {
+        return idempotentMethods.contains(method);
+    }
+    
     bool isValid() const {
         if (!enabled) return true;
+        if (serveStale && staleCacheCapacity <= 0) return false;
         
         switch (strategy) {
             case DegradationStrategy::FallbackService:
@@ -7,11 +7,13 @@
 #include <QtCore/QVariantMap>
 #include <QtCore/QDateTime>
 #include <QtCore/QTimer>
+#include "StateReplication.h"
 
 namespace Eagle {
 namespace Core {
 
 class ServiceRegistry;
+struct StateReplicationLink;
 
 /**
  * @brief 服务角色
@@ -73,16 +75,26 @@ struct FailoverConfig {
     QString serviceName;        // 服务名称
     FailoverMode mode;          // 故障转移模式
     int healthCheckIntervalMs;  // 健康检查间隔（毫秒）
+    int healthCheckTimeoutMs;   // 单次健康检查超时（毫秒），节点元数据healthCheckTimeoutMs可单独覆盖
+    double healthCheckJitter;   // 检查间隔的随机抖动比例（0-1），错开各节点的检查时间
+    double phiThreshold;        // phi-accrual怀疑阈值，主节点phi在相隔一个检查间隔的两次评估中都超过该值时触发故障转移，<=0表示不启用
+    int heartbeatIntervalMs;    // 启用phi检测时主节点的心跳探测间隔（毫秒）
+    int phiMinStdDeviationMs;   // 心跳间隔标准差的下限（毫秒），避免间隔过于规律时过度敏感
     int failureThreshold;       // 失败阈值（连续失败次数）
     int recoveryThreshold;     // 恢复阈值（连续成功次数）
-    bool enableStateSync;       // 启用状态同步
-    int stateSyncIntervalMs;    // 状态同步间隔（毫秒）
+    bool enableStateSync;       // 启用状态同步（备节点元数据replicationSocket为其复制接收端的本地套接字名）
+    int stateSyncIntervalMs;    // 状态同步间隔（毫秒），用于重连和补发；状态变更本身会在批量延迟后立即发送
     QStringList primaryNodes;   // 主节点列表
     QStringList standbyNodes;   // 备节点列表
     
     FailoverConfig()
         : mode(FailoverMode::Automatic)
         , healthCheckIntervalMs(5000)
+        , healthCheckTimeoutMs(3000)
+        , healthCheckJitter(0.1)
+        , phiThreshold(8.0)
+        , heartbeatIntervalMs(500)
+        , phiMinStdDeviationMs(100)
         , failureThreshold(3)
         , recoveryThreshold(2)
         , enableStateSync(true)
@@ -119,6 +131,16 @@ struct FailoverEvent {
  * @brief 故障转移管理器
  * 
  * 负责管理主备服务切换、故障检测和状态同步
+ * 
+ * 健康检查是异步并发的：所有节点共享一个QNetworkAccessManager（复用连接），
+ * 每个节点按各自带抖动的间隔调度，结果到达时立即更新节点状态。
+ * 
+ * 主节点另有phi-accrual故障检测：成功的探测、recordHeartbeat以及ServiceRegistry中
+ * 同名服务的成功调用都作为心跳，根据心跳间隔分布计算phi值；失败调用会让主节点被立即探测。
+ * phi超过阈值且没有进行中的探测时判定主节点失效，不必等待连续失败次数。
+ * 
+ * 每个服务可以有一份ReplicatedState：主节点的变更按批次以增量形式通过本地套接字发送给
+ * 备节点的StateReplicaServer，备节点落后超出变更日志时先发送快照再续传日志。
  */
 class FailoverManager : public QObject {
     Q_OBJECT
@@ -150,6 +172,20 @@ public:
     ServiceStatus getServiceStatus(const QString& serviceName) const;
     QList<FailoverEvent> getFailoverHistory(const QString& serviceName, int limit = 10) const;
     
+    // 状态复制
+    ReplicatedState* replicatedState(const QString& serviceName);
+    bool startReplicaServer(const QString& serviceName, const QString& socketName);
+    void stopReplicaServer(const QString& serviceName);
+    
+    /**
+     * @brief 获取复制统计（版本、各备节点已确认版本、复制延迟等）
+     */
+    QVariantMap getReplicationStatistics(const QString& serviceName) const;
+    
+    // 故障检测
+    void recordHeartbeat(const QString& serviceName, const QString& nodeId);
+    double phi(const QString& serviceName, const QString& nodeId) const;
+    
     // 控制
     void setEnabled(bool enabled);
     bool isEnabled() const;
@@ -161,10 +197,13 @@ signals:
     void failoverCompleted(const QString& serviceName, bool success);
     void nodeStatusChanged(const QString& serviceName, const QString& nodeId, ServiceStatus status);
     void healthCheckFailed(const QString& serviceName, const QString& nodeId);
+    void nodeSuspected(const QString& serviceName, const QString& nodeId, double phi);
     
 private slots:
     void onHealthCheckTimer();
     void onStateSyncTimer();
+    void onServiceCallSucceeded(const QString& serviceName, qint64 elapsedMs);
+    void onServiceCallFailed(const QString& serviceName, const QString& error);
     
 private:
     Q_DISABLE_COPY(FailoverManager)
@@ -175,11 +214,16 @@ private:
     inline Private* d_func() { return d; }
     inline const Private* d_func() const { return d; }
     
-    bool performHealthCheck(const QString& serviceName, const QString& nodeId);
-    bool checkNodeHealth(const ServiceNode& node) const;
+    void startHealthCheck(const QString& serviceName, const ServiceNode& node, int timeoutMs);
+    void applyHealthCheckResult(const QString& serviceName, const QString& nodeId, bool healthy);
     void updateNodeStatus(const QString& serviceName, const QString& nodeId, ServiceStatus status);
     void triggerFailover(const QString& serviceName, const QString& reason);
     bool syncState(const QString& serviceName, const ServiceNode& from, const ServiceNode& to);
+    void scheduleReplication(const QString& serviceName);
+    void flushReplication(const QString& serviceName);
+    void shipState(StateReplicationLink* link, ReplicatedState* state);
+    void onReplicationReadyRead(StateReplicationLink* link);
+    void updateReplicationMetrics(const QString& serviceName);
     void recordFailoverEvent(const FailoverEvent& event);
 };
 
@@ -0,0 +1,89 @@
+#ifndef EAGLE_CORE_HEDGINGPOLICY_H
+#define EAGLE_CORE_HEDGINGPOLICY_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+namespace Eagle {
+namespace Core {
+
+class HedgingPolicyPrivate;
+
+/**
+ * @brief 对冲请求配置
+ *
+ * 只应对幂等服务启用：对冲请求可能与原请求同时在不同实例上执行。
+ */
+struct HedgingPolicyConfig {
+    bool enabled = false;            // 是否启用
+    int delayMs = 0;                 // 对冲延迟（毫秒），<=0时使用观测延迟分位数
+    double delayPercentile = 0.95;   // 自动对冲延迟使用的分位数
+    int minDelayMs = 5;              // 自动对冲延迟的下限
+    int defaultDelayMs = 50;         // 样本不足时使用的对冲延迟
+    double budgetRatio = 0.1;        // 对冲预算：对冲请求数不超过调用数的该比例
+    int maxBudgetTokens = 10;        // 预算令牌上限（允许的突发对冲数）
+
+    HedgingPolicyConfig() = default;
+};
+
+/**
+ * @brief 对冲请求策略
+ *
+ * 按服务维护对冲配置、延迟分位数估计、对冲预算以及对冲发起/胜出统计。
+ */
+class HedgingPolicy : public QObject {
+    Q_OBJECT
+
+public:
+    explicit HedgingPolicy(QObject* parent = nullptr);
+    ~HedgingPolicy();
+
+    void setPolicy(const QString& serviceName, const HedgingPolicyConfig& config);
+    void removePolicy(const QString& serviceName);
+    HedgingPolicyConfig getPolicy(const QString& serviceName) const;
+    bool isEnabled(const QString& serviceName) const;
+
+    /**
+     * @brief 当前对冲延迟（毫秒）
+     */
+    int hedgeDelay(const QString& serviceName) const;
+
+    /**
+     * @brief 记录一次对冲调用，并按预算比例积累对冲令牌
+     */
+    void recordCall(const QString& serviceName);
+
+    /**
+     * @brief 记录一次成功调用的延迟（用于分位数估计）
+     */
+    void recordLatency(const QString& serviceName, qint64 latencyUs);
+
+    /**
+     * @brief 尝试消耗一个对冲令牌
+     * @return 预算不足时返回false
+     */
+    bool tryAcquireHedge(const QString& serviceName);
+
+    /**
+     * @brief 记录对冲请求先于原请求成功返回
+     */
+    void recordHedgeWon(const QString& serviceName);
+
+    /**
+     * @brief 获取对冲统计（calls、hedgesIssued、hedgesWon、hedgesThrottled、delayMs）
+     */
+    QVariantMap getStatistics(const QString& serviceName) const;
+
+private:
+    Q_DISABLE_COPY(HedgingPolicy)
+    HedgingPolicyPrivate* d_ptr;
+
+    inline HedgingPolicyPrivate* d_func() { return d_ptr; }
+    inline const HedgingPolicyPrivate* d_func() const { return d_ptr; }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // EAGLE_CORE_HEDGINGPOLICY_H
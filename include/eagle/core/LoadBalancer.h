@@ -7,10 +7,13 @@
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
 #include "ServiceDescriptor.h"
+#include <memory>
 
 namespace Eagle {
 namespace Core {
 
+struct InstanceSelector;
+
 /**
  * @brief 负载均衡算法类型
  */
@@ -19,13 +22,43 @@ enum class LoadBalanceAlgorithm {
     WeightedRoundRobin,  // 加权轮询
     LeastConnections,    // 最少连接数
     Random,          // 随机
-    IPHash          // IP哈希（会话保持）
+    IPHash,         // 一致性哈希（会话保持，带负载上限）
+    P2CEwma         // 双随机选择 + 延迟指数衰减平均（按延迟和在途数择优）
+};
+
+/**
+ * @brief 一致性哈希配置
+ */
+struct ConsistentHashConfig {
+    int virtualNodes = 100;     // 每单位权重的虚拟节点数（权重超过10按10计）
+    double loadFactor = 1.25;   // 负载上限系数：单实例在途数不超过平均值的该倍数
+    
+    ConsistentHashConfig() = default;
+};
+
+/**
+ * @brief 被动异常检测配置
+ *
+ * 根据实际调用结果自动摘除异常实例，摘除时间随摘除次数指数增长。
+ */
+struct OutlierDetectionConfig {
+    bool enabled = true;
+    int consecutiveErrors = 5;          // 连续失败次数达到该值即摘除
+    double latencyFactor = 3.0;         // 平均延迟超过同服务其他实例中位数的倍数即摘除（<=0禁用）
+    int minLatencySamples = 20;         // 参与延迟判定所需的最少样本数
+    qint64 minLatencyUs = 1000;         // 低于该延迟不判定为延迟异常
+    int baseEjectionTimeMs = 30000;     // 基础摘除时间
+    int maxEjectionTimeMs = 300000;     // 最长摘除时间
+    int maxEjectionPercent = 50;        // 同一服务最多被摘除的实例百分比
+    
+    OutlierDetectionConfig() = default;
 };
 
 /**
  * @brief 服务实例信息
  */
 struct ServiceInstance {
+    QString instanceId;            // 实例ID
     ServiceDescriptor descriptor;  // 服务描述符
     int weight;                    // 权重（用于加权轮询）
     int activeConnections;         // 当前活跃连接数
@@ -71,18 +104,23 @@ public:
     
     /**
      * @brief 选择服务实例
+     * @return 选择快照中的实例副本（含instanceId），实例注销后仍可安全访问；无可用实例时返回nullptr
      */
-    ServiceInstance* selectInstance(const QString& serviceName, const QString& clientId = QString());
+    std::shared_ptr<const ServiceInstance> selectInstance(const QString& serviceName,
+                                                          const QString& clientId = QString());
     
     /**
-     * @brief 记录服务调用开始
+     * @brief 记录服务调用开始（无锁，更新实例的原子计数）
      */
     void onServiceCallStart(const QString& serviceName, const QString& instanceId);
     
     /**
-     * @brief 记录服务调用结束
+     * @brief 记录服务调用结束（无锁，仅在需要异常检测时加锁）
+     * @param latencyUs 调用耗时（微秒），<0表示调用未真正执行，不计入延迟统计
+     * @param success 调用是否成功，失败按惩罚延迟计入
      */
-    void onServiceCallEnd(const QString& serviceName, const QString& instanceId);
+    void onServiceCallEnd(const QString& serviceName, const QString& instanceId,
+                          qint64 latencyUs = -1, bool success = true);
     
     /**
      * @brief 设置服务实例健康状态
@@ -104,6 +142,11 @@ public:
      */
     QList<ServiceInstance> getInstances(const QString& serviceName) const;
     
+    /**
+     * @brief 获取当前参与选择的实例数（无锁，读取已发布的快照）
+     */
+    int availableInstanceCount(const QString& serviceName) const;
+    
     /**
      * @brief 获取服务实例统计信息
      */
@@ -119,6 +162,23 @@ public:
      */
     QString getInstanceIdByProvider(const QString& serviceName, QObject* provider) const;
     
+    /**
+     * @brief 设置一致性哈希配置（对所有服务生效）
+     */
+    void setConsistentHashConfig(const ConsistentHashConfig& config);
+    ConsistentHashConfig consistentHashConfig() const;
+    
+    /**
+     * @brief 设置被动异常检测配置（对所有服务生效）
+     */
+    void setOutlierDetectionConfig(const OutlierDetectionConfig& config);
+    OutlierDetectionConfig outlierDetectionConfig() const;
+    
+    /**
+     * @brief 实例当前是否被异常检测摘除
+     */
+    bool isInstanceEjected(const QString& serviceName, const QString& instanceId) const;
+    
     /**
      * @brief 启用/禁用负载均衡
      */
@@ -129,6 +189,8 @@ signals:
     void instanceRegistered(const QString& serviceName, const QString& instanceId);
     void instanceUnregistered(const QString& serviceName, const QString& instanceId);
     void instanceHealthChanged(const QString& serviceName, const QString& instanceId, bool healthy);
+    void instanceEjected(const QString& serviceName, const QString& instanceId, const QString& reason, int durationMs);
+    void instanceReinstated(const QString& serviceName, const QString& instanceId);
     
 private:
     Q_DISABLE_COPY(LoadBalancer)
@@ -139,16 +201,19 @@ private:
     inline Private* d_func() { return d; }
     inline const Private* d_func() const { return d; }
     
-    // 负载均衡算法实现
-    ServiceInstance* selectRoundRobin(const QString& serviceName);
-    ServiceInstance* selectWeightedRoundRobin(const QString& serviceName);
-    ServiceInstance* selectLeastConnections(const QString& serviceName);
-    ServiceInstance* selectRandom(const QString& serviceName);
-    ServiceInstance* selectIPHash(const QString& serviceName, const QString& clientId);
+    // 负载均衡算法实现（基于已发布的选择快照）
+    int selectRoundRobin(InstanceSelector& selector);
+    int selectWeightedRoundRobin(InstanceSelector& selector);
+    int selectLeastConnections(InstanceSelector& selector);
+    int selectRandom(InstanceSelector& selector);
+    int selectIPHash(const QString& serviceName, InstanceSelector& selector, const QString& clientId);
+    int selectP2CEwma(InstanceSelector& selector);
+    
+    // 异常检测辅助方法
+    void reinstateExpiredInstances(qint64 nowNs);
     
     // 辅助方法
     QString generateInstanceId(const ServiceDescriptor& descriptor) const;
-    QList<ServiceInstance*> getHealthyInstances(const QString& serviceName) const;
 };
 
 } // namespace Core
@@ -0,0 +1,88 @@
+#ifndef EAGLE_CORE_PRINCIPALRESOLVER_H
+#define EAGLE_CORE_PRINCIPALRESOLVER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+#include <memory>
+
+namespace Eagle {
+namespace Core {
+
+class ApiKeyManager;
+class SessionManager;
+class PrincipalResolverPrivate;
+
+/**
+ * @brief 认证凭证类型
+ */
+enum class CredentialType {
+    ApiKey,
+    Session
+};
+
+/**
+ * @brief 已认证的主体（由认证token解析得到）
+ */
+struct AuthPrincipal {
+    QString userId;                  // 用户ID
+    CredentialType credentialType = CredentialType::ApiKey;
+    QString credentialId;            // API密钥ID或会话ID
+    qint64 expiresAtMs = 0;          // 解析结果失效时间（自纪元起的毫秒数），不晚于凭证本身的过期时间
+
+    bool isValid() const {
+        return !userId.isEmpty();
+    }
+};
+
+/**
+ * @brief 认证token到主体的解析器
+ *
+ * 依次尝试API密钥和会话验证token，把结果缓存一个较短的时间（按token的SHA-256分片保存，
+ * 不缓存失败结果）。缓存期内的请求不再访问ApiKeyManager和SessionManager；
+ * 密钥被删除或更新、会话被销毁或过期时立即移除对应的缓存项。
+ */
+class PrincipalResolver : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PrincipalResolver(ApiKeyManager* apiKeyManager, SessionManager* sessionManager,
+                               QObject* parent = nullptr);
+    ~PrincipalResolver();
+
+    /**
+     * @brief 解析token，无效时返回空指针
+     */
+    std::shared_ptr<const AuthPrincipal> resolve(const QString& token);
+
+    /**
+     * @brief 移除某个凭证（API密钥ID或会话ID）的缓存
+     */
+    void invalidateCredential(const QString& credentialId);
+    void clear();
+
+    // 配置
+    void setCacheTTL(int ttlMs);
+    int cacheTTL() const;
+    void setCacheMaxSize(int maxSize);
+    int cacheMaxSize() const;
+
+    /**
+     * @brief 获取统计信息（命中数、未命中数、缓存条目数）
+     */
+    QVariantMap getStatistics() const;
+
+private:
+    Q_DISABLE_COPY(PrincipalResolver)
+    PrincipalResolverPrivate* d_ptr;
+
+    std::shared_ptr<const AuthPrincipal> resolveUncached(const QString& token) const;
+
+    inline PrincipalResolverPrivate* d_func() { return d_ptr; }
+    inline const PrincipalResolverPrivate* d_func() const { return d_ptr; }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // EAGLE_CORE_PRINCIPALRESOLVER_H
@@ -93,6 +93,9 @@ struct User {
 
 /**
  * @brief RBAC权限管理器
+ *
+ * 权限名在添加时分配整数序号，角色的有效权限（含多级继承）在角色或权限变更时编译为位集。
+ * 权限检查取出用户编译后的位集（按用户分片缓存，CLOCK淘汰）并测试对应的位，不再逐个遍历角色。
  */
 class RBACManager : public QObject {
     Q_OBJECT
@@ -178,9 +181,6 @@ private:
     inline const Private* d_func() const { return d; }
     
     // 私有辅助函数
-    void cachePermissionResult(const QString& userId, const QString& permissionName, bool result) const;
-    void evictLRUEntries() const;
-    void clearPermissionCache(const QString& permissionName) const;
     void notifyPermissionChange(const PermissionChangeNotification& notification) const;
     
     friend class Private;
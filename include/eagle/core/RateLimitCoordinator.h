@@ -0,0 +1,49 @@
+#ifndef EAGLE_CORE_RATELIMITCOORDINATOR_H
+#define EAGLE_CORE_RATELIMITCOORDINATOR_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+namespace Eagle {
+namespace Core {
+
+class RateLimitCoordinatorPrivate;
+
+/**
+ * @brief 本机限流协调器
+ *
+ * 在本地套接字上监听，为使用 LocalBroker 后端的进程按键分配配额租约，
+ * 所有进程的租用量合计不超过规则限额。协议为每行一个JSON对象。
+ */
+class RateLimitCoordinator : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RateLimitCoordinator(QObject* parent = nullptr);
+    ~RateLimitCoordinator();
+
+    bool start(const QString& serverName);
+    void stop();
+    bool isRunning() const;
+    QString serverName() const;
+
+    QVariantMap getStatistics() const;
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    Q_DISABLE_COPY(RateLimitCoordinator)
+
+    RateLimitCoordinatorPrivate* d_ptr;
+
+    inline RateLimitCoordinatorPrivate* d_func() { return d_ptr; }
+    inline const RateLimitCoordinatorPrivate* d_func() const { return d_ptr; }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // EAGLE_CORE_RATELIMITCOORDINATOR_H
@@ -3,6 +3,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 #include <QtCore/QDateTime>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
@@ -11,64 +12,83 @@
 namespace Eagle {
 namespace Core {
 
+class RateLimiterBackend;
+
 /**
  * @brief 限流算法类型
  */
 enum class RateLimitAlgorithm {
-    TokenBucket,    // 令牌桶算法
-    SlidingWindow   // 滑动窗口算法
+    TokenBucket,        // 令牌桶算法
+    SlidingWindow,      // 滑动窗口计数算法（相邻两个固定窗口加权估算，每个键O(1)内存）
+    SlidingWindowExact  // 精确滑动窗口（记录窗口内每个请求的时间，内存随限额线性增长）
 };
 
 /**
  * @brief 限流器
- * 
- * 支持令牌桶和滑动窗口两种算法
+ *
+ * 支持令牌桶、滑动窗口计数（默认）和精确滑动窗口三种算法。限流状态按键分片存放，时间使用单调纳秒时钟，
+ * 令牌以“令牌数 × 窗口纳秒”的定点数存储，低速率下补充也不丢失精度。
+ *
+ * 规则键以"*"结尾时作为前缀规则，匹配该前缀的每个键拥有独立的限流状态
+ * （如"apikey:*"为每个API密钥单独限流）。
  */
 class RateLimiter : public QObject {
     Q_OBJECT
-    
+
 public:
     explicit RateLimiter(QObject* parent = nullptr);
     ~RateLimiter();
-    
+
     // 配置限流规则
-    void setLimit(const QString& key, int maxRequests, int windowMs, 
-                  RateLimitAlgorithm algorithm = RateLimitAlgorithm::TokenBucket);
+    void setLimit(const QString& key, int maxRequests, int windowMs,
+                  RateLimitAlgorithm algorithm = RateLimitAlgorithm::SlidingWindow);
     void removeLimit(const QString& key);
     void clearLimits();
-    
+    bool hasLimit(const QString& key) const;
+
     // 检查是否允许请求
     bool allowRequest(const QString& key);
     bool allowRequest(const QString& key, int maxRequests, int windowMs);
-    
+
+    /**
+     * @brief 分层限流检查（如 全局 → API密钥 → 路由）
+     *
+     * 一次性检查所有层级，全部允许时才在每一层各消耗一次配额，
+     * 任一层拒绝时不消耗任何层的配额。没有匹配规则的键会被跳过。
+     */
+    bool allowHierarchical(const QStringList& keys);
+
     // 获取限流信息
     int getRemainingRequests(const QString& key) const;
     QDateTime getResetTime(const QString& key) const;
-    
+
     // 配置
     void setEnabled(bool enabled);
     bool isEnabled() const;
-    
+
+    /**
+     * @brief 设置跨进程计数后端（RateLimiter接管所有权，传入nullptr恢复进程内计数）
+     *
+     * 后端可用时，有规则的键由后端按滑动窗口计数统一限流；
+     * 后端不可用时自动回退到进程内计数。
+     */
+    void setBackend(RateLimiterBackend* backend);
+    RateLimiterBackend* backend() const;
+
 signals:
     void rateLimitExceeded(const QString& key, int maxRequests, int windowMs);
-    
+
 private slots:
     void onCleanupTimer();
-    
+
 private:
     Q_DISABLE_COPY(RateLimiter)
-    
+
     class Private;
     Private* d;
-    
+
     inline Private* d_func() { return d; }
     inline const Private* d_func() const { return d; }
-    
-    // 令牌桶算法
-    bool checkTokenBucket(const QString& key, int maxRequests, int windowMs);
-    
-    // 滑动窗口算法
-    bool checkSlidingWindow(const QString& key, int maxRequests, int windowMs);
 };
 
 } // namespace Core
@@ -0,0 +1,80 @@
+#ifndef EAGLE_CORE_RATELIMITERBACKEND_H
+#define EAGLE_CORE_RATELIMITERBACKEND_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+namespace Eagle {
+namespace Core {
+
+/**
+ * @brief 后端获取配额的结果
+ */
+enum class RateLimitAcquireResult {
+    Acquired,     // 已获取配额
+    Rejected,     // 超出限额
+    Unavailable   // 后端无法为该键计数，由进程内计数兜底
+};
+
+/**
+ * @brief 限流计数后端基类
+ *
+ * RateLimiter 默认在进程内计数。设置后端后，有规则的键改由后端计数，
+ * 用于同一主机上多个框架进程共享限额。后端统一使用滑动窗口计数算法。
+ */
+class RateLimiterBackend : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RateLimiterBackend(QObject* parent = nullptr) : QObject(parent) {}
+    virtual ~RateLimiterBackend() {}
+
+    virtual QString name() const = 0;
+
+    /**
+     * @brief 后端当前是否可用（不可用时 RateLimiter 回退到进程内计数）
+     */
+    virtual bool isAvailable() const = 0;
+
+    // 获取一次配额 / 退还一次本窗口内已获取的配额
+    virtual RateLimitAcquireResult tryAcquire(const QString& key, int maxRequests, int windowMs) = 0;
+    virtual void release(const QString& key, int maxRequests, int windowMs) = 0;
+
+    // 剩余配额，-1表示未知
+    virtual int remaining(const QString& key, int maxRequests, int windowMs) = 0;
+
+    // 距离下一次可获取配额的毫秒数（0表示当前可用），-1表示未知
+    virtual qint64 msUntilAvailable(const QString& key, int maxRequests, int windowMs) = 0;
+
+    virtual QVariantMap getStatistics() const { return QVariantMap(); }
+};
+
+/**
+ * @brief 共享内存限流后端工厂
+ *
+ * 同一主机上使用相同 segmentKey 的进程共享一块固定大小的计数表，
+ * 计数通过原子CAS更新，热路径不经过任何进程间锁。空闲超过两个窗口的槽位
+ * 会被新键复用；计数表已满时新键回退到进程内计数。
+ */
+class SharedMemoryRateLimiterBackendFactory {
+public:
+    static RateLimiterBackend* create(const QString& segmentKey, QObject* parent = nullptr);
+};
+
+/**
+ * @brief 本地协调器限流后端工厂
+ *
+ * 通过本地套接字向 RateLimitCoordinator 批量租用配额，租到的配额在本进程内消耗，
+ * 只有租约用尽或过期时才访问协调器。
+ */
+class LocalBrokerRateLimiterBackendFactory {
+public:
+    static RateLimiterBackend* create(const QString& serverName, int leaseBatch = 10,
+                                      int timeoutMs = 200, QObject* parent = nullptr);
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // EAGLE_CORE_RATELIMITERBACKEND_H
@@ -0,0 +1,217 @@
+#ifndef EAGLE_CORE_SERVICECALLFUTURE_H
+#define EAGLE_CORE_SERVICECALLFUTURE_H
+
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QMetaType>
+#include <QtCore/QList>
+#include <functional>
+
+class QObject;
+class QThreadPool;
+
+namespace Eagle {
+namespace Core {
+
+class ServiceCallState;
+
+/**
+ * @brief 服务调用结果
+ */
+struct ServiceCallResult {
+    bool success;           // 是否成功
+    QVariant result;        // 返回结果
+    QString error;          // 错误信息
+    int elapsedMs;          // 耗时（毫秒）
+    bool stale;             // 结果是否为降级时返回的最近一次成功结果
+    qint64 staleAgeMs;      // 旧结果的年龄（毫秒，仅stale为true时有效）
+
+    ServiceCallResult()
+        : success(false)
+        , elapsedMs(0)
+        , stale(false)
+        , staleAgeMs(0)
+    {}
+
+    ServiceCallResult(const QVariant& res)
+        : success(true)
+        , result(res)
+        , elapsedMs(0)
+        , stale(false)
+        , staleAgeMs(0)
+    {}
+
+    ServiceCallResult(const QString& err)
+        : success(false)
+        , error(err)
+        , elapsedMs(0)
+        , stale(false)
+        , staleAgeMs(0)
+    {}
+};
+
+/**
+ * @brief 续体执行器
+ *
+ * 接收一个任务并决定在哪里执行它；空执行器表示在完成结果的线程上内联执行
+ */
+using ServiceExecutor = std::function<void(std::function<void()>)>;
+
+namespace ServiceExecutors {
+
+/**
+ * @brief 内联执行器（在设置结果的线程上直接执行续体）
+ */
+ServiceExecutor inlineExecutor();
+
+/**
+ * @brief 线程池执行器
+ * @param pool 线程池，nullptr表示使用全局线程池
+ */
+ServiceExecutor threadPool(QThreadPool* pool = nullptr);
+
+/**
+ * @brief Qt事件循环执行器（投递到context所在线程执行，context销毁后任务被丢弃）
+ *
+ * 执行器只弱引用context，并在context所在线程上检查它是否存活后才执行任务，
+ * 因此续体可以直接捕获context，即使完成与context销毁并发发生也是安全的
+ */
+ServiceExecutor eventLoop(QObject* context);
+
+} // namespace ServiceExecutors
+
+/**
+ * @brief 轻量级服务调用Future
+ *
+ * 值类型，仅持有共享状态的引用计数指针；共享状态来自全局无锁对象池，
+ * 不创建QObject，也不依赖事件循环。需要信号的调用方请使用ServiceFuture适配器。
+ */
+class ServiceCallFuture {
+public:
+    using Continuation = std::function<void(const ServiceCallResult&)>;
+
+    ServiceCallFuture();
+    ServiceCallFuture(const ServiceCallFuture& other);
+    ServiceCallFuture(ServiceCallFuture&& other) noexcept;
+    ServiceCallFuture& operator=(const ServiceCallFuture& other);
+    ServiceCallFuture& operator=(ServiceCallFuture&& other) noexcept;
+    ~ServiceCallFuture();
+
+    /**
+     * @brief 创建已完成的Future
+     */
+    static ServiceCallFuture makeReady(const ServiceCallResult& result);
+
+    /**
+     * @brief 是否关联了共享状态
+     */
+    bool isValid() const;
+
+    /**
+     * @brief 检查是否完成（无锁）
+     */
+    bool isFinished() const;
+
+    /**
+     * @brief 等待结果（阻塞）
+     * @param timeoutMs 超时时间（毫秒），-1表示无限等待
+     * @return 调用结果，超时返回失败结果
+     */
+    ServiceCallResult wait(int timeoutMs = -1) const;
+
+    /**
+     * @brief 获取结果（非阻塞，如果未完成返回默认的失败结果）
+     */
+    ServiceCallResult result() const;
+
+    /**
+     * @brief 注册完成续体
+     * @param continuation 续体，已完成时立即调度
+     * @param executor 执行器，空表示内联执行
+     * @return 订阅ID，可用于unsubscribe；已完成时立即调度并返回0
+     */
+    quint64 subscribe(Continuation continuation, const ServiceExecutor& executor = ServiceExecutor()) const;
+
+    /**
+     * @brief 取消尚未调度的续体（续体捕获的对象销毁前调用）
+     * @return 是否取消成功（已完成或ID无效时返回false）
+     */
+    bool unsubscribe(quint64 subscription) const;
+
+    /**
+     * @brief 链式操作：成功后执行，失败原样传递
+     * @return 新的Future
+     */
+    ServiceCallFuture then(std::function<QVariant(const QVariant&)> callback,
+                           const ServiceExecutor& executor = ServiceExecutor()) const;
+
+    /**
+     * @brief 链式操作：失败后执行
+     * @return 当前Future
+     */
+    ServiceCallFuture onError(std::function<void(const QString&)> callback,
+                              const ServiceExecutor& executor = ServiceExecutor()) const;
+
+    /**
+     * @brief 链式操作：无论成功失败都执行
+     * @return 当前Future
+     */
+    ServiceCallFuture finally(std::function<void()> callback,
+                              const ServiceExecutor& executor = ServiceExecutor()) const;
+
+private:
+    friend class ServicePromise;
+    explicit ServiceCallFuture(ServiceCallState* state);
+
+    ServiceCallState* state;
+};
+
+/**
+ * @brief 服务调用Promise
+ *
+ * 结果的生产端，可复制（所有副本共享同一状态），结果只能设置一次
+ */
+class ServicePromise {
+public:
+    ServicePromise();
+    ServicePromise(const ServicePromise& other);
+    ServicePromise& operator=(const ServicePromise& other);
+    ~ServicePromise();
+
+    /**
+     * @brief 获取关联的Future
+     */
+    ServiceCallFuture future() const;
+
+    /**
+     * @brief 设置结果并调度所有续体
+     * @return 是否设置成功（已设置过结果时返回false）
+     */
+    bool setResult(const ServiceCallResult& result) const;
+
+private:
+    ServiceCallState* state;
+};
+
+/**
+ * @brief 组合：全部完成
+ *
+ * 不阻塞线程。全部成功时结果为按输入顺序排列的QVariantList；
+ * 任意一个失败时立即以该错误完成
+ */
+ServiceCallFuture whenAll(const QList<ServiceCallFuture>& futures);
+
+/**
+ * @brief 组合：任意一个完成
+ *
+ * 不阻塞线程。以最先完成的调用结束，结果为QVariantMap：
+ * index（在输入中的下标）、success、result、error；输入为空时失败
+ */
+ServiceCallFuture whenAny(const QList<ServiceCallFuture>& futures);
+
+} // namespace Core
+} // namespace Eagle
+
+Q_DECLARE_METATYPE(Eagle::Core::ServiceCallResult)
+
+#endif // EAGLE_CORE_SERVICECALLFUTURE_H
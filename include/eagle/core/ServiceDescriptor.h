@@ -14,6 +14,7 @@ struct ServiceDescriptor {
     QStringList methods;
     QStringList endpoints;
     QString healthCheck;
+    QString pluginId;       // 提供服务的插件ID（可选，用于按插件划分舱壁）
     QObject* provider;
     
     ServiceDescriptor() : provider(nullptr) {}
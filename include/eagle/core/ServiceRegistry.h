@@ -13,6 +13,10 @@
 #include "DegradationPolicy.h"
 #include "LoadBalancer.h"
 #include "AsyncServiceCall.h"
+#include "ConcurrencyLimiter.h"
+#include "HedgingPolicy.h"
+#include "Bulkhead.h"
+#include "StaleResultCache.h"
 
 namespace Eagle {
 namespace Core {
@@ -52,6 +56,10 @@ public:
     
     // 异步服务调用
     AsyncServiceCall* asyncServiceCall() const;
+    ServiceCallFuture callAsync(const QString& serviceName,
+                                const QString& method,
+                                const QVariantList& args = QVariantList(),
+                                int timeout = 5000);
     
     // 配置
     void setDefaultTimeout(int timeoutMs);
@@ -77,6 +85,16 @@ public:
     void setDegradationPolicy(const QString& serviceName, const DegradationPolicyConfig& config);
     DegradationPolicyConfig getDegradationPolicy(const QString& serviceName) const;
     
+    // 最近一次成功结果缓存（降级策略启用serveStale时使用）
+    StaleResultCache* staleResultCache() const;
+    
+    /**
+     * @brief 获取当前线程最近一次callService返回值的陈旧信息
+     *
+     * 熔断或超时降级返回缓存的旧值时stale为true，ageMs为旧值的年龄。
+     */
+    StaleResultInfo lastResultStaleness() const;
+    
     // 健康检查
     bool checkServiceHealth(const QString& serviceName) const;
     
@@ -90,20 +108,48 @@ public:
     QString getLoadBalanceAlgorithm(const QString& serviceName) const;
     LoadBalancer* loadBalancer() const;
     
+    // 自适应并发限制配置（默认关闭）
+    void setConcurrencyLimitEnabled(bool enabled);
+    bool isConcurrencyLimitEnabled() const;
+    ConcurrencyLimiter* concurrencyLimiter() const;
+    
+    // 对冲请求配置（仅对幂等且有多个实例的服务启用）
+    void setHedgingPolicy(const QString& serviceName, const HedgingPolicyConfig& config);
+    HedgingPolicyConfig getHedgingPolicy(const QString& serviceName) const;
+    HedgingPolicy* hedgingPolicy() const;
+    
+    // 舱壁隔离配置（name为服务名，或"plugin:<插件ID>"表示插件的所有服务共享）
+    void setBulkhead(const QString& name, const BulkheadConfig& config);
+    void removeBulkhead(const QString& name);
+    void assignServiceBulkhead(const QString& serviceName, const QString& bulkheadName);
+    QVariantMap getBulkheadStatistics(const QString& name) const;
+    BulkheadManager* bulkheadManager() const;
+    
 private:
     // 重试辅助函数
     bool isRetryableError(const QString& serviceName, const QString& error, const RetryPolicyConfig& config) const;
     int calculateRetryDelay(const RetryPolicyConfig& config, int attemptCount) const;
     
+    // 对冲调用：超过对冲延迟后向另一实例发起重复请求，取最先成功的结果
+    bool invokeHedged(const QString& serviceName, const QString& method, const QVariantList& args,
+                      QObject* primary, const QString& primaryInstanceId, int timeout, QVariant& returnValue);
+    
+    friend class AsyncServiceCall;
+    
     // 降级辅助函数（非const，因为需要调用非const的callService）
     QVariant tryDegrade(const QString& serviceName, const QString& method, 
                        const QVariantList& args, DegradationTrigger trigger);
     
+    // 服务恢复后在后台重新调用降级期间返回过旧值的请求，刷新缓存
+    void revalidateStaleResults(const QString& serviceName);
+    
 public:
 signals:
     void serviceRegistered(const QString& serviceName, const QString& version);
     void serviceUnregistered(const QString& serviceName, const QString& version);
     void serviceCallFailed(const QString& serviceName, const QString& error);
+    void serviceCallSucceeded(const QString& serviceName, qint64 elapsedMs);
+    void staleResultServed(const QString& serviceName, const QString& method, qint64 ageMs);
     
 private:
     Q_DISABLE_COPY(ServiceRegistry)
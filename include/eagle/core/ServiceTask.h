@@ -0,0 +1,161 @@
+#ifndef EAGLE_CORE_SERVICETASK_H
+#define EAGLE_CORE_SERVICETASK_H
+
+#include "ServiceCallFuture.h"
+
+/**
+ * 协程支持仅在以C++20（或更高）编译且标准库提供<coroutine>时启用，
+ * 框架本身仍按C++17编译，插件可按需使用更高的语言标准
+ */
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define EAGLE_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef EAGLE_HAS_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace Eagle {
+namespace Core {
+
+/**
+ * @brief 等待ServiceCallFuture的Awaiter
+ *
+ * 挂起协程而不阻塞线程，结果就绪后通过指定执行器恢复协程
+ */
+class ServiceCallAwaiter {
+public:
+    ServiceCallAwaiter(ServiceCallFuture future, ServiceExecutor executor)
+        : m_future(std::move(future))
+        , m_executor(std::move(executor))
+    {}
+
+    bool await_ready() const noexcept
+    {
+        return m_future.isFinished();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // 注意：已完成时续体会在subscribe内部立即恢复协程，之后不能再访问成员
+        m_future.subscribe([handle](const ServiceCallResult&) {
+            handle.resume();
+        }, m_executor);
+    }
+
+    ServiceCallResult await_resume() const
+    {
+        return m_future.result();
+    }
+
+private:
+    ServiceCallFuture m_future;
+    ServiceExecutor m_executor;
+};
+
+/**
+ * @brief co_await future：在完成结果的线程上恢复协程
+ */
+inline ServiceCallAwaiter operator co_await(ServiceCallFuture future)
+{
+    return ServiceCallAwaiter(std::move(future), ServiceExecutor());
+}
+
+/**
+ * @brief co_await resumeOn(future, executor)：在指定执行器上恢复协程
+ *
+ * 例如ServiceExecutors::eventLoop(this)回到对象所在线程，
+ * ServiceExecutors::threadPool()回到线程池
+ */
+inline ServiceCallAwaiter resumeOn(ServiceCallFuture future, const ServiceExecutor& executor)
+{
+    return ServiceCallAwaiter(std::move(future), executor);
+}
+
+/**
+ * @brief 异步服务调用协程的返回类型
+ *
+ * 协程立即开始执行，co_return QVariant表示成功，co_return ServiceCallResult可返回错误，
+ * 未捕获的异常转换为失败结果。任务本身可被co_await，也可转换为ServiceCallFuture
+ * 与whenAll/whenAny组合。
+ *
+ * 用法：
+ * @code
+ * ServiceTask loadProfile(ServiceRegistry* registry, QString userId) {
+ *     ServiceCallResult user = co_await registry->callAsync("UserService", "getUser", {userId});
+ *     if (!user.success) {
+ *         co_return user;
+ *     }
+ *     ServiceCallResult all = co_await whenAll({
+ *         registry->callAsync("OrderService", "listOrders", {userId}),
+ *         registry->callAsync("PointService", "getPoints", {userId})});
+ *     co_return all.result;
+ * }
+ * @endcode
+ */
+class ServiceTask {
+public:
+    struct promise_type {
+        ServicePromise promise;
+
+        ServiceTask get_return_object()
+        {
+            return ServiceTask(promise.future());
+        }
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        void return_value(const ServiceCallResult& result)
+        {
+            promise.setResult(result);
+        }
+
+        void unhandled_exception()
+        {
+            try {
+                std::rethrow_exception(std::current_exception());
+            } catch (const std::exception& e) {
+                promise.setResult(ServiceCallResult(QString("Exception in coroutine: %1").arg(e.what())));
+            } catch (...) {
+                promise.setResult(ServiceCallResult(QString("Unknown exception in coroutine")));
+            }
+        }
+    };
+
+    /**
+     * @brief 获取任务结果的Future
+     */
+    ServiceCallFuture future() const
+    {
+        return m_future;
+    }
+
+    operator ServiceCallFuture() const
+    {
+        return m_future;
+    }
+
+    friend ServiceCallAwaiter operator co_await(const ServiceTask& task)
+    {
+        return ServiceCallAwaiter(task.m_future, ServiceExecutor());
+    }
+
+private:
+    explicit ServiceTask(ServiceCallFuture future)
+        : m_future(std::move(future))
+    {}
+
+    ServiceCallFuture m_future;
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // EAGLE_HAS_COROUTINES
+
+#endif // EAGLE_CORE_SERVICETASK_H
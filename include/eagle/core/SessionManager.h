@@ -50,6 +50,13 @@ struct Session {
 
 /**
  * @brief 会话管理器
+ *
+ * 会话表按sessionId分片，验证只持有分片读锁，最后访问时间以1秒粒度近似更新。
+ * 过期由每个分片的分层时间轮跟踪，定时清理只处理到期的会话。
+ * 启用持久化后会话变更追加写入SessionStore，重启时批量加载恢复。存储中只有会话ID的摘要，
+ * 恢复的会话在第一次出示会话ID时放回会话表；此前计入活跃会话数和每用户会话上限（超出时最先淘汰），
+ * 但getSessionsByUser无法列出其会话ID。验证时的最后访问时间只在内存中更新，不写入存储，
+ * 恢复的会话的lastAccessTime是最后一次写入（创建或修改属性）时的值。
  */
 class SessionManager : public QObject {
     Q_OBJECT
@@ -84,10 +91,16 @@ public:
     void cleanupExpiredSessions();
     void cleanupInactiveSessions(int inactiveMinutes);
     
+    // 持久化
+    bool enablePersistence(const QString& filePath);
+    void disablePersistence();
+    bool isPersistenceEnabled() const;
+    bool compactSessionStore();
+    
 signals:
     void sessionCreated(const QString& sessionId, const QString& userId);
-    void sessionDestroyed(const QString& sessionId);
-    void sessionExpired(const QString& sessionId);
+    void sessionDestroyed(const QString& sessionId);  // 任何原因移除会话时发出（包括过期）
+    void sessionExpired(const QString& sessionId);    // 会话因过期被移除时额外发出
     
 private slots:
     void onCleanupTimer();
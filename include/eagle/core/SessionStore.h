@@ -0,0 +1,96 @@
+#ifndef EAGLE_CORE_SESSIONSTORE_H
+#define EAGLE_CORE_SESSIONSTORE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtCore/QVariantMap>
+#include "SessionManager.h"
+
+namespace Eagle {
+namespace Core {
+
+class SessionStorePrivate;
+
+/**
+ * @brief 日志中的会话，key为会话ID的带密钥摘要（日志中不保存会话ID本身）
+ */
+struct StoredSession {
+    QByteArray key;
+    Session session;    // 从日志加载时sessionId为空
+};
+
+/**
+ * @brief 会话持久化存储（追加写日志）
+ *
+ * 每次创建、修改、删除会话追加一条紧凑的二进制记录（类型、长度、校验和、负载），
+ * 写入先进入内存缓冲，由flush批量落盘。启动时把文件映射到内存一次性重放，
+ * 末尾不完整的记录（写入中途崩溃）被截断。日志中失效记录过多时通过compact
+ * 用当前会话快照重写文件。
+ *
+ * 会话ID是持有者凭证：记录以会话ID的HMAC-SHA256为键（密钥随机生成并保存在文件头），
+ * 文件权限限制为仅所有者可读写。
+ */
+class SessionStore : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SessionStore(const QString& filePath, QObject* parent = nullptr);
+    ~SessionStore();
+
+    bool open();
+    void close();
+    bool isOpen() const;
+    QString filePath() const;
+
+    /**
+     * @brief 会话ID在日志中的键（open之后可用）
+     */
+    QByteArray sessionKey(const QString& sessionId) const;
+
+    /**
+     * @brief 重放日志，返回仍然有效（未删除、未过期）的会话
+     */
+    QVector<StoredSession> loadAll(qint64 nowMs);
+
+    // 追加记录（线程安全，写入缓冲区）
+    void recordPut(const Session& session);
+    void recordRemove(const QString& sessionId);
+    void recordRemoveKey(const QByteArray& key);  // 只知道会话键时（尚未出示会话ID的恢复会话）
+
+    /**
+     * @brief 把缓冲区写入文件，文件未打开时丢弃缓冲并返回false
+     */
+    bool flush();
+
+    /**
+     * @brief 日志记录数超过有效会话数的两倍（且达到最小规模）时需要压缩
+     */
+    bool needsCompaction(int liveSessions) const;
+
+    /**
+     * @brief 开始压缩：之后追加的记录同时保存，压缩时写在快照之后
+     *
+     * 调用方在beginCompaction之后获取会话快照，再调用compact，
+     * 快照期间并发产生的变更不会丢失（重放时后写的记录覆盖快照）。
+     */
+    void beginCompaction();
+    bool compact(const QVector<StoredSession>& liveSessions);
+
+    /**
+     * @brief 获取统计信息（文件大小、记录数、最近一次加载耗时等）
+     */
+    QVariantMap getStatistics() const;
+
+private:
+    Q_DISABLE_COPY(SessionStore)
+    SessionStorePrivate* d_ptr;
+
+    inline SessionStorePrivate* d_func() { return d_ptr; }
+    inline const SessionStorePrivate* d_func() const { return d_ptr; }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // EAGLE_CORE_SESSIONSTORE_H
@@ -0,0 +1,80 @@
+#ifndef EAGLE_CORE_STALERESULTCACHE_H
+#define EAGLE_CORE_STALERESULTCACHE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QVariantList>
+#include <QtCore/QVariantMap>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+
+namespace Eagle {
+namespace Core {
+
+class StaleResultCachePrivate;
+
+/**
+ * @brief 陈旧结果信息（返回给调用方，说明结果是否来自最近一次成功调用的缓存）
+ */
+struct StaleResultInfo {
+    bool stale = false;          // 结果是否为缓存的旧值
+    qint64 ageMs = 0;            // 缓存值的年龄（毫秒）
+    qint64 storedAtMs = 0;       // 缓存值的写入时间（自纪元起的毫秒数）
+};
+
+/**
+ * @brief 最近一次成功结果缓存（stale-while-revalidate）
+ *
+ * 按服务分别保存有界的LRU缓存，键为方法名和序列化后的完整参数。服务熔断或超时时返回
+ * 缓存的旧值，幂等方法的键同时标记为待重新验证；服务恢复后由调用方取出待验证的键在后台重新调用。
+ */
+class StaleResultCache : public QObject {
+    Q_OBJECT
+
+public:
+    explicit StaleResultCache(QObject* parent = nullptr);
+    ~StaleResultCache();
+
+    /**
+     * @brief 保存一次成功调用的结果
+     * @param capacity 该服务最多缓存的结果条数，超出时淘汰最久未使用的条目
+     */
+    void store(const QString& serviceName, const QString& method, const QVariantList& args,
+               const QVariant& value, int capacity);
+
+    /**
+     * @brief 查找缓存的旧值
+     * @param maxStaleMs 旧值最长可用时间（毫秒），<=0表示不限制
+     * @param revalidate 命中时是否把该键标记为待重新验证（只应对幂等方法为true）
+     * @param info 输出陈旧信息
+     * @return 未命中或已超过maxStaleMs时返回无效QVariant
+     */
+    QVariant lookup(const QString& serviceName, const QString& method, const QVariantList& args,
+                    int maxStaleMs, bool revalidate, StaleResultInfo* info = nullptr);
+
+    /**
+     * @brief 取出最多maxCount个待重新验证的调用（方法名、参数）
+     */
+    QList<QPair<QString, QVariantList>> takePendingRevalidation(const QString& serviceName, int maxCount);
+    bool hasPendingRevalidation(const QString& serviceName) const;
+
+    void clear(const QString& serviceName);
+
+    /**
+     * @brief 获取服务的缓存统计（size、capacity、hits、misses、pendingRevalidation等）
+     */
+    QVariantMap getStatistics(const QString& serviceName) const;
+
+private:
+    Q_DISABLE_COPY(StaleResultCache)
+    StaleResultCachePrivate* d_ptr;
+
+    inline StaleResultCachePrivate* d_func() { return d_ptr; }
+    inline const StaleResultCachePrivate* d_func() const { return d_ptr; }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // EAGLE_CORE_STALERESULTCACHE_H
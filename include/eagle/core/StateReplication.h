@@ -0,0 +1,143 @@
+#ifndef EAGLE_CORE_STATEREPLICATION_H
+#define EAGLE_CORE_STATEREPLICATION_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtCore/QVariantMap>
+#include <QtCore/QList>
+
+class QLocalSocket;
+
+namespace Eagle {
+namespace Core {
+
+class ReplicatedStatePrivate;
+class StateReplicaServerPrivate;
+
+/**
+ * @brief 状态变更（变更日志中的一条记录）
+ */
+struct StateChange {
+    quint64 version = 0;       // 变更后的状态版本（连续递增）
+    QString key;
+    QVariant value;
+    bool removed = false;      // true表示删除key
+    qint64 timestampMs = 0;    // 主节点上产生变更的时间（自纪元起的毫秒数）
+};
+
+/**
+ * @brief 带版本和变更日志的键值状态
+ *
+ * 每次修改产生一个连续的版本号并追加到有界的变更日志。主节点按备节点已确认的版本
+ * 取出增量发送；备节点落后超过日志范围时先发送快照，再发送快照之后的日志。
+ */
+class ReplicatedState : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @param maxLogSize 变更日志保留的最大条数
+     */
+    explicit ReplicatedState(int maxLogSize = 10000, QObject* parent = nullptr);
+    ~ReplicatedState();
+
+    // 修改状态，返回新版本号
+    quint64 set(const QString& key, const QVariant& value);
+    quint64 remove(const QString& key);
+
+    QVariant value(const QString& key, const QVariant& defaultValue = QVariant()) const;
+    bool contains(const QString& key) const;
+    QStringList keys() const;
+    quint64 version() const;
+
+    /**
+     * @brief 状态历史标识：创建时随机生成，备节点应用快照后与主节点一致
+     *
+     * 标识不同说明双方的版本号不属于同一段历史（如主节点重启），必须先同步快照。
+     */
+    quint64 epoch() const;
+
+    /**
+     * @brief 获取完整快照及其版本
+     */
+    QVariantMap snapshot(quint64* version = nullptr) const;
+
+    /**
+     * @brief 取出version之后的最多maxCount条变更
+     * @return 日志已截断、无法从version接续时返回false（需要先发送快照）
+     */
+    bool changesSince(quint64 version, int maxCount, QList<StateChange>* changes) const;
+
+    /**
+     * @brief 获取某个版本变更的产生时间，不在日志中时返回0
+     */
+    qint64 changeTimestamp(quint64 version) const;
+
+    /**
+     * @brief 应用主节点发来的增量（备节点使用），重复的变更被忽略
+     * @return 增量与当前版本不连续时返回false，调用方应请求重新同步
+     */
+    bool applyChanges(const QList<StateChange>& changes);
+
+    /**
+     * @brief 以快照替换全部状态（备节点使用），清空变更日志
+     */
+    void applySnapshot(const QVariantMap& snapshot, quint64 version, quint64 epoch);
+
+signals:
+    void changed(quint64 version);
+
+private:
+    Q_DISABLE_COPY(ReplicatedState)
+    ReplicatedStatePrivate* d_ptr;
+
+    inline ReplicatedStatePrivate* d_func() { return d_ptr; }
+    inline const ReplicatedStatePrivate* d_func() const { return d_ptr; }
+};
+
+/**
+ * @brief 备节点上的状态复制接收端
+ *
+ * 在本地套接字上监听主节点的增量和快照，应用到ReplicatedState后回复已确认的版本。
+ * 连接建立时先回复一次当前的历史标识和版本，主节点据此决定从日志续传还是发送快照。
+ */
+class StateReplicaServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit StateReplicaServer(ReplicatedState* state, QObject* parent = nullptr);
+    ~StateReplicaServer();
+
+    bool listen(const QString& serverName);
+    void close();
+    bool isListening() const;
+    QString serverName() const;
+
+    /**
+     * @brief 获取统计信息（已应用的增量数、快照数、重新同步请求数、当前版本）
+     */
+    QVariantMap getStatistics() const;
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    Q_DISABLE_COPY(StateReplicaServer)
+
+    void sendAck(QLocalSocket* socket, bool resync);
+
+    StateReplicaServerPrivate* d_ptr;
+
+    inline StateReplicaServerPrivate* d_func() { return d_ptr; }
+    inline const StateReplicaServerPrivate* d_func() const { return d_ptr; }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+Q_DECLARE_METATYPE(Eagle::Core::StateChange)
+
+#endif // EAGLE_CORE_STATEREPLICATION_H
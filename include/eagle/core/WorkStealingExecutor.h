@@ -0,0 +1,127 @@
+#ifndef EAGLE_CORE_WORKSTEALINGEXECUTOR_H
+#define EAGLE_CORE_WORKSTEALINGEXECUTOR_H
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+#include "ServiceCallFuture.h"
+#include <functional>
+
+namespace Eagle {
+namespace Core {
+
+class WorkStealingExecutorPrivate;
+
+/**
+ * @brief 任务优先级（优先级通道）
+ */
+enum class TaskPriority {
+    High = 0,      // 高优先级（短小、延迟敏感的调用）
+    Normal = 1,    // 普通优先级
+    Low = 2        // 低优先级（批处理、耗时调用）
+};
+
+/**
+ * @brief 工作窃取执行器
+ *
+ * 每个工作线程拥有按优先级划分的本地双端队列：所有者从尾部取任务（LIFO，保持局部性），
+ * 空闲线程从兄弟线程的头部窃取（FIFO）。取任务时总是先耗尽更高优先级的通道。
+ *
+ * 支持按服务配置优先级通道和并发上限（舱壁）：超过上限的任务在该服务自己的
+ * 等待队列中排队，不占用工作线程，也不会阻塞其他服务的任务。
+ */
+class WorkStealingExecutor : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @param workerCount 工作线程数，<=0表示使用QThread::idealThreadCount()
+     */
+    explicit WorkStealingExecutor(int workerCount = 0, QObject* parent = nullptr);
+    ~WorkStealingExecutor();
+
+    /**
+     * @brief 提交通用任务
+     * @return 执行器已停止时任务被丢弃并返回false
+     */
+    bool submit(std::function<void()> task, TaskPriority priority = TaskPriority::Normal);
+
+    /**
+     * @brief 提交属于某个服务的任务（使用该服务的优先级通道和并发上限）
+     * @return 执行器已停止时任务被丢弃并返回false
+     */
+    bool submit(const QString& serviceName, std::function<void()> task);
+
+    /**
+     * @brief 提交属于某个服务的任务，服务等待队列已满或执行器已停止时拒绝
+     * @return 任务被接受（执行或排队）时返回true，可用isStopping()区分拒绝原因
+     */
+    bool trySubmit(const QString& serviceName, std::function<void()> task);
+
+    /**
+     * @brief 执行器是否已开始停止（此后外部线程提交的任务都会被拒绝）
+     */
+    bool isStopping() const;
+
+    /**
+     * @brief 以ServiceExecutor形式使用本执行器（用于Future续体）
+     *
+     * 执行器停止后续体在调用线程内联执行，保证不会丢失
+     */
+    ServiceExecutor asServiceExecutor(TaskPriority priority = TaskPriority::Normal);
+
+    // 服务通道配置
+    void setServicePriority(const QString& serviceName, TaskPriority priority);
+    TaskPriority servicePriority(const QString& serviceName) const;
+
+    /**
+     * @brief 设置服务并发上限
+     * @param maxConcurrent 最大并发执行数，<=0表示不限制
+     */
+    void setServiceConcurrencyLimit(const QString& serviceName, int maxConcurrent);
+    int serviceConcurrencyLimit(const QString& serviceName) const;
+
+    /**
+     * @brief 设置服务等待队列容量（仅对trySubmit生效）
+     * @param maxQueued 最大排队任务数，<=0表示不限制
+     */
+    void setServiceQueueCapacity(const QString& serviceName, int maxQueued);
+    int serviceQueueCapacity(const QString& serviceName) const;
+
+    /**
+     * @brief 获取服务当前执行中的任务数
+     */
+    int serviceRunningCount(const QString& serviceName) const;
+
+    /**
+     * @brief 获取服务因并发上限而排队的任务数
+     */
+    int serviceQueuedCount(const QString& serviceName) const;
+
+    int workerCount() const;
+    int pendingCount() const;
+
+    /**
+     * @brief 获取统计信息（执行数、窃取数、各服务通道状态）
+     */
+    QVariantMap getStatistics() const;
+
+    /**
+     * @brief 停止执行器：执行完已提交的任务后退出所有工作线程
+     */
+    void shutdown();
+
+private:
+    Q_DISABLE_COPY(WorkStealingExecutor)
+    WorkStealingExecutorPrivate* d_ptr;
+
+    inline WorkStealingExecutorPrivate* d_func() { return d_ptr; }
+    inline const WorkStealingExecutorPrivate* d_func() const { return d_ptr; }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+Q_DECLARE_METATYPE(Eagle::Core::TaskPriority)
+
+#endif // EAGLE_CORE_WORKSTEALINGEXECUTOR_H
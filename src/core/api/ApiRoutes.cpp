@@ -7,6 +7,7 @@
 #include "eagle/core/AuditLog.h"
 #include "eagle/core/ApiKeyManager.h"
 #include "eagle/core/SessionManager.h"
+#include "eagle/core/PrincipalResolver.h"
 #include "eagle/core/RBAC.h"
 #include "eagle/core/RateLimiter.h"
 #include "eagle/core/Logger.h"
@@ -22,7 +23,10 @@
 #include "eagle/core/ConfigFormat.h"
 #include "eagle/core/PluginSignature.h"
 #include "eagle/core/LoadBalancer.h"
+#include "eagle/core/ConcurrencyLimiter.h"
+#include "eagle/core/HedgingPolicy.h"
 #include "eagle/core/AsyncServiceCall.h"
+#include "eagle/core/AsyncResultStore.h"
 #include "eagle/core/SslConfig.h"
 #include "eagle/core/SystemHealth.h"
 #include "eagle/core/PermissionChangeNotification.h"
@@ -30,17 +34,20 @@
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QDateTime>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+#include <memory>
 
 namespace Eagle {
 namespace Core {
 
 /**
  * @brief 创建认证中间件
+ *
+ * 把token解析为主体并附加到请求上，路由处理器通过getUserIdFromRequest直接读取。
  */
-Middleware createAuthMiddleware(Framework* framework) {
-    return [framework](const HttpRequest& request, HttpResponse& response) -> bool {
-        Q_UNUSED(request);
-        Q_UNUSED(response);
+Middleware createAuthMiddleware(Framework* framework, PrincipalResolver* resolver) {
+    return [framework, resolver](const HttpRequest& request, HttpResponse& response) -> bool {
         if (!framework) {
             response.setError(500, "Framework not available");
             return false;
@@ -58,17 +65,9 @@ Middleware createAuthMiddleware(Framework* framework) {
             return false;
         }
         
-        // 尝试API密钥验证
-        ApiKeyManager* apiKeyManager = framework->apiKeyManager();
-        if (apiKeyManager && apiKeyManager->validateKey(token)) {
-            // API密钥验证成功
-            return true;
-        }
-        
-        // 尝试会话验证
-        SessionManager* sessionManager = framework->sessionManager();
-        if (sessionManager && sessionManager->validateSession(token)) {
-            // 会话验证成功
+        // 依次尝试API密钥和会话验证（短时缓存）
+        request.principal = resolver->resolve(token);
+        if (request.principal) {
             return true;
         }
         
@@ -99,6 +98,12 @@ Middleware createPermissionMiddleware(Framework* framework) {
  * @brief 创建限流中间件
  */
 Middleware createRateLimitMiddleware(Framework* framework) {
+    // 默认IP限流规则：每个IP每分钟100次请求
+    RateLimiter* limiter = framework ? framework->rateLimiter() : nullptr;
+    if (limiter && !limiter->hasLimit("ip:*")) {
+        limiter->setLimit("ip:*", 100, 60000, RateLimitAlgorithm::SlidingWindow);
+    }
+    
     return [framework](const HttpRequest& request, HttpResponse& response) -> bool {
         Q_UNUSED(response);
         if (!framework) {
@@ -110,10 +115,16 @@ Middleware createRateLimitMiddleware(Framework* framework) {
             return true;
         }
         
-        QString key = request.remoteAddress;
+        // 分层检查：全局 → IP → API密钥 → 路由，未配置规则的层级自动跳过
+        QStringList keys;
+        keys << "global" << ("ip:" + request.remoteAddress);
+        QString token = request.getAuthToken();
+        if (!token.isEmpty()) {
+            keys << ("apikey:" + QString::number(qHash(token), 16));
+        }
+        keys << ("route:" + request.path);
         
-        // 检查限流（默认：每分钟100次请求）
-        if (!rateLimiter->allowRequest(key, 100, 60000)) {
+        if (!rateLimiter->allowHierarchical(keys)) {
             response.setError(429, "Too Many Requests", "Rate limit exceeded");
             return false;
         }
@@ -123,29 +134,44 @@ Middleware createRateLimitMiddleware(Framework* framework) {
 }
 
 /**
- * @brief 获取用户ID（从认证token）
+ * @brief 获取用户ID（认证中间件解析出的主体）
  */
-QString getUserIdFromRequest(Framework* framework, const HttpRequest& request) {
-    QString token = request.getAuthToken();
-    if (token.isEmpty()) {
-        return "anonymous";
-    }
-    
-    // 尝试API密钥
-    ApiKeyManager* apiKeyManager = framework->apiKeyManager();
-    if (apiKeyManager && apiKeyManager->validateKey(token)) {
-        ApiKey key = apiKeyManager->getKeyByValue(token);
-        return key.userId;
+QString getUserIdFromRequest(const HttpRequest& request) {
+    if (request.principal) {
+        return request.principal->userId;
     }
-    
-    // 尝试会话
-    SessionManager* sessionManager = framework->sessionManager();
-    if (sessionManager && sessionManager->validateSession(token)) {
-        Session session = sessionManager->getSession(token);
-        return session.userId;
+    return "anonymous";
+}
+
+/**
+ * @brief 长轮询最长等待时间（毫秒）
+ */
+const int kMaxLongPollWaitMs = 30000;
+
+/**
+ * @brief 异步调用结果转换为JSON
+ */
+QJsonObject asyncResultToJson(const QString& futureId, const ServiceCallFuture& future) {
+    QJsonObject result;
+    result["futureId"] = futureId;
+    result["finished"] = future.isFinished();
+    
+    if (future.isFinished()) {
+        ServiceCallResult callResult = future.result();
+        result["success"] = callResult.success;
+        if (callResult.success) {
+            result["result"] = QJsonValue::fromVariant(callResult.result);
+            if (callResult.stale) {
+                result["stale"] = true;
+                result["staleAgeMs"] = callResult.staleAgeMs;
+            }
+        } else {
+            result["error"] = callResult.error;
+        }
+        result["elapsedMs"] = callResult.elapsedMs;
     }
     
-    return "anonymous";
+    return result;
 }
 
 /**
@@ -159,7 +185,9 @@ void registerApiRoutes(ApiServer* server) {
     }
     
     // 注册中间件
-    server->use(createAuthMiddleware(framework));
+    PrincipalResolver* principalResolver = new PrincipalResolver(
+        framework->apiKeyManager(), framework->sessionManager(), server);
+    server->use(createAuthMiddleware(framework, principalResolver));
     server->use(createPermissionMiddleware(framework));
     server->use(createRateLimitMiddleware(framework));
     
@@ -170,7 +198,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/plugins - 获取插件列表
     server->get("/api/v1/plugins", [framework](const HttpRequest& req, HttpResponse& resp) {
         // 权限检查
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         RBACManager* rbac = framework->rbacManager();
         if (rbac && !rbac->checkPermission(userId, "plugin.read")) {
             resp.setError(403, "Forbidden", "缺少权限: plugin.read");
@@ -276,7 +304,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/plugins/{id}/load - 加载插件
     server->post("/api/v1/plugins/{id}/load", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -322,7 +350,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // DELETE /api/v1/plugins/{id} - 卸载插件
     server->delete_("/api/v1/plugins/{id}", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -376,7 +404,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // GET /api/v1/audit/integrity - 验证日志完整性
     server->get("/api/v1/audit/integrity", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -415,7 +443,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // GET /api/v1/audit/integrity/report - 获取完整性报告
     server->get("/api/v1/audit/integrity/report", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -444,7 +472,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/audit/integrity/config - 配置防篡改
     server->post("/api/v1/audit/integrity/config", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -522,7 +550,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // GET /api/v1/logs - 日志查询
     server->get("/api/v1/logs", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -570,7 +598,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/config - 配置更新
     server->post("/api/v1/config", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -615,7 +643,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/config/load - 从文件加载配置（支持多种格式）
     server->post("/api/v1/config/load", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -666,7 +694,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/config/save - 保存配置到文件（支持多种格式）
     server->post("/api/v1/config/save", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -717,7 +745,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/config/convert - 格式转换
     server->post("/api/v1/config/convert", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -765,7 +793,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // GET /api/v1/backups - 获取备份列表
     server->get("/api/v1/backups", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -803,7 +831,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/backups - 创建备份
     server->post("/api/v1/backups", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -849,7 +877,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // GET /api/v1/backups/{id} - 获取备份详情
     server->get("/api/v1/backups/{id}", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -891,7 +919,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/backups/{id}/restore - 恢复备份
     server->post("/api/v1/backups/{id}/restore", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -932,7 +960,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // DELETE /api/v1/backups/{id} - 删除备份
     server->delete_("/api/v1/backups/{id}", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -976,7 +1004,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/plugins/{id}/reload - 热重载插件
     server->post("/api/v1/plugins/{id}/reload", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1023,7 +1051,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/plugins/reloadable - 获取可重载插件列表
     server->get("/api/v1/plugins/reloadable", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1057,7 +1085,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/failover/services - 获取已注册的服务列表
     server->get("/api/v1/failover/services", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1092,7 +1120,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/failover/services/{name}/failover - 执行故障转移
     server->post("/api/v1/failover/services/{name}/failover", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1140,7 +1168,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/failover/services/{name}/nodes - 获取服务节点列表
     server->get("/api/v1/failover/services/{name}/nodes", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1184,7 +1212,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/failover/services/{name}/history - 获取故障转移历史
     server->get("/api/v1/failover/services/{name}/history", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1232,7 +1260,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/diagnostics/stacktrace - 捕获堆栈跟踪
     server->post("/api/v1/diagnostics/stacktrace", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1283,7 +1311,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/diagnostics/stacktraces - 获取堆栈跟踪列表
     server->get("/api/v1/diagnostics/stacktraces", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1321,7 +1349,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/diagnostics/stacktraces/{id} - 获取堆栈跟踪详情
     server->get("/api/v1/diagnostics/stacktraces/{id}", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1372,7 +1400,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/diagnostics/memory/snapshot - 捕获内存快照
     server->post("/api/v1/diagnostics/memory/snapshot", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1415,7 +1443,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/diagnostics/memory/snapshots - 获取内存快照列表
     server->get("/api/v1/diagnostics/memory/snapshots", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1451,7 +1479,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/diagnostics/memory/compare - 比较内存快照
     server->post("/api/v1/diagnostics/memory/compare", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1487,7 +1515,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/diagnostics/deadlocks - 获取死锁列表
     server->get("/api/v1/diagnostics/deadlocks", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1527,7 +1555,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/plugins/{id}/resources - 获取插件资源使用情况
     server->get("/api/v1/plugins/{id}/resources", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1576,7 +1604,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/plugins/{id}/resources/limits - 设置插件资源限制
     server->post("/api/v1/plugins/{id}/resources/limits", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1700,7 +1728,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/plugins/{id}/resources/events - 获取资源超限事件
     server->get("/api/v1/plugins/{id}/resources/events", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1744,7 +1772,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/config/encryption/key - 获取加密密钥信息
     server->get("/api/v1/config/encryption/key", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1767,7 +1795,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/config/encryption/rotate - 轮换加密密钥
     server->post("/api/v1/config/encryption/rotate", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1830,7 +1858,7 @@ void registerApiRoutes(ApiServer* server) {
     // POST /api/v1/config/encryption/generate - 生成新密钥
     server->post("/api/v1/config/encryption/generate", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1856,7 +1884,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/config/validate - 验证配置
     server->post("/api/v1/config/validate", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1922,7 +1950,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/config/schema - 加载Schema
     server->post("/api/v1/config/schema", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1956,7 +1984,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/config/schema - 获取当前Schema信息
     server->get("/api/v1/config/schema", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -1996,7 +2024,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/plugins/sign - 为插件生成签名
     server->post("/api/v1/plugins/sign", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2039,7 +2067,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/plugins/verify - 验证插件签名
     server->post("/api/v1/plugins/verify", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2113,7 +2141,7 @@ void registerApiRoutes(ApiServer* server) {
     // GET /api/v1/plugins/certificates/trusted - 获取受信任的根证书列表
     server->get("/api/v1/plugins/certificates/trusted", [framework](const HttpRequest& req, HttpResponse& resp) {
         Q_UNUSED(req);
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2143,7 +2171,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/plugins/certificates/trusted - 设置受信任的根证书
     server->post("/api/v1/plugins/certificates/trusted", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2170,7 +2198,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // GET /api/v1/services/{name}/loadbalance - 获取服务负载均衡配置
     server->get("/api/v1/services/{name}/loadbalance", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2203,13 +2231,21 @@ void registerApiRoutes(ApiServer* server) {
         QJsonArray instancesArray;
         for (const ServiceInstance& instance : instances) {
             QJsonObject instanceObj;
-            QString instanceId = loadBalancer->getInstanceIdByProvider(serviceName, instance.provider);
+            const QString& instanceId = instance.instanceId;
             instanceObj["instanceId"] = instanceId;
             instanceObj["version"] = instance.descriptor.version;
             instanceObj["weight"] = instance.weight;
             instanceObj["activeConnections"] = instance.activeConnections;
             instanceObj["totalRequests"] = instance.totalRequests;
             instanceObj["healthy"] = instance.healthy;
+            
+            // 延迟感知评分（P2C-EWMA使用）
+            QMap<QString, QVariant> stats = loadBalancer->getInstanceStats(serviceName, instanceId);
+            instanceObj["outstanding"] = stats.value("outstanding").toInt();
+            instanceObj["ewmaLatencyUs"] = stats.value("ewmaLatencyUs").toDouble();
+            instanceObj["score"] = stats.value("score").toDouble();
+            instanceObj["failures"] = stats.value("failures").toLongLong();
+            instanceObj["ejected"] = stats.value("ejected").toBool();
             instancesArray.append(instanceObj);
         }
         
@@ -2219,13 +2255,71 @@ void registerApiRoutes(ApiServer* server) {
         result["enabled"] = serviceRegistry->isLoadBalanceEnabled();
         result["instances"] = instancesArray;
         result["instanceCount"] = instances.size();
+        if (serviceRegistry->hedgingPolicy()) {
+            result["hedging"] = QJsonObject::fromVariantMap(
+                serviceRegistry->hedgingPolicy()->getStatistics(serviceName));
+        }
         
         resp.setSuccess(result);
     });
     
+    // GET /api/v1/services/{name}/concurrency - 获取服务自适应并发限制状态
+    server->get("/api/v1/services/{name}/concurrency", [framework](const HttpRequest& req, HttpResponse& resp) {
+        QString userId = getUserIdFromRequest(req);
+        
+        // 权限检查
+        RBACManager* rbac = framework->rbacManager();
+        if (rbac && !rbac->checkPermission(userId, "service.concurrency.view")) {
+            resp.setError(403, "Forbidden", "缺少权限: service.concurrency.view");
+            return;
+        }
+        
+        ServiceRegistry* serviceRegistry = framework->serviceRegistry();
+        if (!serviceRegistry || !serviceRegistry->concurrencyLimiter()) {
+            resp.setError(500, "ConcurrencyLimiter not available");
+            return;
+        }
+        
+        QString serviceName = req.pathParams.value("name");
+        if (serviceName.isEmpty()) {
+            resp.setError(400, "Bad Request", "Service name is required");
+            return;
+        }
+        
+        QVariantMap stats = serviceRegistry->concurrencyLimiter()->getStatistics(serviceName);
+        resp.setSuccess(QJsonObject::fromVariantMap(stats));
+    });
+    
+    // GET /api/v1/bulkheads/{name} - 获取舱壁状态（并发名额、队列深度、拒绝数）
+    server->get("/api/v1/bulkheads/{name}", [framework](const HttpRequest& req, HttpResponse& resp) {
+        QString userId = getUserIdFromRequest(req);
+        
+        // 权限检查
+        RBACManager* rbac = framework->rbacManager();
+        if (rbac && !rbac->checkPermission(userId, "service.bulkhead.view")) {
+            resp.setError(403, "Forbidden", "缺少权限: service.bulkhead.view");
+            return;
+        }
+        
+        ServiceRegistry* serviceRegistry = framework->serviceRegistry();
+        if (!serviceRegistry) {
+            resp.setError(500, "ServiceRegistry not available");
+            return;
+        }
+        
+        QString name = req.pathParams.value("name");
+        if (name.isEmpty()) {
+            resp.setError(400, "Bad Request", "Bulkhead name is required");
+            return;
+        }
+        
+        QVariantMap stats = serviceRegistry->getBulkheadStatistics(name);
+        resp.setSuccess(QJsonObject::fromVariantMap(stats));
+    });
+    
     // POST /api/v1/services/{name}/loadbalance - 配置服务负载均衡
     server->post("/api/v1/services/{name}/loadbalance", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2266,7 +2360,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/services/{name}/instances/{instanceId}/weight - 设置实例权重
     server->post("/api/v1/services/{name}/instances/{instanceId}/weight", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2310,7 +2404,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/services/{name}/instances/{instanceId}/health - 设置实例健康状态
     server->post("/api/v1/services/{name}/instances/{instanceId}/health", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2349,7 +2443,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // GET /api/v1/config/versions - 获取配置版本列表
     server->get("/api/v1/config/versions", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2395,7 +2489,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // GET /api/v1/config/versions/{version} - 获取指定版本
     server->get("/api/v1/config/versions/{version}", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2443,7 +2537,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/config/versions - 创建新版本
     server->post("/api/v1/config/versions", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2483,7 +2577,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/config/versions/{version}/rollback - 回滚到指定版本
     server->post("/api/v1/config/versions/{version}/rollback", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2525,7 +2619,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // GET /api/v1/config/versions/{version1}/compare/{version2} - 对比两个版本
     server->get("/api/v1/config/versions/{version1}/compare/{version2}", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2584,7 +2678,7 @@ void registerApiRoutes(ApiServer* server) {
     
     // POST /api/v1/services/{name}/async - 异步调用服务
     server->post("/api/v1/services/{name}/async", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
@@ -2627,67 +2721,156 @@ void registerApiRoutes(ApiServer* server) {
             return;
         }
         
-        // 启动异步调用
-        ServiceFuture* future = asyncCall->callAsync(serviceName, method, args, timeout);
+        // 启动异步调用并登记到结果存储
+        ServiceCallFuture future = asyncCall->call(serviceName, method, args, timeout);
+        QString futureId = asyncCall->resultStore()->add(future, serviceName, method, userId);
+        if (futureId.isEmpty()) {
+            resp.setError(503, "Service Unavailable", "异步结果存储已满，请稍后重试");
+            return;
+        }
         
         // 立即返回，不等待结果
         QJsonObject result;
         result["async"] = true;
         result["serviceName"] = serviceName;
         result["method"] = method;
-        result["message"] = "异步调用已启动，使用futureId查询结果";
-        
-        // 生成futureId（简化实现，使用Future指针地址的哈希）
-        QString futureId = QString::number(reinterpret_cast<quintptr>(future), 16);
         result["futureId"] = futureId;
-        
-        // 存储Future（简化实现，实际应该使用更持久化的存储）
-        // 这里暂时不存储，客户端需要轮询或使用WebSocket获取结果
+        result["pollUrl"] = QString("/api/v1/services/async/%1?wait=%2").arg(futureId).arg(kMaxLongPollWaitMs);
+        result["message"] = "异步调用已启动，使用futureId查询结果（支持wait参数长轮询）";
         
         resp.setSuccess(result);
     });
     
-    // GET /api/v1/services/async/{futureId} - 查询异步调用结果
-    server->get("/api/v1/services/async/{futureId}", [framework](const HttpRequest& req, HttpResponse& resp) {
-        QString userId = getUserIdFromRequest(framework, req);
+    // GET /api/v1/services/async/events - 以Server-Sent Events推送异步调用完成事件
+    // 可选参数 ids=id1,id2：只推送指定调用，全部推送完成后关闭流
+    server->getAsync("/api/v1/services/async/events", [framework](const HttpRequest& req, HttpResponder responder) {
+        HttpResponse resp;
+        QString userId = getUserIdFromRequest(req);
         
         // 权限检查
         RBACManager* rbac = framework->rbacManager();
         if (rbac && !rbac->checkPermission(userId, "service.call")) {
             resp.setError(403, "Forbidden", "缺少权限: service.call");
+            responder.send(resp);
             return;
         }
         
-        QString futureIdStr = req.pathParams.value("futureId");
-        bool ok;
-        quintptr futurePtr = futureIdStr.toULongLong(&ok, 16);
-        
-        if (!ok) {
-            resp.setError(400, "Bad Request", "Invalid future ID");
+        ServiceRegistry* serviceRegistry = framework->serviceRegistry();
+        AsyncServiceCall* asyncCall = serviceRegistry ? serviceRegistry->asyncServiceCall() : nullptr;
+        if (!asyncCall) {
+            resp.setError(500, "AsyncServiceCall not available");
+            responder.send(resp);
             return;
         }
         
-        ServiceFuture* future = reinterpret_cast<ServiceFuture*>(futurePtr);
-        if (!future) {
-            resp.setError(404, "Not Found", "Future not found");
+        AsyncResultStore* store = asyncCall->resultStore();
+        auto pending = std::make_shared<QSet<QString>>();
+        for (const QString& id : req.queryParams.value("ids").split(',', Qt::SkipEmptyParts)) {
+            pending->insert(id.trimmed());
+        }
+        bool filtered = !pending->isEmpty();
+        
+        if (!responder.beginStream()) {
             return;
         }
         
-        QJsonObject result;
-        result["futureId"] = futureIdStr;
-        result["finished"] = future->isFinished();
+        // 先推送已经完成的指定调用
+        for (const QString& id : pending->values()) {
+            ServiceCallFuture future = store->find(id);
+            if (!future.isValid() || store->owner(id) != userId) {
+                pending->remove(id);
+                continue;
+            }
+            if (future.isFinished()) {
+                responder.sendEvent("result", asyncResultToJson(id, future), id);
+                pending->remove(id);
+            }
+        }
+        if (filtered && pending->isEmpty()) {
+            responder.close();
+            return;
+        }
         
-        if (future->isFinished()) {
-            result["success"] = future->isSuccess();
-            if (future->isSuccess()) {
-                result["result"] = QJsonValue::fromVariant(future->result());
-            } else {
-                result["error"] = future->error();
+        // 连接断开时（context销毁）自动断开信号连接
+        QObject::connect(store, &AsyncResultStore::resultReady, responder.context(),
+                         [responder, store, userId, pending, filtered](const QString& id, const QString& owner) mutable {
+            if (owner != userId || (filtered && !pending->contains(id))) {
+                return;
+            }
+            
+            ServiceCallFuture future = store->find(id);
+            if (!future.isValid()) {
+                return;
+            }
+            
+            responder.sendEvent("result", asyncResultToJson(id, future), id);
+            if (filtered) {
+                pending->remove(id);
+                if (pending->isEmpty()) {
+                    responder.close();
+                }
             }
-            result["elapsedMs"] = future->elapsedMs();
+        });
+    });
+    
+    // GET /api/v1/services/async/{futureId} - 查询异步调用结果
+    // 可选参数 wait=毫秒：长轮询，结果就绪后立即返回，最长等待30秒
+    server->getAsync("/api/v1/services/async/{futureId}", [framework](const HttpRequest& req, HttpResponder responder) {
+        HttpResponse resp;
+        QString userId = getUserIdFromRequest(req);
+        
+        // 权限检查
+        RBACManager* rbac = framework->rbacManager();
+        if (rbac && !rbac->checkPermission(userId, "service.call")) {
+            resp.setError(403, "Forbidden", "缺少权限: service.call");
+            responder.send(resp);
+            return;
         }
         
-        resp.setSuccess(result);
+        ServiceRegistry* serviceRegistry = framework->serviceRegistry();
+        AsyncServiceCall* asyncCall = serviceRegistry ? serviceRegistry->asyncServiceCall() : nullptr;
+        if (!asyncCall) {
+            resp.setError(500, "AsyncServiceCall not available");
+            responder.send(resp);
+            return;
+        }
+        
+        QString futureId = req.pathParams.value("futureId");
+        AsyncResultStore* store = asyncCall->resultStore();
+        ServiceCallFuture future = store->find(futureId);
+        
+        // 其他用户的调用同样返回404，不暴露ID是否存在
+        if (!future.isValid() || store->owner(futureId) != userId) {
+            resp.setError(404, "Not Found", "Future not found or expired");
+            responder.send(resp);
+            return;
+        }
+        
+        int waitMs = qBound(0, req.queryParams.value("wait").toInt(), kMaxLongPollWaitMs);
+        QObject* context = responder.context();
+        if (future.isFinished() || waitMs == 0 || !context) {
+            resp.setSuccess(asyncResultToJson(futureId, future));
+            responder.send(resp);
+            return;
+        }
+        
+        // 长轮询：结果就绪或等待超时，先到者写回响应
+        // eventLoop只弱引用客户端连接，连接断开（deleteLater）时取消订阅，不再持有responder
+        quint64 subscription = future.subscribe([responder, futureId, future](const ServiceCallResult&) mutable {
+            HttpResponse readyResp;
+            readyResp.setSuccess(asyncResultToJson(futureId, future));
+            responder.send(readyResp);
+        }, ServiceExecutors::eventLoop(context));
+        QObject::connect(context, &QObject::destroyed, [future, subscription]() {
+            future.unsubscribe(subscription);
+        });
+        
+        QTimer::singleShot(waitMs, context, [responder, futureId, future, subscription]() mutable {
+            future.unsubscribe(subscription);
+            HttpResponse pendingResp;
+            pendingResp.setSuccess(asyncResultToJson(futureId, future));
+            responder.send(pendingResp);
+        });
     });
 }
 
@@ -10,6 +10,7 @@
 #include <QtNetwork/QHostAddress>
 #include <QtNetwork/QSslSocket>
 #include <QtNetwork/QSslError>
+#include <atomic>
 
 namespace Eagle {
 namespace Core {
@@ -178,7 +179,9 @@ QByteArray HttpResponse::toHttpResponse() const {
         case 401: statusText = "Unauthorized"; break;
         case 403: statusText = "Forbidden"; break;
         case 404: statusText = "Not Found"; break;
+        case 429: statusText = "Too Many Requests"; break;
         case 500: statusText = "Internal Server Error"; break;
+        case 503: statusText = "Service Unavailable"; break;
         default: statusText = "Unknown"; break;
     }
     response.append(QString("HTTP/1.1 %1 %2\r\n").arg(statusCode).arg(statusText).toUtf8());
@@ -200,6 +203,122 @@ QByteArray HttpResponse::toHttpResponse() const {
     return response;
 }
 
+// ============================================================================
+// HttpResponder 实现
+// ============================================================================
+
+struct HttpResponder::State {
+    QPointer<ApiServer> server;
+    QPointer<QAbstractSocket> socket;
+    QString method;
+    QString path;
+    std::atomic<bool> completed{false};
+    std::atomic<bool> streaming{false};
+};
+
+HttpResponder::HttpResponder()
+{
+}
+
+HttpResponder::HttpResponder(ApiServer* server, QAbstractSocket* socket, const HttpRequest& request)
+    : state(std::make_shared<State>())
+{
+    state->server = server;
+    state->socket = socket;
+    state->method = request.method;
+    state->path = request.path;
+}
+
+bool HttpResponder::isOpen() const {
+    return state && !state->completed.load() && !state->socket.isNull();
+}
+
+QObject* HttpResponder::context() const {
+    return state ? state->socket.data() : nullptr;
+}
+
+bool HttpResponder::send(const HttpResponse& response) {
+    if (!state || state->streaming.load() || state->completed.exchange(true)) {
+        return false;
+    }
+    
+    if (!write(response.toHttpResponse())) {
+        return false;
+    }
+    
+    std::shared_ptr<State> st = state;
+    int statusCode = response.statusCode;
+    if (ApiServer* server = st->server.data()) {
+        QMetaObject::invokeMethod(server, [st, statusCode]() {
+            if (st->server) {
+                emit st->server->requestCompleted(st->method, st->path, statusCode);
+            }
+        }, Qt::AutoConnection);
+    }
+    return true;
+}
+
+bool HttpResponder::beginStream() {
+    if (!state || state->completed.load() || state->streaming.exchange(true)) {
+        return false;
+    }
+    
+    QByteArray header;
+    header.append("HTTP/1.1 200 OK\r\n");
+    header.append("Content-Type: text/event-stream; charset=utf-8\r\n");
+    header.append("Cache-Control: no-cache\r\n");
+    header.append("Connection: keep-alive\r\n");
+    header.append("Server: EagleFramework/1.0\r\n");
+    header.append("\r\n");
+    return write(header);
+}
+
+bool HttpResponder::sendEvent(const QString& event, const QJsonObject& data, const QString& id) {
+    if (!state || !state->streaming.load() || state->completed.load()) {
+        return false;
+    }
+    
+    QByteArray message;
+    if (!id.isEmpty()) {
+        message.append("id: ").append(id.toUtf8()).append('\n');
+    }
+    if (!event.isEmpty()) {
+        message.append("event: ").append(event.toUtf8()).append('\n');
+    }
+    message.append("data: ").append(QJsonDocument(data).toJson(QJsonDocument::Compact)).append("\n\n");
+    return write(message);
+}
+
+void HttpResponder::close() {
+    if (!state || state->completed.exchange(true)) {
+        return;
+    }
+    write(QByteArray(), true);
+}
+
+bool HttpResponder::write(const QByteArray& data, bool closeAfter) {
+    QAbstractSocket* socket = state->socket.data();
+    if (!socket) {
+        return false;
+    }
+    
+    // 写操作投递到连接所在线程
+    QPointer<QAbstractSocket> guard(socket);
+    QMetaObject::invokeMethod(socket, [guard, data, closeAfter]() {
+        if (!guard) {
+            return;
+        }
+        if (!data.isEmpty()) {
+            guard->write(data);
+            guard->flush();
+        }
+        if (closeAfter) {
+            guard->disconnectFromHost();
+        }
+    }, Qt::AutoConnection);
+    return true;
+}
+
 // ============================================================================
 // ApiServer 实现
 // ============================================================================
@@ -387,6 +506,15 @@ void ApiServer::delete_(const QString& path, RequestHandler handler) {
     d->routes.append(route);
 }
 
+void ApiServer::getAsync(const QString& path, AsyncRequestHandler handler) {
+    QMutexLocker locker(&d->routesMutex);
+    Route route;
+    route.method = "GET";
+    route.pattern = path;
+    route.asyncHandler = handler;
+    d->routes.append(route);
+}
+
 void ApiServer::use(Middleware middleware) {
     QMutexLocker locker(&d->middlewaresMutex);
     d->middlewares.append(middleware);
@@ -578,6 +706,23 @@ void ApiServer::handleRequest(QAbstractSocket* socket, const HttpRequest& reques
             HttpRequest mutableRequest = request;
             mutableRequest.pathParams = pathParams;
             
+            // 延迟响应路由：由处理器持有的HttpResponder负责写回
+            if (route.asyncHandler) {
+                HttpResponder responder(this, socket, mutableRequest);
+                try {
+                    route.asyncHandler(mutableRequest, responder);
+                } catch (const std::exception& e) {
+                    Logger::error("ApiServer", QString("处理请求时发生异常: %1").arg(e.what()));
+                    response.setError(500, "Internal Server Error", e.what());
+                    responder.send(response);
+                } catch (...) {
+                    Logger::error("ApiServer", "处理请求时发生未知异常");
+                    response.setError(500, "Internal Server Error", "Unknown exception");
+                    responder.send(response);
+                }
+                return;
+            }
+            
             // 执行处理器
             try {
                 route.handler(mutableRequest, response);
@@ -20,6 +20,7 @@ struct Route {
     QString method;              // GET, POST, DELETE等
     QString pattern;             // 路由模式（如 /api/v1/plugins/{id}）
     RequestHandler handler;      // 处理器函数
+    AsyncRequestHandler asyncHandler;  // 延迟响应处理器（设置时优先使用）
 };
 
 // 定义ApiServerPrivate类（非嵌套类，在ApiServer.h中前向声明）
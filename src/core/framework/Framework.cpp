@@ -3,6 +3,8 @@
 #include "Framework_p.h"
 #include "eagle/core/Logger.h"
 #include "eagle/core/ApiRoutes.h"
+#include "eagle/core/RateLimiterBackend.h"
+#include "eagle/core/RateLimitCoordinator.h"
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
@@ -151,6 +153,24 @@ bool Framework::initialize(const QString& configPath)
     bool signatureRequired = securityConfig["plugin_signature_required"].toBool();
     d->pluginManager->setPluginSignatureRequired(signatureRequired);
     
+    // 多进程共享限流（local / shared_memory / broker）
+    QVariantMap rateLimitConfig = frameworkConfig["rate_limit"].toMap();
+    QString rateLimitBackend = rateLimitConfig.value("backend", "local").toString();
+    if (rateLimitBackend == "shared_memory") {
+        d->rateLimiter->setBackend(SharedMemoryRateLimiterBackendFactory::create(
+            rateLimitConfig.value("shared_memory_key", "eagle-ratelimit").toString()));
+    } else if (rateLimitBackend == "broker") {
+        QString brokerServer = rateLimitConfig.value("broker_server", "eagle-ratelimit").toString();
+        if (rateLimitConfig.value("broker_coordinator", false).toBool()) {
+            RateLimitCoordinator* coordinator = new RateLimitCoordinator(this);
+            coordinator->start(brokerServer);
+        }
+        d->rateLimiter->setBackend(LocalBrokerRateLimiterBackendFactory::create(
+            brokerServer,
+            rateLimitConfig.value("lease_batch", 10).toInt(),
+            rateLimitConfig.value("timeout_ms", 200).toInt()));
+    }
+    
     // 初始化API服务器
     if (d->apiServer) {
         d->apiServer->setFramework(this);
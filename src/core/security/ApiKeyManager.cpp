@@ -5,11 +5,137 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QUuid>
 #include <QtCore/QCryptographicHash>
+#include <QtCore/QMessageAuthenticationCode>
+#include <QtCore/QRandomGenerator>
 #include <QtCore/QByteArray>
+#include <QtCore/QtEndian>
 
 namespace Eagle {
 namespace Core {
 
+namespace {
+
+const QString kApiKeyValuePrefix = QStringLiteral("eagle_");
+
+/**
+ * @brief 常量时间比较，耗时与不同字节的位置无关
+ */
+bool constantTimeEquals(const QByteArray& a, const QByteArray& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    
+    char diff = 0;
+    for (int i = 0; i < a.size(); ++i) {
+        diff |= a.at(i) ^ b.at(i);
+    }
+    return diff == 0;
+}
+
+/**
+ * @brief 解析密钥值中的查找前缀（eagle_<16位十六进制>_...）
+ */
+bool parseLookupPrefix(const QString& keyValue, quint64* lookupId)
+{
+    int prefixEnd = kApiKeyValuePrefix.size() + kApiKeyLookupPrefixLength;
+    if (keyValue.size() <= prefixEnd || !keyValue.startsWith(kApiKeyValuePrefix)
+        || keyValue.at(prefixEnd) != QLatin1Char('_')) {
+        return false;
+    }
+    
+    bool ok = false;
+    *lookupId = keyValue.midRef(kApiKeyValuePrefix.size(), kApiKeyLookupPrefixLength).toULongLong(&ok, 16);
+    return ok;
+}
+
+QString maskKeyValue(const QString& keyValue)
+{
+    quint64 lookupId = 0;
+    if (parseLookupPrefix(keyValue, &lookupId)) {
+        return keyValue.left(kApiKeyValuePrefix.size() + kApiKeyLookupPrefixLength + 1) + QStringLiteral("****");
+    }
+    return keyValue.left(4) + QStringLiteral("****");
+}
+
+} // namespace
+
+// ApiKeyManager::Private实现
+ApiKeyManager::Private::Private()
+    : index(std::make_shared<const ApiKeyIndex>())
+    , digestSecret(32, Qt::Uninitialized)
+{
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(digestSecret.data()),
+                                          digestSecret.size() / int(sizeof(quint32)));
+}
+
+QByteArray ApiKeyManager::Private::digest(const QString& keyValue) const
+{
+    return QMessageAuthenticationCode::hash(keyValue.toUtf8(), digestSecret, QCryptographicHash::Sha256);
+}
+
+quint64 ApiKeyManager::Private::lookupId(const QString& keyValue, const QByteArray& digest) const
+{
+    quint64 id = 0;
+    if (parseLookupPrefix(keyValue, &id)) {
+        return id;
+    }
+    
+    // 不带前缀的密钥值（通过updateKey设置）以摘要的前8字节作为索引键
+    return qFromBigEndian<quint64>(digest.constData());
+}
+
+std::shared_ptr<const ApiKeyEntry> ApiKeyManager::Private::resolve(const QString& keyValue) const
+{
+    if (keyValue.isEmpty()) {
+        return nullptr;
+    }
+    
+    QByteArray keyDigest = digest(keyValue);
+    std::shared_ptr<const ApiKeyIndex> table = std::atomic_load(&index);
+    auto it = table->constFind(lookupId(keyValue, keyDigest));
+    if (it == table->constEnd() || !constantTimeEquals(it.value()->digest, keyDigest)) {
+        return nullptr;
+    }
+    return it.value();
+}
+
+std::shared_ptr<const ApiKeyEntry> ApiKeyManager::Private::compileEntry(const ApiKey& key, const QByteArray& digest,
+                                                                        quint64 lookupId)
+{
+    auto entry = std::make_shared<ApiKeyEntry>();
+    entry->key = key;
+    entry->lookupId = lookupId;
+    entry->digest = digest;
+    entry->expiresAtMs = key.expiresAt.isValid() ? key.expiresAt.toMSecsSinceEpoch() : 0;
+    entry->permissions = QSet<QString>(key.permissions.begin(), key.permissions.end());
+    return entry;
+}
+
+void ApiKeyManager::Private::publishEntry(const std::shared_ptr<const ApiKeyEntry>& entry)
+{
+    auto table = std::make_shared<ApiKeyIndex>(*std::atomic_load(&index));
+    std::shared_ptr<const ApiKeyEntry> previous = entries.value(entry->key.keyId);
+    if (previous && previous->lookupId != entry->lookupId) {
+        table->remove(previous->lookupId);
+    }
+    table->insert(entry->lookupId, entry);
+    entries.insert(entry->key.keyId, entry);
+    std::atomic_store(&index, std::shared_ptr<const ApiKeyIndex>(table));
+}
+
+void ApiKeyManager::Private::unpublishEntry(const QString& keyId)
+{
+    std::shared_ptr<const ApiKeyEntry> entry = entries.take(keyId);
+    if (!entry) {
+        return;
+    }
+    
+    auto table = std::make_shared<ApiKeyIndex>(*std::atomic_load(&index));
+    table->remove(entry->lookupId);
+    std::atomic_store(&index, std::shared_ptr<const ApiKeyIndex>(table));
+}
+
 ApiKeyManager::ApiKeyManager(QObject* parent)
     : QObject(parent)
     , d(new ApiKeyManager::Private)
@@ -28,9 +154,17 @@ ApiKey ApiKeyManager::createKey(const QString& userId, const QString& descriptio
     auto* d = d_func();
     QMutexLocker locker(&d->mutex);
     
+    // keyId前缀即索引键，极少数情况下与已有密钥冲突时重新生成
     ApiKey key;
-    key.keyId = QUuid::createUuid().toString(QUuid::WithoutBraces);
-    key.keyValue = generateKeyValue();
+    QByteArray keyDigest;
+    quint64 lookupId = 0;
+    do {
+        key.keyId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        key.keyValue = generateKeyValue(key.keyId);
+        keyDigest = d->digest(key.keyValue);
+        lookupId = d->lookupId(key.keyValue, keyDigest);
+    } while (d->index->contains(lookupId));
+    
     key.userId = userId;
     key.description = description;
     key.permissions = permissions;
@@ -42,8 +176,10 @@ ApiKey ApiKeyManager::createKey(const QString& userId, const QString& descriptio
         key.expiresAt = QDateTime::currentDateTime().addDays(d->defaultExpirationDays);
     }
     
-    d->keys[key.keyId] = key;
-    d->keyValueToId[key.keyValue] = key.keyId;
+    // 只保存摘要和掩码，完整密钥值只在此处返回一次
+    ApiKey stored = key;
+    stored.keyValue = maskKeyValue(key.keyValue);
+    d->publishEntry(Private::compileEntry(stored, keyDigest, lookupId));
     
     Logger::info("ApiKeyManager", QString("创建API密钥: %1 (用户: %2)").arg(key.keyId, userId));
     emit keyCreated(key.keyId, userId);
@@ -56,13 +192,11 @@ bool ApiKeyManager::removeKey(const QString& keyId)
     auto* d = d_func();
     QMutexLocker locker(&d->mutex);
     
-    if (!d->keys.contains(keyId)) {
+    if (!d->entries.contains(keyId)) {
         return false;
     }
     
-    ApiKey key = d->keys[keyId];
-    d->keyValueToId.remove(key.keyValue);
-    d->keys.remove(keyId);
+    d->unpublishEntry(keyId);
     
     Logger::info("ApiKeyManager", QString("删除API密钥: %1").arg(keyId));
     emit keyRemoved(keyId);
@@ -79,19 +213,27 @@ bool ApiKeyManager::updateKey(const ApiKey& key)
     auto* d = d_func();
     QMutexLocker locker(&d->mutex);
     
-    if (!d->keys.contains(key.keyId)) {
+    std::shared_ptr<const ApiKeyEntry> previous = d->entries.value(key.keyId);
+    if (!previous) {
         return false;
     }
     
-    ApiKey oldKey = d->keys[key.keyId];
-    
-    // 如果密钥值改变，更新映射
-    if (oldKey.keyValue != key.keyValue) {
-        d->keyValueToId.remove(oldKey.keyValue);
-        d->keyValueToId[key.keyValue] = key.keyId;
+    // 密钥值未改变（仍为掩码）时沿用原摘要，否则重新计算
+    ApiKey stored = key;
+    QByteArray keyDigest = previous->digest;
+    quint64 lookupId = previous->lookupId;
+    if (key.keyValue != previous->key.keyValue) {
+        keyDigest = d->digest(key.keyValue);
+        lookupId = d->lookupId(key.keyValue, keyDigest);
+        auto it = d->index->constFind(lookupId);
+        if (it != d->index->constEnd() && it.value()->key.keyId != key.keyId) {
+            Logger::warning("ApiKeyManager", QString("密钥值前缀与已有密钥冲突: %1").arg(key.keyId));
+            return false;
+        }
+        stored.keyValue = maskKeyValue(key.keyValue);
     }
     
-    d->keys[key.keyId] = key;
+    d->publishEntry(Private::compileEntry(stored, keyDigest, lookupId));
     
     Logger::info("ApiKeyManager", QString("更新API密钥: %1").arg(key.keyId));
     emit keyUpdated(key.keyId);
@@ -103,27 +245,22 @@ ApiKey ApiKeyManager::getKey(const QString& keyId) const
 {
     const auto* d = d_func();
     QMutexLocker locker(&d->mutex);
-    return d->keys.value(keyId);
+    std::shared_ptr<const ApiKeyEntry> entry = d->entries.value(keyId);
+    return entry ? entry->key : ApiKey();
 }
 
 ApiKey ApiKeyManager::getKeyByValue(const QString& keyValue) const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->keyValueToId.contains(keyValue)) {
-        return ApiKey();
-    }
-    
-    QString keyId = d->keyValueToId[keyValue];
-    return d->keys.value(keyId);
+    std::shared_ptr<const ApiKeyEntry> entry = d->resolve(keyValue);
+    return entry ? entry->key : ApiKey();
 }
 
 QStringList ApiKeyManager::getAllKeyIds() const
 {
     const auto* d = d_func();
     QMutexLocker locker(&d->mutex);
-    return d->keys.keys();
+    return d->entries.keys();
 }
 
 QStringList ApiKeyManager::getKeysByUser(const QString& userId) const
@@ -132,8 +269,8 @@ QStringList ApiKeyManager::getKeysByUser(const QString& userId) const
     QMutexLocker locker(&d->mutex);
     
     QStringList keyIds;
-    for (auto it = d->keys.begin(); it != d->keys.end(); ++it) {
-        if (it.value().userId == userId) {
+    for (auto it = d->entries.begin(); it != d->entries.end(); ++it) {
+        if (it.value()->key.userId == userId) {
             keyIds.append(it.key());
         }
     }
@@ -143,18 +280,14 @@ QStringList ApiKeyManager::getKeysByUser(const QString& userId) const
 bool ApiKeyManager::validateKey(const QString& keyValue) const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->keyValueToId.contains(keyValue)) {
+    std::shared_ptr<const ApiKeyEntry> entry = d->resolve(keyValue);
+    if (!entry) {
         return false;
     }
     
-    QString keyId = d->keyValueToId[keyValue];
-    const ApiKey& key = d->keys[keyId];
-    
-    bool valid = key.enabled && !key.isExpired();
+    bool valid = entry->key.enabled && !entry->isExpired(QDateTime::currentMSecsSinceEpoch());
     
-    emit const_cast<ApiKeyManager*>(this)->keyValidated(keyId, valid);
+    emit const_cast<ApiKeyManager*>(this)->keyValidated(entry->key.keyId, valid);
     
     return valid;
 }
@@ -162,25 +295,21 @@ bool ApiKeyManager::validateKey(const QString& keyValue) const
 bool ApiKeyManager::checkPermission(const QString& keyValue, const QString& permission) const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->keyValueToId.contains(keyValue)) {
+    std::shared_ptr<const ApiKeyEntry> entry = d->resolve(keyValue);
+    if (!entry) {
         return false;
     }
     
-    QString keyId = d->keyValueToId[keyValue];
-    const ApiKey& key = d->keys[keyId];
-    
-    if (!key.enabled || key.isExpired()) {
+    if (!entry->key.enabled || entry->isExpired(QDateTime::currentMSecsSinceEpoch())) {
         return false;
     }
     
     // 检查权限列表
-    if (key.permissions.isEmpty()) {
+    if (entry->permissions.isEmpty()) {
         return true;  // 没有权限限制，允许所有操作
     }
     
-    return key.permissions.contains(permission);
+    return entry->permissions.contains(permission);
 }
 
 void ApiKeyManager::setKeyExpiration(int days)
@@ -198,22 +327,19 @@ int ApiKeyManager::getKeyExpiration() const
     return d->defaultExpirationDays;
 }
 
-QString ApiKeyManager::generateKeyValue() const
+QString ApiKeyManager::generateKeyValue(const QString& keyId) const
 {
-    // 生成格式：eagle_<随机UUID>_<时间戳>
-    QString uuid = QUuid::createUuid().toString(QUuid::WithoutBraces);
-    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    // 生成格式：eagle_<keyId前缀>_<随机部分>，前缀用于索引查找
+    QString prefix = QString(keyId).remove(QLatin1Char('-')).left(kApiKeyLookupPrefixLength);
     
-    // 使用SHA256生成更安全的密钥
-    QCryptographicHash hash(QCryptographicHash::Sha256);
-    hash.addData(uuid.toUtf8());
-    hash.addData(QByteArray::number(timestamp));
-    QByteArray hashResult = hash.result();
+    // 192位系统随机数，转换为URL安全的Base64（32个字符）
+    QByteArray secret(24, Qt::Uninitialized);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(secret.data()),
+                                          secret.size() / int(sizeof(quint32)));
     
-    // 转换为Base64，但使用URL安全的字符
     QString keyValue = QString("eagle_%1_%2")
-        .arg(uuid.left(16))  // 使用UUID的前16位
-        .arg(QString::fromLatin1(hashResult.toBase64().left(32)));  // Base64的前32位
+        .arg(prefix)
+        .arg(QString::fromLatin1(secret.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals)));
     
     return keyValue;
 }
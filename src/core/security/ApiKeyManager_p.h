@@ -2,20 +2,63 @@
 #define APIKEYMANAGER_P_H
 
 #include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
+#include <QtCore/QSet>
 #include <QtCore/QMutex>
 #include <QtCore/QDateTime>
+#include <memory>
 #include "eagle/core/ApiKeyManager.h"
 
 namespace Eagle {
 namespace Core {
 
+/**
+ * @brief 密钥值中查找前缀的长度（keyId去掉连字符后的前16个十六进制字符）
+ */
+const int kApiKeyLookupPrefixLength = 16;
+
+/**
+ * @brief 已编译的密钥条目（发布后不再修改）
+ */
+struct ApiKeyEntry {
+    ApiKey key;                    // keyValue为掩码
+    quint64 lookupId = 0;          // 索引键，由密钥值中的前缀解析
+    QByteArray digest;             // 密钥值的HMAC-SHA256
+    qint64 expiresAtMs = 0;        // 0表示永不过期
+    QSet<QString> permissions;     // 为空表示不限制
+
+    bool isExpired(qint64 nowMs) const {
+        return expiresAtMs > 0 && nowMs > expiresAtMs;
+    }
+};
+
+using ApiKeyIndex = QHash<quint64, std::shared_ptr<const ApiKeyEntry>>;
+
 class ApiKeyManager::Private {
 public:
-    QMap<QString, ApiKey> keys;  // keyId -> ApiKey
-    QMap<QString, QString> keyValueToId;  // keyValue -> keyId (用于快速查找)
+    QMap<QString, std::shared_ptr<const ApiKeyEntry>> entries;  // keyId -> 条目
+    std::shared_ptr<const ApiKeyIndex> index;  // lookupId -> 条目，写时复制，读取无锁
+    QByteArray digestSecret;  // 摘要密钥，每个实例随机生成
     int defaultExpirationDays = 365;  // 默认1年过期
-    mutable QMutex mutex;
+    mutable QMutex mutex;  // 仅保护写操作和entries
+
+    Private();
+
+    QByteArray digest(const QString& keyValue) const;
+    quint64 lookupId(const QString& keyValue, const QByteArray& digest) const;
+
+    /**
+     * @brief 按密钥值查找条目：一次摘要、一次索引查找、常量时间比较
+     */
+    std::shared_ptr<const ApiKeyEntry> resolve(const QString& keyValue) const;
+
+    // 更新entries并发布新的索引（调用方需持有mutex）
+    static std::shared_ptr<const ApiKeyEntry> compileEntry(const ApiKey& key, const QByteArray& digest,
+                                                           quint64 lookupId);
+    void publishEntry(const std::shared_ptr<const ApiKeyEntry>& entry);
+    void unpublishEntry(const QString& keyId);
 };
 
 } // namespace Core
@@ -0,0 +1,233 @@
+#include "eagle/core/PrincipalResolver.h"
+#include "PrincipalResolver_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QReadLocker>
+#include <QtCore/QWriteLocker>
+
+namespace Eagle {
+namespace Core {
+
+PrincipalResolver::PrincipalResolver(ApiKeyManager* apiKeyManager, SessionManager* sessionManager,
+                                     QObject* parent)
+    : QObject(parent)
+    , d_ptr(new PrincipalResolverPrivate)
+{
+    d_ptr->apiKeyManager = apiKeyManager;
+    d_ptr->sessionManager = sessionManager;
+
+    // 凭证失效时立即移除缓存，不等待TTL
+    if (apiKeyManager) {
+        connect(apiKeyManager, &ApiKeyManager::keyRemoved, this, &PrincipalResolver::invalidateCredential,
+                Qt::DirectConnection);
+        connect(apiKeyManager, &ApiKeyManager::keyUpdated, this, &PrincipalResolver::invalidateCredential,
+                Qt::DirectConnection);
+    }
+    if (sessionManager) {
+        // 过期的会话同样发出sessionDestroyed，不再连接sessionExpired以免重复失效
+        connect(sessionManager, &SessionManager::sessionDestroyed, this, &PrincipalResolver::invalidateCredential,
+                Qt::DirectConnection);
+    }
+}
+
+PrincipalResolver::~PrincipalResolver()
+{
+    delete d_ptr;
+}
+
+std::shared_ptr<const AuthPrincipal> PrincipalResolver::resolve(const QString& token)
+{
+    auto* d = d_func();
+    if (token.isEmpty()) {
+        return nullptr;
+    }
+
+    QByteArray digest = QCryptographicHash::hash(token.toUtf8(), QCryptographicHash::Sha256);
+    PrincipalCacheShard& shard = d->shardFor(digest);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    quint64 generation = 0;
+    quint64 invalidations = d->invalidations.load();
+
+    {
+        QReadLocker locker(&shard.lock);
+        auto it = shard.entries.constFind(digest);
+        if (it != shard.entries.constEnd() && it.value()->expiresAtMs > now) {
+            d->hits.fetch_add(1, std::memory_order_relaxed);
+            return it.value();
+        }
+        generation = shard.generation;
+    }
+
+    d->misses.fetch_add(1, std::memory_order_relaxed);
+    std::shared_ptr<const AuthPrincipal> principal = resolveUncached(token);
+
+    QWriteLocker locker(&shard.lock);
+    auto existing = shard.entries.find(digest);
+    if (!principal) {
+        if (existing != shard.entries.end()) {
+            d->eraseEntry(shard, existing);
+        }
+        return nullptr;
+    }
+
+    // 解析期间发生过失效时不缓存：结果可能是失效前读到的凭证
+    if (shard.generation != generation) {
+        return principal;
+    }
+
+    // 分片已满时先清理过期条目，仍然满则任意淘汰一条
+    int capacity = qMax(1, d->maxSize.load(std::memory_order_relaxed) / kPrincipalCacheShardCount);
+    if (existing != shard.entries.end()) {
+        d->eraseEntry(shard, existing);
+    }
+    if (shard.entries.size() >= capacity) {
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            if (it.value()->expiresAtMs <= now) {
+                d->eraseEntry(shard, it);
+            } else {
+                ++it;
+            }
+        }
+        if (shard.entries.size() >= capacity) {
+            auto it = shard.entries.begin();
+            d->eraseEntry(shard, it);
+        }
+    }
+    auto inserted = shard.entries.insert(digest, principal);
+    {
+        QMutexLocker indexLocker(&d->indexMutex);
+        d->credentialDigests.insert(principal->credentialId, digest);
+    }
+
+    // 入索引后再确认期间没有凭证失效：之后发生的失效一定能从索引找到这一条
+    if (d->invalidations.load() != invalidations) {
+        d->eraseEntry(shard, inserted);
+    }
+    return principal;
+}
+
+std::shared_ptr<const AuthPrincipal> PrincipalResolver::resolveUncached(const QString& token) const
+{
+    const auto* d = d_func();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto principal = std::make_shared<AuthPrincipal>();
+    principal->expiresAtMs = now + d->ttlMs.load(std::memory_order_relaxed);
+
+    // 尝试API密钥
+    if (d->apiKeyManager) {
+        ApiKey key = d->apiKeyManager->getKeyByValue(token);
+        if (key.isValid() && key.enabled && !key.isExpired()) {
+            principal->userId = key.userId;
+            principal->credentialType = CredentialType::ApiKey;
+            principal->credentialId = key.keyId;
+            if (!key.expiresAt.isNull()) {
+                principal->expiresAtMs = qMin(principal->expiresAtMs, key.expiresAt.toMSecsSinceEpoch());
+            }
+            return principal;
+        }
+    }
+
+    // 尝试会话
+    if (d->sessionManager && d->sessionManager->validateSession(token)) {
+        Session session = d->sessionManager->getSession(token);
+        if (session.isValid()) {
+            principal->userId = session.userId;
+            principal->credentialType = CredentialType::Session;
+            principal->credentialId = session.sessionId;
+            if (!session.expiresAt.isNull()) {
+                principal->expiresAtMs = qMin(principal->expiresAtMs, session.expiresAt.toMSecsSinceEpoch());
+            }
+            return principal;
+        }
+    }
+
+    return nullptr;
+}
+
+void PrincipalResolver::invalidateCredential(const QString& credentialId)
+{
+    auto* d = d_func();
+    d->invalidations.fetch_add(1);
+
+    QList<QByteArray> digests;
+    {
+        QMutexLocker locker(&d->indexMutex);
+        digests = d->credentialDigests.values(credentialId);
+    }
+
+    // 只锁定缓存了该凭证的分片；按摘要重新确认，期间可能已被淘汰或替换
+    int removed = 0;
+    for (const QByteArray& digest : digests) {
+        PrincipalCacheShard& shard = d->shardFor(digest);
+        QWriteLocker locker(&shard.lock);
+        shard.generation++;
+        auto it = shard.entries.find(digest);
+        if (it != shard.entries.end() && it.value()->credentialId == credentialId) {
+            d->eraseEntry(shard, it);
+            removed++;
+        }
+    }
+
+    if (removed > 0) {
+        Logger::debug("PrincipalResolver", QString("凭证已失效，移除缓存: %1").arg(credentialId));
+    }
+}
+
+void PrincipalResolver::clear()
+{
+    auto* d = d_func();
+    for (PrincipalCacheShard& shard : d->shards) {
+        QWriteLocker locker(&shard.lock);
+        shard.generation++;
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            d->eraseEntry(shard, it);
+        }
+    }
+}
+
+void PrincipalResolver::setCacheTTL(int ttlMs)
+{
+    auto* d = d_func();
+    d->ttlMs.store(qMax(0, ttlMs));
+    clear();
+}
+
+int PrincipalResolver::cacheTTL() const
+{
+    const auto* d = d_func();
+    return d->ttlMs.load();
+}
+
+void PrincipalResolver::setCacheMaxSize(int maxSize)
+{
+    auto* d = d_func();
+    d->maxSize.store(qMax(1, maxSize));
+}
+
+int PrincipalResolver::cacheMaxSize() const
+{
+    const auto* d = d_func();
+    return d->maxSize.load();
+}
+
+QVariantMap PrincipalResolver::getStatistics() const
+{
+    auto* d = const_cast<PrincipalResolverPrivate*>(d_func());
+    int size = 0;
+    for (PrincipalCacheShard& shard : d->shards) {
+        QReadLocker locker(&shard.lock);
+        size += shard.entries.size();
+    }
+
+    QVariantMap stats;
+    stats["hits"] = static_cast<qint64>(d->hits.load());
+    stats["misses"] = static_cast<qint64>(d->misses.load());
+    stats["size"] = size;
+    stats["ttlMs"] = d->ttlMs.load();
+    stats["maxSize"] = d->maxSize.load();
+    return stats;
+}
+
+} // namespace Core
+} // namespace Eagle
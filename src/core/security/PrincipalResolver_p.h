@@ -0,0 +1,65 @@
+#ifndef PRINCIPALRESOLVER_P_H
+#define PRINCIPALRESOLVER_P_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QMultiHash>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+#include <QtCore/QReadWriteLock>
+#include <atomic>
+#include <memory>
+#include "eagle/core/PrincipalResolver.h"
+#include "eagle/core/ApiKeyManager.h"
+#include "eagle/core/SessionManager.h"
+
+namespace Eagle {
+namespace Core {
+
+/**
+ * @brief 主体缓存分片数（2的幂）
+ */
+const int kPrincipalCacheShardCount = 16;
+
+/**
+ * @brief 主体缓存分片，键为token的SHA-256摘要
+ */
+struct PrincipalCacheShard {
+    QReadWriteLock lock;
+    QHash<QByteArray, std::shared_ptr<const AuthPrincipal>> entries;
+    quint64 generation = 0;  // 每次失效递增，丢弃失效前开始解析的结果
+};
+
+class PrincipalResolverPrivate {
+public:
+    QPointer<ApiKeyManager> apiKeyManager;
+    QPointer<SessionManager> sessionManager;
+    PrincipalCacheShard shards[kPrincipalCacheShardCount];
+    QMutex indexMutex;
+    QMultiHash<QString, QByteArray> credentialDigests;  // 凭证ID -> 缓存条目的token摘要，失效时只锁定相关分片
+    std::atomic<quint64> invalidations{0};  // 每次凭证失效递增，丢弃失效前开始解析的结果（条目尚未入缓存时无法按分片定位）
+    std::atomic<int> ttlMs{5000};
+    std::atomic<int> maxSize{10000};
+    std::atomic<qint64> hits{0};
+    std::atomic<qint64> misses{0};
+
+    PrincipalCacheShard& shardFor(const QByteArray& digest) {
+        return shards[qHash(digest) & (kPrincipalCacheShardCount - 1)];
+    }
+
+    /**
+     * @brief 从分片移除条目并同步移除索引，调用方持有分片写锁
+     */
+    void eraseEntry(PrincipalCacheShard& shard, QHash<QByteArray, std::shared_ptr<const AuthPrincipal>>::iterator& it) {
+        {
+            QMutexLocker locker(&indexMutex);
+            credentialDigests.remove(it.value()->credentialId, it.key());
+        }
+        it = shard.entries.erase(it);
+    }
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // PRINCIPALRESOLVER_P_H
@@ -7,7 +7,11 @@
 #include <QtCore/QVariantMap>
 #include <QtCore/QVariantList>
 #include <QtCore/QDateTime>
+#include <QtCore/QReadLocker>
+#include <QtCore/QWriteLocker>
+#include <QtCore/QtAlgorithms>
 #include <algorithm>
+#include <memory>
 
 namespace Eagle {
 namespace Core {
@@ -87,6 +91,276 @@ QSet<QString> User::getAllPermissions(const QMap<QString, Role>& allRoles) const
     return allPerms;
 }
 
+namespace {
+
+/**
+ * @brief 编译角色的有效权限：合并自身及所有祖先角色的权限（容忍循环继承）
+ */
+PermissionBitset compileRole(const QString& roleName, const QMap<QString, Role>& roles,
+                             const QHash<QString, int>& permissionIds)
+{
+    PermissionBitset bits;
+    QSet<QString> visited;
+    QStringList pending;
+    pending.append(roleName);
+    
+    while (!pending.isEmpty()) {
+        QString current = pending.takeLast();
+        auto roleIt = roles.constFind(current);
+        if (roleIt == roles.constEnd() || visited.contains(current)) {
+            continue;
+        }
+        visited.insert(current);
+        
+        for (const QString& permName : roleIt->permissions) {
+            bits.set(permissionIds.value(permName));
+        }
+        for (const QString& parentName : roleIt->parentRoles) {
+            pending.append(parentName);
+        }
+    }
+    
+    return bits;
+}
+
+} // namespace
+
+void RBACManager::Private::rebuildCompiledTable(const QString& changedPermission)
+{
+    std::shared_ptr<const CompiledPermissionTable> previous = compiledTable();
+    auto table = std::make_shared<CompiledPermissionTable>();
+    table->epoch = previous->epoch + 1;
+    table->permissionIds = previous->permissionIds;
+    
+    // 角色和用户可能引用尚未添加的权限名，同样分配序号
+    auto intern = [&table](const QString& name) {
+        if (!table->permissionIds.contains(name)) {
+            table->permissionIds.insert(name, table->permissionIds.size());
+        }
+    };
+    for (auto it = permissions.constBegin(); it != permissions.constEnd(); ++it) {
+        intern(it.key());
+    }
+    for (const Role& role : roles) {
+        for (const QString& permName : role.permissions) {
+            intern(permName);
+        }
+    }
+    
+    for (auto it = roles.constBegin(); it != roles.constEnd(); ++it) {
+        table->roleBits.insert(it.key(), compileRole(it.key(), roles, table->permissionIds));
+    }
+    
+    // 标记授予关系发生变化的权限：新旧角色位集的差异，以及调用方指定的权限
+    table->permissionEpochs = previous->permissionEpochs;
+    table->permissionEpochs.resize(table->permissionIds.size());
+    auto markChanged = [&table](const PermissionBitset& before, const PermissionBitset& after) {
+        int words = qMax(before.words.size(), after.words.size());
+        for (int w = 0; w < words; ++w) {
+            quint64 changed = before.words.value(w) ^ after.words.value(w);
+            while (changed) {
+                table->permissionEpochs[w * 64 + qCountTrailingZeroBits(changed)] = table->epoch;
+                changed &= changed - 1;
+            }
+        }
+    };
+    for (auto it = table->roleBits.constBegin(); it != table->roleBits.constEnd(); ++it) {
+        markChanged(previous->roleBits.value(it.key()), it.value());
+    }
+    for (auto it = previous->roleBits.constBegin(); it != previous->roleBits.constEnd(); ++it) {
+        if (!table->roleBits.contains(it.key())) {
+            markChanged(it.value(), PermissionBitset());
+        }
+    }
+    int changedId = table->permissionIds.value(changedPermission, -1);
+    if (changedId >= 0) {
+        table->permissionEpochs[changedId] = table->epoch;
+    }
+    
+    std::atomic_store(&compiled, std::shared_ptr<const CompiledPermissionTable>(table));
+}
+
+void RBACManager::Private::internPermissions(const QSet<QString>& names)
+{
+    std::shared_ptr<const CompiledPermissionTable> previous = compiledTable();
+    std::shared_ptr<CompiledPermissionTable> table;
+    for (const QString& name : names) {
+        if (previous->permissionIds.contains(name) || (table && table->permissionIds.contains(name))) {
+            continue;
+        }
+        if (!table) {
+            table = std::make_shared<CompiledPermissionTable>(*previous);
+        }
+        table->permissionIds.insert(name, table->permissionIds.size());
+    }
+    if (!table) {
+        return;
+    }
+    
+    // 新序号此前没有任何授予关系，版本记为0
+    table->permissionEpochs.resize(table->permissionIds.size());
+    std::atomic_store(&compiled, std::shared_ptr<const CompiledPermissionTable>(table));
+}
+
+PermissionBitset RBACManager::Private::compileUserPermissions(const User& user) const
+{
+    PermissionBitset bits;
+    if (!user.enabled) {
+        return bits;
+    }
+    
+    std::shared_ptr<const CompiledPermissionTable> table = compiledTable();
+    for (const QString& permName : user.directPermissions) {
+        int id = table->permissionIds.value(permName, -1);
+        if (id >= 0) {
+            bits.set(id);
+        }
+    }
+    for (const QString& roleName : user.roles) {
+        auto it = table->roleBits.constFind(roleName);
+        if (it != table->roleBits.constEnd()) {
+            bits.unite(it.value());
+        }
+    }
+    return bits;
+}
+
+// PermissionCache实现
+bool PermissionCache::lookup(const QString& userId, int permissionId, const CompiledPermissionTable& table,
+                             qint64 nowMs, bool* granted, quint64* generation) const
+{
+    PermissionCacheShard& shard = shardFor(userId);
+    QReadLocker locker(&shard.lock);
+    *generation = shard.generation;
+    
+    auto it = shard.index.constFind(userId);
+    if (it == shard.index.constEnd()) {
+        return false;
+    }
+    
+    // 过期，或该权限的授予关系在编译之后发生过变化
+    const PermissionCacheEntry& entry = shard.entries.at(it.value());
+    if (entry.expireMs <= nowMs || table.permissionEpochs.value(permissionId) > entry.epoch) {
+        return false;
+    }
+    
+    entry.referenced.storeRelaxed(1);
+    *granted = entry.permissions.test(permissionId);
+    return true;
+}
+
+void PermissionCache::insert(const QString& userId, const PermissionBitset& permissions, quint64 epoch,
+                             qint64 expireMs, quint64 generation, qint64 nowMs)
+{
+    PermissionCacheShard& shard = shardFor(userId);
+    QWriteLocker locker(&shard.lock);
+    if (shard.generation != generation) {
+        return;
+    }
+    
+    int slot = shard.index.value(userId, -1);
+    if (slot < 0) {
+        if (shard.entries.size() < shardCapacity.load(std::memory_order_relaxed)) {
+            slot = shard.entries.size();
+            shard.entries.append(PermissionCacheEntry());
+        } else {
+            slot = evictSlot(shard, nowMs);
+        }
+        shard.index.insert(userId, slot);
+    }
+    
+    PermissionCacheEntry& entry = shard.entries[slot];
+    entry.userId = userId;
+    entry.permissions = permissions;
+    entry.epoch = epoch;
+    entry.expireMs = expireMs;
+    entry.referenced.storeRelaxed(0);
+}
+
+int PermissionCache::evictSlot(PermissionCacheShard& shard, qint64 nowMs)
+{
+    // CLOCK：清除沿途条目的访问位，第一个未被访问（或已过期）的条目被淘汰，最多转两圈
+    forever {
+        if (shard.hand >= shard.entries.size()) {
+            shard.hand = 0;
+        }
+        int slot = shard.hand++;
+        PermissionCacheEntry& entry = shard.entries[slot];
+        if (entry.expireMs > nowMs && entry.referenced.fetchAndStoreRelaxed(0)) {
+            continue;
+        }
+        shard.index.remove(entry.userId);
+        return slot;
+    }
+}
+
+bool PermissionCache::removeUser(const QString& userId)
+{
+    PermissionCacheShard& shard = shardFor(userId);
+    QWriteLocker locker(&shard.lock);
+    shard.generation++;
+    
+    int slot = shard.index.value(userId, -1);
+    if (slot < 0) {
+        return false;
+    }
+    
+    // 用最后一项填补空位，保持entries紧凑
+    shard.index.remove(userId);
+    int last = shard.entries.size() - 1;
+    if (slot != last) {
+        shard.entries[slot] = shard.entries.at(last);
+        shard.index.insert(shard.entries.at(slot).userId, slot);
+    }
+    shard.entries.removeLast();
+    return true;
+}
+
+int PermissionCache::clear()
+{
+    int removed = 0;
+    for (PermissionCacheShard& shard : shards) {
+        QWriteLocker locker(&shard.lock);
+        removed += shard.entries.size();
+        shard.index.clear();
+        shard.entries.clear();
+        shard.hand = 0;
+        shard.generation++;
+    }
+    return removed;
+}
+
+int PermissionCache::size(qint64 nowMs) const
+{
+    int count = 0;
+    for (PermissionCacheShard& shard : shards) {
+        QReadLocker locker(&shard.lock);
+        for (const PermissionCacheEntry& entry : shard.entries) {
+            if (entry.expireMs > nowMs) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+void PermissionCache::setCapacity(int maxSize)
+{
+    int capacity = qMax(1, (maxSize + kPermissionCacheShardCount - 1) / kPermissionCacheShardCount);
+    shardCapacity.store(capacity, std::memory_order_relaxed);
+    
+    // 超出新容量的分片直接清空，之后按CLOCK重新填充
+    for (PermissionCacheShard& shard : shards) {
+        QWriteLocker locker(&shard.lock);
+        if (shard.entries.size() > capacity) {
+            shard.index.clear();
+            shard.entries.clear();
+            shard.hand = 0;
+            shard.generation++;
+        }
+    }
+}
+
 RBACManager::RBACManager(QObject* parent)
     : QObject(parent)
     , d(new RBACManager::Private)
@@ -139,12 +413,11 @@ bool RBACManager::addPermission(const Permission& permission)
     }
     
     d->permissions[permission.name] = permission;
+    d->rebuildCompiledTable();
     QString operatorId = d->currentOperatorId;
     Logger::info("RBACManager", QString("添加权限: %1").arg(permission.name));
     
-    // 清除相关缓存（所有包含此权限的缓存）
     locker.unlock();
-    clearPermissionCache(permission.name);
     
     emit permissionAdded(permission.name);
     
@@ -181,11 +454,11 @@ bool RBACManager::removePermission(const QString& permissionName)
     }
     
     d->permissions.remove(permissionName);
+    d->rebuildCompiledTable(permissionName);
     Logger::info("RBACManager", QString("移除权限: %1").arg(permissionName));
     
-    // 清除相关缓存
+    // 权限表已标记该权限，相关缓存在下次检查时重新编译
     locker.unlock();
-    clearPermissionCache(permissionName);
     
     emit permissionRemoved(permissionName);
     
@@ -238,11 +511,11 @@ bool RBACManager::addRole(const Role& role)
     }
     
     d->roles[role.name] = role;
+    d->rebuildCompiledTable();
     Logger::info("RBACManager", QString("添加角色: %1").arg(role.name));
     
-    // 清除所有缓存（角色变更可能影响所有用户）
+    // 角色有效权限的变化已在权限表中标记，不需要清除缓存
     locker.unlock();
-    clearCache();
     
     emit roleAdded(role.name);
     
@@ -274,11 +547,11 @@ bool RBACManager::removeRole(const QString& roleName)
     }
     
     d->roles.remove(roleName);
+    d->rebuildCompiledTable();
     Logger::info("RBACManager", QString("移除角色: %1").arg(roleName));
     
-    // 清除所有缓存（角色变更可能影响所有用户）
+    // 角色有效权限的变化已在权限表中标记，不需要清除缓存
     locker.unlock();
-    clearCache();
     
     emit roleRemoved(roleName);
     
@@ -311,11 +584,11 @@ bool RBACManager::assignPermissionToRole(const QString& roleName, const QString&
     }
     
     d->roles[roleName].permissions.insert(permissionName);
+    d->rebuildCompiledTable();
     Logger::info("RBACManager", QString("为角色 %1 分配权限: %2").arg(roleName, permissionName));
     
-    // 清除相关缓存
+    // 角色有效权限的变化已在权限表中标记，不需要清除缓存
     locker.unlock();
-    clearPermissionCache(permissionName);
     
     // 发送权限变更通知
     PermissionChangeNotification notification = PermissionChangeNotifier::createNotification(
@@ -340,11 +613,11 @@ bool RBACManager::revokePermissionFromRole(const QString& roleName, const QStrin
     }
     
     d->roles[roleName].permissions.remove(permissionName);
+    d->rebuildCompiledTable();
     Logger::info("RBACManager", QString("从角色 %1 撤销权限: %2").arg(roleName, permissionName));
     
-    // 清除相关缓存
+    // 角色有效权限的变化已在权限表中标记，不需要清除缓存
     locker.unlock();
-    clearPermissionCache(permissionName);
     
     // 发送权限变更通知
     PermissionChangeNotification notification = PermissionChangeNotifier::createNotification(
@@ -376,11 +649,11 @@ bool RBACManager::addRoleInheritance(const QString& childRole, const QString& pa
     }
     
     d->roles[childRole].parentRoles.insert(parentRole);
+    d->rebuildCompiledTable();
     Logger::info("RBACManager", QString("角色 %1 继承角色 %2").arg(childRole, parentRole));
     
-    // 清除所有缓存（角色继承变更可能影响所有用户）
+    // 角色有效权限的变化已在权限表中标记，不需要清除缓存
     locker.unlock();
-    clearCache();
     
     // 发送权限变更通知
     PermissionChangeNotification notification = PermissionChangeNotifier::createNotification(
@@ -431,7 +704,9 @@ bool RBACManager::addUser(const User& user)
         }
     }
     
+    // 新用户不影响角色的有效权限，只需为其直接权限分配序号
     d->users[user.userId] = user;
+    d->internPermissions(user.directPermissions);
     Logger::info("RBACManager", QString("添加用户: %1").arg(user.userId));
     
     // 清除该用户的缓存（如果有）
@@ -634,55 +909,45 @@ QStringList RBACManager::getAllUsers() const
 bool RBACManager::checkPermission(const QString& userId, const QString& permissionName) const
 {
     const auto* d = d_func();
+    auto* mutableD = const_cast<Private*>(d);
+    
+    // 没有任何角色或用户引用过的权限不会被授予
+    std::shared_ptr<const CompiledPermissionTable> table = d->compiledTable();
+    int permissionId = table->permissionIds.value(permissionName, -1);
+    if (permissionId < 0) {
+        return false;
+    }
     
     // 检查缓存
-    if (d->cacheEnabled) {
-        QString cacheKey = QString("%1:%2").arg(userId, permissionName);
-        // 使用const_cast来修改缓存（缓存是mutable的，但QMap不是）
-        auto* mutableD = const_cast<Private*>(d);
-        QMutexLocker cacheLocker(&mutableD->cacheMutex);
-        
-        if (mutableD->permissionCache.contains(cacheKey)) {
-            PermissionCacheEntry entry = mutableD->permissionCache[cacheKey];
-            
-            // 检查是否过期
-            if (!entry.isExpired()) {
-                entry.updateAccessTime();
-                // 更新缓存中的访问时间
-                mutableD->permissionCache[cacheKey] = entry;
-                return entry.result;
-            } else {
-                // 过期，移除
-                mutableD->permissionCache.remove(cacheKey);
-            }
+    bool cacheEnabled = d->cacheEnabled.load(std::memory_order_relaxed);
+    qint64 nowMs = d->clock.elapsed();
+    quint64 generation = 0;
+    if (cacheEnabled) {
+        bool granted = false;
+        if (mutableD->permissionCache.lookup(userId, permissionId, *table, nowMs, &granted, &generation)) {
+            return granted;
         }
-        cacheLocker.unlock();
     }
     
-    // 执行实际权限检查
+    // 编译用户的有效权限
     QMutexLocker locker(&d->mutex);
-    
-    if (!d->users.contains(userId)) {
+    quint64 epoch = d->compiledTable()->epoch;
+    PermissionBitset permissions;
+    auto userIt = d->users.constFind(userId);
+    if (userIt == d->users.constEnd()) {
         Logger::warning("RBACManager", QString("用户不存在: %1").arg(userId));
-        bool result = false;
-        
-        // 缓存结果（即使是false也缓存）
-        if (d->cacheEnabled) {
-            cachePermissionResult(userId, permissionName, result);
-        }
-        return result;
+    } else {
+        permissions = d->compileUserPermissions(userIt.value());
     }
+    locker.unlock();
     
-    const User& user = d->users[userId];
-    bool result = user.hasPermission(permissionName, d->roles);
-    
-    // 缓存结果
-    if (d->cacheEnabled) {
-        locker.unlock();  // 释放主锁，避免死锁
-        cachePermissionResult(userId, permissionName, result);
+    // 缓存结果（用户不存在时也缓存）
+    if (cacheEnabled) {
+        qint64 expireMs = nowMs + qint64(d->cacheTTLSeconds.load(std::memory_order_relaxed)) * 1000;
+        mutableD->permissionCache.insert(userId, permissions, epoch, expireMs, generation, nowMs);
     }
     
-    return result;
+    return permissions.test(permissionId);
 }
 
 bool RBACManager::checkAnyPermission(const QString& userId, const QStringList& permissionNames) const
@@ -745,8 +1010,17 @@ bool RBACManager::loadFromConfig(const QVariantMap& config)
         user.enabled = userData.contains("enabled") ? userData["enabled"].toBool() : true;
         d->users[user.userId] = user;
     }
+    d->rebuildCompiledTable();
+    
+    QSet<QString> userPermissions;
+    for (const User& user : d->users) {
+        userPermissions.unite(user.directPermissions);
+    }
+    d->internPermissions(userPermissions);
     
     Logger::info("RBACManager", "从配置加载RBAC数据完成");
+    locker.unlock();
+    clearCache();
     return true;
 }
 
@@ -798,8 +1072,7 @@ QVariantMap RBACManager::saveToConfig() const
 void RBACManager::setCacheEnabled(bool enabled)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->cacheMutex);
-    d->cacheEnabled = enabled;
+    d->cacheEnabled.store(enabled);
     if (!enabled) {
         d->permissionCache.clear();
     }
@@ -809,171 +1082,56 @@ void RBACManager::setCacheEnabled(bool enabled)
 bool RBACManager::isCacheEnabled() const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->cacheMutex);
-    return d->cacheEnabled;
+    return d->cacheEnabled.load();
 }
 
 void RBACManager::setCacheMaxSize(int maxSize)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->cacheMutex);
-    d->cacheMaxSize = qMax(1, maxSize);
-    
-    // 如果当前缓存超过最大大小，执行LRU淘汰
-    if (d->permissionCache.size() > d->cacheMaxSize) {
-        evictLRUEntries();
-    }
+    d->cacheMaxSize.store(qMax(1, maxSize));
+    d->permissionCache.setCapacity(d->cacheMaxSize.load());
     
-    Logger::info("RBACManager", QString("设置缓存最大大小: %1").arg(d->cacheMaxSize));
+    Logger::info("RBACManager", QString("设置缓存最大大小: %1").arg(d->cacheMaxSize.load()));
 }
 
 int RBACManager::getCacheMaxSize() const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->cacheMutex);
-    return d->cacheMaxSize;
+    return d->cacheMaxSize.load();
 }
 
 void RBACManager::setCacheTTL(int seconds)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->cacheMutex);
-    d->cacheTTLSeconds = qMax(1, seconds);
-    Logger::info("RBACManager", QString("设置缓存TTL: %1秒").arg(d->cacheTTLSeconds));
+    d->cacheTTLSeconds.store(qMax(1, seconds));
+    Logger::info("RBACManager", QString("设置缓存TTL: %1秒").arg(d->cacheTTLSeconds.load()));
 }
 
 int RBACManager::getCacheTTL() const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->cacheMutex);
-    return d->cacheTTLSeconds;
+    return d->cacheTTLSeconds.load();
 }
 
 void RBACManager::clearCache()
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->cacheMutex);
-    int size = d->permissionCache.size();
-    d->permissionCache.clear();
+    int size = d->permissionCache.clear();
     Logger::info("RBACManager", QString("清除权限缓存，共%1条记录").arg(size));
 }
 
 void RBACManager::clearUserCache(const QString& userId)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->cacheMutex);
-    
-    QString prefix = userId + ":";
-    QList<QString> keysToRemove;
-    
-    for (auto it = d->permissionCache.begin(); it != d->permissionCache.end(); ++it) {
-        if (it.key().startsWith(prefix)) {
-            keysToRemove.append(it.key());
-        }
-    }
-    
-    for (const QString& key : keysToRemove) {
-        d->permissionCache.remove(key);
-    }
-    
-    if (!keysToRemove.isEmpty()) {
-        Logger::info("RBACManager", QString("清除用户 %1 的缓存，共%2条记录").arg(userId).arg(keysToRemove.size()));
+    if (d->permissionCache.removeUser(userId)) {
+        Logger::info("RBACManager", QString("清除用户 %1 的缓存").arg(userId));
     }
 }
 
 int RBACManager::getCacheSize() const
 {
-    auto* d = const_cast<Private*>(d_func());
-    QMutexLocker locker(&d->cacheMutex);
-    
-    // 清理过期条目
-    QList<QString> expiredKeys;
-    for (auto it = d->permissionCache.begin(); it != d->permissionCache.end(); ++it) {
-        if (it.value().isExpired()) {
-            expiredKeys.append(it.key());
-        }
-    }
-    for (const QString& key : expiredKeys) {
-        d->permissionCache.remove(key);
-    }
-    
-    return d->permissionCache.size();
-}
-
-// 私有辅助函数：缓存权限检查结果
-void RBACManager::cachePermissionResult(const QString& userId, const QString& permissionName, bool result) const
-{
-    auto* d = const_cast<Private*>(d_func());
-    QMutexLocker locker(&d->cacheMutex);
-    
-    if (!d->cacheEnabled) {
-        return;
-    }
-    
-    QString cacheKey = QString("%1:%2").arg(userId, permissionName);
-    QDateTime expireTime = QDateTime::currentDateTime().addSecs(d->cacheTTLSeconds);
-    
-    // 如果缓存已满，执行LRU淘汰
-    if (d->permissionCache.size() >= d->cacheMaxSize && !d->permissionCache.contains(cacheKey)) {
-        evictLRUEntries();
-    }
-    
-    // 添加或更新缓存
-    d->permissionCache[cacheKey] = PermissionCacheEntry(result, expireTime);
-}
-
-// 私有辅助函数：LRU淘汰
-void RBACManager::evictLRUEntries() const
-{
-    auto* d = const_cast<Private*>(d_func());
-    
-    if (d->permissionCache.size() <= d->cacheMaxSize) {
-        return;
-    }
-    
-    // 需要淘汰的数量
-    int toEvict = d->permissionCache.size() - d->cacheMaxSize + 1;
-    
-    // 按访问时间排序，淘汰最久未访问的
-    QList<QPair<QDateTime, QString>> entries;
-    for (auto it = d->permissionCache.begin(); it != d->permissionCache.end(); ++it) {
-        entries.append(qMakePair(it.value().accessTime, it.key()));
-    }
-    
-    // 按访问时间升序排序（最早的在前）
-    std::sort(entries.begin(), entries.end(), 
-              [](const QPair<QDateTime, QString>& a, const QPair<QDateTime, QString>& b) {
-                  return a.first < b.first;
-              });
-    
-    // 淘汰最久未访问的条目
-    for (int i = 0; i < toEvict && i < entries.size(); ++i) {
-        d->permissionCache.remove(entries[i].second);
-    }
-}
-
-// 私有辅助函数：清除特定权限的缓存
-void RBACManager::clearPermissionCache(const QString& permissionName) const
-{
-    auto* d = const_cast<Private*>(d_func());
-    QMutexLocker locker(&d->cacheMutex);
-    
-    QString suffix = ":" + permissionName;
-    QList<QString> keysToRemove;
-    
-    for (auto it = d->permissionCache.begin(); it != d->permissionCache.end(); ++it) {
-        if (it.key().endsWith(suffix)) {
-            keysToRemove.append(it.key());
-        }
-    }
-    
-    for (const QString& key : keysToRemove) {
-        d->permissionCache.remove(key);
-    }
-    
-    if (!keysToRemove.isEmpty()) {
-        Logger::debug("RBACManager", QString("清除权限 %1 的缓存，共%2条记录").arg(permissionName).arg(keysToRemove.size()));
-    }
+    const auto* d = d_func();
+    return d->permissionCache.size(d->clock.elapsed());
 }
 
 // 权限变更通知配置
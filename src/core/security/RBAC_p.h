@@ -5,8 +5,14 @@
 #include <QtCore/QMap>
 #include <QtCore/QSet>
 #include <QtCore/QMutex>
-#include <QtCore/QDateTime>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QAtomicInt>
 #include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <atomic>
+#include <memory>
 #include "eagle/core/RBAC.h"
 #include "eagle/core/EventBus.h"
 
@@ -14,30 +20,106 @@ namespace Eagle {
 namespace Core {
 
 /**
- * @brief 缓存项
+ * @brief 权限位集，第N位对应序号为N的权限
  */
-struct PermissionCacheEntry {
-    bool result;                    // 权限检查结果
-    QDateTime expireTime;           // 过期时间
-    QDateTime accessTime;            // 最后访问时间（用于LRU）
+struct PermissionBitset {
+    QVector<quint64> words;
     
-    PermissionCacheEntry()
-        : result(false)
-    {
+    bool test(int id) const {
+        int word = id >> 6;
+        return id >= 0 && word < words.size() && ((words.at(word) >> (id & 63)) & 1);
     }
     
-    PermissionCacheEntry(bool res, const QDateTime& expire)
-        : result(res), expireTime(expire), accessTime(QDateTime::currentDateTime())
-    {
+    void set(int id) {
+        int word = id >> 6;
+        if (word >= words.size()) {
+            words.resize(word + 1);
+        }
+        words[word] |= quint64(1) << (id & 63);
     }
     
-    bool isExpired() const {
-        return QDateTime::currentDateTime() > expireTime;
+    void unite(const PermissionBitset& other) {
+        if (other.words.size() > words.size()) {
+            words.resize(other.words.size());
+        }
+        for (int i = 0; i < other.words.size(); ++i) {
+            words[i] |= other.words.at(i);
+        }
     }
+};
+
+/**
+ * @brief 编译后的权限表，角色或权限变更时整体重建后替换
+ */
+struct CompiledPermissionTable {
+    quint64 epoch = 0;                             // 表版本，每次重建递增
+    QHash<QString, int> permissionIds;             // 权限名 -> 位序号，序号只增不复用
+    QHash<QString, PermissionBitset> roleBits;     // 角色 -> 有效权限（含所有祖先角色）
+    QVector<quint64> permissionEpochs;             // 位序号 -> 最近一次授予关系变化时的表版本
+};
+
+/**
+ * @brief 权限缓存分片数（2的幂）
+ */
+const int kPermissionCacheShardCount = 16;
+
+/**
+ * @brief 缓存项：用户编译后的有效权限
+ */
+struct PermissionCacheEntry {
+    QString userId;
+    PermissionBitset permissions;   // 用户的有效权限位集
+    quint64 epoch = 0;              // 编译时的权限表版本
+    qint64 expireMs = 0;            // 过期时间（clock毫秒）
+    mutable QAtomicInt referenced;  // CLOCK访问位，命中时在读锁下置位
+};
+
+/**
+ * @brief 权限缓存分片
+ */
+struct PermissionCacheShard {
+    QReadWriteLock lock;
+    QHash<QString, int> index;              // userId -> entries下标
+    QVector<PermissionCacheEntry> entries;
+    int hand = 0;                           // CLOCK指针
+    quint64 generation = 0;                 // 每次失效递增，丢弃失效前开始编译的结果
+};
+
+/**
+ * @brief 按用户分片的权限缓存，CLOCK淘汰
+ *
+ * 命中只在分片读锁下测试位并置访问位；插入和淘汰为O(1)。角色和权限变更不扫描缓存，
+ * 而是在权限表中标记受影响权限的版本，早于该版本编译的缓存项对这些权限视为未命中。
+ */
+class PermissionCache {
+public:
+    /**
+     * @brief 查找用户的权限
+     * @param generation 输出分片当前的失效计数，未命中后插入时传回
+     * @return 命中时返回true并写入granted
+     */
+    bool lookup(const QString& userId, int permissionId, const CompiledPermissionTable& table,
+                qint64 nowMs, bool* granted, quint64* generation) const;
+    
+    /**
+     * @brief 插入或替换用户的权限，查找之后分片发生过失效时放弃
+     */
+    void insert(const QString& userId, const PermissionBitset& permissions, quint64 epoch,
+                qint64 expireMs, quint64 generation, qint64 nowMs);
+    
+    bool removeUser(const QString& userId);
+    int clear();
+    int size(qint64 nowMs) const;
+    void setCapacity(int maxSize);
     
-    void updateAccessTime() {
-        accessTime = QDateTime::currentDateTime();
+private:
+    PermissionCacheShard& shardFor(const QString& userId) const {
+        return shards[qHash(userId) & (kPermissionCacheShardCount - 1)];
     }
+    static int evictSlot(PermissionCacheShard& shard, qint64 nowMs);
+    
+    mutable PermissionCacheShard shards[kPermissionCacheShardCount];
+    std::atomic<int> shardCapacity{(1000 + kPermissionCacheShardCount - 1) / kPermissionCacheShardCount};
 };
 
 class RBACManager::Private {
@@ -46,18 +128,47 @@ public:
     QMap<QString, Role> roles;
     QMap<QString, User> users;
     mutable QMutex mutex;
+    std::shared_ptr<const CompiledPermissionTable> compiled;  // 通过std::atomic_load读取，在mutex下重建
     
     // 权限缓存
-    QMap<QString, PermissionCacheEntry> permissionCache;  // key = "userId:permissionName"
-    bool cacheEnabled = true;                              // 是否启用缓存
-    int cacheMaxSize = 1000;                               // 最大缓存条目数
-    int cacheTTLSeconds = 300;                            // 缓存TTL（秒），默认5分钟
-    mutable QMutex cacheMutex;                             // 缓存专用互斥锁
+    PermissionCache permissionCache;                       // key = userId
+    std::atomic<bool> cacheEnabled{true};                  // 是否启用缓存
+    std::atomic<int> cacheMaxSize{1000};                   // 最大缓存条目数
+    std::atomic<int> cacheTTLSeconds{300};                 // 缓存TTL（秒），默认5分钟
+    QElapsedTimer clock;                                   // 缓存过期使用的单调时钟
     
     // 权限变更通知
     bool notificationEnabled = true;                       // 是否启用通知
     EventBus* eventBus = nullptr;                          // 事件总线
     QString currentOperatorId;                             // 当前操作者ID
+    
+    Private()
+        : compiled(std::make_shared<const CompiledPermissionTable>())
+    {
+        clock.start();
+    }
+    
+    std::shared_ptr<const CompiledPermissionTable> compiledTable() const { return std::atomic_load(&compiled); }
+    
+    /**
+     * @brief 重新分配权限序号并编译所有角色的有效权限（调用方需持有mutex）
+     *
+     * 任一角色的有效权限发生变化时，对应权限在新表中标记为已变化；
+     * changedPermission用于标记不经过角色的变化（如从用户直接权限中移除）。
+     */
+    void rebuildCompiledTable(const QString& changedPermission = QString());
+    
+    /**
+     * @brief 为用户直接权限中尚未分配序号的权限名分配序号（调用方需持有mutex）
+     *
+     * 只追加序号，不重新编译角色，表版本不变；没有新权限名时不发布新表。
+     */
+    void internPermissions(const QSet<QString>& names);
+    
+    /**
+     * @brief 编译用户的有效权限：直接权限 + 各角色的有效权限（调用方需持有mutex）
+     */
+    PermissionBitset compileUserPermissions(const User& user) const;
 };
 
 } // namespace Core
@@ -0,0 +1,171 @@
+#include "eagle/core/RateLimitCoordinator.h"
+#include "RateLimiterBackend_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QMutexLocker>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtNetwork/QLocalSocket>
+
+namespace Eagle {
+namespace Core {
+
+namespace {
+
+const qint64 kCoordinatorPruneIntervalMs = 60000;  // 空闲键清理间隔
+
+} // namespace
+
+void RateLimitCoordinatorPrivate::pruneIdle(qint64 nowMs)
+{
+    lastPruneMs = nowMs;
+    for (auto it = windows.begin(); it != windows.end();) {
+        if (nowMs - it->lastAccessMs > 2 * it->windowMs) {
+            it = windows.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+RateLimitCoordinator::RateLimitCoordinator(QObject* parent)
+    : QObject(parent)
+    , d_ptr(new RateLimitCoordinatorPrivate)
+{
+    d_ptr->clock.start();
+}
+
+RateLimitCoordinator::~RateLimitCoordinator()
+{
+    stop();
+    delete d_ptr;
+}
+
+bool RateLimitCoordinator::start(const QString& serverName)
+{
+    auto* d = d_func();
+    if (d->server && d->server->isListening()) {
+        return true;
+    }
+
+    if (!d->server) {
+        d->server = new QLocalServer(this);
+        connect(d->server, &QLocalServer::newConnection, this, &RateLimitCoordinator::onNewConnection);
+    }
+
+    // 清理上次异常退出残留的套接字文件
+    QLocalServer::removeServer(serverName);
+    if (!d->server->listen(serverName)) {
+        Logger::error("RateLimitCoordinator", QString("限流协调器启动失败: %1 - %2")
+            .arg(serverName, d->server->errorString()));
+        return false;
+    }
+
+    Logger::info("RateLimitCoordinator", QString("限流协调器已启动: %1").arg(serverName));
+    return true;
+}
+
+void RateLimitCoordinator::stop()
+{
+    auto* d = d_func();
+    if (d->server && d->server->isListening()) {
+        d->server->close();
+        Logger::info("RateLimitCoordinator", "限流协调器已停止");
+    }
+}
+
+bool RateLimitCoordinator::isRunning() const
+{
+    const auto* d = d_func();
+    return d->server && d->server->isListening();
+}
+
+QString RateLimitCoordinator::serverName() const
+{
+    const auto* d = d_func();
+    return d->server ? d->server->serverName() : QString();
+}
+
+QVariantMap RateLimitCoordinator::getStatistics() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+
+    QVariantMap stats;
+    stats["running"] = d->server && d->server->isListening();
+    stats["keys"] = d->windows.size();
+    stats["leaseRequests"] = d->leaseRequests;
+    stats["tokensGranted"] = d->tokensGranted;
+    stats["leasesDenied"] = d->leasesDenied;
+    return stats;
+}
+
+void RateLimitCoordinator::onNewConnection()
+{
+    auto* d = d_func();
+    while (QLocalSocket* socket = d->server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, &RateLimitCoordinator::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+    }
+}
+
+void RateLimitCoordinator::onReadyRead()
+{
+    auto* d = d_func();
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+
+    while (socket->canReadLine()) {
+        QJsonObject request = QJsonDocument::fromJson(socket->readLine().trimmed()).object();
+        QString op = request.value("op").toString();
+        QString key = request.value("key").toString();
+        qint64 capacity = qMax(1, request.value("max").toInt());
+        qint64 windowMs = qMax(1, request.value("windowMs").toInt());
+
+        qint64 now = d->clock.elapsed();
+        qint64 offset = now % windowMs;
+
+        QJsonObject reply;
+        {
+            QMutexLocker locker(&d->mutex);
+            if (now - d->lastPruneMs >= kCoordinatorPruneIntervalMs) {
+                d->pruneIdle(now);
+            }
+
+            CoordinatorWindow& window = d->windows[key];
+            if (window.windowMs != windowMs) {
+                window = CoordinatorWindow();
+                window.windowMs = windowMs;
+                window.counter.windowIndex = now / windowMs;
+            }
+            window.lastAccessMs = now;
+            window.counter.advance(now / windowMs);
+            qint64 available = window.counter.available(capacity, windowMs, offset);
+
+            if (op == "lease") {
+                qint64 granted = qMin<qint64>(qMax(1, request.value("count").toInt()), available);
+                window.counter.currentCount += granted;
+                d->leaseRequests++;
+                d->tokensGranted += granted;
+                if (granted == 0) {
+                    d->leasesDenied++;
+                }
+                reply["granted"] = static_cast<int>(granted);
+                // 租约在当前窗口结束时失效，避免跨窗口囤积配额
+                reply["ttlMs"] = static_cast<int>(windowMs - offset);
+            } else if (op == "remaining") {
+                reply["remaining"] = static_cast<int>(available);
+            } else if (op == "wait") {
+                reply["waitMs"] = static_cast<double>(window.counter.msUntilAvailable(capacity, windowMs, offset));
+            } else {
+                reply["error"] = QString("unknown op: %1").arg(op);
+            }
+        }
+
+        socket->write(QJsonDocument(reply).toJson(QJsonDocument::Compact) + '\n');
+    }
+}
+
+} // namespace Core
+} // namespace Eagle
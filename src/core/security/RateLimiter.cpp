@@ -6,117 +6,213 @@
 #include <QtCore/QTimer>
 #include <QtCore/QList>
 #include <algorithm>
+#include <limits>
 
 namespace Eagle {
 namespace Core {
 
-struct RateLimitRule {
-    int maxRequests;
-    int windowMs;
-    RateLimitAlgorithm algorithm;
-    QDateTime lastUpdate;
-    
-    RateLimitRule() 
-        : maxRequests(0)
-        , windowMs(0)
-        , algorithm(RateLimitAlgorithm::TokenBucket)
-    {
-        lastUpdate = QDateTime::currentDateTime();
-    }
-};
-
-struct TokenBucket {
-    int tokens;           // 当前令牌数
-    int capacity;          // 桶容量
-    QDateTime lastRefill;  // 上次补充时间
-    int refillRate;        // 补充速率（令牌/秒）
-    
-    // 默认构造函数（QMap需要）
-    TokenBucket()
-        : tokens(0)
-        , capacity(0)
-        , refillRate(0)
-    {
-        lastRefill = QDateTime::currentDateTime();
+namespace {
+
+const qint64 kNsPerMs = 1000000;
+const qint64 kIdleBucketTimeoutNs = 3600LL * 1000 * kNsPerMs;  // 1小时未访问的限流状态被清理
+
+/**
+ * @brief 前缀规则键（以"*"结尾）
+ */
+bool isPrefixKey(const QString& key)
+{
+    return key.endsWith(QLatin1Char('*'));
+}
+
+} // namespace
+
+bool RateLimitRuleTable::find(const QString& key, RateLimitRule& rule) const
+{
+    auto it = exact.constFind(key);
+    if (it != exact.constEnd()) {
+        rule = it.value();
+        return true;
     }
-    
-    TokenBucket(int maxRequests, int windowMs) 
-        : tokens(maxRequests)
-        , capacity(maxRequests)
-        , refillRate(maxRequests * 1000 / windowMs)  // 转换为令牌/秒
-    {
-        lastRefill = QDateTime::currentDateTime();
-    }
-    
-    bool consume() {
-        QDateTime now = QDateTime::currentDateTime();
-        qint64 elapsed = lastRefill.msecsTo(now);
-        
-        // 补充令牌
-        int tokensToAdd = (elapsed * refillRate) / 1000;
-        if (tokensToAdd > 0) {
-            tokens = qMin(capacity, tokens + tokensToAdd);
-            lastRefill = now;
-        }
-        
-        // 消费令牌
-        if (tokens > 0) {
-            tokens--;
+    for (const auto& prefixRule : prefixes) {
+        if (key.startsWith(prefixRule.first)) {
+            rule = prefixRule.second;
             return true;
         }
-        return false;
     }
-};
-
-struct SlidingWindow {
-    QList<QDateTime> requests;  // 请求时间列表
-    int maxRequests;
-    int windowMs;
-    
-    // 默认构造函数（QMap需要）
-    SlidingWindow()
-        : maxRequests(0)
-        , windowMs(0)
-    {}
-    
-    SlidingWindow(int maxRequests, int windowMs)
-        : maxRequests(maxRequests)
-        , windowMs(windowMs)
-    {}
-    
-    bool addRequest() {
-        QDateTime now = QDateTime::currentDateTime();
-        
-        // 移除窗口外的请求
-        while (!requests.isEmpty()) {
-            qint64 elapsed = requests.first().msecsTo(now);
-            if (elapsed < windowMs) {
-                break;
-            }
-            requests.removeFirst();
+    return false;
+}
+
+void RateLimitBucket::init(const RateLimitRule& rule, qint64 nowNs)
+{
+    algorithm = rule.algorithm;
+    capacity = qMax(1, rule.maxRequests);
+    windowNs = qMax<qint64>(1, qint64(rule.windowMs) * kNsPerMs);
+    // 保证 2 × capacity × windowNs 不溢出（滑动窗口计数的加权和上限）
+    windowNs = qMin(windowNs, std::numeric_limits<qint64>::max() / (2 * capacity));
+    tokens = capacity * windowNs;
+    lastRefillNs = nowNs;
+    windowStartNs = nowNs;
+    currentCount = 0;
+    previousCount = 0;
+    lastAccessNs = nowNs;
+    requests.clear();
+}
+
+void RateLimitBucket::refill(qint64 nowNs)
+{
+    switch (algorithm) {
+    case RateLimitAlgorithm::TokenBucket: {
+        // 空桶经过一个完整窗口即补满，超出部分无需计算，同时避免乘法溢出
+        qint64 elapsed = qMin(qMax<qint64>(0, nowNs - lastRefillNs), windowNs);
+        tokens = qMin(capacity * windowNs, tokens + elapsed * capacity);
+        break;
+    }
+    case RateLimitAlgorithm::SlidingWindow: {
+        qint64 windowsPassed = (nowNs - windowStartNs) / windowNs;
+        if (windowsPassed == 1) {
+            previousCount = currentCount;
+            currentCount = 0;
+        } else if (windowsPassed > 1) {
+            previousCount = 0;
+            currentCount = 0;
         }
-        
-        // 检查是否超过限制
-        if (requests.size() >= maxRequests) {
-            return false;
+        if (windowsPassed > 0) {
+            windowStartNs += windowsPassed * windowNs;
         }
-        
-        requests.append(now);
-        return true;
+        break;
+    }
+    case RateLimitAlgorithm::SlidingWindowExact:
+        while (!requests.empty() && requests.front() <= nowNs - windowNs) {
+            requests.pop_front();
+        }
+        break;
     }
-};
+    lastRefillNs = qMax(lastRefillNs, nowNs);
+}
 
-// Private类定义在RateLimiter_p.h中
+qint64 RateLimitBucket::weightedCount() const
+{
+    // 上一窗口按其与滑动窗口的重叠比例计入：prev × (window - offset) / window + cur
+    qint64 offset = qBound<qint64>(0, lastRefillNs - windowStartNs, windowNs);
+    return previousCount * (windowNs - offset) + currentCount * windowNs;
+}
+
+bool RateLimitBucket::available() const
+{
+    switch (algorithm) {
+    case RateLimitAlgorithm::TokenBucket:
+        return tokens >= windowNs;
+    case RateLimitAlgorithm::SlidingWindow:
+        return weightedCount() + windowNs <= capacity * windowNs;
+    case RateLimitAlgorithm::SlidingWindowExact:
+        break;
+    }
+    return static_cast<qint64>(requests.size()) < capacity;
+}
+
+void RateLimitBucket::consume(qint64 nowNs)
+{
+    switch (algorithm) {
+    case RateLimitAlgorithm::TokenBucket:
+        tokens -= windowNs;
+        break;
+    case RateLimitAlgorithm::SlidingWindow:
+        currentCount++;
+        break;
+    case RateLimitAlgorithm::SlidingWindowExact:
+        requests.push_back(nowNs);
+        break;
+    }
+}
+
+qint64 RateLimitBucket::remaining() const
+{
+    switch (algorithm) {
+    case RateLimitAlgorithm::TokenBucket:
+        return tokens / windowNs;
+    case RateLimitAlgorithm::SlidingWindow:
+        return qMax<qint64>(0, (capacity * windowNs - weightedCount()) / windowNs);
+    case RateLimitAlgorithm::SlidingWindowExact:
+        break;
+    }
+    return qMax<qint64>(0, capacity - static_cast<qint64>(requests.size()));
+}
+
+qint64 RateLimitBucket::nsUntilAvailable(qint64 nowNs) const
+{
+    if (available()) {
+        return 0;
+    }
+    switch (algorithm) {
+    case RateLimitAlgorithm::TokenBucket:
+        return (windowNs - tokens + capacity - 1) / capacity;
+    case RateLimitAlgorithm::SlidingWindow: {
+        qint64 excess = weightedCount() + windowNs - capacity * windowNs;
+        qint64 untilNextWindow = windowStartNs + windowNs - lastRefillNs;
+        if (currentCount < capacity && previousCount > 0) {
+            // 上一窗口的权重随时间线性衰减，在当前窗口结束前即可放行
+            return (excess + previousCount - 1) / previousCount;
+        }
+        // 当前窗口已满：等到下一窗口，此时当前窗口的计数成为衰减的上一窗口
+        qint64 nextExcess = currentCount * windowNs + windowNs - capacity * windowNs;
+        if (nextExcess <= 0 || currentCount == 0) {
+            return untilNextWindow;
+        }
+        return untilNextWindow + (nextExcess + currentCount - 1) / currentCount;
+    }
+    case RateLimitAlgorithm::SlidingWindowExact:
+        break;
+    }
+    return qMax<qint64>(0, requests.front() + windowNs - nowNs);
+}
+
+RateLimitBucket& RateLimiter::Private::bucketFor(RateLimitShard& shard, const QString& key,
+                                                 const RateLimitRule& rule, qint64 nowNs)
+{
+    auto it = shard.buckets.find(key);
+    if (it == shard.buckets.end()) {
+        RateLimitBucket bucket;
+        bucket.init(rule, nowNs);
+        it = shard.buckets.insert(key, bucket);
+    }
+    it->refill(nowNs);
+    it->lastAccessNs = nowNs;
+    return it.value();
+}
+
+void RateLimiter::Private::dropBuckets(const QString& key)
+{
+    if (!isPrefixKey(key)) {
+        RateLimitShard& shard = shardFor(key);
+        QMutexLocker locker(&shard.mutex);
+        shard.buckets.remove(key);
+        return;
+    }
+
+    QString prefix = key.left(key.size() - 1);
+    for (RateLimitShard& shard : shards) {
+        QMutexLocker locker(&shard.mutex);
+        for (auto it = shard.buckets.begin(); it != shard.buckets.end();) {
+            if (it.key().startsWith(prefix)) {
+                it = shard.buckets.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
 
 RateLimiter::RateLimiter(QObject* parent)
     : QObject(parent)
     , d(new RateLimiter::Private)
 {
+    d->clock.start();
+
     d->cleanupTimer = new QTimer(this);
     d->cleanupTimer->setInterval(60000);  // 每分钟清理一次
     connect(d->cleanupTimer, &QTimer::timeout, this, &RateLimiter::onCleanupTimer);
     d->cleanupTimer->start();
-    
+
     Logger::info("RateLimiter", "限流器初始化完成");
 }
 
@@ -128,208 +224,352 @@ RateLimiter::~RateLimiter()
 void RateLimiter::setLimit(const QString& key, int maxRequests, int windowMs, RateLimitAlgorithm algorithm)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    RateLimitRule rule;
-    rule.maxRequests = maxRequests;
-    rule.windowMs = windowMs;
-    rule.algorithm = algorithm;
-    rule.lastUpdate = QDateTime::currentDateTime();
-    
-    d->rules[key] = rule;
-    
-    // 初始化对应的数据结构
-    if (algorithm == RateLimitAlgorithm::TokenBucket) {
-        d->tokenBuckets[key] = TokenBucket(maxRequests, windowMs);
-    } else {
-        d->slidingWindows[key] = SlidingWindow(maxRequests, windowMs);
-    }
-    
+    {
+        QMutexLocker locker(&d->rulesMutex);
+
+        RateLimitRule rule;
+        rule.maxRequests = maxRequests;
+        rule.windowMs = windowMs;
+        rule.algorithm = algorithm;
+
+        auto table = std::make_shared<RateLimitRuleTable>(*d->ruleTable());
+        if (isPrefixKey(key)) {
+            QString prefix = key.left(key.size() - 1);
+            for (int i = 0; i < table->prefixes.size(); ++i) {
+                if (table->prefixes[i].first == prefix) {
+                    table->prefixes.removeAt(i);
+                    break;
+                }
+            }
+            table->prefixes.append(qMakePair(prefix, rule));
+            std::sort(table->prefixes.begin(), table->prefixes.end(),
+                      [](const QPair<QString, RateLimitRule>& a, const QPair<QString, RateLimitRule>& b) {
+                          return a.first.size() > b.first.size();
+                      });
+        } else {
+            table->exact.insert(key, rule);
+        }
+        std::atomic_store(&d->rules, std::shared_ptr<const RateLimitRuleTable>(table));
+    }
+
+    // 丢弃旧状态，下次访问时按新规则重建
+    d->dropBuckets(key);
+
     Logger::info("RateLimiter", QString("设置限流规则: %1 - %2次/%3ms").arg(key).arg(maxRequests).arg(windowMs));
 }
 
 void RateLimiter::removeLimit(const QString& key)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    d->rules.remove(key);
-    d->tokenBuckets.remove(key);
-    d->slidingWindows.remove(key);
-    
+    {
+        QMutexLocker locker(&d->rulesMutex);
+        auto table = std::make_shared<RateLimitRuleTable>(*d->ruleTable());
+        if (isPrefixKey(key)) {
+            QString prefix = key.left(key.size() - 1);
+            for (int i = 0; i < table->prefixes.size(); ++i) {
+                if (table->prefixes[i].first == prefix) {
+                    table->prefixes.removeAt(i);
+                    break;
+                }
+            }
+        } else {
+            table->exact.remove(key);
+        }
+        std::atomic_store(&d->rules, std::shared_ptr<const RateLimitRuleTable>(table));
+    }
+
+    d->dropBuckets(key);
+
     Logger::info("RateLimiter", QString("移除限流规则: %1").arg(key));
 }
 
 void RateLimiter::clearLimits()
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    d->rules.clear();
-    d->tokenBuckets.clear();
-    d->slidingWindows.clear();
-    
+    {
+        QMutexLocker locker(&d->rulesMutex);
+        std::atomic_store(&d->rules, std::make_shared<const RateLimitRuleTable>());
+    }
+
+    for (RateLimitShard& shard : d->shards) {
+        QMutexLocker locker(&shard.mutex);
+        shard.buckets.clear();
+    }
+
     Logger::info("RateLimiter", "清空所有限流规则");
 }
 
+bool RateLimiter::hasLimit(const QString& key) const
+{
+    const auto* d = d_func();
+    std::shared_ptr<const RateLimitRuleTable> table = d->ruleTable();
+    if (isPrefixKey(key)) {
+        QString prefix = key.left(key.size() - 1);
+        for (const auto& prefixRule : table->prefixes) {
+            if (prefixRule.first == prefix) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return table->exact.contains(key);
+}
+
 bool RateLimiter::allowRequest(const QString& key)
+{
+    return allowHierarchical(QStringList() << key);
+}
+
+bool RateLimiter::allowRequest(const QString& key, int maxRequests, int windowMs)
 {
     if (!isEnabled()) {
         return true;
     }
-    
+
+    // 临时限流检查（使用滑动窗口计数算法），已配置规则的键按规则检查
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->rules.contains(key)) {
-        return true;  // 没有限流规则，允许通过
+    RateLimitRule rule;
+    if (!d->ruleTable()->find(key, rule)) {
+        rule.maxRequests = maxRequests;
+        rule.windowMs = windowMs;
+        rule.algorithm = RateLimitAlgorithm::SlidingWindow;
+    }
+
+    // 后端无法为该键计数时回退到进程内计数
+    if (std::shared_ptr<RateLimiterBackend> backend = d->activeBackend()) {
+        RateLimitAcquireResult result = backend->tryAcquire(key, rule.maxRequests, rule.windowMs);
+        if (result != RateLimitAcquireResult::Unavailable) {
+            return result == RateLimitAcquireResult::Acquired;
+        }
     }
-    
-    const RateLimitRule& rule = d->rules[key];
-    
-    bool allowed = false;
-    if (rule.algorithm == RateLimitAlgorithm::TokenBucket) {
-        allowed = checkTokenBucket(key, rule.maxRequests, rule.windowMs);
-    } else {
-        allowed = checkSlidingWindow(key, rule.maxRequests, rule.windowMs);
-    }
-    
-    if (!allowed) {
-        emit rateLimitExceeded(key, rule.maxRequests, rule.windowMs);
-        Logger::warning("RateLimiter", QString("限流触发: %1 - %2次/%3ms").arg(key).arg(rule.maxRequests).arg(rule.windowMs));
-    }
-    
-    return allowed;
+
+    qint64 now = d->nowNs();
+    RateLimitShard& shard = d->shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    RateLimitBucket& bucket = d->bucketFor(shard, key, rule, now);
+    if (!bucket.available()) {
+        return false;
+    }
+    bucket.consume(now);
+    return true;
 }
 
-bool RateLimiter::allowRequest(const QString& key, int maxRequests, int windowMs)
+bool RateLimiter::allowHierarchical(const QStringList& keys)
 {
     if (!isEnabled()) {
         return true;
     }
-    
-    // 临时限流检查（使用滑动窗口算法）
+
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->slidingWindows.contains(key)) {
-        d->slidingWindows[key] = SlidingWindow(maxRequests, windowMs);
+    std::shared_ptr<const RateLimitRuleTable> table = d->ruleTable();
+
+    // 收集有规则的层级
+    QStringList limitedKeys;
+    QList<RateLimitRule> limitedRules;
+    for (const QString& key : keys) {
+        RateLimitRule rule;
+        if (!limitedKeys.contains(key) && table->find(key, rule)) {
+            limitedKeys.append(key);
+            limitedRules.append(rule);
+        }
+    }
+    if (limitedKeys.isEmpty()) {
+        return true;  // 没有限流规则，允许通过
+    }
+
+    // 跨进程后端：逐层获取，任一层拒绝时退还已获取的层级；
+    // 后端无法计数的层级（如共享计数表已满）留给下面的进程内计数
+    std::shared_ptr<RateLimiterBackend> backend = d->activeBackend();
+    QStringList backendKeys;
+    QList<RateLimitRule> backendRules;
+    if (backend) {
+        QStringList localKeys;
+        QList<RateLimitRule> localRules;
+        for (int i = 0; i < limitedKeys.size(); ++i) {
+            const RateLimitRule& rule = limitedRules[i];
+            RateLimitAcquireResult result = backend->tryAcquire(limitedKeys[i], rule.maxRequests, rule.windowMs);
+            if (result == RateLimitAcquireResult::Acquired) {
+                backendKeys.append(limitedKeys[i]);
+                backendRules.append(rule);
+                continue;
+            }
+            if (result == RateLimitAcquireResult::Unavailable) {
+                localKeys.append(limitedKeys[i]);
+                localRules.append(rule);
+                continue;
+            }
+            for (int j = backendKeys.size() - 1; j >= 0; --j) {
+                backend->release(backendKeys[j], backendRules[j].maxRequests, backendRules[j].windowMs);
+            }
+            emit rateLimitExceeded(limitedKeys[i], rule.maxRequests, rule.windowMs);
+            Logger::warning("RateLimiter", QString("限流触发: %1 - %2次/%3ms (%4)")
+                .arg(limitedKeys[i]).arg(rule.maxRequests).arg(rule.windowMs).arg(backend->name()));
+            return false;
+        }
+        if (localKeys.isEmpty()) {
+            return true;
+        }
+        limitedKeys = localKeys;
+        limitedRules = localRules;
+    }
+
+    int shardMask = 0;
+    for (const QString& key : limitedKeys) {
+        shardMask |= 1 << d->shardIndex(key);
+    }
+
+    // 按分片下标顺序加锁，避免多个调用之间死锁
+    for (int i = 0; i < kRateLimiterShardCount; ++i) {
+        if (shardMask & (1 << i)) {
+            d->shards[i].mutex.lock();
+        }
+    }
+
+    // 先创建并补充所有层级的状态，再逐层检查（插入可能导致同一分片的引用失效）
+    qint64 now = d->nowNs();
+    for (int i = 0; i < limitedKeys.size(); ++i) {
+        d->bucketFor(d->shardFor(limitedKeys[i]), limitedKeys[i], limitedRules[i], now);
+    }
+
+    int rejectedIndex = -1;
+    for (int i = 0; i < limitedKeys.size(); ++i) {
+        if (!d->shardFor(limitedKeys[i]).buckets.constFind(limitedKeys[i])->available()) {
+            rejectedIndex = i;
+            break;
+        }
     }
-    
-    return d->slidingWindows[key].addRequest();
+
+    if (rejectedIndex < 0) {
+        for (const QString& key : limitedKeys) {
+            d->shardFor(key).buckets.find(key)->consume(now);
+        }
+    }
+
+    for (int i = kRateLimiterShardCount - 1; i >= 0; --i) {
+        if (shardMask & (1 << i)) {
+            d->shards[i].mutex.unlock();
+        }
+    }
+
+    if (rejectedIndex >= 0) {
+        for (int j = backendKeys.size() - 1; j >= 0; --j) {
+            backend->release(backendKeys[j], backendRules[j].maxRequests, backendRules[j].windowMs);
+        }
+        const RateLimitRule& rule = limitedRules[rejectedIndex];
+        emit rateLimitExceeded(limitedKeys[rejectedIndex], rule.maxRequests, rule.windowMs);
+        Logger::warning("RateLimiter", QString("限流触发: %1 - %2次/%3ms")
+            .arg(limitedKeys[rejectedIndex]).arg(rule.maxRequests).arg(rule.windowMs));
+        return false;
+    }
+    return true;
 }
 
 int RateLimiter::getRemainingRequests(const QString& key) const
 {
-    const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->rules.contains(key)) {
+    auto* d = const_cast<RateLimiter::Private*>(d_func());
+    RateLimitRule rule;
+    if (!d->ruleTable()->find(key, rule)) {
         return -1;  // 无限制
     }
-    
-    const RateLimitRule& rule = d->rules[key];
-    
-    if (rule.algorithm == RateLimitAlgorithm::TokenBucket) {
-        if (d->tokenBuckets.contains(key)) {
-            return d->tokenBuckets[key].tokens;
-        }
-    } else {
-        if (d->slidingWindows.contains(key)) {
-            const SlidingWindow& window = d->slidingWindows[key];
-            return qMax(0, rule.maxRequests - window.requests.size());
+
+    if (std::shared_ptr<RateLimiterBackend> backend = d->activeBackend()) {
+        int remaining = backend->remaining(key, rule.maxRequests, rule.windowMs);
+        if (remaining >= 0) {
+            return remaining;
         }
     }
-    
-    return 0;
+
+    RateLimitShard& shard = d->shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    RateLimitBucket& bucket = d->bucketFor(shard, key, rule, d->nowNs());
+    return static_cast<int>(qMin<qint64>(bucket.remaining(), std::numeric_limits<int>::max()));
 }
 
 QDateTime RateLimiter::getResetTime(const QString& key) const
 {
-    const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->rules.contains(key)) {
+    auto* d = const_cast<RateLimiter::Private*>(d_func());
+    RateLimitRule rule;
+    if (!d->ruleTable()->find(key, rule)) {
         return QDateTime();
     }
-    
-    const RateLimitRule& rule = d->rules[key];
-    QDateTime resetTime = rule.lastUpdate.addMSecs(rule.windowMs);
-    
-    if (rule.algorithm == RateLimitAlgorithm::SlidingWindow) {
-        if (d->slidingWindows.contains(key)) {
-            const SlidingWindow& window = d->slidingWindows[key];
-            if (!window.requests.isEmpty()) {
-                resetTime = window.requests.first().addMSecs(rule.windowMs);
-            }
+
+    // 后端计数的键以后端状态为准，与allowRequest和getRemainingRequests一致
+    if (std::shared_ptr<RateLimiterBackend> backend = d->activeBackend()) {
+        qint64 waitMs = backend->msUntilAvailable(key, rule.maxRequests, rule.windowMs);
+        if (waitMs >= 0) {
+            return QDateTime::currentDateTime().addMSecs(waitMs);
         }
     }
-    
-    return resetTime;
+
+    qint64 now = d->nowNs();
+    RateLimitShard& shard = d->shardFor(key);
+    QMutexLocker locker(&shard.mutex);
+    RateLimitBucket& bucket = d->bucketFor(shard, key, rule, now);
+    qint64 waitMs = (bucket.nsUntilAvailable(now) + kNsPerMs - 1) / kNsPerMs;
+    return QDateTime::currentDateTime().addMSecs(waitMs);
 }
 
 void RateLimiter::setEnabled(bool enabled)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    d->enabled = enabled;
+    d->enabled.store(enabled);
     Logger::info("RateLimiter", QString("限流器%1").arg(enabled ? "启用" : "禁用"));
 }
 
 bool RateLimiter::isEnabled() const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    return d->enabled;
+    return d->enabled.load(std::memory_order_relaxed);
 }
 
-void RateLimiter::onCleanupTimer()
+void RateLimiter::setBackend(RateLimiterBackend* backend)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    QDateTime now = QDateTime::currentDateTime();
-    QStringList keysToRemove;
-    
-    // 清理长时间未使用的限流规则（超过1小时）
-    for (auto it = d->rules.begin(); it != d->rules.end(); ++it) {
-        qint64 elapsed = it.value().lastUpdate.msecsTo(now);
-        if (elapsed > 3600000) {  // 1小时
-            keysToRemove.append(it.key());
-        }
-    }
-    
-    for (const QString& key : keysToRemove) {
-        d->rules.remove(key);
-        d->tokenBuckets.remove(key);
-        d->slidingWindows.remove(key);
-    }
-    
-    if (!keysToRemove.isEmpty()) {
-        Logger::debug("RateLimiter", QString("清理了 %1 个过期限流规则").arg(keysToRemove.size()));
+    std::shared_ptr<RateLimiterBackend> shared;
+    if (backend) {
+        backend->setParent(nullptr);
+        // 其他线程可能仍持有旧后端的引用，延迟到引用全部释放后删除
+        shared = std::shared_ptr<RateLimiterBackend>(backend, [](RateLimiterBackend* b) { b->deleteLater(); });
     }
+    std::atomic_store(&d->backend, shared);
+
+    Logger::info("RateLimiter", QString("限流计数后端: %1").arg(backend ? backend->name() : QString("local")));
 }
 
-bool RateLimiter::checkTokenBucket(const QString& key, int maxRequests, int windowMs)
+RateLimiterBackend* RateLimiter::backend() const
 {
-    auto* d = d_func();
-    
-    if (!d->tokenBuckets.contains(key)) {
-        d->tokenBuckets[key] = TokenBucket(maxRequests, windowMs);
-    }
-    
-    return d->tokenBuckets[key].consume();
+    const auto* d = d_func();
+    return std::atomic_load(&d->backend).get();
 }
 
-bool RateLimiter::checkSlidingWindow(const QString& key, int maxRequests, int windowMs)
+std::shared_ptr<RateLimiterBackend> RateLimiter::Private::activeBackend() const
+{
+    std::shared_ptr<RateLimiterBackend> current = std::atomic_load(&backend);
+    return current && current->isAvailable() ? current : nullptr;
+}
+
+void RateLimiter::onCleanupTimer()
 {
     auto* d = d_func();
-    
-    if (!d->slidingWindows.contains(key)) {
-        d->slidingWindows[key] = SlidingWindow(maxRequests, windowMs);
+    qint64 now = d->nowNs();
+    int removed = 0;
+
+    // 清理长时间未访问的限流状态（规则本身保留）
+    for (RateLimitShard& shard : d->shards) {
+        QMutexLocker locker(&shard.mutex);
+        for (auto it = shard.buckets.begin(); it != shard.buckets.end();) {
+            if (now - it->lastAccessNs > kIdleBucketTimeoutNs) {
+                it = shard.buckets.erase(it);
+                removed++;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (removed > 0) {
+        Logger::debug("RateLimiter", QString("清理了 %1 个过期限流状态").arg(removed));
     }
-    
-    return d->slidingWindows[key].addRequest();
 }
 
 } // namespace Core
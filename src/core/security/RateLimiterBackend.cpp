@@ -0,0 +1,519 @@
+#include "eagle/core/RateLimiterBackend.h"
+#include "RateLimiterBackend_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QSharedMemory>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtNetwork/QLocalSocket>
+
+namespace Eagle {
+namespace Core {
+
+namespace {
+
+/**
+ * @brief 跨进程稳定的64位键哈希（FNV-1a + splitmix64终结），不使用带进程随机种子的qHash
+ */
+quint64 stableKeyHash(const QString& key, int windowMs)
+{
+    QByteArray bytes = key.toUtf8();
+    bytes.append('\n');
+    bytes.append(QByteArray::number(windowMs));
+
+    quint64 hash = 14695981039346656037ULL;
+    for (char c : bytes) {
+        hash ^= static_cast<quint8>(c);
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash ? hash : 1;
+}
+
+quint64 packState(qint64 windowIndex, qint64 previousCount, qint64 currentCount)
+{
+    const quint64 indexMask = (1ULL << kSharedWindowIndexBits) - 1;
+    return ((static_cast<quint64>(windowIndex) & indexMask) << (2 * kSharedCountBits))
+         | (static_cast<quint64>(previousCount) << kSharedCountBits)
+         | static_cast<quint64>(currentCount);
+}
+
+/**
+ * @brief 解包槽位状态并滚动到 windowIndex 所在窗口
+ */
+SlidingWindowCounter unpackState(quint64 state, qint64 windowIndex)
+{
+    const quint64 indexMask = (1ULL << kSharedWindowIndexBits) - 1;
+    SlidingWindowCounter counter;
+    counter.currentCount = static_cast<qint64>(state & kSharedMaxCount);
+    counter.previousCount = static_cast<qint64>((state >> kSharedCountBits) & kSharedMaxCount);
+
+    // 窗口序号只保存低24位，按模差值判断是否相邻
+    quint64 storedIndex = state >> (2 * kSharedCountBits);
+    quint64 distance = (static_cast<quint64>(windowIndex) - storedIndex) & indexMask;
+    counter.windowIndex = windowIndex - static_cast<qint64>(distance);
+    counter.advance(windowIndex);
+    return counter;
+}
+
+/**
+ * @brief 槽位是否空闲：窗口序号落后两个窗口以上（按24位模差值判断）
+ */
+bool isIdleSlot(const SharedRateLimitSlot& slot, qint64 nowMs)
+{
+    qint64 windowMs = slot.windowMs.load(std::memory_order_acquire);
+    if (windowMs <= 0) {
+        return false;
+    }
+
+    const quint64 indexMask = (1ULL << kSharedWindowIndexBits) - 1;
+    quint64 storedIndex = slot.state.load(std::memory_order_acquire) >> (2 * kSharedCountBits);
+    quint64 distance = (static_cast<quint64>(nowMs / windowMs) - storedIndex) & indexMask;
+    return distance >= 2;
+}
+
+} // namespace
+
+/**
+ * @brief 共享内存限流后端实现
+ */
+class SharedMemoryRateLimiterBackend : public RateLimiterBackend {
+public:
+    SharedMemoryRateLimiterBackend(const QString& segmentKey, QObject* parent)
+        : RateLimiterBackend(parent)
+        , sharedMemory(segmentKey)
+        , segment(nullptr)
+        , tableFullWarned(false)
+        , slotsReclaimed(0)
+        , tableFullCount(0)
+    {
+        if (!sharedMemory.attach()) {
+            if (!sharedMemory.create(sizeof(SharedRateLimitSegment))
+                && !(sharedMemory.error() == QSharedMemory::AlreadyExists && sharedMemory.attach())) {
+                Logger::error("RateLimiterBackend", QString("无法创建或连接共享内存段 %1: %2")
+                    .arg(segmentKey, sharedMemory.errorString()));
+                return;
+            }
+        }
+        if (sharedMemory.size() < static_cast<int>(sizeof(SharedRateLimitSegment))) {
+            Logger::error("RateLimiterBackend", QString("共享内存段 %1 大小不匹配").arg(segmentKey));
+            sharedMemory.detach();
+            return;
+        }
+
+        segment = static_cast<SharedRateLimitSegment*>(sharedMemory.data());
+        sharedMemory.lock();
+        if (segment->magic.load() != kSharedRateLimitMagic) {
+            segment->slotCount = kSharedRateLimitSlots;
+            segment->magic.store(kSharedRateLimitMagic);
+        }
+        sharedMemory.unlock();
+
+        Logger::info("RateLimiterBackend", QString("共享内存限流后端已连接: %1").arg(segmentKey));
+    }
+
+    QString name() const override {
+        return "shared_memory";
+    }
+
+    bool isAvailable() const override {
+        return segment != nullptr;
+    }
+
+    RateLimitAcquireResult tryAcquire(const QString& key, int maxRequests, int windowMs) override {
+        SharedRateLimitSlot* slot = findSlot(key, windowMs, true);
+        if (!slot) {
+            return RateLimitAcquireResult::Unavailable;  // 计数表已满，由进程内计数兜底
+        }
+
+        qint64 capacity = qBound<qint64>(1, maxRequests, kSharedMaxCount);
+        qint64 window = qMax(1, windowMs);
+        qint64 now = QElapsedTimer::msecsSinceReference();
+        qint64 index = now / window;
+        qint64 offset = now % window;
+
+        quint64 expected = slot->state.load(std::memory_order_acquire);
+        for (;;) {
+            SlidingWindowCounter counter = unpackState(expected, index);
+            if (counter.available(capacity, window, offset) <= 0) {
+                return RateLimitAcquireResult::Rejected;
+            }
+            quint64 desired = packState(index, counter.previousCount, counter.currentCount + 1);
+            if (slot->state.compare_exchange_weak(expected, desired, std::memory_order_acq_rel)) {
+                return RateLimitAcquireResult::Acquired;
+            }
+        }
+    }
+
+    void release(const QString& key, int maxRequests, int windowMs) override {
+        Q_UNUSED(maxRequests);
+        SharedRateLimitSlot* slot = findSlot(key, windowMs, false);
+        if (!slot) {
+            return;
+        }
+
+        qint64 index = QElapsedTimer::msecsSinceReference() / qMax(1, windowMs);
+        quint64 expected = slot->state.load(std::memory_order_acquire);
+        for (;;) {
+            // 已进入新窗口时无需退还
+            if ((expected >> (2 * kSharedCountBits)) != (packState(index, 0, 0) >> (2 * kSharedCountBits))) {
+                return;
+            }
+            SlidingWindowCounter counter = unpackState(expected, index);
+            if (counter.currentCount == 0) {
+                return;
+            }
+            quint64 desired = packState(index, counter.previousCount, counter.currentCount - 1);
+            if (slot->state.compare_exchange_weak(expected, desired, std::memory_order_acq_rel)) {
+                return;
+            }
+        }
+    }
+
+    int remaining(const QString& key, int maxRequests, int windowMs) override {
+        qint64 capacity = qBound<qint64>(1, maxRequests, kSharedMaxCount);
+        SharedRateLimitSlot* slot = findSlot(key, windowMs, false);
+        if (!slot) {
+            return static_cast<int>(capacity);
+        }
+
+        qint64 window = qMax(1, windowMs);
+        qint64 now = QElapsedTimer::msecsSinceReference();
+        SlidingWindowCounter counter = unpackState(slot->state.load(std::memory_order_acquire), now / window);
+        return static_cast<int>(counter.available(capacity, window, now % window));
+    }
+
+    qint64 msUntilAvailable(const QString& key, int maxRequests, int windowMs) override {
+        SharedRateLimitSlot* slot = findSlot(key, windowMs, false);
+        if (!slot) {
+            return -1;  // 键不在计数表中（可能因表满由进程内计数），由进程内状态计算
+        }
+
+        qint64 capacity = qBound<qint64>(1, maxRequests, kSharedMaxCount);
+        qint64 window = qMax(1, windowMs);
+        qint64 now = QElapsedTimer::msecsSinceReference();
+        SlidingWindowCounter counter = unpackState(slot->state.load(std::memory_order_acquire), now / window);
+        return counter.msUntilAvailable(capacity, window, now % window);
+    }
+
+    QVariantMap getStatistics() const override {
+        QVariantMap stats;
+        stats["backend"] = name();
+        stats["segmentKey"] = sharedMemory.key();
+        stats["available"] = isAvailable();
+        if (segment) {
+            int used = 0;
+            for (int i = 0; i < kSharedRateLimitSlots; ++i) {
+                if (segment->slots[i].keyHash.load(std::memory_order_relaxed) != 0) {
+                    used++;
+                }
+            }
+            stats["slotsUsed"] = used;
+            stats["slotsTotal"] = kSharedRateLimitSlots;
+            stats["slotsReclaimed"] = slotsReclaimed.load();
+            stats["tableFull"] = tableFullCount.load();
+        }
+        return stats;
+    }
+
+private:
+    /**
+     * @brief 线性探测查找键所在槽位，create为true时占用空槽或复用空闲槽位
+     *
+     * 空闲槽位原地改写为新键而不是清零，探测链中不会出现空洞，
+     * 链上后面的键仍能被找到。
+     */
+    SharedRateLimitSlot* findSlot(const QString& key, int windowMs, bool create) {
+        if (!segment) {
+            return nullptr;
+        }
+
+        quint64 hash = stableKeyHash(key, windowMs);
+        qint64 nowMs = QElapsedTimer::msecsSinceReference();
+        int start = static_cast<int>(hash & (kSharedRateLimitSlots - 1));
+        SharedRateLimitSlot* idle = nullptr;
+        quint64 idleHash = 0;
+        for (int probe = 0; probe < kSharedRateLimitSlots; ++probe) {
+            SharedRateLimitSlot& slot = segment->slots[(start + probe) & (kSharedRateLimitSlots - 1)];
+            quint64 current = slot.keyHash.load(std::memory_order_acquire);
+            if (current == hash) {
+                return &slot;
+            }
+            if (current == 0) {
+                break;  // 探测链结束，键不存在
+            }
+            if (create && !idle && isIdleSlot(slot, nowMs)) {
+                idle = &slot;
+                idleHash = current;
+            }
+        }
+        if (!create) {
+            return nullptr;
+        }
+
+        // 优先复用链上第一个空闲槽位，其次占用链尾的空槽
+        if (idle && claimSlot(*idle, idleHash, hash, windowMs, nowMs)) {
+            slotsReclaimed++;
+            return idle;
+        }
+        for (int probe = 0; probe < kSharedRateLimitSlots; ++probe) {
+            SharedRateLimitSlot& slot = segment->slots[(start + probe) & (kSharedRateLimitSlots - 1)];
+            quint64 current = slot.keyHash.load(std::memory_order_acquire);
+            if (current == hash) {
+                return &slot;
+            }
+            if (current == 0 && claimSlot(slot, 0, hash, windowMs, nowMs)) {
+                return &slot;
+            }
+            if (slot.keyHash.load(std::memory_order_acquire) == hash) {
+                return &slot;  // 其他进程同时占用了该槽位
+            }
+        }
+
+        tableFullCount++;
+        if (!tableFullWarned.exchange(true)) {
+            Logger::warning("RateLimiterBackend", "共享限流计数表已满，新键回退到进程内限流");
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief 将槽位从 expectedHash 改写为 hash 并重置计数
+     *
+     * 原键恰好在改写期间回来时，其一次计数可能落到新键上，
+     * 原键已空闲两个窗口以上，这一误差可以接受。
+     */
+    static bool claimSlot(SharedRateLimitSlot& slot, quint64 expectedHash, quint64 hash,
+                          int windowMs, qint64 nowMs) {
+        if (!slot.keyHash.compare_exchange_strong(expectedHash, hash, std::memory_order_acq_rel)) {
+            return false;
+        }
+        qint64 window = qMax(1, windowMs);
+        slot.windowMs.store(0, std::memory_order_release);
+        slot.state.store(packState(nowMs / window, 0, 0), std::memory_order_release);
+        slot.windowMs.store(window, std::memory_order_release);
+        return true;
+    }
+
+    QSharedMemory sharedMemory;
+    SharedRateLimitSegment* segment;
+    std::atomic<bool> tableFullWarned;
+    std::atomic<qint64> slotsReclaimed;
+    std::atomic<qint64> tableFullCount;
+};
+
+/**
+ * @brief 本地协调器限流后端实现
+ */
+class LocalBrokerRateLimiterBackend : public RateLimiterBackend {
+public:
+    LocalBrokerRateLimiterBackend(const QString& serverName, int leaseBatch, int timeoutMs, QObject* parent)
+        : RateLimiterBackend(parent)
+        , serverName(serverName)
+        , leaseBatch(qMax(1, leaseBatch))
+        , timeoutMs(qMax(1, timeoutMs))
+        , retryAfterNs(0)
+        , leaseRequests(0)
+        , leaseFailures(0)
+    {
+        clock.start();
+    }
+
+    QString name() const override {
+        return "local_broker";
+    }
+
+    bool isAvailable() const override {
+        // 通信失败后暂停一段时间再重试，期间由进程内计数兜底
+        return clock.nsecsElapsed() >= retryAfterNs.load(std::memory_order_relaxed);
+    }
+
+    RateLimitAcquireResult tryAcquire(const QString& key, int maxRequests, int windowMs) override {
+        qint64 now = clock.nsecsElapsed();
+        {
+            QMutexLocker locker(&mutex);
+            auto it = leases.find(key);
+            if (it != leases.end() && it->tokens > 0 && it->expiresNs > now) {
+                it->tokens--;
+                return RateLimitAcquireResult::Acquired;
+            }
+        }
+
+        // 小限额时缩小批量，避免单个进程租走整个窗口的配额
+        int batch = qMin(leaseBatch, qMax(1, maxRequests / 10));
+        QJsonObject request;
+        request["op"] = "lease";
+        request["key"] = key;
+        request["max"] = maxRequests;
+        request["windowMs"] = windowMs;
+        request["count"] = batch;
+
+        QJsonObject reply;
+        if (!exchange(request, reply)) {
+            return RateLimitAcquireResult::Unavailable;  // 协调器不可用，回退到进程内计数
+        }
+
+        int granted = reply.value("granted").toInt();
+        qint64 ttlNs = qint64(reply.value("ttlMs").toInt()) * 1000000;
+        if (granted <= 0) {
+            return RateLimitAcquireResult::Rejected;
+        }
+
+        QMutexLocker locker(&mutex);
+        Lease& lease = leases[key];
+        lease.tokens = granted - 1;
+        lease.expiresNs = now + ttlNs;
+        return RateLimitAcquireResult::Acquired;
+    }
+
+    void release(const QString& key, int maxRequests, int windowMs) override {
+        Q_UNUSED(maxRequests);
+        Q_UNUSED(windowMs);
+        // 退还到本地租约，不额外访问协调器
+        QMutexLocker locker(&mutex);
+        auto it = leases.find(key);
+        if (it != leases.end() && it->expiresNs > clock.nsecsElapsed()) {
+            it->tokens++;
+        }
+    }
+
+    int remaining(const QString& key, int maxRequests, int windowMs) override {
+        QJsonObject request;
+        request["op"] = "remaining";
+        request["key"] = key;
+        request["max"] = maxRequests;
+        request["windowMs"] = windowMs;
+
+        QJsonObject reply;
+        if (!exchange(request, reply)) {
+            return -1;
+        }
+
+        int local = 0;
+        {
+            QMutexLocker locker(&mutex);
+            auto it = leases.constFind(key);
+            if (it != leases.constEnd() && it->expiresNs > clock.nsecsElapsed()) {
+                local = it->tokens;
+            }
+        }
+        return reply.value("remaining").toInt() + local;
+    }
+
+    qint64 msUntilAvailable(const QString& key, int maxRequests, int windowMs) override {
+        {
+            QMutexLocker locker(&mutex);
+            auto it = leases.constFind(key);
+            if (it != leases.constEnd() && it->tokens > 0 && it->expiresNs > clock.nsecsElapsed()) {
+                return 0;  // 本地租约还有配额
+            }
+        }
+
+        QJsonObject request;
+        request["op"] = "wait";
+        request["key"] = key;
+        request["max"] = maxRequests;
+        request["windowMs"] = windowMs;
+
+        QJsonObject reply;
+        if (!exchange(request, reply) || !reply.contains("waitMs")) {
+            return -1;
+        }
+        return static_cast<qint64>(reply.value("waitMs").toDouble());
+    }
+
+    QVariantMap getStatistics() const override {
+        QVariantMap stats;
+        stats["backend"] = name();
+        stats["serverName"] = serverName;
+        stats["available"] = isAvailable();
+        stats["leaseBatch"] = leaseBatch;
+        stats["leaseRequests"] = leaseRequests.load();
+        stats["leaseFailures"] = leaseFailures.load();
+        QMutexLocker locker(&mutex);
+        stats["leasedKeys"] = leases.size();
+        return stats;
+    }
+
+private:
+    struct Lease {
+        int tokens = 0;
+        qint64 expiresNs = 0;
+    };
+
+    /**
+     * @brief 同步发送一行请求并读取一行应答
+     *
+     * 每个线程持有独立的连接，阻塞调用无需事件循环，也不与其他线程争用套接字。
+     */
+    bool exchange(const QJsonObject& request, QJsonObject& reply) {
+        leaseRequests++;
+
+        QLocalSocket* socket = sockets.localData();
+        if (!socket) {
+            socket = new QLocalSocket;
+            sockets.setLocalData(socket);
+        }
+        if (socket->state() != QLocalSocket::ConnectedState) {
+            socket->connectToServer(serverName);
+            if (!socket->waitForConnected(timeoutMs)) {
+                return fail(socket->errorString());
+            }
+        }
+
+        socket->write(QJsonDocument(request).toJson(QJsonDocument::Compact) + '\n');
+        if (!socket->waitForBytesWritten(timeoutMs)) {
+            return fail(socket->errorString());
+        }
+        while (!socket->canReadLine()) {
+            if (!socket->waitForReadyRead(timeoutMs)) {
+                return fail(socket->errorString());
+            }
+        }
+
+        reply = QJsonDocument::fromJson(socket->readLine().trimmed()).object();
+        return !reply.isEmpty() || fail("无效的协调器应答");
+    }
+
+    bool fail(const QString& error) {
+        leaseFailures++;
+        QLocalSocket* socket = sockets.localData();
+        if (socket) {
+            socket->abort();
+        }
+        retryAfterNs.store(clock.nsecsElapsed() + 5000LL * 1000000, std::memory_order_relaxed);
+        Logger::warning("RateLimiterBackend", QString("限流协调器 %1 通信失败: %2，5秒内回退到进程内限流")
+            .arg(serverName, error));
+        return false;
+    }
+
+    QString serverName;
+    int leaseBatch;
+    int timeoutMs;
+    QElapsedTimer clock;
+    std::atomic<qint64> retryAfterNs;
+    std::atomic<qint64> leaseRequests;
+    std::atomic<qint64> leaseFailures;
+    QHash<QString, Lease> leases;
+    mutable QMutex mutex;
+    QThreadStorage<QLocalSocket*> sockets;
+};
+
+RateLimiterBackend* SharedMemoryRateLimiterBackendFactory::create(const QString& segmentKey, QObject* parent)
+{
+    return new SharedMemoryRateLimiterBackend(segmentKey, parent);
+}
+
+RateLimiterBackend* LocalBrokerRateLimiterBackendFactory::create(const QString& serverName, int leaseBatch,
+                                                                 int timeoutMs, QObject* parent)
+{
+    return new LocalBrokerRateLimiterBackend(serverName, leaseBatch, timeoutMs, parent);
+}
+
+} // namespace Core
+} // namespace Eagle
@@ -0,0 +1,130 @@
+#ifndef RATELIMITERBACKEND_P_H
+#define RATELIMITERBACKEND_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QElapsedTimer>
+#include <QtNetwork/QLocalServer>
+#include "eagle/core/RateLimiterBackend.h"
+#include <atomic>
+
+namespace Eagle {
+namespace Core {
+
+const quint32 kSharedRateLimitMagic = 0x45524C32;    // "ERL2"
+const int kSharedRateLimitSlots = 4096;               // 共享计数表槽位数（2的幂）
+const int kSharedWindowIndexBits = 24;
+const int kSharedCountBits = 20;
+const qint64 kSharedMaxCount = (1 << kSharedCountBits) - 1;
+
+/**
+ * @brief 共享内存中的单个计数槽
+ *
+ * state 打包为 [窗口序号:24][上一窗口计数:20][当前窗口计数:20]，
+ * 窗口滚动与计数递增在一次CAS内完成。windowMs 用于判断槽位是否空闲：
+ * 窗口序号落后两个窗口以上时计数已归零，槽位可由其他键原地复用。
+ */
+struct SharedRateLimitSlot {
+    std::atomic<quint64> keyHash;     // 0表示空槽
+    std::atomic<quint64> state;
+    std::atomic<qint64> windowMs;     // 0表示刚被占用、尚未写入
+};
+
+/**
+ * @brief 共享内存段布局（操作系统分配时已清零）
+ */
+struct SharedRateLimitSegment {
+    std::atomic<quint32> magic;
+    quint32 slotCount;
+    SharedRateLimitSlot slots[kSharedRateLimitSlots];
+};
+
+static_assert(std::atomic<quint64>::is_always_lock_free, "共享内存计数需要无锁的64位原子操作");
+
+/**
+ * @brief 滑动窗口计数（相邻两个固定窗口加权），时间单位为毫秒
+ */
+struct SlidingWindowCounter {
+    qint64 windowIndex = 0;
+    qint64 previousCount = 0;
+    qint64 currentCount = 0;
+
+    /**
+     * @brief 滚动到 windowIndex 所在窗口
+     */
+    void advance(qint64 index)
+    {
+        if (index == windowIndex + 1) {
+            previousCount = currentCount;
+            currentCount = 0;
+        } else if (index != windowIndex) {
+            previousCount = 0;
+            currentCount = 0;
+        }
+        windowIndex = index;
+    }
+
+    /**
+     * @brief 窗口内剩余可用请求数
+     */
+    qint64 available(qint64 capacity, qint64 windowMs, qint64 offsetMs) const
+    {
+        qint64 weighted = previousCount * (windowMs - offsetMs) + currentCount * windowMs;
+        return qMax<qint64>(0, (capacity * windowMs - weighted) / windowMs);
+    }
+
+    /**
+     * @brief 距离下一次可用的毫秒数（与进程内滑动窗口计数的估算一致）
+     */
+    qint64 msUntilAvailable(qint64 capacity, qint64 windowMs, qint64 offsetMs) const
+    {
+        qint64 weighted = previousCount * (windowMs - offsetMs) + currentCount * windowMs;
+        qint64 excess = weighted + windowMs - capacity * windowMs;
+        if (excess <= 0) {
+            return 0;
+        }
+        if (currentCount < capacity && previousCount > 0) {
+            // 上一窗口的权重随时间线性衰减，在当前窗口结束前即可放行
+            return (excess + previousCount - 1) / previousCount;
+        }
+        // 当前窗口已满：等到下一窗口，此时当前窗口的计数成为衰减的上一窗口
+        qint64 untilNextWindow = windowMs - offsetMs;
+        qint64 nextExcess = currentCount * windowMs + windowMs - capacity * windowMs;
+        if (nextExcess <= 0 || currentCount == 0) {
+            return untilNextWindow;
+        }
+        return untilNextWindow + (nextExcess + currentCount - 1) / currentCount;
+    }
+};
+
+/**
+ * @brief 协调器中单个键的计数状态
+ */
+struct CoordinatorWindow {
+    qint64 windowMs = 0;
+    qint64 lastAccessMs = 0;
+    SlidingWindowCounter counter;
+};
+
+class RateLimitCoordinatorPrivate {
+public:
+    QLocalServer* server = nullptr;
+    QHash<QString, CoordinatorWindow> windows;
+    mutable QMutex mutex;
+    QElapsedTimer clock;
+    qint64 leaseRequests = 0;
+    qint64 tokensGranted = 0;
+    qint64 leasesDenied = 0;
+    qint64 lastPruneMs = 0;
+
+    /**
+     * @brief 清理超过两个窗口未访问的键（计数已归零），调用方需持有mutex
+     */
+    void pruneIdle(qint64 nowMs);
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // RATELIMITERBACKEND_P_H
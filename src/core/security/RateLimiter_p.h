@@ -2,29 +2,106 @@
 #define RATELIMITER_P_H
 
 #include <QtCore/QString>
-#include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QPair>
 #include <QtCore/QMutex>
 #include <QtCore/QTimer>
-#include <QtCore/QDateTime>
-#include <QtCore/QList>
+#include <QtCore/QElapsedTimer>
 #include "eagle/core/RateLimiter.h"
+#include "eagle/core/RateLimiterBackend.h"
+#include <atomic>
+#include <deque>
+#include <memory>
 
 namespace Eagle {
 namespace Core {
 
-// 前向声明
-struct RateLimitRule;
-struct TokenBucket;
-struct SlidingWindow;
+const int kRateLimiterShardCount = 16;   // 分片数（2的幂）
+
+/**
+ * @brief 限流规则
+ */
+struct RateLimitRule {
+    int maxRequests = 0;
+    int windowMs = 0;
+    RateLimitAlgorithm algorithm = RateLimitAlgorithm::SlidingWindow;
+};
+
+/**
+ * @brief 限流规则表（写时复制，读取方无锁）
+ */
+struct RateLimitRuleTable {
+    QHash<QString, RateLimitRule> exact;                 // 精确匹配规则
+    QList<QPair<QString, RateLimitRule>> prefixes;       // 前缀规则，按前缀长度降序
+
+    bool find(const QString& key, RateLimitRule& rule) const;
+};
+
+/**
+ * @brief 单个键的限流状态
+ */
+struct RateLimitBucket {
+    RateLimitAlgorithm algorithm = RateLimitAlgorithm::SlidingWindow;
+    qint64 capacity = 0;             // 窗口内最大请求数
+    qint64 windowNs = 0;             // 窗口长度（纳秒）
+    qint64 tokens = 0;               // 令牌桶：令牌数 × windowNs（定点数）
+    qint64 lastRefillNs = 0;
+    qint64 windowStartNs = 0;        // 滑动窗口计数：当前固定窗口起点
+    qint64 currentCount = 0;         // 滑动窗口计数：当前固定窗口内请求数
+    qint64 previousCount = 0;        // 滑动窗口计数：上一个固定窗口内请求数
+    std::deque<qint64> requests;     // 精确滑动窗口：窗口内请求时间（纳秒）
+    qint64 lastAccessNs = 0;
+
+    qint64 weightedCount() const;    // 滑动窗口计数：估算请求数 × windowNs
+
+    void init(const RateLimitRule& rule, qint64 nowNs);
+    void refill(qint64 nowNs);
+    bool available() const;
+    void consume(qint64 nowNs);
+    qint64 remaining() const;
+    qint64 nsUntilAvailable(qint64 nowNs) const;
+};
+
+/**
+ * @brief 限流状态分片
+ */
+struct RateLimitShard {
+    QHash<QString, RateLimitBucket> buckets;
+    QMutex mutex;
+};
 
 class RateLimiter::Private {
 public:
-    QMap<QString, RateLimitRule> rules;
-    QMap<QString, TokenBucket> tokenBuckets;
-    QMap<QString, SlidingWindow> slidingWindows;
+    std::shared_ptr<const RateLimitRuleTable> rules;     // 通过std::atomic_load读取
+    QMutex rulesMutex;                                   // 串行化规则写入
+    RateLimitShard shards[kRateLimiterShardCount];
+    QElapsedTimer clock;                                 // 单调时钟
     QTimer* cleanupTimer;
-    bool enabled = true;
-    mutable QMutex mutex;
+    std::atomic<bool> enabled{true};
+    std::shared_ptr<RateLimiterBackend> backend;         // 通过std::atomic_load读取，为空表示进程内计数
+
+    Private()
+        : rules(std::make_shared<const RateLimitRuleTable>())
+        , cleanupTimer(nullptr)
+    {}
+
+    qint64 nowNs() const { return clock.nsecsElapsed(); }
+    std::shared_ptr<const RateLimitRuleTable> ruleTable() const { return std::atomic_load(&rules); }
+    std::shared_ptr<RateLimiterBackend> activeBackend() const;
+    RateLimitShard& shardFor(const QString& key) { return shards[qHash(key) & (kRateLimiterShardCount - 1)]; }
+    int shardIndex(const QString& key) const { return qHash(key) & (kRateLimiterShardCount - 1); }
+
+    /**
+     * @brief 获取或按规则创建限流状态（调用方需持有分片锁）
+     */
+    RateLimitBucket& bucketFor(RateLimitShard& shard, const QString& key,
+                               const RateLimitRule& rule, qint64 nowNs);
+
+    /**
+     * @brief 更新规则表后丢弃受影响键的限流状态
+     */
+    void dropBuckets(const QString& key);
 };
 
 } // namespace Core
@@ -2,19 +2,220 @@
 #include "SessionManager_p.h"
 #include "eagle/core/Logger.h"
 #include <QtCore/QMutexLocker>
+#include <QtCore/QReadLocker>
+#include <QtCore/QWriteLocker>
 #include <QtCore/QDateTime>
 #include <QtCore/QUuid>
 #include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <algorithm>
 
 namespace Eagle {
 namespace Core {
 
+// SessionTimingWheel实现
+void SessionTimingWheel::schedule(const SessionExpiryEntry& entry)
+{
+    // 向上取整到tick，保证不早于过期时间触发；已过期的放到下一个tick
+    qint64 tick = qMax((entry.expiresAtMs + kTickMs - 1) / kTickMs, currentTick + 1);
+    qint64 delta = tick - currentTick;
+    
+    for (int level = 0; level < kLevels; ++level) {
+        if (delta < (qint64(1) << (kSlotBits * (level + 1)))) {
+            slots[level][(tick >> (kSlotBits * level)) & (kSlots - 1)].append(entry);
+            return;
+        }
+    }
+    overflow.append(entry);
+}
+
+void SessionTimingWheel::advance(qint64 nowMs, QVector<SessionExpiryEntry>* due)
+{
+    qint64 targetTick = nowMs / kTickMs;
+    while (currentTick < targetTick) {
+        currentTick++;
+        
+        // 进入上层槽的时间范围时，把该槽整体下移（从高层到低层）
+        if ((currentTick & ((qint64(1) << (kSlotBits * kLevels)) - 1)) == 0) {
+            QVector<SessionExpiryEntry> entries;
+            entries.swap(overflow);
+            for (const SessionExpiryEntry& entry : entries) {
+                schedule(entry);
+            }
+        }
+        for (int level = kLevels - 1; level > 0; --level) {
+            if ((currentTick & ((qint64(1) << (kSlotBits * level)) - 1)) != 0) {
+                continue;
+            }
+            QVector<SessionExpiryEntry> entries;
+            entries.swap(slots[level][(currentTick >> (kSlotBits * level)) & (kSlots - 1)]);
+            for (const SessionExpiryEntry& entry : entries) {
+                if (entry.expiresAtMs <= currentTick * kTickMs) {
+                    due->append(entry);
+                } else {
+                    schedule(entry);
+                }
+            }
+        }
+        
+        QVector<SessionExpiryEntry>& slot = slots[0][currentTick & (kSlots - 1)];
+        due->append(slot);
+        slot.clear();
+    }
+}
+
+// SessionManager::Private实现
+std::shared_ptr<SessionRecord> SessionManager::Private::removeSession(const QString& sessionId)
+{
+    std::shared_ptr<SessionRecord> record;
+    {
+        SessionShard& shard = shardFor(sessionId);
+        QWriteLocker locker(&shard.lock);
+        record = shard.sessions.take(sessionId);
+    }
+    if (!record) {
+        return record;
+    }
+    
+    // 从用户会话列表中移除
+    UserSessionShard& userShard = userShardFor(record->session.userId);
+    QMutexLocker locker(&userShard.mutex);
+    auto it = userShard.userSessions.find(record->session.userId);
+    if (it != userShard.userSessions.end()) {
+        it->removeAll(sessionId);
+        if (it->isEmpty()) {
+            userShard.userSessions.erase(it);
+        }
+    }
+    return record;
+}
+
+bool SessionManager::Private::promoteRestored(const QString& sessionId) const
+{
+    if (restoredCount.load(std::memory_order_relaxed) == 0 || sessionId.isEmpty()) {
+        return false;
+    }
+    std::shared_ptr<SessionStore> sessionStore = currentStore();
+    if (!sessionStore) {
+        return false;
+    }
+    
+    QByteArray key = sessionStore->sessionKey(sessionId);
+    SessionShard& shard = shardFor(sessionId);
+    Session session;
+    {
+        QMutexLocker locker(&restoredMutex);
+        auto it = restored.find(key);
+        if (it == restored.end()) {
+            locker.unlock();
+            QReadLocker shardLocker(&shard.lock);
+            return shard.sessions.contains(sessionId);  // 可能已被其他线程放回
+        }
+        session = it.value();
+        restored.erase(it);
+        restoredCount.fetch_sub(1, std::memory_order_relaxed);
+        unindexRestored(session.userId, key);
+    }
+    
+    session.sessionId = sessionId;
+    auto record = std::make_shared<SessionRecord>();
+    record->session = session;
+    record->expiresAtMs = session.expiresAt.isValid() ? session.expiresAt.toMSecsSinceEpoch() : 0;
+    record->lastAccessMs.store(session.lastAccessTime.toMSecsSinceEpoch());
+    {
+        QWriteLocker locker(&shard.lock);
+        if (shard.sessions.contains(sessionId)) {
+            return true;
+        }
+        shard.sessions.insert(sessionId, record);
+        if (record->expiresAtMs > 0) {
+            shard.wheel.schedule(SessionExpiryEntry{sessionId, record->expiresAtMs});
+        }
+    }
+    
+    UserSessionShard& userShard = userShardFor(session.userId);
+    QMutexLocker locker(&userShard.mutex);
+    userShard.userSessions[session.userId].append(sessionId);
+    return true;
+}
+
+void SessionManager::Private::pruneRestored(qint64 nowMs)
+{
+    QMutexLocker locker(&restoredMutex);
+    for (auto it = restored.begin(); it != restored.end();) {
+        qint64 expiresAtMs = it.value().expiresAt.isValid() ? it.value().expiresAt.toMSecsSinceEpoch() : 0;
+        if (expiresAtMs > 0 && nowMs > expiresAtMs) {
+            unindexRestored(it.value().userId, it.key());
+            it = restored.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    restoredCount.store(restored.size(), std::memory_order_relaxed);
+}
+
+void SessionManager::Private::unindexRestored(const QString& userId, const QByteArray& key) const
+{
+    auto it = restoredByUser.find(userId);
+    if (it == restoredByUser.end()) {
+        return;
+    }
+    it->removeOne(key);
+    if (it->isEmpty()) {
+        restoredByUser.erase(it);
+    }
+}
+
+int SessionManager::Private::activeRestoredCount(const QString& userId, qint64 nowMs) const
+{
+    if (restoredCount.load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+    
+    auto isActive = [nowMs](const Session& session) {
+        return session.active && (!session.expiresAt.isValid() || nowMs <= session.expiresAt.toMSecsSinceEpoch());
+    };
+    
+    QMutexLocker locker(&restoredMutex);
+    int count = 0;
+    if (userId.isEmpty()) {
+        for (const Session& session : restored) {
+            count += isActive(session) ? 1 : 0;
+        }
+        return count;
+    }
+    for (const QByteArray& key : restoredByUser.value(userId)) {
+        auto it = restored.constFind(key);
+        count += it != restored.constEnd() && isActive(it.value()) ? 1 : 0;
+    }
+    return count;
+}
+
+QVector<Session> SessionManager::Private::snapshotSessions() const
+{
+    QVector<Session> result;
+    for (SessionShard& shard : shards) {
+        QReadLocker locker(&shard.lock);
+        result.reserve(result.size() + shard.sessions.size());
+        for (const std::shared_ptr<SessionRecord>& record : shard.sessions) {
+            result.append(record->snapshot());
+        }
+    }
+    return result;
+}
+
 SessionManager::SessionManager(QObject* parent)
     : QObject(parent)
     , d(new SessionManager::Private)
 {
+    qint64 nowTick = QDateTime::currentMSecsSinceEpoch() / SessionTimingWheel::kTickMs;
+    for (SessionShard& shard : d->shards) {
+        shard.wheel.currentTick = nowTick;
+    }
+    
+    // 过期由时间轮处理，每个tick只处理到期的会话
     d->cleanupTimer = new QTimer(this);
-    d->cleanupTimer->setInterval(60000);  // 每分钟清理一次
+    d->cleanupTimer->setInterval(static_cast<int>(SessionTimingWheel::kTickMs));
     connect(d->cleanupTimer, &QTimer::timeout, this, &SessionManager::onCleanupTimer);
     d->cleanupTimer->start();
     
@@ -23,6 +224,7 @@ SessionManager::SessionManager(QObject* parent)
 
 SessionManager::~SessionManager()
 {
+    disablePersistence();
     delete d;
 }
 
@@ -34,35 +236,72 @@ QString SessionManager::createSession(const QString& userId, int timeoutMinutes)
     }
     
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    // 检查用户会话数量限制
-    if (d->userSessions.contains(userId)) {
-        QStringList& userSessions = d->userSessions[userId];
-        if (userSessions.size() >= d->maxSessionsPerUser) {
-            // 删除最旧的会话
-            QString oldestSessionId = userSessions.first();
-            destroySession(oldestSessionId);
-        }
-    }
     
     // 创建新会话
-    Session session;
+    auto record = std::make_shared<SessionRecord>();
+    Session& session = record->session;
     session.sessionId = generateSessionId();
     session.userId = userId;
     session.createdAt = QDateTime::currentDateTime();
     session.lastAccessTime = session.createdAt;
     session.active = true;
     
-    int timeout = timeoutMinutes > 0 ? timeoutMinutes : d->defaultTimeoutMinutes;
-    session.expiresAt = QDateTime::currentDateTime().addSecs(timeout * 60);
+    int timeout = timeoutMinutes > 0 ? timeoutMinutes : d->defaultTimeoutMinutes.load();
+    session.expiresAt = session.createdAt.addSecs(timeout * 60);
+    record->expiresAtMs = session.expiresAt.toMSecsSinceEpoch();
+    record->lastAccessMs.store(session.createdAt.toMSecsSinceEpoch());
     
-    d->sessions[session.sessionId] = session;
+    {
+        SessionShard& shard = d->shardFor(session.sessionId);
+        QWriteLocker locker(&shard.lock);
+        shard.sessions.insert(session.sessionId, record);
+        shard.wheel.schedule(SessionExpiryEntry{session.sessionId, record->expiresAtMs});
+    }
+    if (std::shared_ptr<SessionStore> store = d->currentStore()) {
+        store->recordPut(session);
+    }
     
-    if (!d->userSessions.contains(userId)) {
-        d->userSessions[userId] = QStringList();
+    // 检查用户会话数量限制，超出时删除最旧的会话（已恢复的会话都早于本次运行创建的会话，先淘汰）
+    QStringList evicted;
+    QList<QByteArray> evictedRestored;
+    {
+        UserSessionShard& userShard = d->userShardFor(userId);
+        QMutexLocker locker(&userShard.mutex);
+        QStringList& userSessions = userShard.userSessions[userId];
+        int maxSessions = d->maxSessionsPerUser.load();
+        if (d->restoredCount.load(std::memory_order_relaxed) > 0) {
+            QMutexLocker restoredLocker(&d->restoredMutex);
+            auto restoredIt = d->restoredByUser.find(userId);
+            if (restoredIt != d->restoredByUser.end()) {
+                while (!restoredIt->isEmpty() && userSessions.size() + restoredIt->size() >= maxSessions) {
+                    QByteArray key = restoredIt->takeFirst();
+                    if (d->restored.remove(key) > 0) {
+                        d->restoredCount.fetch_sub(1, std::memory_order_relaxed);
+                        evictedRestored.append(key);
+                    }
+                }
+                if (restoredIt->isEmpty()) {
+                    d->restoredByUser.erase(restoredIt);
+                }
+            }
+        }
+        while (!userSessions.isEmpty() && userSessions.size() >= maxSessions) {
+            evicted.append(userSessions.takeFirst());
+        }
+        userSessions.append(session.sessionId);
+    }
+    if (!evictedRestored.isEmpty()) {
+        if (std::shared_ptr<SessionStore> store = d->currentStore()) {
+            for (const QByteArray& key : evictedRestored) {
+                store->recordRemoveKey(key);
+            }
+        }
+        Logger::info("SessionManager", QString("用户 %1 超出会话上限，淘汰%2个已恢复的会话")
+            .arg(userId).arg(evictedRestored.size()));
+    }
+    for (const QString& sessionId : evicted) {
+        destroySession(sessionId);
     }
-    d->userSessions[userId].append(session.sessionId);
     
     Logger::info("SessionManager", QString("创建会话: %1 (用户: %2)").arg(session.sessionId, userId));
     emit sessionCreated(session.sessionId, userId);
@@ -73,21 +312,11 @@ QString SessionManager::createSession(const QString& userId, int timeoutMinutes)
 bool SessionManager::destroySession(const QString& sessionId)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->sessions.contains(sessionId)) {
+    if (!d->removeSession(sessionId) && !(d->promoteRestored(sessionId) && d->removeSession(sessionId))) {
         return false;
     }
-    
-    Session session = d->sessions[sessionId];
-    d->sessions.remove(sessionId);
-    
-    // 从用户会话列表中移除
-    if (d->userSessions.contains(session.userId)) {
-        d->userSessions[session.userId].removeAll(sessionId);
-        if (d->userSessions[session.userId].isEmpty()) {
-            d->userSessions.remove(session.userId);
-        }
+    if (std::shared_ptr<SessionStore> store = d->currentStore()) {
+        store->recordRemove(sessionId);
     }
     
     Logger::info("SessionManager", QString("销毁会话: %1").arg(sessionId));
@@ -99,183 +328,212 @@ bool SessionManager::destroySession(const QString& sessionId)
 bool SessionManager::validateSession(const QString& sessionId)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->sessions.contains(sessionId)) {
-        return false;
-    }
-    
-    Session& session = d->sessions[sessionId];
-    
-    // 检查是否过期
-    if (session.isExpired()) {
-        session.active = false;
-        d->sessions.remove(sessionId);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    
+    {
+        SessionShard& shard = d->shardFor(sessionId);
+        QReadLocker locker(&shard.lock);
+        auto it = shard.sessions.constFind(sessionId);
+        if (it == shard.sessions.constEnd()) {
+            locker.unlock();
+            return d->promoteRestored(sessionId) && validateSession(sessionId);
+        }
         
-        // 从用户会话列表中移除
-        if (d->userSessions.contains(session.userId)) {
-            d->userSessions[session.userId].removeAll(sessionId);
-            if (d->userSessions[session.userId].isEmpty()) {
-                d->userSessions.remove(session.userId);
+        SessionRecord* record = it.value().get();
+        if (!record->isExpired(now)) {
+            // 近似更新最后访问时间：粒度内的重复访问不写入，避免共享缓存行争用；
+            // 只更新内存，不追加存储记录，重启后恢复的是最后一次写入存储时的访问时间
+            if (now - record->lastAccessMs.load(std::memory_order_relaxed) >= kSessionTouchGranularityMs) {
+                record->lastAccessMs.store(now, std::memory_order_relaxed);
             }
+            return record->session.active;
         }
-        
+    }
+    
+    // 已过期但时间轮尚未处理
+    if (d->removeSession(sessionId)) {
         Logger::info("SessionManager", QString("会话已过期: %1").arg(sessionId));
+        emit sessionDestroyed(sessionId);
         emit sessionExpired(sessionId);
-        return false;
     }
-    
-    // 更新最后访问时间
-    session.touch();
-    
-    return session.active;
+    return false;
 }
 
 Session SessionManager::getSession(const QString& sessionId) const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
+    SessionShard& shard = d->shardFor(sessionId);
+    QReadLocker locker(&shard.lock);
     
-    if (!d->sessions.contains(sessionId)) {
-        return Session();
+    auto it = shard.sessions.constFind(sessionId);
+    if (it == shard.sessions.constEnd()) {
+        locker.unlock();
+        return d->promoteRestored(sessionId) ? getSession(sessionId) : Session();
     }
     
-    Session session = d->sessions[sessionId];
-    
     // 检查是否过期
-    if (session.isExpired()) {
+    if (it.value()->isExpired(QDateTime::currentMSecsSinceEpoch())) {
         return Session();
     }
     
-    return session;
+    return it.value()->snapshot();
 }
 
 void SessionManager::setAttribute(const QString& sessionId, const QString& key, const QVariant& value)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->sessions.contains(sessionId)) {
+    SessionShard& shard = d->shardFor(sessionId);
+    QWriteLocker locker(&shard.lock);
+    
+    auto it = shard.sessions.find(sessionId);
+    if (it == shard.sessions.end()) {
+        locker.unlock();
+        if (d->promoteRestored(sessionId)) {
+            setAttribute(sessionId, key, value);
+            return;
+        }
         Logger::warning("SessionManager", QString("会话不存在: %1").arg(sessionId));
         return;
     }
     
-    d->sessions[sessionId].attributes[key] = value;
+    it.value()->session.attributes[key] = value;
+    if (std::shared_ptr<SessionStore> store = d->currentStore()) {
+        store->recordPut(it.value()->snapshot());
+    }
 }
 
 QVariant SessionManager::getAttribute(const QString& sessionId, const QString& key) const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
+    SessionShard& shard = d->shardFor(sessionId);
+    QReadLocker locker(&shard.lock);
     
-    if (!d->sessions.contains(sessionId)) {
-        return QVariant();
+    auto it = shard.sessions.constFind(sessionId);
+    if (it == shard.sessions.constEnd()) {
+        locker.unlock();
+        return d->promoteRestored(sessionId) ? getAttribute(sessionId, key) : QVariant();
     }
     
-    return d->sessions[sessionId].attributes.value(key);
+    return it.value()->session.attributes.value(key);
 }
 
 void SessionManager::removeAttribute(const QString& sessionId, const QString& key)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->sessions.contains(sessionId)) {
+    SessionShard& shard = d->shardFor(sessionId);
+    QWriteLocker locker(&shard.lock);
+    
+    auto it = shard.sessions.find(sessionId);
+    if (it == shard.sessions.end()) {
+        locker.unlock();
+        if (d->promoteRestored(sessionId)) {
+            removeAttribute(sessionId, key);
+        }
         return;
     }
     
-    d->sessions[sessionId].attributes.remove(key);
+    if (it.value()->session.attributes.remove(key) > 0) {
+        if (std::shared_ptr<SessionStore> store = d->currentStore()) {
+            store->recordPut(it.value()->snapshot());
+        }
+    }
 }
 
 QStringList SessionManager::getSessionsByUser(const QString& userId) const
 {
+    // 已恢复、尚未出示会话ID的会话只有摘要，无法列出（计数中包含）
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    return d->userSessions.value(userId);
+    UserSessionShard& userShard = d->userShardFor(userId);
+    QMutexLocker locker(&userShard.mutex);
+    return userShard.userSessions.value(userId);
 }
 
 int SessionManager::getActiveSessionCount() const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
     
     int count = 0;
-    for (const Session& session : d->sessions.values()) {
-        if (session.active && !session.isExpired()) {
-            count++;
+    for (SessionShard& shard : d->shards) {
+        QReadLocker locker(&shard.lock);
+        for (const std::shared_ptr<SessionRecord>& record : shard.sessions) {
+            if (record->session.active && !record->isExpired(now)) {
+                count++;
+            }
         }
     }
-    return count;
+    return count + d->activeRestoredCount(QString(), now);
 }
 
 int SessionManager::getActiveSessionCount(const QString& userId) const
 {
+    QStringList sessionIds = getSessionsByUser(userId);
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    if (!d->userSessions.contains(userId)) {
-        return 0;
-    }
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
     
     int count = 0;
-    for (const QString& sessionId : d->userSessions[userId]) {
-        if (d->sessions.contains(sessionId)) {
-            const Session& session = d->sessions[sessionId];
-            if (session.active && !session.isExpired()) {
-                count++;
-            }
+    for (const QString& sessionId : sessionIds) {
+        SessionShard& shard = d->shardFor(sessionId);
+        QReadLocker locker(&shard.lock);
+        auto it = shard.sessions.constFind(sessionId);
+        if (it != shard.sessions.constEnd() && it.value()->session.active && !it.value()->isExpired(now)) {
+            count++;
         }
     }
-    return count;
+    return count + d->activeRestoredCount(userId, now);
 }
 
 void SessionManager::setDefaultTimeout(int minutes)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    d->defaultTimeoutMinutes = minutes;
+    d->defaultTimeoutMinutes.store(minutes);
     Logger::info("SessionManager", QString("设置默认会话超时: %1分钟").arg(minutes));
 }
 
 int SessionManager::getDefaultTimeout() const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    return d->defaultTimeoutMinutes;
+    return d->defaultTimeoutMinutes.load();
 }
 
 void SessionManager::setMaxSessionsPerUser(int maxSessions)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    d->maxSessionsPerUser = maxSessions;
+    d->maxSessionsPerUser.store(maxSessions);
     Logger::info("SessionManager", QString("设置每用户最大会话数: %1").arg(maxSessions));
 }
 
 int SessionManager::getMaxSessionsPerUser() const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    return d->maxSessionsPerUser;
+    return d->maxSessionsPerUser.load();
 }
 
 void SessionManager::cleanupExpiredSessions()
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
     
+    // 推进各分片的时间轮，只核对到期的项（续期或已销毁的会话按记录的过期时间跳过）
     QStringList expiredSessions;
-    for (auto it = d->sessions.begin(); it != d->sessions.end(); ++it) {
-        if (it.value().isExpired()) {
-            expiredSessions.append(it.key());
+    for (SessionShard& shard : d->shards) {
+        QVector<SessionExpiryEntry> due;
+        QWriteLocker locker(&shard.lock);
+        shard.wheel.advance(now, &due);
+        for (const SessionExpiryEntry& entry : due) {
+            auto it = shard.sessions.constFind(entry.sessionId);
+            if (it != shard.sessions.constEnd() && it.value()->expiresAtMs == entry.expiresAtMs
+                && it.value()->isExpired(now)) {
+                expiredSessions.append(entry.sessionId);
+            }
         }
     }
     
-    locker.unlock();
-    
     for (const QString& sessionId : expiredSessions) {
-        destroySession(sessionId);
-        emit sessionExpired(sessionId);
+        if (d->removeSession(sessionId)) {
+            emit sessionDestroyed(sessionId);
+            emit sessionExpired(sessionId);
+        }
     }
     
     if (!expiredSessions.isEmpty()) {
@@ -286,19 +544,19 @@ void SessionManager::cleanupExpiredSessions()
 void SessionManager::cleanupInactiveSessions(int inactiveMinutes)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
+    qint64 cutoff = QDateTime::currentMSecsSinceEpoch() - qint64(inactiveMinutes) * 60 * 1000;
     
-    QDateTime cutoff = QDateTime::currentDateTime().addSecs(-inactiveMinutes * 60);
+    // 截止时间由调用方指定，无法预先排入时间轮，逐个分片扫描
     QStringList inactiveSessions;
-    
-    for (auto it = d->sessions.begin(); it != d->sessions.end(); ++it) {
-        if (it.value().lastAccessTime < cutoff) {
-            inactiveSessions.append(it.key());
+    for (SessionShard& shard : d->shards) {
+        QReadLocker locker(&shard.lock);
+        for (auto it = shard.sessions.constBegin(); it != shard.sessions.constEnd(); ++it) {
+            if (it.value()->lastAccessMs.load(std::memory_order_relaxed) < cutoff) {
+                inactiveSessions.append(it.key());
+            }
         }
     }
     
-    locker.unlock();
-    
     for (const QString& sessionId : inactiveSessions) {
         destroySession(sessionId);
     }
@@ -308,9 +566,137 @@ void SessionManager::cleanupInactiveSessions(int inactiveMinutes)
     }
 }
 
+bool SessionManager::enablePersistence(const QString& filePath)
+{
+    auto* d = d_func();
+    disablePersistence();
+    
+    auto store = std::make_shared<SessionStore>(filePath);
+    if (!store->open()) {
+        return false;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QVector<Session> existing = d->snapshotSessions();
+    QVector<StoredSession> sessions = store->loadAll(now);
+    
+    // 存储中只有会话ID的摘要：恢复的会话按会话键保存，第一次出示会话ID时再放回会话表
+    QHash<QByteArray, Session> restoredSessions;
+    restoredSessions.reserve(sessions.size());
+    for (const StoredSession& stored : sessions) {
+        restoredSessions.insert(stored.key, stored.session);
+    }
+    for (const Session& session : existing) {
+        restoredSessions.remove(store->sessionKey(session.sessionId));  // 内存中的会话优先
+    }
+    int restored = restoredSessions.size();
+    
+    // 按用户索引（按创建时间排序），用于计数和每用户会话上限
+    QHash<QString, QVector<QPair<qint64, QByteArray>>> byCreation;
+    for (auto it = restoredSessions.constBegin(); it != restoredSessions.constEnd(); ++it) {
+        byCreation[it.value().userId].append(qMakePair(it.value().createdAt.toMSecsSinceEpoch(), it.key()));
+    }
+    QHash<QString, QList<QByteArray>> restoredByUser;
+    restoredByUser.reserve(byCreation.size());
+    for (auto it = byCreation.begin(); it != byCreation.end(); ++it) {
+        std::sort(it->begin(), it->end());
+        QList<QByteArray>& keys = restoredByUser[it.key()];
+        keys.reserve(it->size());
+        for (const auto& entry : it.value()) {
+            keys.append(entry.second);
+        }
+    }
+    {
+        QMutexLocker locker(&d->restoredMutex);
+        d->restored.swap(restoredSessions);
+        d->restoredByUser.swap(restoredByUser);
+        d->restoredCount.store(restored);
+    }
+    
+    // 启用前已存在的会话写入存储，之后的变更由各操作追加
+    for (const Session& session : existing) {
+        store->recordPut(session);
+    }
+    store->flush();
+    
+    std::atomic_store(&d->store, store);
+    Logger::info("SessionManager", QString("启用会话持久化: %1，恢复%2个会话，耗时%3ms")
+        .arg(filePath).arg(restored).arg(timer.elapsed()));
+    return true;
+}
+
+void SessionManager::disablePersistence()
+{
+    auto* d = d_func();
+    std::shared_ptr<SessionStore> store = std::atomic_exchange(&d->store, std::shared_ptr<SessionStore>());
+    if (store) {
+        store->close();
+        Logger::info("SessionManager", QString("停用会话持久化: %1").arg(store->filePath()));
+    }
+    
+    // 没有存储无法计算会话键，尚未被访问的恢复会话留在文件中，下次启用时重新加载
+    QMutexLocker locker(&d->restoredMutex);
+    d->restored.clear();
+    d->restoredByUser.clear();
+    d->restoredCount.store(0);
+}
+
+bool SessionManager::isPersistenceEnabled() const
+{
+    const auto* d = d_func();
+    return d->currentStore() != nullptr;
+}
+
+bool SessionManager::compactSessionStore()
+{
+    auto* d = d_func();
+    std::shared_ptr<SessionStore> store = d->currentStore();
+    if (!store) {
+        return false;
+    }
+    
+    // 先开始压缩再取快照，快照期间的变更保存在压缩尾部；
+    // 先取已恢复的会话再取会话表，期间被放回会话表的会话至少出现在一处
+    store->beginCompaction();
+    QVector<StoredSession> sessions;
+    {
+        QMutexLocker locker(&d->restoredMutex);
+        sessions.reserve(d->restored.size());
+        for (auto it = d->restored.constBegin(); it != d->restored.constEnd(); ++it) {
+            sessions.append(StoredSession{it.key(), it.value()});
+        }
+    }
+    for (const Session& session : d->snapshotSessions()) {
+        sessions.append(StoredSession{store->sessionKey(session.sessionId), session});
+    }
+    return store->compact(sessions);
+}
+
 void SessionManager::onCleanupTimer()
 {
+    auto* d = d_func();
     cleanupExpiredSessions();
+    
+    // 每个tick把缓冲的变更落盘，并定期检查日志是否需要压缩
+    std::shared_ptr<SessionStore> store = d->currentStore();
+    if (!store) {
+        return;
+    }
+    store->flush();
+    if (++d->cleanupTicks >= kSessionStoreCompactCheckTicks) {
+        d->cleanupTicks = 0;
+        d->pruneRestored(QDateTime::currentMSecsSinceEpoch());
+        int liveSessions = d->restoredCount.load();
+        for (SessionShard& shard : d->shards) {
+            QReadLocker locker(&shard.lock);
+            liveSessions += shard.sessions.size();
+        }
+        if (store->needsCompaction(liveSessions)) {
+            compactSessionStore();
+        }
+    }
 }
 
 QString SessionManager::generateSessionId() const
@@ -2,24 +2,160 @@
 #define SESSIONMANAGER_P_H
 
 #include <QtCore/QString>
-#include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
 #include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QTimer>
 #include <QtCore/QDateTime>
 #include <QtCore/QStringList>
+#include <atomic>
+#include <memory>
 #include "eagle/core/SessionManager.h"
+#include "eagle/core/SessionStore.h"
 
 namespace Eagle {
 namespace Core {
 
+/**
+ * @brief 会话表分片数（2的幂）
+ */
+const int kSessionShardCount = 16;
+
+/**
+ * @brief 最后访问时间的更新粒度（毫秒），间隔更短的访问不重复写入
+ */
+const qint64 kSessionTouchGranularityMs = 1000;
+
+/**
+ * @brief 每隔多少个清理tick检查一次会话存储是否需要压缩
+ */
+const int kSessionStoreCompactCheckTicks = 300;
+
+/**
+ * @brief 会话记录
+ */
+struct SessionRecord {
+    Session session;                      // lastAccessTime以lastAccessMs为准
+    qint64 expiresAtMs = 0;               // 过期时间（自纪元起的毫秒数），0表示永不过期
+    std::atomic<qint64> lastAccessMs{0};  // 最后访问时间，验证时在读锁下近似更新
+
+    bool isExpired(qint64 nowMs) const {
+        return expiresAtMs > 0 && nowMs > expiresAtMs;
+    }
+
+    Session snapshot() const {
+        Session result = session;
+        result.lastAccessTime = QDateTime::fromMSecsSinceEpoch(lastAccessMs.load(std::memory_order_relaxed));
+        return result;
+    }
+};
+
+/**
+ * @brief 过期时间轮中的一项（会话续期或销毁后不删除，到期时按记录的过期时间核对）
+ */
+struct SessionExpiryEntry {
+    QString sessionId;
+    qint64 expiresAtMs = 0;
+};
+
+/**
+ * @brief 分层时间轮
+ *
+ * 4层、每层64个槽，tick为1秒，覆盖约194天，更远的过期时间放入溢出列表。
+ * 插入为O(1)；推进时只处理到期的槽，上层槽在进入下层范围时整体下移一次。
+ */
+struct SessionTimingWheel {
+    static const int kLevels = 4;
+    static const int kSlotBits = 6;
+    static const int kSlots = 1 << kSlotBits;
+    static const qint64 kTickMs = 1000;
+
+    QVector<SessionExpiryEntry> slots[kLevels][kSlots];
+    QVector<SessionExpiryEntry> overflow;
+    qint64 currentTick = 0;  // 已处理到的tick
+
+    void schedule(const SessionExpiryEntry& entry);
+
+    /**
+     * @brief 推进到nowMs，把到期的项追加到due
+     */
+    void advance(qint64 nowMs, QVector<SessionExpiryEntry>* due);
+};
+
+/**
+ * @brief 会话表分片（按sessionId划分），包含该分片会话的过期时间轮
+ */
+struct SessionShard {
+    QReadWriteLock lock;
+    QHash<QString, std::shared_ptr<SessionRecord>> sessions;
+    SessionTimingWheel wheel;
+};
+
+/**
+ * @brief 用户会话索引分片（按userId划分）
+ */
+struct UserSessionShard {
+    QMutex mutex;
+    QHash<QString, QStringList> userSessions;  // userId -> sessionIds（按创建顺序）
+};
+
 class SessionManager::Private {
 public:
-    QMap<QString, Session> sessions;  // sessionId -> Session
-    QMap<QString, QStringList> userSessions;  // userId -> sessionIds
+    mutable SessionShard shards[kSessionShardCount];
+    mutable UserSessionShard userShards[kSessionShardCount];
     QTimer* cleanupTimer;
-    int defaultTimeoutMinutes = 30;
-    int maxSessionsPerUser = 5;
-    mutable QMutex mutex;
+    std::atomic<int> defaultTimeoutMinutes{30};
+    std::atomic<int> maxSessionsPerUser{5};
+    std::shared_ptr<SessionStore> store;  // 持久化存储，通过atomic_load/atomic_store访问
+    mutable QHash<QByteArray, Session> restored;  // 从存储恢复、尚未被访问的会话：会话键 -> 会话（sessionId为空）
+    mutable QHash<QString, QList<QByteArray>> restoredByUser;  // userId -> 已恢复会话的键（按创建时间），与restored同受restoredMutex保护
+    mutable QMutex restoredMutex;
+    mutable std::atomic<int> restoredCount{0};
+    int cleanupTicks = 0;
+
+    SessionShard& shardFor(const QString& sessionId) const {
+        return shards[qHash(sessionId) & (kSessionShardCount - 1)];
+    }
+    UserSessionShard& userShardFor(const QString& userId) const {
+        return userShards[qHash(userId) & (kSessionShardCount - 1)];
+    }
+    std::shared_ptr<SessionStore> currentStore() const {
+        return std::atomic_load(&store);
+    }
+
+    /**
+     * @brief 从会话表和用户索引中移除会话，返回被移除的记录
+     */
+    std::shared_ptr<SessionRecord> removeSession(const QString& sessionId);
+
+    /**
+     * @brief 会话表未命中时，按会话键从已恢复的会话中取出并放回会话表
+     *
+     * 存储中只有会话ID的摘要，恢复的会话在第一次出示会话ID时才能放回会话表。
+     * @return 会话已在会话表中时返回true
+     */
+    bool promoteRestored(const QString& sessionId) const;
+
+    /**
+     * @brief 丢弃已过期的已恢复会话
+     */
+    void pruneRestored(qint64 nowMs);
+
+    /**
+     * @brief 从按用户索引中移除一个已恢复会话的键（调用方持有restoredMutex）
+     */
+    void unindexRestored(const QString& userId, const QByteArray& key) const;
+
+    /**
+     * @brief 活跃且未过期的已恢复会话数，userId为空时统计所有用户
+     */
+    int activeRestoredCount(const QString& userId, qint64 nowMs) const;
+
+    /**
+     * @brief 所有分片中会话的快照
+     */
+    QVector<Session> snapshotSessions() const;
 };
 
 } // namespace Core
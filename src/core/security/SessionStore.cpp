@@ -0,0 +1,411 @@
+#include "eagle/core/SessionStore.h"
+#include "SessionStore_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QMutexLocker>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMessageAuthenticationCode>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+#include <cstring>
+
+namespace Eagle {
+namespace Core {
+
+namespace {
+
+/**
+ * @brief 记录负载使用固定的QDataStream版本，保证不同构建之间兼容
+ */
+const QDataStream::Version kSessionStoreStreamVersion = QDataStream::Qt_5_15;
+
+QDateTime fromStoredMs(qint64 ms)
+{
+    // UTC不需要时区换算，批量加载时明显更快
+    return ms > 0 ? QDateTime::fromMSecsSinceEpoch(ms, Qt::UTC) : QDateTime();
+}
+
+qint64 toStoredMs(const QDateTime& dateTime)
+{
+    return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : 0;
+}
+
+/**
+ * @brief 会话ID是持有者凭证，日志文件只允许所有者读写
+ */
+const QFileDevice::Permissions kSessionStorePermissions = QFileDevice::ReadOwner | QFileDevice::WriteOwner;
+
+} // namespace
+
+// SessionStorePrivate实现
+QByteArray SessionStorePrivate::encodePut(const QByteArray& key, const Session& session)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(kSessionStoreStreamVersion);
+    out << key << session.userId.toUtf8()
+        << toStoredMs(session.createdAt) << toStoredMs(session.expiresAt) << toStoredMs(session.lastAccessTime)
+        << session.active << session.attributes;
+    return payload;
+}
+
+void SessionStorePrivate::append(SessionRecordType type, const QByteArray& payload)
+{
+    if (!file.isOpen()) {
+        return;
+    }
+
+    char header[kSessionRecordHeaderSize];
+    header[0] = static_cast<char>(type);
+    qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), header + 1);
+    qToLittleEndian<quint16>(qChecksum(payload.constData(), static_cast<uint>(payload.size())), header + 5);
+
+    pending.append(header, kSessionRecordHeaderSize);
+    pending.append(payload);
+    if (compacting) {
+        compactionTail.append(header, kSessionRecordHeaderSize);
+        compactionTail.append(payload);
+    }
+    recordCount++;
+
+    if (pending.size() >= kSessionStoreFlushThreshold) {
+        writePending();
+    }
+}
+
+bool SessionStorePrivate::writePending()
+{
+    if (!file.isOpen()) {
+        // 文件未打开（如压缩后重新打开失败）：报告失败并丢弃缓冲，不再继续累积
+        pending.clear();
+        return false;
+    }
+    if (pending.isEmpty()) {
+        return true;
+    }
+
+    file.seek(file.size());
+    if (file.write(pending) != pending.size() || !file.flush()) {
+        Logger::error("SessionStore", QString("写入会话存储失败: %1 - %2").arg(filePath, file.errorString()));
+        return false;
+    }
+    pending.clear();
+    return true;
+}
+
+bool SessionStorePrivate::writeHeader(QIODevice* device) const
+{
+    char header[kSessionStoreHeaderSize];
+    qToLittleEndian<quint32>(kSessionStoreMagic, header);
+    qToLittleEndian<quint16>(kSessionStoreVersion, header + 4);
+    qToLittleEndian<quint16>(0, header + 6);
+    memcpy(header + 8, secret.constData(), kSessionStoreSecretSize);
+    return device->write(header, kSessionStoreHeaderSize) == kSessionStoreHeaderSize;
+}
+
+// SessionStore实现
+SessionStore::SessionStore(const QString& filePath, QObject* parent)
+    : QObject(parent)
+    , d_ptr(new SessionStorePrivate)
+{
+    d_ptr->filePath = filePath;
+    d_ptr->file.setFileName(filePath);
+}
+
+SessionStore::~SessionStore()
+{
+    close();
+    delete d_ptr;
+}
+
+bool SessionStore::open()
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    if (d->file.isOpen()) {
+        return true;
+    }
+
+    if (!d->file.open(QIODevice::ReadWrite)) {
+        Logger::error("SessionStore", QString("无法打开会话存储: %1 - %2").arg(d->filePath, d->file.errorString()));
+        return false;
+    }
+    if (!d->file.setPermissions(kSessionStorePermissions)) {
+        Logger::warning("SessionStore", QString("无法限制会话存储的访问权限: %1").arg(d->filePath));
+    }
+
+    if (d->file.size() == 0) {
+        d->secret = QByteArray(kSessionStoreSecretSize, Qt::Uninitialized);
+        QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(d->secret.data()),
+                                              kSessionStoreSecretSize / int(sizeof(quint32)));
+        if (!d->writeHeader(&d->file) || !d->file.flush()) {
+            Logger::error("SessionStore", QString("无法写入会话存储文件头: %1").arg(d->filePath));
+            d->file.close();
+            return false;
+        }
+        return true;
+    }
+
+    char header[kSessionStoreHeaderSize];
+    if (d->file.read(header, kSessionStoreHeaderSize) != kSessionStoreHeaderSize
+        || qFromLittleEndian<quint32>(header) != kSessionStoreMagic
+        || qFromLittleEndian<quint16>(header + 4) != kSessionStoreVersion) {
+        Logger::error("SessionStore", QString("会话存储格式不兼容: %1").arg(d->filePath));
+        d->file.close();
+        return false;
+    }
+    d->secret = QByteArray(header + 8, kSessionStoreSecretSize);
+    return true;
+}
+
+void SessionStore::close()
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    if (d->file.isOpen()) {
+        d->writePending();
+        d->file.close();
+    }
+}
+
+bool SessionStore::isOpen() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->file.isOpen();
+}
+
+QString SessionStore::filePath() const
+{
+    const auto* d = d_func();
+    return d->filePath;
+}
+
+QByteArray SessionStore::sessionKey(const QString& sessionId) const
+{
+    const auto* d = d_func();
+    return QMessageAuthenticationCode::hash(sessionId.toUtf8(), d->secret, QCryptographicHash::Sha256);
+}
+
+QVector<StoredSession> SessionStore::loadAll(qint64 nowMs)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    QVector<StoredSession> result;
+    if (!d->file.isOpen()) {
+        return result;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    d->writePending();
+
+    // 整个文件映射到内存后直接解析，映射失败时退回一次性读取
+    qint64 size = d->file.size();
+    QByteArray fallback;
+    const uchar* data = d->file.map(0, size);
+    bool mapped = data != nullptr;
+    if (!mapped) {
+        d->file.seek(0);
+        fallback = d->file.readAll();
+        data = reinterpret_cast<const uchar*>(fallback.constData());
+        size = fallback.size();
+    }
+
+    QHash<QByteArray, Session> sessions;
+    sessions.reserve(static_cast<int>(qMin<qint64>(size / 96, 1 << 24)));
+    qint64 records = 0;
+    qint64 offset = kSessionStoreHeaderSize;
+    while (offset + kSessionRecordHeaderSize <= size) {
+        const uchar* header = data + offset;
+        quint32 length = qFromLittleEndian<quint32>(header + 1);
+        quint16 checksum = qFromLittleEndian<quint16>(header + 5);
+        if (offset + kSessionRecordHeaderSize + length > size) {
+            break;  // 写入中途中断的记录
+        }
+
+        const char* payloadData = reinterpret_cast<const char*>(header + kSessionRecordHeaderSize);
+        if (qChecksum(payloadData, length) != checksum) {
+            break;
+        }
+
+        QByteArray payload = QByteArray::fromRawData(payloadData, static_cast<int>(length));
+        QDataStream in(payload);
+        in.setVersion(kSessionStoreStreamVersion);
+        QByteArray key;
+        in >> key;
+
+        SessionRecordType type = static_cast<SessionRecordType>(header[0]);
+        if (type == SessionRecordType::Put) {
+            QByteArray userId;
+            qint64 createdAtMs = 0;
+            qint64 expiresAtMs = 0;
+            qint64 lastAccessMs = 0;
+            Session session;
+            in >> userId >> createdAtMs >> expiresAtMs >> lastAccessMs >> session.active >> session.attributes;
+            session.userId = QString::fromUtf8(userId);
+            session.createdAt = fromStoredMs(createdAtMs);
+            session.expiresAt = fromStoredMs(expiresAtMs);
+            session.lastAccessTime = fromStoredMs(lastAccessMs);
+            sessions.insert(key, session);
+        } else if (type == SessionRecordType::Remove) {
+            sessions.remove(key);
+        }
+
+        records++;
+        offset += kSessionRecordHeaderSize + length;
+    }
+
+    if (mapped) {
+        d->file.unmap(const_cast<uchar*>(data));
+    }
+
+    // 截断末尾不完整的记录，之后的追加从完整记录之后开始
+    d->truncatedBytes = size - offset;
+    if (d->truncatedBytes > 0) {
+        Logger::warning("SessionStore", QString("会话存储末尾有%1字节不完整的数据，已截断").arg(d->truncatedBytes));
+        d->file.resize(offset);
+    }
+    d->recordCount = records;
+
+    result.reserve(sessions.size());
+    for (auto it = sessions.constBegin(); it != sessions.constEnd(); ++it) {
+        qint64 expiresAtMs = toStoredMs(it.value().expiresAt);
+        if (expiresAtMs == 0 || expiresAtMs > nowMs) {
+            result.append(StoredSession{it.key(), it.value()});
+        }
+    }
+
+    d->lastLoadMs = timer.elapsed();
+    Logger::info("SessionStore", QString("加载会话存储: %1条记录，%2个有效会话，耗时%3ms")
+        .arg(records).arg(result.size()).arg(d->lastLoadMs));
+    return result;
+}
+
+void SessionStore::recordPut(const Session& session)
+{
+    auto* d = d_func();
+    QByteArray payload = SessionStorePrivate::encodePut(sessionKey(session.sessionId), session);
+    QMutexLocker locker(&d->mutex);
+    d->append(SessionRecordType::Put, payload);
+}
+
+void SessionStore::recordRemove(const QString& sessionId)
+{
+    recordRemoveKey(sessionKey(sessionId));
+}
+
+void SessionStore::recordRemoveKey(const QByteArray& key)
+{
+    auto* d = d_func();
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(kSessionStoreStreamVersion);
+    out << key;
+
+    QMutexLocker locker(&d->mutex);
+    d->append(SessionRecordType::Remove, payload);
+}
+
+bool SessionStore::flush()
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->writePending();
+}
+
+bool SessionStore::needsCompaction(int liveSessions) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return !d->compacting && d->recordCount >= kSessionStoreMinCompactRecords
+        && d->recordCount > 2 * qint64(liveSessions);
+}
+
+void SessionStore::beginCompaction()
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->compacting = true;
+    d->compactionTail.clear();
+}
+
+bool SessionStore::compact(const QVector<StoredSession>& liveSessions)
+{
+    auto* d = d_func();
+
+    // 快照在锁外编码，只有写文件和替换期间阻塞追加
+    QByteArray records;
+    for (const StoredSession& stored : liveSessions) {
+        QByteArray payload = SessionStorePrivate::encodePut(stored.key, stored.session);
+        char header[kSessionRecordHeaderSize];
+        header[0] = static_cast<char>(SessionRecordType::Put);
+        qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), header + 1);
+        qToLittleEndian<quint16>(qChecksum(payload.constData(), static_cast<uint>(payload.size())), header + 5);
+        records.append(header, kSessionRecordHeaderSize);
+        records.append(payload);
+    }
+
+    QMutexLocker locker(&d->mutex);
+    QElapsedTimer timer;
+    timer.start();
+
+    QSaveFile output(d->filePath);
+    bool ok = output.open(QIODevice::WriteOnly)
+        && output.setPermissions(kSessionStorePermissions)
+        && d->writeHeader(&output)
+        && output.write(records) == records.size()
+        && output.write(d->compactionTail) == d->compactionTail.size();
+
+    // 压缩后的文件已包含缓冲区中的记录（快照或压缩尾部）
+    d->file.close();
+    if (ok) {
+        ok = output.commit();
+    } else {
+        output.cancelWriting();
+    }
+    if (!d->file.open(QIODevice::ReadWrite)) {
+        Logger::error("SessionStore", QString("压缩后无法重新打开会话存储: %1").arg(d->filePath));
+    }
+
+    qint64 tailRecords = 0;
+    if (ok) {
+        for (qint64 offset = 0; offset + kSessionRecordHeaderSize <= d->compactionTail.size();) {
+            quint32 length = qFromLittleEndian<quint32>(d->compactionTail.constData() + offset + 1);
+            offset += kSessionRecordHeaderSize + length;
+            tailRecords++;
+        }
+        d->pending.clear();
+        d->recordCount = liveSessions.size() + tailRecords;
+        Logger::info("SessionStore", QString("会话存储压缩完成: %1个会话，耗时%2ms")
+            .arg(liveSessions.size()).arg(timer.elapsed()));
+    } else {
+        Logger::error("SessionStore", QString("会话存储压缩失败: %1").arg(d->filePath));
+    }
+
+    d->compacting = false;
+    d->compactionTail.clear();
+    return ok;
+}
+
+QVariantMap SessionStore::getStatistics() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    QVariantMap stats;
+    stats["filePath"] = d->filePath;
+    stats["open"] = d->file.isOpen();
+    stats["fileSize"] = d->file.isOpen() ? d->file.size() : 0;
+    stats["pendingBytes"] = d->pending.size();
+    stats["recordCount"] = d->recordCount;
+    stats["lastLoadMs"] = d->lastLoadMs;
+    stats["truncatedBytes"] = d->truncatedBytes;
+    return stats;
+}
+
+} // namespace Core
+} // namespace Eagle
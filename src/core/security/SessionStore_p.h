@@ -0,0 +1,54 @@
+#ifndef SESSIONSTORE_P_H
+#define SESSIONSTORE_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include "eagle/core/SessionStore.h"
+
+namespace Eagle {
+namespace Core {
+
+const quint32 kSessionStoreMagic = 0x45535331;       // "ESS1"
+const quint16 kSessionStoreVersion = 2;
+const int kSessionStoreSecretSize = 32;
+const int kSessionStoreHeaderSize = 8 + kSessionStoreSecretSize;  // 魔数(4) + 版本(2) + 保留(2) + 摘要密钥
+const int kSessionRecordHeaderSize = 7;              // 类型(1) + 负载长度(4) + 校验和(2)，小端
+const int kSessionStoreFlushThreshold = 64 * 1024;   // 缓冲区超过该大小时立即落盘
+const qint64 kSessionStoreMinCompactRecords = 10000; // 记录数少于该值时不压缩
+
+/**
+ * @brief 日志记录类型
+ */
+enum class SessionRecordType : quint8 {
+    Put = 1,      // 负载：会话键、userId（UTF-8）、创建/过期/最后访问时间（毫秒）、active、属性
+    Remove = 2    // 负载：会话键
+};
+
+class SessionStorePrivate {
+public:
+    QString filePath;
+    QFile file;
+    QByteArray secret;            // 会话键的摘要密钥，保存在文件头中，open之后不变
+    QByteArray pending;           // 尚未写入文件的记录
+    QByteArray compactionTail;    // beginCompaction之后追加的记录
+    bool compacting = false;
+    qint64 recordCount = 0;       // 文件（含缓冲区）中的记录数
+    qint64 lastLoadMs = 0;        // 最近一次加载耗时
+    qint64 truncatedBytes = 0;    // 最近一次加载截断的不完整数据
+    mutable QMutex mutex;
+
+    /**
+     * @brief 编码一条记录追加到缓冲区（调用方需持有mutex）
+     */
+    void append(SessionRecordType type, const QByteArray& payload);
+    bool writePending();          // 调用方需持有mutex
+    bool writeHeader(QIODevice* device) const;
+    static QByteArray encodePut(const QByteArray& key, const Session& session);
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // SESSIONSTORE_P_H
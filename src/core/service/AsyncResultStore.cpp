@@ -0,0 +1,232 @@
+#include "eagle/core/AsyncResultStore.h"
+#include "AsyncResultStore_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRandomGenerator>
+
+namespace Eagle {
+namespace Core {
+
+namespace {
+
+/**
+ * @brief 生成128位随机的不透明ID
+ */
+QString generateResultId()
+{
+    QRandomGenerator* generator = QRandomGenerator::system();
+    return QString("%1%2")
+        .arg(generator->generate64(), 16, 16, QChar('0'))
+        .arg(generator->generate64(), 16, 16, QChar('0'));
+}
+
+} // namespace
+
+bool AsyncResultStorePrivate::evictOldestFinished()
+{
+    auto oldest = entries.end();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->finishedAtMs < 0) {
+            continue;
+        }
+        if (oldest == entries.end() || it->finishedAtMs < oldest->finishedAtMs) {
+            oldest = it;
+        }
+    }
+
+    if (oldest == entries.end()) {
+        return false;
+    }
+    entries.erase(oldest);
+    return true;
+}
+
+AsyncResultStore::AsyncResultStore(QObject* parent)
+    : QObject(parent)
+    , d_ptr(new AsyncResultStorePrivate)
+{
+    auto* d = d_func();
+    d->clock.start();
+
+    d->purgeTimer = new QTimer(this);
+    connect(d->purgeTimer, &QTimer::timeout, this, [this]() {
+        purgeExpired();
+    });
+    d->purgeTimer->start(d->config.purgeIntervalMs);
+}
+
+AsyncResultStore::~AsyncResultStore()
+{
+    // 取消尚未触发的完成通知，续体捕获了this
+    for (const AsyncResultEntry& entry : d_ptr->entries) {
+        entry.future.unsubscribe(entry.subscription);
+    }
+    delete d_ptr;
+}
+
+void AsyncResultStore::setConfig(const AsyncResultStoreConfig& config)
+{
+    auto* d = d_func();
+    {
+        QMutexLocker locker(&d->mutex);
+        d->config = config;
+    }
+    d->purgeTimer->start(qMax(1000, config.purgeIntervalMs));
+    Logger::info("AsyncResultStore", QString("设置异步结果存储配置: 最大条目%1, TTL %2ms")
+        .arg(config.maxEntries).arg(config.ttlMs));
+}
+
+AsyncResultStoreConfig AsyncResultStore::config() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->config;
+}
+
+QString AsyncResultStore::add(const ServiceCallFuture& future,
+                              const QString& serviceName,
+                              const QString& method,
+                              const QString& owner)
+{
+    if (!future.isValid()) {
+        return QString();
+    }
+
+    auto* d = d_func();
+    QString id = generateResultId();
+    {
+        QMutexLocker locker(&d->mutex);
+
+        if (d->entries.size() >= d->config.maxEntries) {
+            // 先清理过期条目，仍然满时淘汰最早完成的条目
+            qint64 now = d->nowMs();
+            for (auto it = d->entries.begin(); it != d->entries.end();) {
+                if (it->expiresAtMs <= now) {
+                    it = d->entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            if (d->entries.size() >= d->config.maxEntries && !d->evictOldestFinished()) {
+                Logger::warning("AsyncResultStore", QString("异步结果存储已满，拒绝登记: %1::%2")
+                    .arg(serviceName, method));
+                return QString();
+            }
+        }
+
+        AsyncResultEntry entry;
+        entry.future = future;
+        entry.serviceName = serviceName;
+        entry.method = method;
+        entry.owner = owner;
+        entry.expiresAtMs = d->nowMs() + d->config.ttlMs;
+        d->entries.insert(id, entry);
+    }
+
+    // 完成通知投递到本对象所在线程
+    quint64 subscription = future.subscribe([this, id](const ServiceCallResult&) {
+        markFinished(id);
+    }, ServiceExecutors::eventLoop(this));
+    if (subscription != 0) {
+        QMutexLocker locker(&d->mutex);
+        auto it = d->entries.find(id);
+        if (it != d->entries.end()) {
+            it->subscription = subscription;
+        }
+    }
+
+    return id;
+}
+
+ServiceCallFuture AsyncResultStore::find(const QString& id) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->entries.constFind(id);
+    if (it == d->entries.constEnd() || it->expiresAtMs <= d->nowMs()) {
+        return ServiceCallFuture();
+    }
+    return it->future;
+}
+
+QString AsyncResultStore::owner(const QString& id) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->entries.constFind(id);
+    return it != d->entries.constEnd() ? it->owner : QString();
+}
+
+QVariantMap AsyncResultStore::info(const QString& id) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    QVariantMap result;
+    auto it = d->entries.constFind(id);
+    if (it == d->entries.constEnd()) {
+        return result;
+    }
+    result["serviceName"] = it->serviceName;
+    result["method"] = it->method;
+    result["owner"] = it->owner;
+    result["finished"] = it->future.isFinished();
+    return result;
+}
+
+bool AsyncResultStore::remove(const QString& id)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->entries.remove(id) > 0;
+}
+
+int AsyncResultStore::size() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->entries.size();
+}
+
+int AsyncResultStore::purgeExpired()
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+
+    int removed = 0;
+    qint64 now = d->nowMs();
+    for (auto it = d->entries.begin(); it != d->entries.end();) {
+        if (it->expiresAtMs <= now) {
+            it = d->entries.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+
+    if (removed > 0) {
+        Logger::debug("AsyncResultStore", QString("清理过期异步结果: %1").arg(removed));
+    }
+    return removed;
+}
+
+void AsyncResultStore::markFinished(const QString& id)
+{
+    auto* d = d_func();
+    QString entryOwner;
+    {
+        QMutexLocker locker(&d->mutex);
+        auto it = d->entries.find(id);
+        if (it == d->entries.end()) {
+            return;
+        }
+        qint64 now = d->nowMs();
+        it->finishedAtMs = now;
+        it->expiresAtMs = now + d->config.ttlMs;  // 完成后重新计算过期时间
+        entryOwner = it->owner;
+    }
+
+    emit resultReady(id, entryOwner);
+}
+
+} // namespace Core
+} // namespace Eagle
@@ -0,0 +1,42 @@
+#ifndef ASYNCRESULTSTORE_P_H
+#define ASYNCRESULTSTORE_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include "eagle/core/AsyncResultStore.h"
+
+namespace Eagle {
+namespace Core {
+
+/**
+ * @brief 异步结果条目
+ */
+struct AsyncResultEntry {
+    ServiceCallFuture future;
+    QString serviceName;
+    QString method;
+    QString owner;
+    qint64 expiresAtMs = 0;      // 单调时钟下的过期时间
+    qint64 finishedAtMs = -1;    // 完成时间，-1表示未完成
+    quint64 subscription = 0;    // 完成通知的订阅ID，析构时取消
+};
+
+class AsyncResultStorePrivate {
+public:
+    AsyncResultStoreConfig config;
+    QHash<QString, AsyncResultEntry> entries;  // id -> entry
+    QElapsedTimer clock;                       // 单调时钟
+    QTimer* purgeTimer = nullptr;
+    mutable QMutex mutex;
+
+    qint64 nowMs() const { return clock.elapsed(); }
+    bool evictOldestFinished();
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // ASYNCRESULTSTORE_P_H
@@ -1,12 +1,11 @@
 #include "eagle/core/AsyncServiceCall.h"
 #include "eagle/core/ServiceRegistry.h"
 #include "eagle/core/Logger.h"
-#include <QtCore/QThreadPool>
+#include "eagle/core/Bulkhead.h"
+#include "Bulkhead_p.h"
 #include <QtCore/QMutexLocker>
 #include <QtCore/QElapsedTimer>
-#include <QtCore/QTimer>
-#include <QtCore/QFutureWatcher>
-#include <QtConcurrent/QtConcurrent>
+#include <QtCore/QPointer>
 #include <exception>
 
 namespace Eagle {
@@ -14,176 +13,189 @@ namespace Core {
 
 // ==================== ServiceFuture ====================
 
-ServiceFuture::ServiceFuture(QObject* parent)
+ServiceFuture::ServiceFuture(const ServiceCallFuture& future, QObject* parent)
     : QObject(parent)
-    , finishedFlag(false)
+    , future(future)
+    , subscription(0)
 {
+    // 结果投递到本对象所在线程后再发出信号；执行器在本线程检查存活，这里再守卫一次，
+    // 即使unsubscribe因结果已在调度而失败，对象销毁后投递也会被丢弃
+    QPointer<ServiceFuture> self(this);
+    subscription = this->future.subscribe([self](const ServiceCallResult& result) {
+        if (!self) {
+            return;
+        }
+        emit self->finished(result);
+        if (result.success) {
+            emit self->succeeded(result.result);
+        } else {
+            emit self->failed(result.error);
+        }
+    }, ServiceExecutors::eventLoop(this));
 }
 
 ServiceFuture::~ServiceFuture()
 {
+    future.unsubscribe(subscription);
 }
 
 ServiceCallResult ServiceFuture::wait(int timeoutMs)
 {
-    QMutexLocker locker(&mutex);
-    
-    if (finishedFlag) {
-        return callResult;
-    }
-    
-    if (timeoutMs < 0) {
-        // 无限等待
-        condition.wait(&mutex);
-    } else {
-        // 超时等待
-        bool timedOut = !condition.wait(&mutex, timeoutMs);
-        if (timedOut) {
-            ServiceCallResult timeoutResult;
-            timeoutResult.success = false;
-            timeoutResult.error = "Timeout waiting for service call result";
-            timeoutResult.elapsedMs = timeoutMs;
-            return timeoutResult;
-        }
-    }
-    
-    return callResult;
+    return future.wait(timeoutMs);
 }
 
 bool ServiceFuture::isFinished() const
 {
-    QMutexLocker locker(&mutex);
-    return finishedFlag;
+    return future.isFinished();
 }
 
 bool ServiceFuture::isSuccess() const
 {
-    QMutexLocker locker(&mutex);
-    return finishedFlag && callResult.success;
+    return future.isFinished() && future.result().success;
 }
 
 QVariant ServiceFuture::result() const
 {
-    QMutexLocker locker(&mutex);
-    if (finishedFlag && callResult.success) {
-        return callResult.result;
-    }
-    return QVariant();
+    ServiceCallResult callResult = future.result();
+    return callResult.success ? callResult.result : QVariant();
 }
 
 QString ServiceFuture::error() const
 {
-    QMutexLocker locker(&mutex);
-    if (finishedFlag && !callResult.success) {
-        return callResult.error;
+    if (!future.isFinished()) {
+        return QString();
     }
-    return QString();
+    ServiceCallResult callResult = future.result();
+    return callResult.success ? QString() : callResult.error;
 }
 
 int ServiceFuture::elapsedMs() const
 {
-    QMutexLocker locker(&mutex);
-    return callResult.elapsedMs;
+    return future.result().elapsedMs;
+}
+
+ServiceCallFuture ServiceFuture::callFuture() const
+{
+    return future;
 }
 
 ServiceFuture* ServiceFuture::then(std::function<QVariant(const QVariant&)> callback)
 {
-    ServiceFuture* nextFuture = new ServiceFuture(this);
-    
-    connect(this, &ServiceFuture::succeeded, [nextFuture, callback](const QVariant& result) {
-        try {
-            QVariant newResult = callback(result);
-            ServiceCallResult callResult(newResult);
-            nextFuture->setResult(callResult);
-        } catch (const std::exception& e) {
-            ServiceCallResult errorResult(QString("Exception in then callback: %1").arg(e.what()));
-            nextFuture->setResult(errorResult);
-        }
-    });
-    
-    connect(this, &ServiceFuture::failed, [nextFuture](const QString& error) {
-        ServiceCallResult errorResult(error);
-        nextFuture->setResult(errorResult);
-    });
-    
-    return nextFuture;
+    return new ServiceFuture(future.then(callback, ServiceExecutors::eventLoop(this)), this);
 }
 
 ServiceFuture* ServiceFuture::onError(std::function<void(const QString&)> callback)
 {
-    connect(this, &ServiceFuture::failed, callback);
+    future.onError(callback, ServiceExecutors::eventLoop(this));
     return this;
 }
 
 ServiceFuture* ServiceFuture::finally(std::function<void()> callback)
 {
-    connect(this, &ServiceFuture::finished, [callback](const ServiceCallResult&) {
-        callback();
-    });
+    future.finally(callback, ServiceExecutors::eventLoop(this));
     return this;
 }
 
-void ServiceFuture::setResult(const ServiceCallResult& result)
-{
-    QMutexLocker locker(&mutex);
-    callResult = result;
-    finishedFlag = true;
-    locker.unlock();
-    condition.wakeAll();
-    
-    emit finished(result);
-    if (result.success) {
-        emit succeeded(result.result);
-    } else {
-        emit failed(result.error);
-    }
-}
-
 // ==================== AsyncServiceCall ====================
 
 AsyncServiceCall::AsyncServiceCall(ServiceRegistry* serviceRegistry, QObject* parent)
     : QObject(parent)
     , serviceRegistry(serviceRegistry)
-    , threadPool(QThreadPool::globalInstance())
+    , workExecutor(new WorkStealingExecutor(0, this))
+    , results(new AsyncResultStore(this))
 {
-    if (!threadPool) {
-        threadPool = new QThreadPool(this);
-        threadPool->setMaxThreadCount(10);
-    }
+    qRegisterMetaType<ServiceCallResult>("ServiceCallResult");
 }
 
 AsyncServiceCall::~AsyncServiceCall()
 {
+    // 先执行完已提交的调用，避免任务在本对象析构后访问成员
+    workExecutor->shutdown();
 }
 
-ServiceFuture* AsyncServiceCall::callAsync(const QString& serviceName, 
-                                          const QString& method,
-                                          const QVariantList& args,
-                                          int timeout)
+WorkStealingExecutor* AsyncServiceCall::executor() const
+{
+    return workExecutor;
+}
+
+AsyncResultStore* AsyncServiceCall::resultStore() const
+{
+    return results;
+}
+
+ServiceCallFuture AsyncServiceCall::call(const QString& serviceName,
+                                         const QString& method,
+                                         const QVariantList& args,
+                                         int timeout)
 {
-    ServiceFuture* future = new ServiceFuture(this);
+    ServicePromise promise;
+    ServiceCallFuture future = promise.future();
     
     emit callStarted(serviceName, method);
     
-    // 使用QtConcurrent在后台线程执行
-    QFuture<ServiceCallResult> qtFuture = QtConcurrent::run(threadPool, [=]() {
-        return executeCall(serviceName, method, args, timeout);
-    });
+    auto task = [this, promise, serviceName, method, args, timeout]() {
+        ServiceCallResult result = executeCall(serviceName, method, args, timeout);
+        promise.setResult(result);
+        emit callFinished(serviceName, method, result);
+    };
     
-    // 使用QFutureWatcher监控完成
-    QFutureWatcher<ServiceCallResult>* watcher = new QFutureWatcher<ServiceCallResult>(this);
-    connect(watcher, &QFutureWatcher<ServiceCallResult>::finished, [=]() {
-        ServiceCallResult result = qtFuture.result();
-        future->setResult(result);
+    // 执行器停止后提交会被拒绝，必须在这里完成Future，否则等待方永远阻塞
+    auto rejectStopped = [this, promise, serviceName, method]() {
+        ServiceCallResult result(QString("Async executor stopped: %1").arg(serviceName));
+        promise.setResult(result);
         emit callFinished(serviceName, method, result);
-        watcher->deleteLater();
-    });
+    };
+    
+    // 配置了舱壁的服务投递到舱壁自己的有界通道，其余按服务的优先级通道和并发上限投递
+    BulkheadManager* bulkheads = serviceRegistry ? serviceRegistry->bulkheadManager() : nullptr;
+    QString bulkhead = bulkheads ? bulkheads->bulkheadFor(serviceName) : QString();
+    if (bulkhead.isEmpty()) {
+        if (!workExecutor->submit(serviceName, std::move(task))) {
+            rejectStopped();
+        }
+        return future;
+    }
     
-    watcher->setFuture(qtFuture);
+    // 通道已限制并发，callService中不再等待舱壁信号量
+    auto laneTask = [bulkhead, task]() {
+        BulkheadLaneScope lane(bulkhead);
+        task();
+    };
+    
+    if (!workExecutor->trySubmit(bulkhead, std::move(laneTask))) {
+        // 只有通道已满才算舱壁拒绝
+        if (workExecutor->isStopping()) {
+            rejectStopped();
+            return future;
+        }
+        bulkheads->recordQueueRejection(bulkhead, serviceName);
+        
+        // 舱壁队列已满：在公共通道执行降级方案，不占用该舱壁的名额
+        bool accepted = workExecutor->submit([this, promise, serviceName, method, args, bulkhead]() {
+            QVariant degradedResult = serviceRegistry->tryDegrade(serviceName, method, args,
+                                                                  DegradationTrigger::BulkheadFull);
+            ServiceCallResult result = degradedResult.isValid()
+                ? ServiceCallResult(degradedResult)
+                : ServiceCallResult(QString("Service bulkhead queue full: %1 (bulkhead %2)").arg(serviceName, bulkhead));
+            promise.setResult(result);
+            emit callFinished(serviceName, method, result);
+        }, TaskPriority::High);
+        if (!accepted) {
+            rejectStopped();
+        }
+    }
     
     return future;
 }
 
+ServiceFuture* AsyncServiceCall::callAsync(const QString& serviceName, 
+                                          const QString& method,
+                                          const QVariantList& args,
+                                          int timeout)
+{
+    return new ServiceFuture(call(serviceName, method, args, timeout), this);
+}
+
 void AsyncServiceCall::callAsync(const QString& serviceName,
                                  const QString& method,
                                  const QVariantList& args,
@@ -191,19 +203,16 @@ void AsyncServiceCall::callAsync(const QString& serviceName,
                                  std::function<void(const QString&)> onError,
                                  int timeout)
 {
-    ServiceFuture* future = callAsync(serviceName, method, args, timeout);
-    
-    connect(future, &ServiceFuture::succeeded, [onSuccess](const QVariant& result) {
-        if (onSuccess) {
-            onSuccess(result);
-        }
-    });
-    
-    connect(future, &ServiceFuture::failed, [onError](const QString& error) {
-        if (onError) {
-            onError(error);
+    // 回调在本对象所在线程执行，不需要为每次调用创建ServiceFuture
+    call(serviceName, method, args, timeout).subscribe([onSuccess, onError](const ServiceCallResult& result) {
+        if (result.success) {
+            if (onSuccess) {
+                onSuccess(result.result);
+            }
+        } else if (onError) {
+            onError(result.error);
         }
-    });
+    }, ServiceExecutors::eventLoop(this));
 }
 
 QList<ServiceFuture*> AsyncServiceCall::callBatch(const QList<QPair<QString, QPair<QString, QVariantList>>>& calls)
@@ -253,22 +262,17 @@ ServiceFuture* AsyncServiceCall::waitForAny(const QList<ServiceFuture*>& futures
         return nullptr;
     }
     
-    QElapsedTimer timer;
-    timer.start();
+    // 组合为一个whenAny Future后等待，避免轮询
+    QList<ServiceCallFuture> callFutures;
+    for (ServiceFuture* future : futures) {
+        callFutures.append(future->callFuture());
+    }
     
-    while (true) {
-        for (ServiceFuture* future : futures) {
-            if (future->isFinished()) {
-                return future;
-            }
-        }
-        
-        if (timeoutMs >= 0 && timer.elapsed() >= timeoutMs) {
-            return nullptr;
-        }
-        
-        QThread::msleep(10); // 短暂休眠，避免CPU占用过高
+    ServiceCallResult first = whenAny(callFutures).wait(timeoutMs);
+    if (!first.success) {
+        return nullptr;
     }
+    return futures.value(first.result.toMap().value("index").toInt());
 }
 
 ServiceCallResult AsyncServiceCall::executeCall(const QString& serviceName, 
@@ -289,6 +293,11 @@ ServiceCallResult AsyncServiceCall::executeCall(const QString& serviceName,
         
         ServiceCallResult callResult(result);
         callResult.elapsedMs = elapsed;
+        
+        // 降级返回缓存旧值时把陈旧信息带给调用方
+        StaleResultInfo staleness = serviceRegistry->lastResultStaleness();
+        callResult.stale = staleness.stale;
+        callResult.staleAgeMs = staleness.ageMs;
         return callResult;
     } catch (const std::exception& e) {
         int elapsed = static_cast<int>(timer.elapsed());
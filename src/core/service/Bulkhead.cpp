@@ -0,0 +1,246 @@
+#include "eagle/core/Bulkhead.h"
+#include "Bulkhead_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QMutexLocker>
+#include <QtCore/QDeadlineTimer>
+
+namespace Eagle {
+namespace Core {
+
+namespace {
+
+thread_local const BulkheadLaneScope* currentLaneScope = nullptr;
+
+} // namespace
+
+BulkheadLaneScope::BulkheadLaneScope(const QString& name)
+    : name(name)
+    , previous(currentLaneScope)
+{
+    currentLaneScope = this;
+}
+
+BulkheadLaneScope::~BulkheadLaneScope()
+{
+    currentLaneScope = previous;
+}
+
+bool BulkheadLaneScope::isCurrent(const QString& name)
+{
+    return currentLaneScope && currentLaneScope->name == name;
+}
+
+std::shared_ptr<BulkheadState> BulkheadManagerPrivate::state(const QString& name) const
+{
+    QMutexLocker locker(&mutex);
+    return bulkheads.value(name);
+}
+
+BulkheadManager::BulkheadManager(QObject* parent)
+    : QObject(parent)
+    , d_ptr(new BulkheadManagerPrivate)
+{
+}
+
+BulkheadManager::~BulkheadManager()
+{
+    delete d_ptr;
+}
+
+void BulkheadManager::setBulkhead(const QString& name, const BulkheadConfig& config)
+{
+    auto* d = d_func();
+    std::shared_ptr<BulkheadState> state;
+    {
+        QMutexLocker locker(&d->mutex);
+        state = d->bulkheads.value(name);
+        if (!state) {
+            state = std::make_shared<BulkheadState>();
+            d->bulkheads.insert(name, state);
+        }
+    }
+
+    {
+        // 已持有名额的调用不受影响，新上限从下一次获取开始生效
+        QMutexLocker locker(&state->mutex);
+        state->config = config;
+        state->released.wakeAll();
+    }
+
+    Logger::info("Bulkhead", QString("设置舱壁: %1 (并发%2, 等待%3ms, 队列%4)")
+        .arg(name).arg(config.maxConcurrentCalls).arg(config.maxWaitMs).arg(config.maxQueueDepth));
+}
+
+void BulkheadManager::removeBulkhead(const QString& name)
+{
+    auto* d = d_func();
+    std::shared_ptr<BulkheadState> state;
+    {
+        QMutexLocker locker(&d->mutex);
+        state = d->bulkheads.take(name);
+    }
+
+    if (state) {
+        // 唤醒等待者，让其重新检查（舱壁移除后不再限制）
+        QMutexLocker locker(&state->mutex);
+        state->config.maxConcurrentCalls = 0;
+        state->released.wakeAll();
+        Logger::info("Bulkhead", QString("移除舱壁: %1").arg(name));
+    }
+}
+
+bool BulkheadManager::hasBulkhead(const QString& name) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->bulkheads.contains(name);
+}
+
+BulkheadConfig BulkheadManager::bulkheadConfig(const QString& name) const
+{
+    const auto* d = d_func();
+    std::shared_ptr<BulkheadState> state = d->state(name);
+    if (!state) {
+        return BulkheadConfig();
+    }
+    QMutexLocker locker(&state->mutex);
+    return state->config;
+}
+
+QStringList BulkheadManager::bulkheads() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->bulkheads.keys();
+}
+
+void BulkheadManager::assignService(const QString& serviceName, const QString& bulkheadName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->assignments.insert(serviceName, bulkheadName);
+}
+
+void BulkheadManager::unassignService(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->assignments.remove(serviceName);
+}
+
+QString BulkheadManager::bulkheadFor(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    if (d->bulkheads.contains(serviceName)) {
+        return serviceName;
+    }
+    QString assigned = d->assignments.value(serviceName);
+    if (!assigned.isEmpty() && d->bulkheads.contains(assigned)) {
+        return assigned;
+    }
+    return QString();
+}
+
+bool BulkheadManager::tryAcquire(const QString& name, const QString& serviceName)
+{
+    auto* d = d_func();
+    std::shared_ptr<BulkheadState> state = d->state(name);
+    if (!state) {
+        return true;
+    }
+
+    {
+        QMutexLocker locker(&state->mutex);
+        QDeadlineTimer deadline(qMax(0, state->config.maxWaitMs));
+        while (state->config.maxConcurrentCalls > 0 && state->active >= state->config.maxConcurrentCalls) {
+            if (deadline.hasExpired()) {
+                break;
+            }
+            state->waiting++;
+            state->released.wait(&state->mutex, deadline);
+            state->waiting--;
+        }
+
+        if (state->config.maxConcurrentCalls <= 0 || state->active < state->config.maxConcurrentCalls) {
+            state->active++;
+            state->accepted++;
+            state->peakActive = qMax(state->peakActive, state->active);
+            return true;
+        }
+        state->rejected++;
+    }
+
+    Logger::warning("Bulkhead", QString("舱壁已满，拒绝调用: %1 (服务: %2)").arg(name, serviceName));
+    emit callRejected(name, serviceName, "concurrency");
+    return false;
+}
+
+void BulkheadManager::acquireForLane(const QString& name)
+{
+    auto* d = d_func();
+    std::shared_ptr<BulkheadState> state = d->state(name);
+    if (!state) {
+        return;
+    }
+
+    QMutexLocker locker(&state->mutex);
+    state->active++;
+    state->accepted++;
+    state->peakActive = qMax(state->peakActive, state->active);
+}
+
+void BulkheadManager::release(const QString& name)
+{
+    auto* d = d_func();
+    std::shared_ptr<BulkheadState> state = d->state(name);
+    if (!state) {
+        return;
+    }
+
+    QMutexLocker locker(&state->mutex);
+    state->active = qMax(0, state->active - 1);
+    state->released.wakeOne();
+}
+
+void BulkheadManager::recordQueueRejection(const QString& name, const QString& serviceName)
+{
+    auto* d = d_func();
+    std::shared_ptr<BulkheadState> state = d->state(name);
+    if (state) {
+        QMutexLocker locker(&state->mutex);
+        state->queueRejected++;
+    }
+
+    Logger::warning("Bulkhead", QString("舱壁队列已满，拒绝异步调用: %1 (服务: %2)").arg(name, serviceName));
+    emit callRejected(name, serviceName, "queue");
+}
+
+QVariantMap BulkheadManager::getStatistics(const QString& name) const
+{
+    const auto* d = d_func();
+    QVariantMap stats;
+    stats["name"] = name;
+
+    std::shared_ptr<BulkheadState> state = d->state(name);
+    if (!state) {
+        stats["configured"] = false;
+        return stats;
+    }
+
+    QMutexLocker locker(&state->mutex);
+    stats["configured"] = true;
+    stats["maxConcurrentCalls"] = state->config.maxConcurrentCalls;
+    stats["maxWaitMs"] = state->config.maxWaitMs;
+    stats["maxQueueDepth"] = state->config.maxQueueDepth;
+    stats["active"] = state->active;
+    stats["waiting"] = state->waiting;
+    stats["peakActive"] = state->peakActive;
+    stats["accepted"] = state->accepted;
+    stats["rejected"] = state->rejected;
+    stats["queueRejected"] = state->queueRejected;
+    return stats;
+}
+
+} // namespace Core
+} // namespace Eagle
@@ -0,0 +1,65 @@
+#ifndef BULKHEAD_P_H
+#define BULKHEAD_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include "eagle/core/Bulkhead.h"
+#include <memory>
+
+namespace Eagle {
+namespace Core {
+
+/**
+ * @brief 单个舱壁的运行状态
+ *
+ * 每个舱壁使用独立的锁和条件变量，等待名额的调用不影响其他舱壁。
+ */
+struct BulkheadState {
+    BulkheadConfig config;
+    QMutex mutex;
+    QWaitCondition released;
+    int active = 0;
+    int waiting = 0;
+    int peakActive = 0;
+    qint64 accepted = 0;
+    qint64 rejected = 0;          // 并发名额不足被拒绝
+    qint64 queueRejected = 0;     // 异步队列已满被拒绝
+};
+
+/**
+ * @brief 标记当前线程正在执行某个舱壁执行器通道中的异步调用
+ *
+ * 通道已按舱壁的maxConcurrentCalls限制并发，作用域内的调用不再等待舱壁信号量。
+ */
+class BulkheadLaneScope {
+public:
+    explicit BulkheadLaneScope(const QString& name);
+    ~BulkheadLaneScope();
+
+    /**
+     * @brief 当前线程是否在指定舱壁的通道中执行
+     */
+    static bool isCurrent(const QString& name);
+
+private:
+    QString name;
+    const BulkheadLaneScope* previous;
+
+    Q_DISABLE_COPY(BulkheadLaneScope)
+};
+
+class BulkheadManagerPrivate {
+public:
+    QHash<QString, std::shared_ptr<BulkheadState>> bulkheads;   // name -> state
+    QHash<QString, QString> assignments;                       // serviceName -> bulkheadName
+    mutable QMutex mutex;                                      // 保护上面两个表
+
+    std::shared_ptr<BulkheadState> state(const QString& name) const;
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // BULKHEAD_P_H
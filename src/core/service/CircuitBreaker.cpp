@@ -1,103 +1,161 @@
 #include "eagle/core/CircuitBreaker.h"
 #include "eagle/core/Logger.h"
-#include <QtCore/QMutexLocker>
 
 namespace Eagle {
 namespace Core {
 
-CircuitBreaker::CircuitBreaker(const QString& serviceName, 
+namespace {
+
+const int kCountBits = 21;
+const quint64 kCountMask = (1ULL << kCountBits) - 1;
+const quint64 kStateMask = 0x3;
+
+quint64 packStateWord(CircuitState state, qint64 sinceMs)
+{
+    return (static_cast<quint64>(sinceMs) << 2) | static_cast<quint64>(state);
+}
+
+CircuitState wordState(quint64 word)
+{
+    return static_cast<CircuitState>(word & kStateMask);
+}
+
+qint64 wordSinceMs(quint64 word)
+{
+    return static_cast<qint64>(word >> 2);
+}
+
+QString stateName(CircuitState state)
+{
+    switch (state) {
+    case CircuitState::Closed:
+        return "Closed";
+    case CircuitState::Open:
+        return "Open";
+    case CircuitState::HalfOpen:
+        return "HalfOpen";
+    }
+    return "Unknown";
+}
+
+} // namespace
+
+CircuitBreaker::CircuitBreaker(const QString& serviceName,
                                const CircuitBreakerConfig& config,
                                QObject* parent)
     : QObject(parent)
     , m_serviceName(serviceName)
     , m_config(config)
-    , m_state(CircuitState::Closed)
-    , m_failureCount(0)
-    , m_successCount(0)
+    , m_stateWord(packStateWord(CircuitState::Closed, 0))
+    , m_halfOpenPermits(0)
+    , m_halfOpenSuccesses(0)
 {
-    m_timeoutTimer = new QTimer(this);
-    m_timeoutTimer->setSingleShot(true);
-    connect(m_timeoutTimer, &QTimer::timeout, this, &CircuitBreaker::onTimeout);
+    m_clock.start();
     
-    m_halfOpenTimer = new QTimer(this);
-    m_halfOpenTimer->setSingleShot(true);
-    connect(m_halfOpenTimer, &QTimer::timeout, this, &CircuitBreaker::onHalfOpenTimeout);
+    m_bucketCount = qMax(1, m_config.windowBuckets);
+    m_bucketMs = qMax<qint64>(1, m_config.windowMs / m_bucketCount);
+    m_buckets.reset(new Bucket[m_bucketCount]);
 }
 
-bool CircuitBreaker::allowCall()
+CircuitBreaker::~CircuitBreaker()
 {
-    QMutexLocker locker(&m_mutex);
+}
+
+bool CircuitBreaker::allowCall(bool* probe)
+{
+    if (probe) {
+        *probe = false;
+    }
+    quint64 word = m_stateWord.load(std::memory_order_acquire);
+    qint64 now = nowMs();
     
-    switch (m_state) {
+    switch (wordState(word)) {
     case CircuitState::Closed:
         return true;
-        
+    
     case CircuitState::Open:
         // 检查是否超时，可以进入半开状态
-        if (m_lastFailureTime.isValid()) {
-            int elapsed = m_lastFailureTime.msecsTo(QDateTime::currentDateTime());
-            if (elapsed >= m_config.timeoutMs) {
-                setState(CircuitState::HalfOpen);
-                m_successCount = 0;
-                m_halfOpenTimer->start(m_config.halfOpenTimeoutMs);
-                Logger::info("CircuitBreaker", QString("熔断器进入半开状态: %1").arg(m_serviceName));
-                return true;
-            }
+        if (now - wordSinceMs(word) < m_config.timeoutMs) {
+            return false;
         }
-        return false;
-        
+        if (transition(word, CircuitState::HalfOpen)) {
+            Logger::info("CircuitBreaker", QString("熔断器进入半开状态: %1").arg(m_serviceName));
+        }
+        word = m_stateWord.load(std::memory_order_acquire);
+        if (wordState(word) != CircuitState::HalfOpen) {
+            return wordState(word) == CircuitState::Closed;
+        }
+        break;
+    
     case CircuitState::HalfOpen:
-        return true;
+        break;
     }
     
-    return false;
+    // 半开状态：超时未完成探测则重新熔断，否则按名额放行探测调用
+    if (now - wordSinceMs(word) >= m_config.halfOpenTimeoutMs) {
+        if (transition(word, CircuitState::Open)) {
+            Logger::warning("CircuitBreaker", QString("半开状态超时，重新熔断: %1").arg(m_serviceName));
+        }
+        return false;
+    }
+    if (m_halfOpenPermits.fetch_sub(1, std::memory_order_acq_rel) <= 0) {
+        m_halfOpenPermits.fetch_add(1, std::memory_order_acq_rel);  // 名额已用尽，撤销本次扣减
+        return false;
+    }
+    if (probe) {
+        *probe = true;
+    }
+    return true;
+}
+
+void CircuitBreaker::releaseProbe()
+{
+    // 半开期间才归还；状态已变化时新状态会重新初始化名额
+    if (wordState(m_stateWord.load(std::memory_order_acquire)) == CircuitState::HalfOpen) {
+        m_halfOpenPermits.fetch_add(1, std::memory_order_acq_rel);
+    }
 }
 
-void CircuitBreaker::recordSuccess()
+void CircuitBreaker::recordSuccess(qint64 durationMs)
 {
-    QMutexLocker locker(&m_mutex);
+    recordCall(false, durationMs);
     
-    if (m_state == CircuitState::HalfOpen) {
-        m_successCount++;
-        if (m_successCount >= m_config.successThreshold) {
-            setState(CircuitState::Closed);
-            m_failureCount = 0;
-            m_halfOpenTimer->stop();
+    quint64 word = m_stateWord.load(std::memory_order_acquire);
+    if (wordState(word) == CircuitState::HalfOpen) {
+        int successes = m_halfOpenSuccesses.fetch_add(1, std::memory_order_acq_rel) + 1;
+        if (successes >= m_config.successThreshold && transition(word, CircuitState::Closed)) {
             Logger::info("CircuitBreaker", QString("熔断器恢复正常: %1").arg(m_serviceName));
         }
-    } else if (m_state == CircuitState::Closed) {
-        // 正常状态下，成功调用可以重置失败计数
-        m_failureCount = 0;
+    } else if (wordState(word) == CircuitState::Closed) {
+        // 慢调用也可能触发熔断
+        evaluateThresholds();
     }
 }
 
-void CircuitBreaker::recordFailure()
+void CircuitBreaker::recordFailure(qint64 durationMs)
 {
-    QMutexLocker locker(&m_mutex);
-    
-    m_failureCount++;
-    m_lastFailureTime = QDateTime::currentDateTime();
+    recordCall(true, durationMs);
     
-    if (m_state == CircuitState::HalfOpen) {
+    quint64 word = m_stateWord.load(std::memory_order_acquire);
+    if (wordState(word) == CircuitState::HalfOpen) {
         // 半开状态下失败，立即熔断
-        setState(CircuitState::Open);
-        m_halfOpenTimer->stop();
-        m_timeoutTimer->start(m_config.timeoutMs);
-        Logger::warning("CircuitBreaker", QString("熔断器再次开启: %1").arg(m_serviceName));
-    } else if (m_state == CircuitState::Closed) {
-        if (m_failureCount >= m_config.failureThreshold) {
-            setState(CircuitState::Open);
-            m_timeoutTimer->start(m_config.timeoutMs);
-            Logger::error("CircuitBreaker", QString("熔断器开启: %1 (失败次数: %2)")
-                .arg(m_serviceName).arg(m_failureCount));
+        if (transition(word, CircuitState::Open)) {
+            Logger::warning("CircuitBreaker", QString("熔断器再次开启: %1").arg(m_serviceName));
         }
+    } else if (wordState(word) == CircuitState::Closed) {
+        evaluateThresholds();
     }
 }
 
 CircuitState CircuitBreaker::state() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_state;
+    quint64 word = m_stateWord.load(std::memory_order_acquire);
+    CircuitState current = wordState(word);
+    // 熔断超时后下一次调用即进入半开状态，这里提前反映出来
+    if (current == CircuitState::Open && nowMs() - wordSinceMs(word) >= m_config.timeoutMs) {
+        return CircuitState::HalfOpen;
+    }
+    return current;
 }
 
 QString CircuitBreaker::serviceName() const
@@ -105,47 +163,129 @@ QString CircuitBreaker::serviceName() const
     return m_serviceName;
 }
 
+CircuitBreakerConfig CircuitBreaker::config() const
+{
+    return m_config;
+}
+
+QVariantMap CircuitBreaker::getStatistics() const
+{
+    WindowTotals totals = windowTotals();
+    
+    QVariantMap stats;
+    stats["serviceName"] = m_serviceName;
+    stats["state"] = stateName(state());
+    stats["calls"] = totals.calls;
+    stats["failures"] = totals.failures;
+    stats["slowCalls"] = totals.slowCalls;
+    stats["failureRate"] = totals.calls > 0 ? totals.failures * 100.0 / totals.calls : 0.0;
+    stats["slowCallRate"] = totals.calls > 0 ? totals.slowCalls * 100.0 / totals.calls : 0.0;
+    stats["windowMs"] = m_bucketMs * m_bucketCount;
+    return stats;
+}
+
 void CircuitBreaker::reset()
 {
-    QMutexLocker locker(&m_mutex);
-    setState(CircuitState::Closed);
-    m_failureCount = 0;
-    m_successCount = 0;
-    m_lastFailureTime = QDateTime();
-    m_timeoutTimer->stop();
-    m_halfOpenTimer->stop();
+    quint64 word = m_stateWord.load(std::memory_order_acquire);
+    while (!transition(word, CircuitState::Closed)) {
+        word = m_stateWord.load(std::memory_order_acquire);
+    }
     Logger::info("CircuitBreaker", QString("熔断器重置: %1").arg(m_serviceName));
 }
 
-void CircuitBreaker::onTimeout()
+qint64 CircuitBreaker::nowMs() const
+{
+    return m_clock.elapsed();
+}
+
+void CircuitBreaker::recordCall(bool failed, qint64 durationMs)
 {
-    QMutexLocker locker(&m_mutex);
-    if (m_state == CircuitState::Open) {
-        setState(CircuitState::HalfOpen);
-        m_successCount = 0;
-        m_halfOpenTimer->start(m_config.halfOpenTimeoutMs);
-        Logger::info("CircuitBreaker", QString("熔断器超时，进入半开状态: %1").arg(m_serviceName));
+    qint64 epoch = nowMs() / m_bucketMs;
+    Bucket& bucket = m_buckets[epoch % m_bucketCount];
+    
+    // 时间片滚动时由CAS胜出的线程清零；与清零并发的少量计数可能丢失，对比率统计无影响
+    qint64 current = bucket.epoch.load(std::memory_order_acquire);
+    if (current != epoch && bucket.epoch.compare_exchange_strong(current, epoch, std::memory_order_acq_rel)) {
+        bucket.counts.store(0, std::memory_order_release);
+    }
+    
+    quint64 delta = 1;
+    if (failed) {
+        delta |= 1ULL << kCountBits;
+    }
+    if (durationMs >= m_config.slowCallDurationMs) {
+        delta |= 1ULL << (2 * kCountBits);
     }
+    bucket.counts.fetch_add(delta, std::memory_order_acq_rel);
 }
 
-void CircuitBreaker::onHalfOpenTimeout()
+CircuitBreaker::WindowTotals CircuitBreaker::windowTotals() const
 {
-    QMutexLocker locker(&m_mutex);
-    if (m_state == CircuitState::HalfOpen) {
-        // 半开状态下没有达到成功阈值，重新熔断
-        setState(CircuitState::Open);
-        m_timeoutTimer->start(m_config.timeoutMs);
-        Logger::warning("CircuitBreaker", QString("半开状态超时，重新熔断: %1").arg(m_serviceName));
+    WindowTotals totals;
+    qint64 epoch = nowMs() / m_bucketMs;
+    for (int i = 0; i < m_bucketCount; ++i) {
+        const Bucket& bucket = m_buckets[i];
+        qint64 bucketEpoch = bucket.epoch.load(std::memory_order_acquire);
+        if (bucketEpoch < 0 || epoch - bucketEpoch >= m_bucketCount) {
+            continue;  // 已滑出窗口
+        }
+        quint64 counts = bucket.counts.load(std::memory_order_acquire);
+        totals.calls += static_cast<qint64>(counts & kCountMask);
+        totals.failures += static_cast<qint64>((counts >> kCountBits) & kCountMask);
+        totals.slowCalls += static_cast<qint64>((counts >> (2 * kCountBits)) & kCountMask);
+    }
+    return totals;
+}
+
+void CircuitBreaker::clearWindow()
+{
+    for (int i = 0; i < m_bucketCount; ++i) {
+        m_buckets[i].epoch.store(-1, std::memory_order_release);
+        m_buckets[i].counts.store(0, std::memory_order_release);
+    }
+}
+
+void CircuitBreaker::evaluateThresholds()
+{
+    WindowTotals totals = windowTotals();
+    if (totals.calls < m_config.minimumCalls || totals.calls == 0) {
+        return;
+    }
+    
+    double failureRate = totals.failures * 100.0 / totals.calls;
+    double slowCallRate = totals.slowCalls * 100.0 / totals.calls;
+    if (failureRate < m_config.failureRateThreshold && slowCallRate < m_config.slowCallRateThreshold) {
+        return;
+    }
+    
+    quint64 word = m_stateWord.load(std::memory_order_acquire);
+    if (wordState(word) == CircuitState::Closed && transition(word, CircuitState::Open)) {
+        Logger::error("CircuitBreaker", QString("熔断器开启: %1 (调用数: %2, 失败率: %3%, 慢调用率: %4%)")
+            .arg(m_serviceName).arg(totals.calls)
+            .arg(failureRate, 0, 'f', 1).arg(slowCallRate, 0, 'f', 1));
     }
 }
 
-void CircuitBreaker::setState(CircuitState newState)
+bool CircuitBreaker::transition(quint64 expectedWord, CircuitState newState)
 {
-    if (m_state != newState) {
-        CircuitState oldState = m_state;
-        m_state = newState;
+    CircuitState oldState = wordState(expectedWord);
+    quint64 desired = packStateWord(newState, nowMs());
+    if (!m_stateWord.compare_exchange_strong(expectedWord, desired, std::memory_order_acq_rel)) {
+        return false;
+    }
+    
+    // 只有CAS胜出的线程负责进入新状态的初始化
+    if (newState == CircuitState::HalfOpen) {
+        m_halfOpenSuccesses.store(0, std::memory_order_release);
+        m_halfOpenPermits.store(qMax(1, m_config.successThreshold), std::memory_order_release);
+    } else if (newState == CircuitState::Closed) {
+        clearWindow();
+    }
+    
+    if (oldState != newState) {
         emit stateChanged(m_serviceName, oldState, newState);
     }
+    return true;
 }
 
 } // namespace Core
@@ -0,0 +1,274 @@
+#include "eagle/core/ConcurrencyLimiter.h"
+#include "ConcurrencyLimiter_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QMutexLocker>
+#include <cmath>
+
+namespace Eagle {
+namespace Core {
+
+ConcurrencyLimitState& ConcurrencyLimiterPrivate::stateFor(const QString& serviceName)
+{
+    auto it = states.find(serviceName);
+    if (it == states.end()) {
+        ConcurrencyLimitState state;
+        state.config = serviceConfigs.value(serviceName, defaultConfig);
+        state.estimatedLimit = qBound(state.config.minLimit, state.config.initialLimit,
+                                      state.config.maxLimit);
+        it = states.insert(serviceName, state);
+    }
+    return it.value();
+}
+
+void ConcurrencyLimiterPrivate::updateLimit(ConcurrencyLimitState& state, qint64 latencyUs,
+                                            bool dropped, int inFlightAtStart)
+{
+    const ConcurrencyLimiterConfig& config = state.config;
+    double limit = state.estimatedLimit;
+
+    state.samples++;
+    state.lastRttUs = latencyUs;
+    if (state.minRttUs == 0 || latencyUs < state.minRttUs) {
+        state.minRttUs = latencyUs;
+    }
+
+    // 长期平均延迟：预热阶段为算术平均，之后为窗口大小的指数移动平均
+    qint64 window = qMin<qint64>(state.samples, qMax(1, config.longWindow));
+    state.longRttUs += (latencyUs - state.longRttUs) / window;
+
+    if (dropped) {
+        limit = limit * config.backoffRatio;
+    } else if (config.algorithm == ConcurrencyLimitAlgorithm::Aimd) {
+        if (latencyUs > qint64(config.latencyThresholdMs) * 1000) {
+            limit = limit * config.backoffRatio;
+        } else if (inFlightAtStart * 2 >= state.limit()) {
+            // 只有在并发真正接近上限时才增长，避免空闲期无限抬高上限
+            limit += 1.0;
+        }
+    } else {
+        // 延迟回落后让长期平均尽快跟上，避免上限长时间偏高
+        if (latencyUs > 0 && state.longRttUs / latencyUs > 2.0) {
+            state.longRttUs *= 0.95;
+        }
+        if (inFlightAtStart * 2 < state.limit()) {
+            return;
+        }
+        double gradient = latencyUs > 0
+            ? qBound(0.5, config.tolerance * state.longRttUs / latencyUs, 1.0)
+            : 1.0;
+        double queueSize = std::sqrt(limit);
+        double newLimit = limit * gradient + queueSize;
+        limit = limit * (1.0 - config.smoothing) + newLimit * config.smoothing;
+    }
+
+    state.estimatedLimit = qBound<double>(config.minLimit, limit, config.maxLimit);
+}
+
+ConcurrencyLimiter::ConcurrencyLimiter(QObject* parent)
+    : QObject(parent)
+    , d_ptr(new ConcurrencyLimiterPrivate)
+{
+}
+
+ConcurrencyLimiter::~ConcurrencyLimiter()
+{
+    delete d_ptr;
+}
+
+void ConcurrencyLimiter::setEnabled(bool enabled)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->enabled = enabled;
+    Logger::info("ConcurrencyLimiter", QString("自适应并发限制%1").arg(enabled ? "启用" : "禁用"));
+}
+
+bool ConcurrencyLimiter::isEnabled() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->enabled;
+}
+
+void ConcurrencyLimiter::setDefaultConfig(const ConcurrencyLimiterConfig& config)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->defaultConfig = config;
+}
+
+ConcurrencyLimiterConfig ConcurrencyLimiter::defaultConfig() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->defaultConfig;
+}
+
+void ConcurrencyLimiter::setServiceConfig(const QString& serviceName, const ConcurrencyLimiterConfig& config)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->serviceConfigs[serviceName] = config;
+
+    auto it = d->states.find(serviceName);
+    if (it != d->states.end()) {
+        it->config = config;
+        it->estimatedLimit = qBound<double>(config.minLimit, it->estimatedLimit, config.maxLimit);
+    }
+
+    Logger::info("ConcurrencyLimiter", QString("设置服务并发限制: %1 (初始%2, 范围%3-%4)")
+        .arg(serviceName).arg(config.initialLimit).arg(config.minLimit).arg(config.maxLimit));
+}
+
+ConcurrencyLimiterConfig ConcurrencyLimiter::serviceConfig(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->serviceConfigs.value(serviceName, d->defaultConfig);
+}
+
+bool ConcurrencyLimiter::tryAcquire(const QString& serviceName)
+{
+    auto* d = d_func();
+    int currentLimit = 0;
+    int currentInFlight = 0;
+    {
+        QMutexLocker locker(&d->mutex);
+        if (!d->enabled) {
+            return true;
+        }
+
+        ConcurrencyLimitState& state = d->stateFor(serviceName);
+        if (state.inFlight < state.limit()) {
+            state.inFlight++;
+            state.accepted++;
+            return true;
+        }
+
+        state.rejected++;
+        currentLimit = state.limit();
+        currentInFlight = state.inFlight;
+    }
+
+    emit requestRejected(serviceName, currentLimit, currentInFlight);
+    return false;
+}
+
+void ConcurrencyLimiter::release(const QString& serviceName, qint64 latencyUs, bool dropped)
+{
+    auto* d = d_func();
+    int oldLimit = 0;
+    int newLimit = 0;
+    {
+        QMutexLocker locker(&d->mutex);
+        auto it = d->states.find(serviceName);
+        if (it == d->states.end() || it->inFlight <= 0) {
+            // 限制器在调用期间被启用或重置，没有对应的名额
+            return;
+        }
+
+        int inFlightAtStart = it->inFlight;
+        it->inFlight--;
+        if (dropped) {
+            it->dropped++;
+        }
+
+        oldLimit = it->limit();
+        d->updateLimit(it.value(), qMax<qint64>(0, latencyUs), dropped, inFlightAtStart);
+        newLimit = it->limit();
+    }
+
+    if (newLimit != oldLimit) {
+        Logger::debug("ConcurrencyLimiter", QString("服务并发上限调整: %1 %2 -> %3")
+            .arg(serviceName).arg(oldLimit).arg(newLimit));
+        emit limitChanged(serviceName, oldLimit, newLimit);
+    }
+}
+
+void ConcurrencyLimiter::cancel(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.find(serviceName);
+    if (it != d->states.end() && it->inFlight > 0) {
+        it->inFlight--;
+    }
+}
+
+int ConcurrencyLimiter::limit(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.constFind(serviceName);
+    if (it != d->states.constEnd()) {
+        return it->limit();
+    }
+    ConcurrencyLimiterConfig config = d->serviceConfigs.value(serviceName, d->defaultConfig);
+    return qBound(config.minLimit, config.initialLimit, config.maxLimit);
+}
+
+int ConcurrencyLimiter::inFlight(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.constFind(serviceName);
+    return it != d->states.constEnd() ? it->inFlight : 0;
+}
+
+QVariantMap ConcurrencyLimiter::getStatistics(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+
+    QVariantMap stats;
+    stats["serviceName"] = serviceName;
+    stats["enabled"] = d->enabled;
+
+    auto it = d->states.constFind(serviceName);
+    if (it == d->states.constEnd()) {
+        ConcurrencyLimiterConfig config = d->serviceConfigs.value(serviceName, d->defaultConfig);
+        stats["limit"] = qBound(config.minLimit, config.initialLimit, config.maxLimit);
+        stats["inFlight"] = 0;
+        return stats;
+    }
+
+    stats["algorithm"] = it->config.algorithm == ConcurrencyLimitAlgorithm::Aimd ? "aimd" : "gradient";
+    stats["limit"] = it->limit();
+    stats["inFlight"] = it->inFlight;
+    stats["accepted"] = it->accepted;
+    stats["rejected"] = it->rejected;
+    stats["dropped"] = it->dropped;
+    stats["minRttUs"] = it->minRttUs;
+    stats["longRttUs"] = static_cast<qint64>(it->longRttUs);
+    stats["lastRttUs"] = it->lastRttUs;
+    return stats;
+}
+
+QStringList ConcurrencyLimiter::services() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->states.keys();
+}
+
+void ConcurrencyLimiter::reset(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.find(serviceName);
+    if (it == d->states.end()) {
+        return;
+    }
+
+    // 保留在途数，使进行中的调用仍能正确释放名额
+    int inFlight = it->inFlight;
+    ConcurrencyLimitState state;
+    state.config = d->serviceConfigs.value(serviceName, d->defaultConfig);
+    state.estimatedLimit = qBound(state.config.minLimit, state.config.initialLimit, state.config.maxLimit);
+    state.inFlight = inFlight;
+    it.value() = state;
+    Logger::info("ConcurrencyLimiter", QString("重置服务并发限制: %1").arg(serviceName));
+}
+
+} // namespace Core
+} // namespace Eagle
@@ -0,0 +1,45 @@
+#ifndef CONCURRENCYLIMITER_P_H
+#define CONCURRENCYLIMITER_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include "eagle/core/ConcurrencyLimiter.h"
+
+namespace Eagle {
+namespace Core {
+
+/**
+ * @brief 单个服务的并发限制状态
+ */
+struct ConcurrencyLimitState {
+    ConcurrencyLimiterConfig config;
+    double estimatedLimit = 0.0;     // 带小数的估计上限，取整后作为实际上限
+    int inFlight = 0;
+    double longRttUs = 0.0;          // 长期平均延迟（指数移动平均）
+    qint64 minRttUs = 0;             // 观察到的最小延迟
+    qint64 lastRttUs = 0;
+    qint64 accepted = 0;
+    qint64 rejected = 0;
+    qint64 dropped = 0;
+    qint64 samples = 0;
+
+    int limit() const { return qMax(1, static_cast<int>(estimatedLimit)); }
+};
+
+class ConcurrencyLimiterPrivate {
+public:
+    bool enabled = false;  // 默认关闭，由调用方显式启用
+    ConcurrencyLimiterConfig defaultConfig;
+    QHash<QString, ConcurrencyLimiterConfig> serviceConfigs;  // serviceName -> config
+    QHash<QString, ConcurrencyLimitState> states;             // serviceName -> state
+    mutable QMutex mutex;
+
+    ConcurrencyLimitState& stateFor(const QString& serviceName);
+    void updateLimit(ConcurrencyLimitState& state, qint64 latencyUs, bool dropped, int inFlightAtStart);
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // CONCURRENCYLIMITER_P_H
@@ -1,7 +1,10 @@
 #include "eagle/core/FailoverManager.h"
 #include "FailoverManager_p.h"
 #include "eagle/core/ServiceRegistry.h"
+#include "eagle/core/Framework.h"
+#include "eagle/core/PerformanceMonitor.h"
 #include "eagle/core/Logger.h"
+#include "StateReplication_p.h"
 #include <algorithm>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QDateTime>
@@ -10,12 +13,138 @@
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
-#include <QtCore/QEventLoop>
+#include <QtNetwork/QLocalSocket>
+#include <QtCore/QRandomGenerator>
 #include <QtCore/QTimer>
+#include <cmath>
 
 namespace Eagle {
 namespace Core {
 
+namespace {
+
+/**
+ * @brief 带随机抖动的检查间隔（毫秒）
+ */
+qint64 jitteredInterval(int intervalMs, double jitterRatio)
+{
+    int interval = qMax(kHealthCheckTickMs, intervalMs);
+    int jitter = static_cast<int>(interval * qBound(0.0, jitterRatio, 1.0));
+    if (jitter <= 0) {
+        return interval;
+    }
+    return interval - jitter + QRandomGenerator::global()->bounded(2 * jitter + 1);
+}
+
+/**
+ * @brief 节点的探测间隔：启用phi检测时主节点按心跳间隔探测
+ */
+int probeIntervalMs(const FailoverConfig& config, const ServiceNode& node)
+{
+    if (config.phiThreshold > 0 && node.role == ServiceRole::Primary) {
+        return config.heartbeatIntervalMs;
+    }
+    return config.healthCheckIntervalMs;
+}
+
+} // namespace
+
+void PhiAccrualDetector::heartbeat(qint64 nowMs, bool sample)
+{
+    if (sample && lastHeartbeatMs >= 0 && nowMs > lastHeartbeatMs) {
+        qint64 interval = nowMs - lastHeartbeatMs;
+        if (intervals.size() < kMaxSamples) {
+            intervals.append(interval);
+        } else {
+            qint64 evicted = intervals[nextSample];
+            sum -= evicted;
+            sumSquares -= static_cast<double>(evicted) * evicted;
+            intervals[nextSample] = interval;
+            nextSample = (nextSample + 1) % kMaxSamples;
+        }
+        sum += interval;
+        sumSquares += static_cast<double>(interval) * interval;
+    }
+    lastHeartbeatMs = qMax(lastHeartbeatMs, nowMs);
+}
+
+double PhiAccrualDetector::phi(qint64 nowMs, double minStdDeviationMs, double expectedIntervalMs) const
+{
+    if (lastHeartbeatMs < 0) {
+        return 0.0;
+    }
+    
+    // 样本不足时按期望的心跳间隔估计分布
+    double mean = expectedIntervalMs;
+    double stdDeviation = expectedIntervalMs / 4.0;
+    if (intervals.size() >= 2) {
+        mean = sum / intervals.size();
+        stdDeviation = std::sqrt(qMax(0.0, sumSquares / intervals.size() - mean * mean));
+    }
+    stdDeviation = qMax(stdDeviation, minStdDeviationMs);
+    
+    // 正态分布累积函数的logistic近似
+    double elapsed = static_cast<double>(nowMs - lastHeartbeatMs);
+    double y = (elapsed - mean) / stdDeviation;
+    double e = std::exp(-y * (1.5976 + 0.070566 * y * y));
+    if (elapsed > mean) {
+        return -std::log10(e / (1.0 + e));
+    }
+    return -std::log10(1.0 - 1.0 / (1.0 + e));
+}
+
+void FailoverManager::Private::dropReplicationLink(const QString& key)
+{
+    StateReplicationLink* link = replicationLinks.take(key);
+    if (!link) {
+        return;
+    }
+    if (link->socket) {
+        link->socket->disconnect();
+        link->socket->abort();
+        link->socket->deleteLater();
+    }
+    delete link;
+}
+
+void FailoverManager::Private::publishPrimary(const QString& serviceName)
+{
+    auto table = std::make_shared<PrimaryCallSignalTable>(*std::atomic_load(&callSignals));
+    auto primaryIt = currentPrimaries.constFind(serviceName);
+    if (primaryIt == currentPrimaries.constEnd()) {
+        table->remove(serviceName);
+    } else if (!table->contains(serviceName) || table->value(serviceName)->nodeId != primaryIt.value()) {
+        auto callSignal = std::make_shared<PrimaryCallSignal>();
+        callSignal->nodeId = primaryIt.value();
+        table->insert(serviceName, callSignal);
+    }
+    std::atomic_store(&callSignals, std::shared_ptr<const PrimaryCallSignalTable>(table));
+}
+
+void FailoverManager::Private::applyCallSignals(qint64 nowMs)
+{
+    std::shared_ptr<const PrimaryCallSignalTable> table = std::atomic_load(&callSignals);
+    for (auto it = table->constBegin(); it != table->constEnd(); ++it) {
+        QString key = healthCheckKey(it.key(), it.value()->nodeId);
+        
+        // 成功调用证明主节点存活，只刷新心跳时间，不改变按探测间隔建立的分布
+        qint64 lastSuccessMs = it.value()->lastSuccessMs.load(std::memory_order_relaxed);
+        if (lastSuccessMs >= 0) {
+            auto detectorIt = detectors.find(key);
+            if (detectorIt != detectors.end()) {
+                detectorIt.value().heartbeat(lastSuccessMs, false);
+            }
+        }
+        
+        if (it.value()->probeRequested.exchange(false, std::memory_order_relaxed)) {
+            auto nextIt = nextHealthCheckMs.find(key);
+            if (nextIt != nextHealthCheckMs.end()) {
+                nextIt.value() = qMin(nextIt.value(), nowMs);
+            }
+        }
+    }
+}
+
 FailoverManager::FailoverManager(ServiceRegistry* serviceRegistry, QObject* parent)
     : QObject(parent)
     , d(new FailoverManager::Private(serviceRegistry))
@@ -25,12 +154,21 @@ FailoverManager::FailoverManager(ServiceRegistry* serviceRegistry, QObject* pare
         return;
     }
     
+    // 健康检查共享一个网络管理器，到同一主机的请求复用keep-alive连接
+    d->networkManager = new QNetworkAccessManager(this);
+    
     // 连接定时器
     connect(d->healthCheckTimer, &QTimer::timeout,
             this, &FailoverManager::onHealthCheckTimer, Qt::QueuedConnection);
     connect(d->stateSyncTimer, &QTimer::timeout,
             this, &FailoverManager::onStateSyncTimer, Qt::QueuedConnection);
     
+    // 被动调用结果作为故障检测的输入（调用可能发生在任意线程，直接在调用线程记录）
+    connect(serviceRegistry, &ServiceRegistry::serviceCallSucceeded,
+            this, &FailoverManager::onServiceCallSucceeded, Qt::DirectConnection);
+    connect(serviceRegistry, &ServiceRegistry::serviceCallFailed,
+            this, &FailoverManager::onServiceCallFailed, Qt::DirectConnection);
+    
     Logger::info("FailoverManager", "故障转移管理器初始化完成");
 }
 
@@ -63,6 +201,7 @@ bool FailoverManager::registerService(const FailoverConfig& config)
     // 设置当前主节点
     if (!config.primaryNodes.isEmpty()) {
         d->currentPrimaries[config.serviceName] = config.primaryNodes.first();
+        d->publishPrimary(config.serviceName);
     }
     
     // 启动健康检查定时器（如果还未启动）
@@ -95,9 +234,38 @@ bool FailoverManager::unregisterService(const QString& serviceName)
     d->serviceConfigs.remove(serviceName);
     d->serviceNodes.remove(serviceName);
     d->currentPrimaries.remove(serviceName);
+    d->publishPrimary(serviceName);
     d->failoverHistory.remove(serviceName);
     d->serviceEnabled.remove(serviceName);
     
+    QString prefix = FailoverManager::Private::healthCheckKey(serviceName, QString());
+    for (auto it = d->nextHealthCheckMs.begin(); it != d->nextHealthCheckMs.end();) {
+        if (it.key().startsWith(prefix)) {
+            it = d->nextHealthCheckMs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = d->detectors.begin(); it != d->detectors.end();) {
+        if (it.key().startsWith(prefix)) {
+            it = d->detectors.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = d->phiSuspectSinceMs.begin(); it != d->phiSuspectSinceMs.end();) {
+        if (it.key().startsWith(prefix)) {
+            it = d->phiSuspectSinceMs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const QString& key : d->replicationLinks.keys()) {
+        if (key.startsWith(prefix)) {
+            d->dropReplicationLink(key);
+        }
+    }
+    
     Logger::info("FailoverManager", QString("服务已注销: %1").arg(serviceName));
     return true;
 }
@@ -147,6 +315,10 @@ bool FailoverManager::removeNode(const QString& serviceName, const QString& node
     }
     
     d->serviceNodes[serviceName].remove(nodeId);
+    d->nextHealthCheckMs.remove(FailoverManager::Private::healthCheckKey(serviceName, nodeId));
+    d->detectors.remove(FailoverManager::Private::healthCheckKey(serviceName, nodeId));
+    d->phiSuspectSinceMs.remove(FailoverManager::Private::healthCheckKey(serviceName, nodeId));
+    d->dropReplicationLink(FailoverManager::Private::healthCheckKey(serviceName, nodeId));
     
     // 如果移除的是主节点，触发故障转移
     if (d->currentPrimaries.value(serviceName) == nodeId) {
@@ -204,8 +376,13 @@ bool FailoverManager::performFailover(const QString& serviceName, const QString&
     // 确定目标节点
     QString newPrimaryId = targetNodeId;
     if (newPrimaryId.isEmpty()) {
-        // 自动选择第一个备节点
-        QList<ServiceNode> standbyNodes = getStandbyNodes(serviceName);
+        // 自动选择第一个备节点（已持有锁，不能调用getStandbyNodes）
+        QList<ServiceNode> standbyNodes;
+        for (const ServiceNode& node : d->serviceNodes.value(serviceName)) {
+            if (node.role == ServiceRole::Standby) {
+                standbyNodes.append(node);
+            }
+        }
         if (standbyNodes.isEmpty()) {
             Logger::error("FailoverManager", QString("没有可用的备节点: %1").arg(serviceName));
             return false;
@@ -270,6 +447,24 @@ bool FailoverManager::switchToPrimary(const QString& serviceName, const QString&
     ServiceNode& node = d->serviceNodes[serviceName][nodeId];
     node.role = ServiceRole::Primary;
     d->currentPrimaries[serviceName] = nodeId;
+    d->publishPrimary(serviceName);
+    
+    // 主节点改用心跳间隔探测，旧的间隔分布不再适用，保留最后一次心跳时间
+    QString key = FailoverManager::Private::healthCheckKey(serviceName, nodeId);
+    PhiAccrualDetector& detector = d->detectors[key];
+    qint64 lastHeartbeatMs = detector.lastHeartbeatMs;
+    detector = PhiAccrualDetector();
+    detector.lastHeartbeatMs = lastHeartbeatMs;
+    d->nextHealthCheckMs.remove(key);
+    
+    // 本进程的复制接收端所在节点成为主节点：停止接收，之后由本进程向其他备节点发送
+    StateReplicaServer* replicaServer = d->replicaServers.value(serviceName);
+    if (replicaServer && replicaServer->serverName() == node.metadata.value("replicationSocket").toString()) {
+        d->replicaServers.remove(serviceName);
+        replicaServer->deleteLater();
+        Logger::info("FailoverManager", QString("本节点已提升为主节点，停止接收状态复制: %1").arg(serviceName));
+    }
+    d->dropReplicationLink(key);
     
     emit failoverTriggered(serviceName, QString(), nodeId);
     
@@ -393,35 +588,113 @@ bool FailoverManager::isServiceEnabled(const QString& serviceName) const
 void FailoverManager::onHealthCheckTimer()
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    QStringList services = d->serviceConfigs.keys();
-    locker.unlock();
     
-    for (const QString& serviceName : services) {
-        if (!d->serviceEnabled.value(serviceName, false)) {
-            continue;
-        }
-        
-        FailoverConfig config = getServiceConfig(serviceName);
-        QList<ServiceNode> nodes = getNodes(serviceName);
+    // 收集到期的节点，锁外并发发起检查
+    struct DueCheck {
+        QString serviceName;
+        ServiceNode node;
+        int timeoutMs;
+    };
+    QList<DueCheck> dueChecks;
+    
+    // phi超过阈值的主节点
+    struct Suspect {
+        QString serviceName;
+        QString nodeId;
+        double phi;
+    };
+    QList<Suspect> suspects;
+    
+    {
+        QMutexLocker locker(&d->mutex);
+        qint64 now = d->clock.elapsed();
+        d->applyCallSignals(now);
         
-        for (const ServiceNode& node : nodes) {
-            bool healthy = performHealthCheck(serviceName, node.id);
+        for (auto serviceIt = d->serviceConfigs.constBegin(); serviceIt != d->serviceConfigs.constEnd(); ++serviceIt) {
+            const QString& serviceName = serviceIt.key();
+            const FailoverConfig& config = serviceIt.value();
+            if (!d->serviceEnabled.value(serviceName, false)) {
+                continue;
+            }
             
-            if (!healthy) {
-                emit healthCheckFailed(serviceName, node.id);
+            auto nodesIt = d->serviceNodes.constFind(serviceName);
+            if (nodesIt == d->serviceNodes.constEnd()) {
+                continue;
+            }
+            
+            for (const ServiceNode& node : nodesIt.value()) {
+                QString key = FailoverManager::Private::healthCheckKey(serviceName, node.id);
+                if (d->inFlightChecks.contains(key)) {
+                    continue;
+                }
                 
-                // 如果是主节点且达到失败阈值，触发故障转移
-                if (node.role == ServiceRole::Primary && 
-                    config.mode == FailoverMode::Automatic) {
-                    ServiceNode updatedNode = getNode(serviceName, node.id);
-                    if (updatedNode.consecutiveFailures >= config.failureThreshold) {
-                        triggerFailover(serviceName, QString("主节点健康检查失败: %1").arg(node.id));
-                    }
+                auto next = d->nextHealthCheckMs.find(key);
+                if (next == d->nextHealthCheckMs.end()) {
+                    // 新节点的首次检查在一个间隔内随机错开，避免所有节点同时发起
+                    d->nextHealthCheckMs.insert(key, now + QRandomGenerator::global()->bounded(
+                        qMax(kHealthCheckTickMs, probeIntervalMs(config, node))));
+                    continue;
+                }
+                if (next.value() > now) {
+                    continue;
                 }
+                
+                next.value() = now + jitteredInterval(probeIntervalMs(config, node), config.healthCheckJitter);
+                d->inFlightChecks.insert(key, now);
+                
+                int timeoutMs = node.metadata.value("healthCheckTimeoutMs").toInt();
+                dueChecks.append({serviceName, node, timeoutMs > 0 ? timeoutMs : config.healthCheckTimeoutMs});
+            }
+            
+            // 主节点故障检测：探测进行中时按探测发起时刻评估phi，挂起的探测既不掩盖也不放大此前的静默
+            if (config.phiThreshold <= 0 || config.mode != FailoverMode::Automatic) {
+                continue;
+            }
+            QString primaryId = d->currentPrimaries.value(serviceName);
+            QString primaryKey = FailoverManager::Private::healthCheckKey(serviceName, primaryId);
+            auto primaryIt = nodesIt.value().constFind(primaryId);
+            auto detectorIt = d->detectors.constFind(primaryKey);
+            if (primaryIt == nodesIt.value().constEnd() || detectorIt == d->detectors.constEnd() ||
+                primaryIt.value().status == ServiceStatus::Failed) {
+                continue;
+            }
+            
+            qint64 evaluatedAtMs = d->inFlightChecks.value(primaryKey, now);
+            double phi = detectorIt.value().phi(evaluatedAtMs, config.phiMinStdDeviationMs, config.heartbeatIntervalMs);
+            if (phi < config.phiThreshold) {
+                d->phiSuspectSinceMs.remove(primaryKey);
+                continue;
+            }
+            
+            // 单次超过阈值只记为怀疑：需在一个探测间隔后的评估中仍超过阈值，或健康检查已连续失败到阈值，才判定失效
+            if (!d->phiSuspectSinceMs.contains(primaryKey)) {
+                d->phiSuspectSinceMs.insert(primaryKey, evaluatedAtMs);
+            }
+            qint64 suspectSinceMs = d->phiSuspectSinceMs.value(primaryKey);
+            bool confirmed = evaluatedAtMs - suspectSinceMs >= probeIntervalMs(config, primaryIt.value()) ||
+                             primaryIt.value().consecutiveFailures >= config.failureThreshold;
+            if (confirmed) {
+                suspects.append({serviceName, primaryId, phi});
             }
         }
+        
+        for (const Suspect& suspect : suspects) {
+            d->serviceNodes[suspect.serviceName][suspect.nodeId].status = ServiceStatus::Failed;
+            d->phiSuspectSinceMs.remove(FailoverManager::Private::healthCheckKey(suspect.serviceName, suspect.nodeId));
+        }
+    }
+    
+    for (const DueCheck& check : dueChecks) {
+        startHealthCheck(check.serviceName, check.node, check.timeoutMs);
+    }
+    
+    for (const Suspect& suspect : suspects) {
+        Logger::warning("FailoverManager", QString("主节点疑似失效: %1/%2 (phi=%3)")
+            .arg(suspect.serviceName, suspect.nodeId).arg(suspect.phi, 0, 'f', 2));
+        emit nodeSuspected(suspect.serviceName, suspect.nodeId, suspect.phi);
+        updateNodeStatus(suspect.serviceName, suspect.nodeId, ServiceStatus::Failed);
+        triggerFailover(suspect.serviceName, QString("主节点故障检测phi超过阈值: %1 (phi=%2)")
+            .arg(suspect.nodeId).arg(suspect.phi, 0, 'f', 2));
     }
 }
 
@@ -454,89 +727,159 @@ void FailoverManager::onStateSyncTimer()
                 syncState(serviceName, primary, standby);
             }
         }
+        
+        updateReplicationMetrics(serviceName);
     }
 }
 
-bool FailoverManager::performHealthCheck(const QString& serviceName, const QString& nodeId)
+void FailoverManager::startHealthCheck(const QString& serviceName, const ServiceNode& node, int timeoutMs)
 {
-    ServiceNode node = getNode(serviceName, nodeId);
-    if (node.id.isEmpty()) {
-        return false;
+    auto* d = d_func();
+    
+    // 简化实现：检查端点的/health接口
+    QUrl url(node.endpoint + "/health");
+    if (!url.isValid()) {
+        applyHealthCheckResult(serviceName, node.id, false);
+        return;
     }
     
-    bool healthy = checkNodeHealth(node);
+    QNetworkRequest request(url);
+    request.setRawHeader("User-Agent", "Eagle-Framework/1.0");
+    
+    QNetworkReply* reply = d->networkManager->get(request);
     
+    // 单节点超时：到期中止请求，finished照常发出并按失败处理；应答先到时定时器随reply销毁
+    QTimer::singleShot(qMax(1, timeoutMs), reply, &QNetworkReply::abort);
+    
+    QString nodeId = node.id;
+    connect(reply, &QNetworkReply::finished, this, [this, reply, serviceName, nodeId]() {
+        bool healthy = false;
+        if (reply->error() == QNetworkReply::NoError) {
+            int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+            healthy = (statusCode >= 200 && statusCode < 300);
+        }
+        reply->deleteLater();
+        
+        applyHealthCheckResult(serviceName, nodeId, healthy);
+    });
+}
+
+void FailoverManager::applyHealthCheckResult(const QString& serviceName, const QString& nodeId, bool healthy)
+{
     auto* d = d_func();
     QMutexLocker locker(&d->mutex);
     
-    ServiceNode& updatedNode = d->serviceNodes[serviceName][nodeId];
-    updatedNode.lastHealthCheck = QDateTime::currentDateTime();
+    QString key = FailoverManager::Private::healthCheckKey(serviceName, nodeId);
+    d->inFlightChecks.remove(key);
     
+    // 检查期间服务或节点可能已被移除
+    auto nodesIt = d->serviceNodes.find(serviceName);
+    if (nodesIt == d->serviceNodes.end() || !nodesIt.value().contains(nodeId)) {
+        return;
+    }
+    
+    FailoverConfig config = d->serviceConfigs.value(serviceName);
+    ServiceNode& node = nodesIt.value()[nodeId];
+    node.lastHealthCheck = QDateTime::currentDateTime();
+    
+    QList<ServiceStatus> transitions;
     if (healthy) {
-        updatedNode.consecutiveFailures = 0;
-        if (updatedNode.status != ServiceStatus::Healthy) {
-            updatedNode.status = ServiceStatus::Healthy;
-            locker.unlock();
-            updateNodeStatus(serviceName, nodeId, ServiceStatus::Healthy);
-            locker.relock();
+        // 连续成功的探测间隔计入心跳分布，失败后恢复的第一次只刷新心跳时间
+        d->detectors[key].heartbeat(d->clock.elapsed(), node.consecutiveFailures == 0);
+        node.consecutiveFailures = 0;
+        if (node.status != ServiceStatus::Healthy) {
+            node.status = ServiceStatus::Healthy;
+            transitions.append(ServiceStatus::Healthy);
         }
     } else {
-        updatedNode.consecutiveFailures++;
-        if (updatedNode.status == ServiceStatus::Healthy) {
-            updatedNode.status = ServiceStatus::Degraded;
-            locker.unlock();
-            updateNodeStatus(serviceName, nodeId, ServiceStatus::Degraded);
-            locker.relock();
+        node.consecutiveFailures++;
+        if (node.status == ServiceStatus::Healthy) {
+            node.status = ServiceStatus::Degraded;
+            transitions.append(ServiceStatus::Degraded);
         }
-        
-        FailoverConfig config = d->serviceConfigs[serviceName];
-        if (updatedNode.consecutiveFailures >= config.failureThreshold) {
-            updatedNode.status = ServiceStatus::Failed;
-            locker.unlock();
-            updateNodeStatus(serviceName, nodeId, ServiceStatus::Failed);
-            locker.relock();
+        if (node.consecutiveFailures >= config.failureThreshold && node.status != ServiceStatus::Failed) {
+            node.status = ServiceStatus::Failed;
+            transitions.append(ServiceStatus::Failed);
         }
     }
     
-    return healthy;
+    // 主节点达到失败阈值时触发故障转移
+    bool primaryFailed = !healthy && node.role == ServiceRole::Primary &&
+                         config.mode == FailoverMode::Automatic &&
+                         node.consecutiveFailures >= config.failureThreshold;
+    locker.unlock();
+    
+    for (ServiceStatus status : transitions) {
+        updateNodeStatus(serviceName, nodeId, status);
+    }
+    
+    if (!healthy) {
+        emit healthCheckFailed(serviceName, nodeId);
+    }
+    
+    if (primaryFailed) {
+        triggerFailover(serviceName, QString("主节点健康检查失败: %1").arg(nodeId));
+    }
 }
 
-bool FailoverManager::checkNodeHealth(const ServiceNode& node) const
+void FailoverManager::recordHeartbeat(const QString& serviceName, const QString& nodeId)
 {
-    // 简化实现：检查端点是否可访问
-    // 实际应该调用服务的健康检查接口
-    QUrl url(node.endpoint + "/health");
-    if (!url.isValid()) {
-        return false;
-    }
-    
-    // 使用QNetworkAccessManager进行HTTP健康检查
-    QNetworkAccessManager manager;
-    QNetworkRequest request(url);
-    request.setRawHeader("User-Agent", "Eagle-Framework/1.0");
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
     
-    QNetworkReply* reply = manager.get(request);
+    if (!d->serviceNodes.value(serviceName).contains(nodeId)) {
+        return;
+    }
+    d->detectors[FailoverManager::Private::healthCheckKey(serviceName, nodeId)].heartbeat(d->clock.elapsed(), true);
+}
+
+double FailoverManager::phi(const QString& serviceName, const QString& nodeId) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
     
-    QEventLoop loop;
-    QTimer timer;
-    timer.setSingleShot(true);
-    timer.setInterval(3000);  // 3秒超时
+    auto it = d->detectors.constFind(FailoverManager::Private::healthCheckKey(serviceName, nodeId));
+    if (it == d->detectors.constEnd()) {
+        return 0.0;
+    }
     
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
-    connect(&timer, &QTimer::timeout, reply, &QNetworkReply::abort);
+    // 计入尚未合并的成功调用
+    PhiAccrualDetector detector = it.value();
+    std::shared_ptr<const PrimaryCallSignalTable> table = std::atomic_load(&d->callSignals);
+    auto signalIt = table->constFind(serviceName);
+    if (signalIt != table->constEnd() && signalIt.value()->nodeId == nodeId) {
+        detector.heartbeat(signalIt.value()->lastSuccessMs.load(std::memory_order_relaxed), false);
+    }
     
-    timer.start();
-    loop.exec();
+    FailoverConfig config = d->serviceConfigs.value(serviceName);
+    ServiceNode node = d->serviceNodes.value(serviceName).value(nodeId);
+    return detector.phi(d->clock.elapsed(), config.phiMinStdDeviationMs, probeIntervalMs(config, node));
+}
+
+void FailoverManager::onServiceCallSucceeded(const QString& serviceName, qint64 elapsedMs)
+{
+    Q_UNUSED(elapsedMs);
+    auto* d = d_func();
     
-    bool healthy = false;
-    if (reply->error() == QNetworkReply::NoError) {
-        int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-        healthy = (statusCode >= 200 && statusCode < 300);
+    // 在每次服务调用的线程上执行：只写主节点的原子信号，未注册的服务直接返回，不加锁
+    std::shared_ptr<const PrimaryCallSignalTable> table = std::atomic_load(&d->callSignals);
+    auto it = table->constFind(serviceName);
+    if (it != table->constEnd()) {
+        it.value()->lastSuccessMs.store(d->clock.elapsed(), std::memory_order_relaxed);
     }
+}
+
+void FailoverManager::onServiceCallFailed(const QString& serviceName, const QString& error)
+{
+    Q_UNUSED(error);
+    auto* d = d_func();
     
-    reply->deleteLater();
-    return healthy;
+    // 调用失败时在下一个调度节拍立即探测主节点
+    std::shared_ptr<const PrimaryCallSignalTable> table = std::atomic_load(&d->callSignals);
+    auto it = table->constFind(serviceName);
+    if (it != table->constEnd()) {
+        it.value()->probeRequested.store(true, std::memory_order_relaxed);
+    }
 }
 
 void FailoverManager::updateNodeStatus(const QString& serviceName, const QString& nodeId, ServiceStatus status)
@@ -558,16 +901,326 @@ void FailoverManager::triggerFailover(const QString& serviceName, const QString&
 
 bool FailoverManager::syncState(const QString& serviceName, const ServiceNode& from, const ServiceNode& to)
 {
-    // 简化实现：状态同步逻辑
-    // 实际应该根据服务类型实现具体的同步逻辑
-    Q_UNUSED(serviceName);
     Q_UNUSED(from);
-    Q_UNUSED(to);
+    auto* d = d_func();
+    
+    QString socketName = to.metadata.value("replicationSocket").toString();
+    ReplicatedState* state = nullptr;
+    StateReplicationLink* link = nullptr;
+    {
+        QMutexLocker locker(&d->mutex);
+        state = d->states.value(serviceName);
+        
+        // 没有需要复制的状态、备节点未提供接收端，或本进程自身是备节点时无需发送
+        if (!state || socketName.isEmpty() || d->replicaServers.contains(serviceName)) {
+            return true;
+        }
+        
+        QString key = FailoverManager::Private::healthCheckKey(serviceName, to.id);
+        link = d->replicationLinks.value(key);
+        if (link && link->socketName != socketName) {
+            d->dropReplicationLink(key);
+            link = nullptr;
+        }
+        if (!link) {
+            link = new StateReplicationLink;
+            link->serviceName = serviceName;
+            link->nodeId = to.id;
+            link->socketName = socketName;
+            d->replicationLinks.insert(key, link);
+        }
+    }
+    
+    if (!link->socket) {
+        link->socket = new QLocalSocket(this);
+        connect(link->socket, &QLocalSocket::readyRead, this, [this, link]() {
+            onReplicationReadyRead(link);
+        });
+        connect(link->socket, &QLocalSocket::disconnected, this, [this, link]() {
+            // 未确认的变更在重连握手后按备节点的实际版本重发
+            auto* d = d_func();
+            QMutexLocker locker(&d->mutex);
+            link->handshaken = false;
+            link->buffer.clear();
+            link->sentVersion = link->ackedVersion;
+        });
+    }
+    
+    // 连接建立后等待备节点的握手确认再发送
+    if (link->socket->state() == QLocalSocket::UnconnectedState) {
+        link->socket->connectToServer(socketName);
+        return false;
+    }
+    if (link->socket->state() != QLocalSocket::ConnectedState) {
+        return false;
+    }
+    
+    shipState(link, state);
+    return true;
+}
+
+void FailoverManager::shipState(StateReplicationLink* link, ReplicatedState* state)
+{
+    auto* d = d_func();
+    quint64 sentVersion = 0;
+    bool needsSnapshot = false;
+    {
+        QMutexLocker locker(&d->mutex);
+        if (!link->handshaken || link->sentVersion - link->ackedVersion >= kMaxUnackedVersions) {
+            return;
+        }
+        sentVersion = link->sentVersion;
+        needsSnapshot = link->needsSnapshot;
+    }
+    
+    quint64 epoch = state->epoch();
+    QList<StateChange> changes;
+    qint64 snapshots = 0;
+    
+    // 备节点历史不同或已落后于日志范围：先发送快照，再续传快照之后的日志
+    if (needsSnapshot || !state->changesSince(sentVersion, kReplicationBatchSize, &changes)) {
+        QVariantMap snapshot = state->snapshot(&sentVersion);
+        
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(kReplicationStreamVersion);
+        out << static_cast<quint8>(ReplicationMessage::Snapshot) << epoch << sentVersion << snapshot;
+        link->socket->write(frameReplicationMessage(payload));
+        snapshots++;
+        
+        changes.clear();
+        state->changesSince(sentVersion, kReplicationBatchSize, &changes);
+        Logger::info("FailoverManager", QString("向备节点发送状态快照: %1/%2 (版本%3)")
+            .arg(link->serviceName, link->nodeId).arg(sentVersion));
+    }
+    
+    if (!changes.isEmpty()) {
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(kReplicationStreamVersion);
+        out << static_cast<quint8>(ReplicationMessage::Delta) << epoch << changes;
+        link->socket->write(frameReplicationMessage(payload));
+        sentVersion = changes.last().version;
+    }
+    
+    QMutexLocker locker(&d->mutex);
+    link->sentVersion = qMax(link->sentVersion, sentVersion);
+    link->needsSnapshot = false;
+    link->snapshotsSent += snapshots;
+    if (!changes.isEmpty()) {
+        link->deltasSent++;
+    }
+}
+
+void FailoverManager::onReplicationReadyRead(StateReplicationLink* link)
+{
+    auto* d = d_func();
+    link->buffer.append(link->socket->readAll());
+    
+    ReplicatedState* state = nullptr;
+    {
+        QMutexLocker locker(&d->mutex);
+        state = d->states.value(link->serviceName);
+    }
+    if (!state) {
+        return;
+    }
+    
+    QByteArray payload;
+    while (takeReplicationMessage(link->buffer, &payload)) {
+        QDataStream in(payload);
+        in.setVersion(kReplicationStreamVersion);
+        quint8 type = 0;
+        quint64 epoch = 0;
+        quint64 version = 0;
+        bool resync = false;
+        in >> type >> epoch >> version >> resync;
+        if (type != static_cast<quint8>(ReplicationMessage::Ack)) {
+            continue;
+        }
+        
+        QMutexLocker locker(&d->mutex);
+        link->handshaken = true;
+        link->lastAckMs = QDateTime::currentMSecsSinceEpoch();
+        if (epoch != state->epoch()) {
+            // 备节点持有另一段历史（如本进程重启过），版本号不可比较
+            link->needsSnapshot = true;
+            link->ackedVersion = 0;
+            link->sentVersion = 0;
+        } else {
+            link->ackedVersion = version;
+            if (resync || link->sentVersion < version) {
+                link->sentVersion = version;
+            }
+        }
+    }
+    
+    shipState(link, state);
+    updateReplicationMetrics(link->serviceName);
+}
+
+void FailoverManager::scheduleReplication(const QString& serviceName)
+{
+    auto* d = d_func();
+    {
+        QMutexLocker locker(&d->mutex);
+        if (d->pendingReplication.contains(serviceName)) {
+            return;
+        }
+        d->pendingReplication.insert(serviceName);
+    }
+    
+    // 合并批量延迟内的所有变更后一次发送（状态可能在任意线程修改，发送在本对象线程进行）
+    QMetaObject::invokeMethod(this, [this, serviceName]() {
+        QTimer::singleShot(kReplicationBatchDelayMs, this, [this, serviceName]() {
+            flushReplication(serviceName);
+        });
+    }, Qt::QueuedConnection);
+}
+
+void FailoverManager::flushReplication(const QString& serviceName)
+{
+    auto* d = d_func();
+    {
+        QMutexLocker locker(&d->mutex);
+        d->pendingReplication.remove(serviceName);
+        FailoverConfig config = d->serviceConfigs.value(serviceName);
+        if (!d->enabled || !config.enableStateSync || !d->serviceEnabled.value(serviceName, false)) {
+            return;
+        }
+    }
+    
+    ServiceNode primary = getCurrentPrimary(serviceName);
+    for (const ServiceNode& standby : getStandbyNodes(serviceName)) {
+        if (standby.status == ServiceStatus::Healthy) {
+            syncState(serviceName, primary, standby);
+        }
+    }
+}
+
+void FailoverManager::updateReplicationMetrics(const QString& serviceName)
+{
+    QVariantMap stats = getReplicationStatistics(serviceName);
+    Framework* framework = Framework::instance();
+    if (!framework || !framework->performanceMonitor() || !stats.contains("standbys")) {
+        return;
+    }
+    
+    framework->performanceMonitor()->updateMetric(QString("failover.%1.replication_lag_versions").arg(serviceName),
+        stats.value("maxLagVersions").toDouble());
+    framework->performanceMonitor()->updateMetric(QString("failover.%1.replication_lag_ms").arg(serviceName),
+        stats.value("maxLagMs").toDouble());
+}
+
+ReplicatedState* FailoverManager::replicatedState(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    
+    ReplicatedState* state = d->states.value(serviceName);
+    if (!state) {
+        state = new ReplicatedState(10000, this);
+        d->states.insert(serviceName, state);
+        
+        // 变更可能发生在任意线程，在变更线程上登记批量发送
+        connect(state, &ReplicatedState::changed, this, [this, serviceName]() {
+            scheduleReplication(serviceName);
+        }, Qt::DirectConnection);
+    }
+    return state;
+}
+
+bool FailoverManager::startReplicaServer(const QString& serviceName, const QString& socketName)
+{
+    ReplicatedState* state = replicatedState(serviceName);
+    
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    if (d->replicaServers.contains(serviceName)) {
+        return d->replicaServers.value(serviceName)->serverName() == socketName;
+    }
+    
+    StateReplicaServer* server = new StateReplicaServer(state, this);
+    if (!server->listen(socketName)) {
+        delete server;
+        return false;
+    }
+    d->replicaServers.insert(serviceName, server);
     
-    // TODO: 实现状态同步
+    Logger::info("FailoverManager", QString("作为备节点接收状态复制: %1 (%2)").arg(serviceName, socketName));
     return true;
 }
 
+void FailoverManager::stopReplicaServer(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    StateReplicaServer* server = d->replicaServers.take(serviceName);
+    if (server) {
+        server->deleteLater();
+    }
+}
+
+QVariantMap FailoverManager::getReplicationStatistics(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    
+    QVariantMap stats;
+    stats["serviceName"] = serviceName;
+    
+    ReplicatedState* state = d->states.value(serviceName);
+    if (!state) {
+        return stats;
+    }
+    
+    quint64 version = state->version();
+    stats["version"] = version;
+    stats["epoch"] = QString::number(state->epoch(), 16);
+    
+    StateReplicaServer* server = d->replicaServers.value(serviceName);
+    if (server) {
+        stats["replica"] = server->getStatistics();
+    }
+    
+    // 复制延迟：备节点落后的版本数，以及最早未确认变更距今的时间
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    quint64 maxLagVersions = 0;
+    qint64 maxLagMs = 0;
+    QVariantList standbys;
+    QString prefix = FailoverManager::Private::healthCheckKey(serviceName, QString());
+    for (auto it = d->replicationLinks.constBegin(); it != d->replicationLinks.constEnd(); ++it) {
+        if (!it.key().startsWith(prefix)) {
+            continue;
+        }
+        const StateReplicationLink* link = it.value();
+        quint64 lagVersions = version > link->ackedVersion ? version - link->ackedVersion : 0;
+        qint64 lagMs = 0;
+        if (lagVersions > 0) {
+            qint64 oldestUnacked = state->changeTimestamp(link->ackedVersion + 1);
+            lagMs = oldestUnacked > 0 ? now - oldestUnacked : (link->lastAckMs > 0 ? now - link->lastAckMs : 0);
+        }
+        maxLagVersions = qMax(maxLagVersions, lagVersions);
+        maxLagMs = qMax(maxLagMs, lagMs);
+        
+        QVariantMap standby;
+        standby["nodeId"] = link->nodeId;
+        standby["socketName"] = link->socketName;
+        standby["connected"] = link->handshaken;
+        standby["sentVersion"] = link->sentVersion;
+        standby["ackedVersion"] = link->ackedVersion;
+        standby["lagVersions"] = lagVersions;
+        standby["lagMs"] = lagMs;
+        standby["deltasSent"] = link->deltasSent;
+        standby["snapshotsSent"] = link->snapshotsSent;
+        standbys.append(standby);
+    }
+    stats["standbys"] = standbys;
+    stats["maxLagVersions"] = maxLagVersions;
+    stats["maxLagMs"] = maxLagMs;
+    return stats;
+}
+
 void FailoverManager::recordFailoverEvent(const FailoverEvent& event)
 {
     auto* d = d_func();
@@ -5,16 +5,102 @@
 #include <QtCore/QStringList>
 #include <QtCore/QMap>
 #include <QtCore/QList>
+#include <QtCore/QVector>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMutex>
 #include <QtCore/QTimer>
 #include <QtCore/QDateTime>
 #include "eagle/core/FailoverManager.h"
+#include <atomic>
+#include <memory>
+
+class QNetworkAccessManager;
+class QLocalSocket;
 
 namespace Eagle {
 namespace Core {
 
 class ServiceRegistry;
 
+/**
+ * @brief 健康检查调度节拍（毫秒），各节点按自己的间隔在节拍上到期
+ */
+const int kHealthCheckTickMs = 100;
+
+/**
+ * @brief phi-accrual故障检测器（单个节点）
+ *
+ * 保存最近的心跳间隔样本，按正态分布估计"到现在仍未收到心跳"的概率，
+ * phi = -log10(该概率)。phi为1表示误判概率约10%，为8表示约1e-8。
+ */
+struct PhiAccrualDetector {
+    static const int kMaxSamples = 200;
+    
+    QVector<qint64> intervals;   // 心跳间隔样本（环形）
+    int nextSample = 0;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    qint64 lastHeartbeatMs = -1;
+    
+    /**
+     * @param sample 是否把与上次心跳的间隔计入分布（被动调用成功只刷新时间，不计入）
+     */
+    void heartbeat(qint64 nowMs, bool sample);
+    
+    /**
+     * @param expectedIntervalMs 样本不足时假定的心跳间隔
+     */
+    double phi(qint64 nowMs, double minStdDeviationMs, double expectedIntervalMs) const;
+};
+
+/**
+ * @brief 主节点的被动调用信号
+ *
+ * 服务调用线程无锁写入，健康检查节拍在锁内合并到故障检测器和探测调度。
+ */
+struct PrimaryCallSignal {
+    QString nodeId;
+    std::atomic<qint64> lastSuccessMs{-1};      // 最近一次调用成功的时间（clock毫秒）
+    std::atomic<bool> probeRequested{false};    // 调用失败，下一个节拍立即探测
+};
+
+using PrimaryCallSignalTable = QHash<QString, std::shared_ptr<PrimaryCallSignal>>;
+
+/**
+ * @brief 每批发送的最大变更数
+ */
+const int kReplicationBatchSize = 500;
+
+/**
+ * @brief 状态变更后等待合并成一批的时间（毫秒）
+ */
+const int kReplicationBatchDelayMs = 20;
+
+/**
+ * @brief 已发送但未确认的最大版本数，超过时等待备节点确认
+ */
+const quint64 kMaxUnackedVersions = 5000;
+
+/**
+ * @brief 主节点到一个备节点的复制连接
+ */
+struct StateReplicationLink {
+    QString serviceName;
+    QString nodeId;
+    QString socketName;
+    QLocalSocket* socket = nullptr;
+    QByteArray buffer;              // 未解析完的确认消息
+    bool handshaken = false;        // 已收到备节点的历史标识和版本
+    bool needsSnapshot = false;     // 备节点的历史与本地不同，需要先发送快照
+    quint64 sentVersion = 0;
+    quint64 ackedVersion = 0;
+    qint64 lastAckMs = 0;
+    qint64 deltasSent = 0;
+    qint64 snapshotsSent = 0;
+};
+
 class FailoverManager::Private {
 public:
     ServiceRegistry* serviceRegistry;
@@ -26,21 +112,47 @@ public:
     QMap<QString, bool> serviceEnabled;  // serviceName -> enabled
     QTimer* healthCheckTimer;
     QTimer* stateSyncTimer;
+    QNetworkAccessManager* networkManager = nullptr;  // 所有健康检查共享，复用到同一主机的连接
+    QHash<QString, qint64> nextHealthCheckMs;  // "服务/节点" -> 下次检查时间（clock毫秒）
+    QHash<QString, qint64> inFlightChecks;  // 正在检查的节点 -> 探测发起时间（clock毫秒），上一次检查未返回前不重复发起
+    QHash<QString, PhiAccrualDetector> detectors;  // "服务/节点" -> 故障检测器
+    QHash<QString, qint64> phiSuspectSinceMs;  // "服务/节点" -> 主节点phi首次超过阈值的评估时间，需跨一个探测间隔再次确认
+    QHash<QString, ReplicatedState*> states;  // serviceName -> 复制的状态
+    QHash<QString, StateReplicationLink*> replicationLinks;  // "服务/节点" -> 到备节点的复制连接
+    QHash<QString, StateReplicaServer*> replicaServers;  // serviceName -> 本进程作为备节点时的接收端
+    QSet<QString> pendingReplication;  // 已安排批量发送的服务
+    std::shared_ptr<const PrimaryCallSignalTable> callSignals;  // serviceName -> 主节点调用信号，写时复制，读取无锁
+    QElapsedTimer clock;  // 调度使用的单调时钟
     mutable QMutex mutex;
     
     Private(ServiceRegistry* sr)
         : serviceRegistry(sr)
         , enabled(true)
+        , callSignals(std::make_shared<const PrimaryCallSignalTable>())
     {
+        clock.start();
+        
         healthCheckTimer = new QTimer();
         healthCheckTimer->setSingleShot(false);
-        healthCheckTimer->setInterval(5000);  // 默认5秒
+        healthCheckTimer->setInterval(kHealthCheckTickMs);
         
         stateSyncTimer = new QTimer();
         stateSyncTimer->setSingleShot(false);
         stateSyncTimer->setInterval(10000);  // 默认10秒
     }
     
+    static QString healthCheckKey(const QString& serviceName, const QString& nodeId) {
+        return serviceName + QLatin1Char('/') + nodeId;
+    }
+    
+    void dropReplicationLink(const QString& key);
+    
+    // 主节点变化后重新发布调用信号表（调用方需持有mutex）
+    void publishPrimary(const QString& serviceName);
+    
+    // 把调用信号合并到故障检测器和探测调度（调用方需持有mutex）
+    void applyCallSignals(qint64 nowMs);
+    
     ~Private() {
         if (healthCheckTimer) {
             healthCheckTimer->stop();
@@ -50,6 +162,9 @@ public:
             stateSyncTimer->stop();
             stateSyncTimer->deleteLater();
         }
+        for (const QString& key : replicationLinks.keys()) {
+            dropReplicationLink(key);
+        }
     }
 };
 
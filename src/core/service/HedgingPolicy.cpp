@@ -0,0 +1,177 @@
+#include "eagle/core/HedgingPolicy.h"
+#include "HedgingPolicy_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QMutexLocker>
+#include <algorithm>
+
+namespace Eagle {
+namespace Core {
+
+int HedgingServiceState::delayMs() const
+{
+    if (config.delayMs > 0) {
+        return config.delayMs;
+    }
+    if (cachedDelayUs < 0) {
+        return config.defaultDelayMs;
+    }
+    return qMax(config.minDelayMs, static_cast<int>((cachedDelayUs + 999) / 1000));
+}
+
+void HedgingServiceState::recomputeDelay()
+{
+    samplesSinceRecompute = 0;
+    if (static_cast<int>(latencySamples.size()) < kHedgingMinSamples) {
+        cachedDelayUs = -1;
+        return;
+    }
+
+    std::vector<qint64> sorted(latencySamples);
+    double percentile = qBound(0.0, config.delayPercentile, 1.0);
+    size_t rank = static_cast<size_t>(percentile * (sorted.size() - 1));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    cachedDelayUs = sorted[rank];
+}
+
+HedgingPolicy::HedgingPolicy(QObject* parent)
+    : QObject(parent)
+    , d_ptr(new HedgingPolicyPrivate)
+{
+}
+
+HedgingPolicy::~HedgingPolicy()
+{
+    delete d_ptr;
+}
+
+void HedgingPolicy::setPolicy(const QString& serviceName, const HedgingPolicyConfig& config)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    HedgingServiceState& state = d->states[serviceName];
+    state.config = config;
+    state.budgetTokens = qMin(state.budgetTokens, static_cast<double>(config.maxBudgetTokens));
+    Logger::info("HedgingPolicy", QString("设置对冲策略: %1 %2 (延迟%3, 预算%4)")
+        .arg(serviceName, config.enabled ? "启用" : "禁用")
+        .arg(config.delayMs > 0 ? QString("%1ms").arg(config.delayMs)
+                                : QString("P%1").arg(config.delayPercentile * 100))
+        .arg(config.budgetRatio));
+}
+
+void HedgingPolicy::removePolicy(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->states.remove(serviceName);
+}
+
+HedgingPolicyConfig HedgingPolicy::getPolicy(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.constFind(serviceName);
+    return it != d->states.constEnd() ? it->config : HedgingPolicyConfig();
+}
+
+bool HedgingPolicy::isEnabled(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.constFind(serviceName);
+    return it != d->states.constEnd() && it->config.enabled;
+}
+
+int HedgingPolicy::hedgeDelay(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.constFind(serviceName);
+    return it != d->states.constEnd() ? it->delayMs() : HedgingPolicyConfig().defaultDelayMs;
+}
+
+void HedgingPolicy::recordCall(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.find(serviceName);
+    if (it == d->states.end()) {
+        return;
+    }
+    it->calls++;
+    it->budgetTokens = qMin(it->budgetTokens + it->config.budgetRatio,
+                            static_cast<double>(it->config.maxBudgetTokens));
+}
+
+void HedgingPolicy::recordLatency(const QString& serviceName, qint64 latencyUs)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.find(serviceName);
+    if (it == d->states.end()) {
+        return;
+    }
+
+    if (static_cast<int>(it->latencySamples.size()) < kHedgingLatencySamples) {
+        it->latencySamples.push_back(latencyUs);
+    } else {
+        it->latencySamples[it->nextSample] = latencyUs;
+        it->nextSample = (it->nextSample + 1) % kHedgingLatencySamples;
+    }
+
+    if (++it->samplesSinceRecompute >= kHedgingRecomputeInterval || it->cachedDelayUs < 0) {
+        it->recomputeDelay();
+    }
+}
+
+bool HedgingPolicy::tryAcquireHedge(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.find(serviceName);
+    if (it == d->states.end()) {
+        return false;
+    }
+    if (it->budgetTokens < 1.0) {
+        it->hedgesThrottled++;
+        return false;
+    }
+    it->budgetTokens -= 1.0;
+    it->hedgesIssued++;
+    return true;
+}
+
+void HedgingPolicy::recordHedgeWon(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    auto it = d->states.find(serviceName);
+    if (it != d->states.end()) {
+        it->hedgesWon++;
+    }
+}
+
+QVariantMap HedgingPolicy::getStatistics(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+
+    QVariantMap stats;
+    stats["serviceName"] = serviceName;
+    auto it = d->states.constFind(serviceName);
+    if (it == d->states.constEnd()) {
+        stats["enabled"] = false;
+        return stats;
+    }
+
+    stats["enabled"] = it->config.enabled;
+    stats["delayMs"] = it->delayMs();
+    stats["calls"] = it->calls;
+    stats["hedgesIssued"] = it->hedgesIssued;
+    stats["hedgesWon"] = it->hedgesWon;
+    stats["hedgesThrottled"] = it->hedgesThrottled;
+    stats["budgetTokens"] = it->budgetTokens;
+    return stats;
+}
+
+} // namespace Core
+} // namespace Eagle
@@ -0,0 +1,45 @@
+#ifndef HEDGINGPOLICY_P_H
+#define HEDGINGPOLICY_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include "eagle/core/HedgingPolicy.h"
+#include <vector>
+
+namespace Eagle {
+namespace Core {
+
+const int kHedgingLatencySamples = 256;     // 分位数估计使用的最近样本数
+const int kHedgingRecomputeInterval = 32;   // 每积累多少个样本重新计算一次分位数
+const int kHedgingMinSamples = 20;          // 使用观测分位数所需的最少样本数
+
+/**
+ * @brief 单个服务的对冲状态
+ */
+struct HedgingServiceState {
+    HedgingPolicyConfig config;
+    std::vector<qint64> latencySamples;     // 环形缓冲区（微秒）
+    int nextSample = 0;
+    int samplesSinceRecompute = 0;
+    qint64 cachedDelayUs = -1;              // 缓存的分位数延迟，-1表示尚未计算
+    double budgetTokens = 0.0;
+    qint64 calls = 0;
+    qint64 hedgesIssued = 0;
+    qint64 hedgesWon = 0;
+    qint64 hedgesThrottled = 0;             // 因预算不足未发起的对冲
+
+    int delayMs() const;
+    void recomputeDelay();
+};
+
+class HedgingPolicyPrivate {
+public:
+    QHash<QString, HedgingServiceState> states;  // serviceName -> state
+    mutable QMutex mutex;
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // HEDGINGPOLICY_P_H
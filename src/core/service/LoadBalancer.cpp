@@ -3,19 +3,275 @@
 #include "eagle/core/Logger.h"
 #include <QtCore/QMutexLocker>
 #include <QtCore/QDateTime>
-#include <QtCore/QCryptographicHash>
 #include <QtCore/QRandomGenerator>
 #include <QtCore/QVariant>
 #include <climits>
 #include <algorithm>
+#include <numeric>
+#include <cmath>
 
 namespace Eagle {
 namespace Core {
 
+namespace {
+
+const qint64 kMaxWeightedSequence = 1024;  // 平滑加权轮询序列的最大长度
+const double kEwmaDecayNs = 10e9;          // 延迟平均的衰减时间常数（10秒）
+const double kFailurePenaltyUs = 1e6;      // 失败调用按至少1秒的延迟计入
+const qint64 kOutlierLatencyCheckInterval = 16;  // 每隔多少个样本加锁做一次延迟异常判定
+
+/**
+ * @brief 生成平滑加权轮询序列
+ *
+ * 按nginx的平滑加权轮询算法展开一个完整周期，权重先约去最大公约数，
+ * 总和仍超过上限时按比例缩放，保证序列长度有界。
+ */
+std::vector<int> buildWeightedSequence(const std::vector<std::shared_ptr<const ServiceInstance>>& instances)
+{
+    std::vector<int> weights;
+    weights.reserve(instances.size());
+    int divisor = 0;
+    for (const std::shared_ptr<const ServiceInstance>& instance : instances) {
+        int weight = qMax(1, instance->weight);
+        weights.push_back(weight);
+        divisor = std::gcd(divisor, weight);
+    }
+    if (weights.empty()) {
+        return std::vector<int>();
+    }
+
+    qint64 totalWeight = 0;
+    for (int& weight : weights) {
+        weight /= divisor;
+        totalWeight += weight;
+    }
+    if (totalWeight > kMaxWeightedSequence) {
+        qint64 scaledTotal = 0;
+        for (int& weight : weights) {
+            weight = static_cast<int>(qMax<qint64>(1, qint64(weight) * kMaxWeightedSequence / totalWeight));
+            scaledTotal += weight;
+        }
+        totalWeight = scaledTotal;
+    }
+
+    std::vector<int> sequence;
+    sequence.reserve(static_cast<size_t>(totalWeight));
+    std::vector<qint64> currentWeights(weights.size(), 0);
+    for (qint64 step = 0; step < totalWeight; ++step) {
+        size_t best = 0;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            currentWeights[i] += weights[i];
+            if (currentWeights[i] > currentWeights[best]) {
+                best = i;
+            }
+        }
+        currentWeights[best] -= totalWeight;
+        sequence.push_back(static_cast<int>(best));
+    }
+    return sequence;
+}
+
+/**
+ * @brief 64位FNV-1a哈希并做一次splitmix64混合，保证哈希环上分布均匀
+ */
+quint64 hashKey(const QString& key)
+{
+    quint64 hash = 14695981039346656037ULL;
+    const QChar* data = key.constData();
+    for (int i = 0; i < key.size(); ++i) {
+        hash ^= data[i].unicode();
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+} // namespace
+
+void InstanceRuntime::recordLatency(qint64 nowNs, double latencyUs, double decayNs)
+{
+    qint64 lastNs = lastSampleNs.exchange(nowNs, std::memory_order_relaxed);
+    double weight = lastNs > 0 ? std::exp(-qMax<qint64>(0, nowNs - lastNs) / decayNs) : 0.0;
+
+    // 峰值敏感：延迟升高立即生效，回落时按时间衰减
+    double current = ewmaLatencyUs.load(std::memory_order_relaxed);
+    double next = 0.0;
+    do {
+        next = latencyUs > current ? latencyUs : current * weight + latencyUs * (1.0 - weight);
+    } while (!ewmaLatencyUs.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+double InstanceRuntime::decayedLatency(qint64 nowNs, double decayNs) const
+{
+    qint64 lastNs = lastSampleNs.load(std::memory_order_relaxed);
+    if (lastNs <= 0) {
+        return 0.0;
+    }
+    double elapsed = static_cast<double>(qMax<qint64>(0, nowNs - lastNs));
+    return ewmaLatencyUs.load(std::memory_order_relaxed) * std::exp(-elapsed / decayNs);
+}
+
+double InstanceRuntime::score(qint64 nowNs, double decayNs) const
+{
+    return (decayedLatency(nowNs, decayNs) + 1.0) * (outstanding.load(std::memory_order_relaxed) + 1);
+}
+
+void LoadBalancer::Private::publishSelector(const QString& serviceName)
+{
+    auto table = std::make_shared<InstanceSelectorTable>(*std::atomic_load(&selectors));
+    std::shared_ptr<InstanceSelector> previous = table->value(serviceName);
+
+    auto serviceIt = instances.find(serviceName);
+    if (serviceIt == instances.end()) {
+        table->remove(serviceName);
+    } else {
+        auto selector = std::make_shared<InstanceSelector>();
+        selector->algorithm = algorithms.value(serviceName, LoadBalanceAlgorithm::RoundRobin);
+        selector->outlierConfig = outlierConfig;
+        QMap<QString, std::shared_ptr<InstanceRuntime>>& serviceRuntimes = runtimes[serviceName];
+        QStringList healthyIds;
+        for (auto it = serviceIt->begin(); it != serviceIt->end(); ++it) {
+            std::shared_ptr<InstanceRuntime> runtime = serviceRuntimes.value(it.key());
+            if (!runtime) {
+                runtime = std::make_shared<InstanceRuntime>();
+                serviceRuntimes[it.key()] = runtime;
+            }
+            selector->runtimeById.insert(it.key(), runtime);
+            if (!it->healthy || !it->isValid() || runtime->ejectedUntilNs > 0) {
+                continue;  // 不健康或被异常检测摘除的实例不参与选择
+            }
+            selector->healthy.push_back(std::make_shared<const ServiceInstance>(*it));
+            selector->runtimes.push_back(runtime);
+            healthyIds.append(it.key());
+        }
+        // 加权序列和哈希环只为使用它们的算法构建；切换算法时setAlgorithm会重新发布快照
+        if (selector->algorithm == LoadBalanceAlgorithm::WeightedRoundRobin) {
+            selector->weightedSequence = buildWeightedSequence(selector->healthy);
+        }
+
+        // 一致性哈希环：虚拟节点数与权重成正比，哈希只依赖实例ID，实例增减只影响相邻区间
+        if (selector->algorithm == LoadBalanceAlgorithm::IPHash) {
+            selector->hashLoadFactor = qMax(1.0, hashConfig.loadFactor);
+            int virtualNodes = qMax(1, hashConfig.virtualNodes);
+            for (size_t i = 0; i < selector->healthy.size(); ++i) {
+                int nodeCount = virtualNodes * qBound(1, selector->healthy[i]->weight, 10);
+                for (int node = 0; node < nodeCount; ++node) {
+                    quint64 nodeHash = hashKey(QString("%1#%2").arg(healthyIds[static_cast<int>(i)]).arg(node));
+                    selector->hashRing.emplace_back(nodeHash, static_cast<int>(i));
+                }
+            }
+            std::sort(selector->hashRing.begin(), selector->hashRing.end());
+        }
+
+        // 延续原有计数器，避免每次重建后都从第一个实例开始
+        if (previous) {
+            selector->roundRobinCounter.store(previous->roundRobinCounter.load(std::memory_order_relaxed),
+                                              std::memory_order_relaxed);
+            selector->weightedCounter.store(previous->weightedCounter.load(std::memory_order_relaxed),
+                                            std::memory_order_relaxed);
+        }
+        table->insert(serviceName, selector);
+    }
+
+    std::atomic_store(&selectors, std::shared_ptr<const InstanceSelectorTable>(table));
+}
+
+std::shared_ptr<InstanceSelector> LoadBalancer::Private::selector(const QString& serviceName) const
+{
+    std::shared_ptr<const InstanceSelectorTable> table = std::atomic_load(&selectors);
+    return table->value(serviceName);
+}
+
+QString LoadBalancer::Private::detectOutlier(const QString& serviceName, const QString& instanceId,
+                                             InstanceRuntime& runtime, qint64 nowNs, int& durationMs)
+{
+    if (!outlierConfig.enabled || runtime.ejectedUntilNs > 0) {
+        return QString();
+    }
+    
+    const QMap<QString, ServiceInstance>& serviceInstances = instances[serviceName];
+    const QMap<QString, std::shared_ptr<InstanceRuntime>>& serviceRuntimes = runtimes[serviceName];
+    
+    QString reason;
+    int consecutiveErrors = runtime.consecutiveErrors.load(std::memory_order_relaxed);
+    if (outlierConfig.consecutiveErrors > 0 && consecutiveErrors >= outlierConfig.consecutiveErrors) {
+        reason = QString("连续失败%1次").arg(consecutiveErrors);
+    } else if (outlierConfig.latencyFactor > 0
+               && runtime.samples.load(std::memory_order_relaxed) >= outlierConfig.minLatencySamples) {
+        double latency = runtime.decayedLatency(nowNs, kEwmaDecayNs);
+        if (latency >= outlierConfig.minLatencyUs) {
+            // 与同服务其他参与选择的实例的延迟中位数比较
+            std::vector<double> others;
+            for (auto it = serviceRuntimes.begin(); it != serviceRuntimes.end(); ++it) {
+                const InstanceRuntime& other = *it.value();
+                if (it.key() == instanceId || other.ejectedUntilNs > 0
+                    || !serviceInstances.value(it.key()).healthy
+                    || other.samples.load(std::memory_order_relaxed) < outlierConfig.minLatencySamples) {
+                    continue;
+                }
+                others.push_back(other.decayedLatency(nowNs, kEwmaDecayNs));
+            }
+            if (others.size() >= 2) {
+                auto middle = others.begin() + others.size() / 2;
+                std::nth_element(others.begin(), middle, others.end());
+                if (latency > outlierConfig.latencyFactor * (*middle)) {
+                    reason = QString("平均延迟%1us超过中位数%2us的%3倍")
+                        .arg(qint64(latency)).arg(qint64(*middle)).arg(outlierConfig.latencyFactor);
+                }
+            }
+        }
+    }
+    
+    if (reason.isEmpty()) {
+        return reason;
+    }
+    
+    // 摘除比例上限：保证服务始终保留足够的实例
+    int total = 0;
+    int ejected = 0;
+    for (auto it = serviceInstances.begin(); it != serviceInstances.end(); ++it) {
+        if (!it->healthy) {
+            continue;
+        }
+        total++;
+        std::shared_ptr<InstanceRuntime> other = serviceRuntimes.value(it.key());
+        if (other && other->ejectedUntilNs > 0) {
+            ejected++;
+        }
+    }
+    if ((ejected + 1) * 100 > outlierConfig.maxEjectionPercent * total) {
+        return QString();
+    }
+    
+    // 摘除时间随摘除次数指数增长，长时间未被摘除后重新计数
+    qint64 maxEjectionNs = qint64(outlierConfig.maxEjectionTimeMs) * 1000000;
+    if (runtime.lastEjectedNs > 0 && nowNs - runtime.lastEjectedNs > maxEjectionNs) {
+        runtime.ejectionCount = 0;
+    }
+    runtime.ejectionCount++;
+    qint64 duration = qMin<qint64>(outlierConfig.maxEjectionTimeMs,
+                                   qint64(outlierConfig.baseEjectionTimeMs) << qMin(runtime.ejectionCount - 1, 20));
+    durationMs = static_cast<int>(duration);
+    runtime.ejectedUntilNs = nowNs + duration * 1000000;
+    runtime.lastEjectedNs = nowNs;
+    runtime.consecutiveErrors.store(0, std::memory_order_relaxed);
+    
+    if (runtime.ejectedUntilNs < nextReinstateNs.load(std::memory_order_relaxed)) {
+        nextReinstateNs.store(runtime.ejectedUntilNs, std::memory_order_relaxed);
+    }
+    publishSelector(serviceName);
+    return reason;
+}
+
 LoadBalancer::LoadBalancer(QObject* parent)
     : QObject(parent)
     , d(new LoadBalancer::Private)
 {
+    d->clock.start();
     Logger::info("LoadBalancer", "负载均衡器初始化完成");
 }
 
@@ -71,6 +327,7 @@ bool LoadBalancer::registerInstance(const QString& serviceName, const ServiceDes
     }
     
     ServiceInstance instance;
+    instance.instanceId = instanceId;
     instance.descriptor = descriptor;
     instance.descriptor.provider = provider;
     instance.provider = provider;
@@ -78,11 +335,13 @@ bool LoadBalancer::registerInstance(const QString& serviceName, const ServiceDes
     instance.healthy = true;
     
     d->instances[serviceName][instanceId] = instance;
+    d->runtimes[serviceName][instanceId] = std::make_shared<InstanceRuntime>();
     
     // 初始化负载均衡算法（如果未设置）
     if (!d->algorithms.contains(serviceName)) {
         d->algorithms[serviceName] = LoadBalanceAlgorithm::RoundRobin;
     }
+    d->publishSelector(serviceName);
     
     Logger::info("LoadBalancer", QString("服务实例注册成功: %1/%2 (权重: %3)")
         .arg(serviceName, instanceId).arg(instance.weight));
@@ -105,15 +364,15 @@ bool LoadBalancer::unregisterInstance(const QString& serviceName, const QString&
     }
     
     d->instances[serviceName].remove(instanceId);
+    d->runtimes[serviceName].remove(instanceId);
     
     // 如果该服务没有实例了，清理相关数据
     if (d->instances[serviceName].isEmpty()) {
         d->instances.remove(serviceName);
         d->algorithms.remove(serviceName);
-        d->roundRobinIndices.remove(serviceName);
-        d->weightedRoundRobinWeights.remove(serviceName);
-        d->ipHashMappings.remove(serviceName);
+        d->runtimes.remove(serviceName);
     }
+    d->publishSelector(serviceName);
     
     Logger::info("LoadBalancer", QString("服务实例注销成功: %1/%2").arg(serviceName, instanceId));
     
@@ -121,229 +380,259 @@ bool LoadBalancer::unregisterInstance(const QString& serviceName, const QString&
     return true;
 }
 
-QList<ServiceInstance*> LoadBalancer::getHealthyInstances(const QString& serviceName) const
-{
-    const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    QList<ServiceInstance*> healthyInstances;
-    
-    if (!d->instances.contains(serviceName)) {
-        return healthyInstances;
-    }
-    
-    // 使用const_cast，因为虽然方法是const，但返回的指针用于非const操作
-    // 这是安全的，因为调用者知道他们正在修改实例状态
-    const QMap<QString, ServiceInstance>& instances = d->instances[serviceName];
-    for (auto it = instances.begin(); it != instances.end(); ++it) {
-        if (it->healthy && it->isValid()) {
-            healthyInstances.append(const_cast<ServiceInstance*>(&(*it)));
-        }
-    }
-    
-    return healthyInstances;
-}
-
-ServiceInstance* LoadBalancer::selectInstance(const QString& serviceName, const QString& clientId)
+std::shared_ptr<const ServiceInstance> LoadBalancer::selectInstance(const QString& serviceName,
+                                                                     const QString& clientId)
 {
-    if (!isEnabled()) {
+    auto* d = d_func();
+    if (!d->enabled.load(std::memory_order_relaxed)) {
         return nullptr;
     }
     
-    auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
+    // 摘除到期的实例在下一次选择时恢复
+    qint64 now = d->clock.nsecsElapsed() + 1;
+    if (now >= d->nextReinstateNs.load(std::memory_order_relaxed)) {
+        reinstateExpiredInstances(now);
+    }
     
-    if (!d->instances.contains(serviceName) || d->instances[serviceName].isEmpty()) {
+    // 读取已发布的快照，选择过程不持有互斥锁
+    std::shared_ptr<InstanceSelector> selector = d->selector(serviceName);
+    if (!selector || selector->healthy.empty()) {
         return nullptr;
     }
     
-    LoadBalanceAlgorithm algorithm = d->algorithms.value(serviceName, LoadBalanceAlgorithm::RoundRobin);
-    locker.unlock();
-    
-    ServiceInstance* selected = nullptr;
+    int selected = 0;
     
-    switch (algorithm) {
+    switch (selector->algorithm) {
     case LoadBalanceAlgorithm::RoundRobin:
-        selected = selectRoundRobin(serviceName);
+        selected = selectRoundRobin(*selector);
         break;
     case LoadBalanceAlgorithm::WeightedRoundRobin:
-        selected = selectWeightedRoundRobin(serviceName);
+        selected = selectWeightedRoundRobin(*selector);
         break;
     case LoadBalanceAlgorithm::LeastConnections:
-        selected = selectLeastConnections(serviceName);
+        selected = selectLeastConnections(*selector);
         break;
     case LoadBalanceAlgorithm::Random:
-        selected = selectRandom(serviceName);
+        selected = selectRandom(*selector);
         break;
     case LoadBalanceAlgorithm::IPHash:
-        selected = selectIPHash(serviceName, clientId);
+        selected = selectIPHash(serviceName, *selector, clientId);
+        break;
+    case LoadBalanceAlgorithm::P2CEwma:
+        selected = selectP2CEwma(*selector);
         break;
     default:
-        selected = selectRoundRobin(serviceName);
+        selected = selectRoundRobin(*selector);
         break;
     }
     
-    return selected;
+    return selector->healthy[static_cast<size_t>(selected)];
 }
 
-ServiceInstance* LoadBalancer::selectRoundRobin(const QString& serviceName)
+int LoadBalancer::selectRoundRobin(InstanceSelector& selector)
 {
-    QList<ServiceInstance*> healthyInstances = getHealthyInstances(serviceName);
-    if (healthyInstances.isEmpty()) {
-        return nullptr;
-    }
-    
-    auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    int& currentIndex = d->roundRobinIndices[serviceName];
-    currentIndex = (currentIndex + 1) % healthyInstances.size();
-    
-    return healthyInstances[currentIndex];
+    quint32 index = selector.roundRobinCounter.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<int>(index % selector.healthy.size());
 }
 
-ServiceInstance* LoadBalancer::selectWeightedRoundRobin(const QString& serviceName)
+int LoadBalancer::selectWeightedRoundRobin(InstanceSelector& selector)
 {
-    QList<ServiceInstance*> healthyInstances = getHealthyInstances(serviceName);
-    if (healthyInstances.isEmpty()) {
-        return nullptr;
+    if (selector.weightedSequence.empty()) {
+        return 0;
     }
     
-    auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    // 计算总权重
-    int totalWeight = 0;
-    for (ServiceInstance* instance : healthyInstances) {
-        totalWeight += instance->weight;
-    }
-    
-    if (totalWeight == 0) {
-        return healthyInstances.first();
-    }
-    
-    // 加权轮询算法
-    int& currentWeight = d->weightedRoundRobinWeights[serviceName];
-    currentWeight = (currentWeight + 1) % totalWeight;
-    
-    int accumulatedWeight = 0;
-    for (ServiceInstance* instance : healthyInstances) {
-        accumulatedWeight += instance->weight;
-        if (currentWeight < accumulatedWeight) {
-            return instance;
-        }
-    }
-    
-    return healthyInstances.first();
+    // 平滑加权轮询：按预计算序列取下标，权重大的实例被均匀穿插
+    quint32 position = selector.weightedCounter.fetch_add(1, std::memory_order_relaxed);
+    return selector.weightedSequence[position % selector.weightedSequence.size()];
 }
 
-ServiceInstance* LoadBalancer::selectLeastConnections(const QString& serviceName)
+int LoadBalancer::selectLeastConnections(InstanceSelector& selector)
 {
-    QList<ServiceInstance*> healthyInstances = getHealthyInstances(serviceName);
-    if (healthyInstances.isEmpty()) {
-        return nullptr;
-    }
-    
     // 找到连接数最少的实例
-    ServiceInstance* selected = nullptr;
+    int selected = 0;
     int minConnections = INT_MAX;
     
-    for (ServiceInstance* instance : healthyInstances) {
-        if (instance->activeConnections < minConnections) {
-            minConnections = instance->activeConnections;
-            selected = instance;
+    for (size_t i = 0; i < selector.healthy.size(); ++i) {
+        int connections = selector.runtimes[i]->outstanding.load(std::memory_order_relaxed);
+        if (connections < minConnections) {
+            minConnections = connections;
+            selected = static_cast<int>(i);
         }
     }
     
     return selected;
 }
 
-ServiceInstance* LoadBalancer::selectRandom(const QString& serviceName)
+int LoadBalancer::selectRandom(InstanceSelector& selector)
 {
-    QList<ServiceInstance*> healthyInstances = getHealthyInstances(serviceName);
-    if (healthyInstances.isEmpty()) {
-        return nullptr;
-    }
-    
     QRandomGenerator* rng = QRandomGenerator::global();
-    int index = rng->bounded(healthyInstances.size());
-    
-    return healthyInstances[index];
+    return rng->bounded(static_cast<int>(selector.healthy.size()));
 }
 
-ServiceInstance* LoadBalancer::selectIPHash(const QString& serviceName, const QString& clientId)
+int LoadBalancer::selectIPHash(const QString& serviceName, InstanceSelector& selector,
+                               const QString& clientId)
 {
-    QList<ServiceInstance*> healthyInstances = getHealthyInstances(serviceName);
-    if (healthyInstances.isEmpty()) {
-        return nullptr;
-    }
+    Q_UNUSED(serviceName)
     
-    if (clientId.isEmpty()) {
+    if (clientId.isEmpty() || selector.hashRing.empty()) {
         // 如果没有clientId，回退到轮询
-        return selectRoundRobin(serviceName);
-    }
-    
-    auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    
-    // 检查是否已有映射
-    if (d->ipHashMappings.contains(serviceName) && 
-        d->ipHashMappings[serviceName].contains(clientId)) {
-        QString instanceId = d->ipHashMappings[serviceName][clientId];
-        
-        // 验证实例是否仍然存在且健康
-        if (d->instances.contains(serviceName) && 
-            d->instances[serviceName].contains(instanceId)) {
-            ServiceInstance& instance = d->instances[serviceName][instanceId];
-            if (instance.healthy && instance.isValid()) {
-                return &instance;
-            }
+        return selectRoundRobin(selector);
+    }
+    
+    // 负载上限：单实例在途数不超过 loadFactor * (总在途数 + 1) / 实例数（向上取整）
+    int totalOutstanding = 0;
+    for (const auto& runtime : selector.runtimes) {
+        totalOutstanding += runtime->outstanding.load(std::memory_order_relaxed);
+    }
+    int capacity = static_cast<int>(std::ceil(selector.hashLoadFactor * (totalOutstanding + 1)
+                                              / selector.healthy.size()));
+    
+    // 从客户端哈希位置顺时针查找第一个未超过负载上限的实例
+    quint64 clientHash = hashKey(clientId);
+    auto start = std::lower_bound(selector.hashRing.begin(), selector.hashRing.end(),
+                                  std::make_pair(clientHash, 0));
+    size_t startIndex = static_cast<size_t>(start - selector.hashRing.begin());
+    size_t ringSize = selector.hashRing.size();
+    for (size_t step = 0; step < ringSize; ++step) {
+        int index = selector.hashRing[(startIndex + step) % ringSize].second;
+        if (selector.runtimes[index]->outstanding.load(std::memory_order_relaxed) < capacity) {
+            return index;
         }
     }
     
-    // 使用IP哈希选择实例
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    hash.addData(clientId.toUtf8());
-    QByteArray hashValue = hash.result();
-    
-    // 将哈希值转换为整数索引
-    quint32 hashInt = 0;
-    for (int i = 0; i < qMin(4, hashValue.size()); ++i) {
-        hashInt = (hashInt << 8) | static_cast<unsigned char>(hashValue[i]);
+    return selector.hashRing[startIndex % ringSize].second;
+}
+
+int LoadBalancer::selectP2CEwma(InstanceSelector& selector)
+{
+    int count = static_cast<int>(selector.healthy.size());
+    if (count == 1) {
+        return 0;
     }
     
-    int index = hashInt % healthyInstances.size();
-    ServiceInstance* selected = healthyInstances[index];
-    
-    // 保存映射（会话保持）
-    QString instanceId = generateInstanceId(selected->descriptor);
-    d->ipHashMappings[serviceName][clientId] = instanceId;
+    // 随机取两个不同的实例，选择评分较低者
+    QRandomGenerator* rng = QRandomGenerator::global();
+    int first = rng->bounded(count);
+    int second = rng->bounded(count - 1);
+    if (second >= first) {
+        second++;
+    }
     
-    return selected;
+    qint64 now = d_func()->clock.nsecsElapsed() + 1;
+    double firstScore = selector.runtimes[first]->score(now, kEwmaDecayNs);
+    double secondScore = selector.runtimes[second]->score(now, kEwmaDecayNs);
+    return firstScore <= secondScore ? first : second;
 }
 
 void LoadBalancer::onServiceCallStart(const QString& serviceName, const QString& instanceId)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
     
-    if (d->instances.contains(serviceName) && d->instances[serviceName].contains(instanceId)) {
-        ServiceInstance& instance = d->instances[serviceName][instanceId];
-        instance.activeConnections++;
-        instance.totalRequests++;
+    // 通过已发布的快照找到实例的运行期负载，只更新原子计数，不持有互斥锁
+    std::shared_ptr<InstanceSelector> selector = d->selector(serviceName);
+    std::shared_ptr<InstanceRuntime> runtime = selector ? selector->runtimeById.value(instanceId) : nullptr;
+    if (runtime) {
+        runtime->outstanding.fetch_add(1, std::memory_order_relaxed);
+        runtime->totalRequests.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
-void LoadBalancer::onServiceCallEnd(const QString& serviceName, const QString& instanceId)
+void LoadBalancer::onServiceCallEnd(const QString& serviceName, const QString& instanceId,
+                                    qint64 latencyUs, bool success)
 {
     auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
+    std::shared_ptr<InstanceSelector> selector = d->selector(serviceName);
+    std::shared_ptr<InstanceRuntime> runtime = selector ? selector->runtimeById.value(instanceId) : nullptr;
+    if (!runtime) {
+        return;
+    }
     
-    if (d->instances.contains(serviceName) && d->instances[serviceName].contains(instanceId)) {
-        ServiceInstance& instance = d->instances[serviceName][instanceId];
-        if (instance.activeConnections > 0) {
-            instance.activeConnections--;
+    // 在途数不减到负数（实例在调用期间被注销并重新注册时可能不匹配）
+    int outstanding = runtime->outstanding.load(std::memory_order_relaxed);
+    do {
+        if (outstanding <= 0) {
+            return;
+        }
+    } while (!runtime->outstanding.compare_exchange_weak(outstanding, outstanding - 1, std::memory_order_relaxed));
+    if (latencyUs < 0) {
+        return;
+    }
+    
+    qint64 now = d->clock.nsecsElapsed() + 1;
+    double sample = success ? static_cast<double>(latencyUs)
+                            : qMax(static_cast<double>(latencyUs), kFailurePenaltyUs);
+    runtime->recordLatency(now, sample, kEwmaDecayNs);
+    qint64 samples = runtime->samples.fetch_add(1, std::memory_order_relaxed) + 1;
+    int consecutiveErrors = 0;
+    if (success) {
+        if (runtime->consecutiveErrors.load(std::memory_order_relaxed) != 0) {
+            runtime->consecutiveErrors.store(0, std::memory_order_relaxed);
+        }
+    } else {
+        runtime->failures.fetch_add(1, std::memory_order_relaxed);
+        consecutiveErrors = runtime->consecutiveErrors.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    
+    // 被动异常检测：连续失败达到阈值或到了延迟检查间隔才加锁判定
+    const OutlierDetectionConfig& config = selector->outlierConfig;
+    bool check = config.enabled
+        && ((config.consecutiveErrors > 0 && consecutiveErrors >= config.consecutiveErrors)
+            || (config.latencyFactor > 0 && samples >= config.minLatencySamples
+                && samples % kOutlierLatencyCheckInterval == 0));
+    if (!check) {
+        return;
+    }
+    
+    QMutexLocker locker(&d->mutex);
+    if (d->runtimes.value(serviceName).value(instanceId) != runtime) {
+        return;  // 实例已注销
+    }
+    int durationMs = 0;
+    QString reason = d->detectOutlier(serviceName, instanceId, *runtime, now, durationMs);
+    if (!reason.isEmpty()) {
+        locker.unlock();
+        Logger::warning("LoadBalancer", QString("摘除异常实例: %1/%2 (%3, %4ms)")
+            .arg(serviceName, instanceId, reason).arg(durationMs));
+        emit instanceEjected(serviceName, instanceId, reason, durationMs);
+    }
+}
+
+void LoadBalancer::reinstateExpiredInstances(qint64 nowNs)
+{
+    auto* d = d_func();
+    QList<QPair<QString, QString>> reinstated;
+    {
+        QMutexLocker locker(&d->mutex);
+        
+        QStringList changedServices;
+        qint64 next = std::numeric_limits<qint64>::max();
+        for (auto serviceIt = d->runtimes.begin(); serviceIt != d->runtimes.end(); ++serviceIt) {
+            for (auto it = serviceIt->begin(); it != serviceIt->end(); ++it) {
+                InstanceRuntime& runtime = *it.value();
+                if (runtime.ejectedUntilNs <= 0) {
+                    continue;
+                }
+                if (runtime.ejectedUntilNs <= nowNs) {
+                    runtime.ejectedUntilNs = 0;
+                    reinstated.append(qMakePair(serviceIt.key(), it.key()));
+                    if (!changedServices.contains(serviceIt.key())) {
+                        changedServices.append(serviceIt.key());
+                    }
+                } else {
+                    next = qMin(next, runtime.ejectedUntilNs);
+                }
+            }
         }
+        
+        for (const QString& serviceName : changedServices) {
+            d->publishSelector(serviceName);
+        }
+        d->nextReinstateNs.store(next, std::memory_order_relaxed);
+    }
+    
+    for (const auto& entry : reinstated) {
+        Logger::info("LoadBalancer", QString("恢复被摘除的实例: %1/%2").arg(entry.first, entry.second));
+        emit instanceReinstated(entry.first, entry.second);
     }
 }
 
@@ -358,6 +647,7 @@ void LoadBalancer::setInstanceHealth(const QString& serviceName, const QString&
         instance.healthy = healthy;
         
         if (oldHealth != healthy) {
+            d->publishSelector(serviceName);
             locker.unlock();
             emit instanceHealthChanged(serviceName, instanceId, healthy);
             Logger::info("LoadBalancer", QString("服务实例健康状态变更: %1/%2 -> %3")
@@ -371,6 +661,7 @@ void LoadBalancer::setAlgorithm(const QString& serviceName, LoadBalanceAlgorithm
     auto* d = d_func();
     QMutexLocker locker(&d->mutex);
     d->algorithms[serviceName] = algorithm;
+    d->publishSelector(serviceName);
     Logger::info("LoadBalancer", QString("设置负载均衡算法: %1 -> %2")
         .arg(serviceName, QString::number(static_cast<int>(algorithm))));
 }
@@ -389,13 +680,29 @@ QList<ServiceInstance> LoadBalancer::getInstances(const QString& serviceName) co
     
     QList<ServiceInstance> result;
     if (d->instances.contains(serviceName)) {
+        const QMap<QString, std::shared_ptr<InstanceRuntime>> serviceRuntimes = d->runtimes.value(serviceName);
         for (auto it = d->instances[serviceName].begin(); it != d->instances[serviceName].end(); ++it) {
-            result.append(*it);
+            ServiceInstance instance = *it;
+            
+            // 调用计数由运行期负载原子维护
+            std::shared_ptr<InstanceRuntime> runtime = serviceRuntimes.value(it.key());
+            if (runtime) {
+                instance.activeConnections = runtime->outstanding.load(std::memory_order_relaxed);
+                instance.totalRequests = static_cast<int>(runtime->totalRequests.load(std::memory_order_relaxed));
+            }
+            result.append(instance);
         }
     }
     return result;
 }
 
+int LoadBalancer::availableInstanceCount(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    std::shared_ptr<InstanceSelector> selector = d->selector(serviceName);
+    return selector ? static_cast<int>(selector->healthy.size()) : 0;
+}
+
 QMap<QString, QVariant> LoadBalancer::getInstanceStats(const QString& serviceName, const QString& instanceId) const
 {
     const auto* d = d_func();
@@ -407,11 +714,23 @@ QMap<QString, QVariant> LoadBalancer::getInstanceStats(const QString& serviceNam
         const ServiceInstance& instance = d->instances[serviceName][instanceId];
         stats["instanceId"] = instanceId;
         stats["weight"] = instance.weight;
-        stats["activeConnections"] = instance.activeConnections;
-        stats["totalRequests"] = instance.totalRequests;
         stats["healthy"] = instance.healthy;
         stats["serviceName"] = instance.descriptor.serviceName;
         stats["version"] = instance.descriptor.version;
+        
+        std::shared_ptr<InstanceRuntime> runtime = d->runtimes.value(serviceName).value(instanceId);
+        if (runtime) {
+            qint64 now = d->clock.nsecsElapsed() + 1;
+            stats["activeConnections"] = runtime->outstanding.load(std::memory_order_relaxed);
+            stats["totalRequests"] = runtime->totalRequests.load(std::memory_order_relaxed);
+            stats["outstanding"] = runtime->outstanding.load(std::memory_order_relaxed);
+            stats["ewmaLatencyUs"] = runtime->decayedLatency(now, kEwmaDecayNs);
+            stats["score"] = runtime->score(now, kEwmaDecayNs);
+            stats["failures"] = runtime->failures.load(std::memory_order_relaxed);
+            stats["ejected"] = runtime->ejectedUntilNs > 0;
+            stats["ejectionCount"] = runtime->ejectionCount;
+            stats["consecutiveErrors"] = runtime->consecutiveErrors.load(std::memory_order_relaxed);
+        }
     }
     
     return stats;
@@ -425,11 +744,59 @@ void LoadBalancer::setInstanceWeight(const QString& serviceName, const QString&
     if (d->instances.contains(serviceName) && d->instances[serviceName].contains(instanceId)) {
         ServiceInstance& instance = d->instances[serviceName][instanceId];
         instance.weight = weight > 0 ? weight : 1;
+        d->publishSelector(serviceName);
         Logger::info("LoadBalancer", QString("设置实例权重: %1/%2 -> %3")
             .arg(serviceName, instanceId).arg(instance.weight));
     }
 }
 
+void LoadBalancer::setConsistentHashConfig(const ConsistentHashConfig& config)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->hashConfig = config;
+    for (auto it = d->instances.begin(); it != d->instances.end(); ++it) {
+        d->publishSelector(it.key());
+    }
+    Logger::info("LoadBalancer", QString("设置一致性哈希配置: 虚拟节点%1, 负载系数%2")
+        .arg(config.virtualNodes).arg(config.loadFactor));
+}
+
+ConsistentHashConfig LoadBalancer::consistentHashConfig() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->hashConfig;
+}
+
+void LoadBalancer::setOutlierDetectionConfig(const OutlierDetectionConfig& config)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->outlierConfig = config;
+    for (auto it = d->instances.begin(); it != d->instances.end(); ++it) {
+        d->publishSelector(it.key());
+    }
+    Logger::info("LoadBalancer", QString("设置异常检测配置: %1, 连续失败%2次, 延迟倍数%3, 最多摘除%4%")
+        .arg(config.enabled ? "启用" : "禁用").arg(config.consecutiveErrors)
+        .arg(config.latencyFactor).arg(config.maxEjectionPercent));
+}
+
+OutlierDetectionConfig LoadBalancer::outlierDetectionConfig() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->outlierConfig;
+}
+
+bool LoadBalancer::isInstanceEjected(const QString& serviceName, const QString& instanceId) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    std::shared_ptr<InstanceRuntime> runtime = d->runtimes.value(serviceName).value(instanceId);
+    return runtime && runtime->ejectedUntilNs > 0;
+}
+
 void LoadBalancer::setEnabled(bool enabled)
 {
     auto* d = d_func();
@@ -441,8 +808,7 @@ void LoadBalancer::setEnabled(bool enabled)
 bool LoadBalancer::isEnabled() const
 {
     const auto* d = d_func();
-    QMutexLocker locker(&d->mutex);
-    return d->enabled;
+    return d->enabled.load(std::memory_order_relaxed);
 }
 
 } // namespace Core
@@ -4,36 +4,122 @@
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
 #include <QtCore/QMutex>
 #include <QtCore/QVariant>
+#include <QtCore/QElapsedTimer>
 #include "eagle/core/LoadBalancer.h"
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
 
 namespace Eagle {
 namespace Core {
 
+/**
+ * @brief 实例运行期负载（跨快照共享，原子更新）
+ */
+struct InstanceRuntime {
+    std::atomic<int> outstanding{0};                 // 在途调用数
+    std::atomic<double> ewmaLatencyUs{0.0};          // 指数衰减的峰值敏感平均延迟
+    std::atomic<qint64> lastSampleNs{0};             // 上次样本时间（单调时钟）
+    std::atomic<qint64> failures{0};
+    std::atomic<qint64> samples{0};
+    std::atomic<qint64> totalRequests{0};
+    std::atomic<int> consecutiveErrors{0};
+
+    // 异常检测状态（由LoadBalancer::Private::mutex保护）
+    int ejectionCount = 0;
+    qint64 ejectedUntilNs = 0;                       // >0 表示当前被摘除
+    qint64 lastEjectedNs = 0;
+
+    /**
+     * @brief 计入一个延迟样本
+     */
+    void recordLatency(qint64 nowNs, double latencyUs, double decayNs);
+
+    /**
+     * @brief 按距上次样本的时间衰减后的平均延迟（不修改状态）
+     */
+    double decayedLatency(qint64 nowNs, double decayNs) const;
+
+    /**
+     * @brief P2C评分：衰减延迟 × (在途数 + 1)，越小越好
+     */
+    double score(qint64 nowNs, double decayNs) const;
+};
+
+/**
+ * @brief 服务实例选择快照
+ *
+ * 实例集合、健康状态、权重、算法或异常检测配置变化时整体重建并发布；
+ * 选择和调用计数路径只读取快照并更新原子计数器，不需要持有互斥锁。
+ * 快照持有实例副本，实例注销后旧快照的读取方仍可安全访问。
+ */
+struct InstanceSelector {
+    LoadBalanceAlgorithm algorithm = LoadBalanceAlgorithm::RoundRobin;
+    std::vector<std::shared_ptr<const ServiceInstance>> healthy;  // 参与选择的实例副本
+    std::vector<std::shared_ptr<InstanceRuntime>> runtimes;  // 与healthy一一对应
+    QHash<QString, std::shared_ptr<InstanceRuntime>> runtimeById;  // 全部实例（含不健康、被摘除的）
+    OutlierDetectionConfig outlierConfig;
+    std::vector<int> weightedSequence;               // 平滑加权轮询预计算序列（healthy下标，仅WeightedRoundRobin）
+    std::vector<std::pair<quint64, int>> hashRing;   // 一致性哈希环：虚拟节点哈希 -> healthy下标（有序，仅IPHash）
+    double hashLoadFactor = 1.25;
+    std::atomic<quint32> roundRobinCounter{0};
+    std::atomic<quint32> weightedCounter{0};
+};
+
+using InstanceSelectorTable = QHash<QString, std::shared_ptr<InstanceSelector>>;
+
 class LoadBalancer::Private {
 public:
     // 服务实例管理：serviceName -> instanceId -> ServiceInstance
     QMap<QString, QMap<QString, ServiceInstance>> instances;
-    
+
     // 负载均衡算法：serviceName -> algorithm
     QMap<QString, LoadBalanceAlgorithm> algorithms;
-    
-    // 轮询索引：serviceName -> currentIndex
-    QMap<QString, int> roundRobinIndices;
-    
-    // 加权轮询当前权重：serviceName -> currentWeight
-    QMap<QString, int> weightedRoundRobinWeights;
-    
-    // IP哈希映射：serviceName -> clientId -> instanceId
-    QMap<QString, QMap<QString, QString>> ipHashMappings;
-    
-    bool enabled;
+
+    // 已发布的选择快照表（写时复制，读取方通过原子加载获得一致视图）
+    std::shared_ptr<const InstanceSelectorTable> selectors;
+
+    // 实例运行期负载：serviceName -> instanceId -> runtime
+    QMap<QString, QMap<QString, std::shared_ptr<InstanceRuntime>>> runtimes;
+
+    // 一致性哈希配置
+    ConsistentHashConfig hashConfig;
+
+    // 延迟统计使用的单调时钟
+    QElapsedTimer clock;
+
+    // 被动异常检测
+    OutlierDetectionConfig outlierConfig;
+    std::atomic<qint64> nextReinstateNs{std::numeric_limits<qint64>::max()};  // 最早的恢复时间
+
+    std::atomic<bool> enabled;
     mutable QMutex mutex;
-    
+
     Private()
-        : enabled(true)
+        : selectors(std::make_shared<const InstanceSelectorTable>())
+        , enabled(true)
     {}
+
+    /**
+     * @brief 重建并发布服务的选择快照（调用方需持有mutex）
+     */
+    void publishSelector(const QString& serviceName);
+
+    /**
+     * @brief 获取当前发布的选择快照（无锁）
+     */
+    std::shared_ptr<InstanceSelector> selector(const QString& serviceName) const;
+
+    /**
+     * @brief 根据调用结果判断是否摘除实例（调用方需持有mutex）
+     * @return 摘除原因，未摘除时返回空字符串
+     */
+    QString detectOutlier(const QString& serviceName, const QString& instanceId,
+                          InstanceRuntime& runtime, qint64 nowNs, int& durationMs);
 };
 
 } // namespace Core
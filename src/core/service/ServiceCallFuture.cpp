@@ -0,0 +1,503 @@
+#include "eagle/core/ServiceCallFuture.h"
+#include "ServiceCallFuture_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QVariantMap>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace Eagle {
+namespace Core {
+
+namespace {
+
+const int kStatePoolCapacity = 256;  // 缓存的共享状态上限
+
+/**
+ * @brief 全局共享状态池（无锁）
+ *
+ * 状态通常在调用方线程分配、在工作线程释放，线程本地池无法回收，
+ * 因此所有线程共用一组槽位：取出用exchange，放回用CAS，不存在ABA问题。
+ */
+struct ServiceCallStatePool {
+    ~ServiceCallStatePool()
+    {
+        for (std::atomic<ServiceCallState*>& slot : slots) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+
+    ServiceCallState* take()
+    {
+        if (count.load(std::memory_order_relaxed) <= 0) {
+            return nullptr;
+        }
+        unsigned start = hint.load(std::memory_order_relaxed);
+        for (int i = 0; i < kStatePoolCapacity; ++i) {
+            unsigned index = (start + i) % kStatePoolCapacity;
+            if (!slots[index].load(std::memory_order_relaxed)) {
+                continue;
+            }
+            ServiceCallState* state = slots[index].exchange(nullptr, std::memory_order_acquire);
+            if (state) {
+                count.fetch_sub(1, std::memory_order_relaxed);
+                hint.store(index, std::memory_order_relaxed);
+                return state;
+            }
+        }
+        return nullptr;
+    }
+
+    bool put(ServiceCallState* state)
+    {
+        if (count.load(std::memory_order_relaxed) >= kStatePoolCapacity) {
+            return false;
+        }
+        unsigned start = hint.load(std::memory_order_relaxed);
+        for (int i = 0; i < kStatePoolCapacity; ++i) {
+            unsigned index = (start + i) % kStatePoolCapacity;
+            ServiceCallState* expected = nullptr;
+            if (!slots[index].load(std::memory_order_relaxed)
+                && slots[index].compare_exchange_strong(expected, state, std::memory_order_release)) {
+                count.fetch_add(1, std::memory_order_relaxed);
+                hint.store(index, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::atomic<ServiceCallState*> slots[kStatePoolCapacity] = {};
+    std::atomic<int> count{0};          // 近似的缓存数量，只用于快速判断空和满
+    std::atomic<unsigned> hint{0};      // 最近一次存取的槽位，下一次从这里开始扫描
+};
+
+ServiceCallStatePool statePool;
+
+} // namespace
+
+// ==================== ServiceExecutors ====================
+
+namespace ServiceExecutors {
+
+ServiceExecutor inlineExecutor()
+{
+    return ServiceExecutor();
+}
+
+ServiceExecutor threadPool(QThreadPool* pool)
+{
+    return [pool](std::function<void()> task) {
+        QThreadPool* target = pool ? pool : QThreadPool::globalInstance();
+        target->start(std::move(task));
+    };
+}
+
+ServiceExecutor eventLoop(QObject* context)
+{
+    if (!context) {
+        return [](std::function<void()>) {};
+    }
+
+    // 执行器可能比context活得更久，且任务在其他线程投递：不能在投递线程检查context后再向它投递
+    // （检查之后context可能被销毁）。改为投递到与context同线程、由执行器持有的中转对象，
+    // 到达目标线程后再检查context，此时检查与销毁在同一线程，不存在竞争
+    std::shared_ptr<QObject> relay(new QObject, [](QObject* object) { object->deleteLater(); });
+    relay->moveToThread(context->thread());
+    QPointer<QObject> guard(context);
+    return [relay, guard](std::function<void()> task) {
+        QMetaObject::invokeMethod(relay.get(), [relay, guard, task = std::move(task)]() {
+            if (guard) {
+                task();
+            }
+        }, Qt::QueuedConnection);
+    };
+}
+
+} // namespace ServiceExecutors
+
+// ==================== ServiceCallState ====================
+
+ServiceCallState* ServiceCallState::acquire()
+{
+    ServiceCallState* state = statePool.take();
+    if (!state) {
+        state = new ServiceCallState;
+    }
+    state->refCount.storeRelaxed(1);
+    return state;
+}
+
+void ServiceCallState::ref(ServiceCallState* state)
+{
+    if (state) {
+        state->refCount.ref();
+    }
+}
+
+void ServiceCallState::deref(ServiceCallState* state)
+{
+    if (!state || state->refCount.deref()) {
+        return;
+    }
+
+    state->reset();
+    if (!statePool.put(state)) {
+        delete state;
+    }
+}
+
+bool ServiceCallState::setResult(const ServiceCallResult& value)
+{
+    {
+        QMutexLocker locker(&mutex);
+        if (isFinished()) {
+            return false;
+        }
+        result = value;
+        finished.storeRelease(1);
+    }
+    condition.wakeAll();
+
+    // 完成后不会再有续体加入，这里无需持锁
+    for (const Continuation& continuation : continuations) {
+        dispatch(continuation, result);
+    }
+    continuations.clear();
+    return true;
+}
+
+quint64 ServiceCallState::addContinuation(ServiceCallFuture::Continuation callback, const ServiceExecutor& executor)
+{
+    if (!callback) {
+        return 0;
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        if (!isFinished()) {
+            quint64 id = ++nextContinuationId;
+            continuations.push_back(Continuation{std::move(callback), executor, id});
+            return id;
+        }
+    }
+
+    // 已完成，立即调度
+    dispatch(Continuation{std::move(callback), executor, 0}, result);
+    return 0;
+}
+
+bool ServiceCallState::removeContinuation(quint64 id)
+{
+    QMutexLocker locker(&mutex);
+    if (id == 0 || isFinished()) {
+        return false;  // 完成后续体已在调度，不能再移除
+    }
+
+    for (auto it = continuations.begin(); it != continuations.end(); ++it) {
+        if (it->id == id) {
+            continuations.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ServiceCallState::reset()
+{
+    result = ServiceCallResult();
+    continuations.clear();
+    finished.storeRelaxed(0);
+}
+
+void ServiceCallState::dispatch(const Continuation& continuation, const ServiceCallResult& result)
+{
+    auto run = [callback = continuation.callback, result]() {
+        try {
+            callback(result);
+        } catch (const std::exception& e) {
+            Logger::error("ServiceCallFuture", QString("续体执行异常: %1").arg(e.what()));
+        } catch (...) {
+            Logger::error("ServiceCallFuture", "续体执行发生未知异常");
+        }
+    };
+
+    if (continuation.executor) {
+        continuation.executor(std::move(run));
+    } else {
+        run();
+    }
+}
+
+// ==================== ServiceCallFuture ====================
+
+ServiceCallFuture::ServiceCallFuture()
+    : state(nullptr)
+{
+}
+
+ServiceCallFuture::ServiceCallFuture(ServiceCallState* state)
+    : state(state)
+{
+    ServiceCallState::ref(state);
+}
+
+ServiceCallFuture::ServiceCallFuture(const ServiceCallFuture& other)
+    : state(other.state)
+{
+    ServiceCallState::ref(state);
+}
+
+ServiceCallFuture::ServiceCallFuture(ServiceCallFuture&& other) noexcept
+    : state(other.state)
+{
+    other.state = nullptr;
+}
+
+ServiceCallFuture& ServiceCallFuture::operator=(const ServiceCallFuture& other)
+{
+    if (state != other.state) {
+        ServiceCallState::ref(other.state);
+        ServiceCallState::deref(state);
+        state = other.state;
+    }
+    return *this;
+}
+
+ServiceCallFuture& ServiceCallFuture::operator=(ServiceCallFuture&& other) noexcept
+{
+    if (this != &other) {
+        ServiceCallState::deref(state);
+        state = other.state;
+        other.state = nullptr;
+    }
+    return *this;
+}
+
+ServiceCallFuture::~ServiceCallFuture()
+{
+    ServiceCallState::deref(state);
+}
+
+ServiceCallFuture ServiceCallFuture::makeReady(const ServiceCallResult& result)
+{
+    ServicePromise promise;
+    promise.setResult(result);
+    return promise.future();
+}
+
+bool ServiceCallFuture::isValid() const
+{
+    return state != nullptr;
+}
+
+bool ServiceCallFuture::isFinished() const
+{
+    return state && state->isFinished();
+}
+
+ServiceCallResult ServiceCallFuture::wait(int timeoutMs) const
+{
+    if (!state) {
+        return ServiceCallResult(QString("Invalid service call future"));
+    }
+
+    if (!state->isFinished()) {
+        QDeadlineTimer deadline(timeoutMs < 0 ? qint64(-1) : qint64(timeoutMs));  // -1表示永不超时
+        QMutexLocker locker(&state->mutex);
+        while (!state->isFinished()) {
+            if (!state->condition.wait(&state->mutex, deadline)) {
+                ServiceCallResult timeoutResult;
+                timeoutResult.success = false;
+                timeoutResult.error = "Timeout waiting for service call result";
+                timeoutResult.elapsedMs = timeoutMs;
+                return timeoutResult;
+            }
+        }
+    }
+
+    return state->result;
+}
+
+ServiceCallResult ServiceCallFuture::result() const
+{
+    if (!isFinished()) {
+        return ServiceCallResult();
+    }
+    return state->result;
+}
+
+quint64 ServiceCallFuture::subscribe(Continuation continuation, const ServiceExecutor& executor) const
+{
+    return state ? state->addContinuation(std::move(continuation), executor) : 0;
+}
+
+bool ServiceCallFuture::unsubscribe(quint64 subscription) const
+{
+    return state && state->removeContinuation(subscription);
+}
+
+ServiceCallFuture ServiceCallFuture::then(std::function<QVariant(const QVariant&)> callback,
+                                          const ServiceExecutor& executor) const
+{
+    ServicePromise next;
+    subscribe([next, callback](const ServiceCallResult& result) {
+        if (!result.success) {
+            next.setResult(result);
+            return;
+        }
+
+        try {
+            ServiceCallResult newResult(callback(result.result));
+            newResult.elapsedMs = result.elapsedMs;
+            next.setResult(newResult);
+        } catch (const std::exception& e) {
+            ServiceCallResult errorResult(QString("Exception in then callback: %1").arg(e.what()));
+            errorResult.elapsedMs = result.elapsedMs;
+            next.setResult(errorResult);
+        }
+    }, executor);
+    return next.future();
+}
+
+ServiceCallFuture ServiceCallFuture::onError(std::function<void(const QString&)> callback,
+                                             const ServiceExecutor& executor) const
+{
+    subscribe([callback](const ServiceCallResult& result) {
+        if (!result.success && callback) {
+            callback(result.error);
+        }
+    }, executor);
+    return *this;
+}
+
+ServiceCallFuture ServiceCallFuture::finally(std::function<void()> callback,
+                                             const ServiceExecutor& executor) const
+{
+    subscribe([callback](const ServiceCallResult&) {
+        if (callback) {
+            callback();
+        }
+    }, executor);
+    return *this;
+}
+
+// ==================== ServicePromise ====================
+
+ServicePromise::ServicePromise()
+    : state(ServiceCallState::acquire())
+{
+}
+
+ServicePromise::ServicePromise(const ServicePromise& other)
+    : state(other.state)
+{
+    ServiceCallState::ref(state);
+}
+
+ServicePromise& ServicePromise::operator=(const ServicePromise& other)
+{
+    if (state != other.state) {
+        ServiceCallState::ref(other.state);
+        ServiceCallState::deref(state);
+        state = other.state;
+    }
+    return *this;
+}
+
+ServicePromise::~ServicePromise()
+{
+    ServiceCallState::deref(state);
+}
+
+ServiceCallFuture ServicePromise::future() const
+{
+    return ServiceCallFuture(state);
+}
+
+bool ServicePromise::setResult(const ServiceCallResult& result) const
+{
+    return state->setResult(result);
+}
+
+// ==================== 组合器 ====================
+
+ServiceCallFuture whenAll(const QList<ServiceCallFuture>& futures)
+{
+    if (futures.isEmpty()) {
+        return ServiceCallFuture::makeReady(ServiceCallResult(QVariant(QVariantList())));
+    }
+
+    struct AllState {
+        ServicePromise promise;
+        std::vector<QVariant> results;
+        QAtomicInt remaining;
+        QAtomicInt maxElapsedMs;
+    };
+    auto shared = std::make_shared<AllState>();
+    shared->results.resize(static_cast<size_t>(futures.size()));
+    shared->remaining.storeRelaxed(futures.size());
+    shared->maxElapsedMs.storeRelaxed(0);
+
+    for (int i = 0; i < futures.size(); ++i) {
+        futures[i].subscribe([shared, i](const ServiceCallResult& result) {
+            int elapsed = shared->maxElapsedMs.loadRelaxed();
+            while (result.elapsedMs > elapsed &&
+                   !shared->maxElapsedMs.testAndSetRelaxed(elapsed, result.elapsedMs, elapsed)) {
+            }
+
+            if (!result.success) {
+                shared->promise.setResult(result);  // 快速失败，之后的结果被忽略
+                return;
+            }
+
+            shared->results[static_cast<size_t>(i)] = result.result;
+            if (!shared->remaining.deref()) {
+                QVariantList values;
+                values.reserve(static_cast<int>(shared->results.size()));
+                for (const QVariant& value : shared->results) {
+                    values.append(value);
+                }
+                ServiceCallResult allResult{QVariant(values)};
+                allResult.elapsedMs = shared->maxElapsedMs.loadRelaxed();
+                shared->promise.setResult(allResult);
+            }
+        });
+    }
+
+    return shared->promise.future();
+}
+
+ServiceCallFuture whenAny(const QList<ServiceCallFuture>& futures)
+{
+    if (futures.isEmpty()) {
+        return ServiceCallFuture::makeReady(ServiceCallResult(QString("whenAny called with no futures")));
+    }
+
+    ServicePromise promise;
+    for (int i = 0; i < futures.size(); ++i) {
+        futures[i].subscribe([promise, i](const ServiceCallResult& result) {
+            QVariantMap first;
+            first["index"] = i;
+            first["success"] = result.success;
+            first["result"] = result.result;
+            first["error"] = result.error;
+
+            ServiceCallResult anyResult{QVariant(first)};
+            anyResult.elapsedMs = result.elapsedMs;
+            promise.setResult(anyResult);  // 只有第一个完成的会生效
+        });
+    }
+
+    return promise.future();
+}
+
+} // namespace Core
+} // namespace Eagle
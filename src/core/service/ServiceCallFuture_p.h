@@ -0,0 +1,52 @@
+#ifndef SERVICECALLFUTURE_P_H
+#define SERVICECALLFUTURE_P_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include "eagle/core/ServiceCallFuture.h"
+#include <vector>
+
+namespace Eagle {
+namespace Core {
+
+/**
+ * @brief Future/Promise共享状态
+ *
+ * 从全局无锁对象池分配，引用计数归零后重置并归还对象池，
+ * 互斥量、条件变量和续体数组的容量都会被复用
+ */
+class ServiceCallState {
+public:
+    struct Continuation {
+        ServiceCallFuture::Continuation callback;
+        ServiceExecutor executor;
+        quint64 id;                  // 订阅ID，0表示已直接调度
+    };
+
+    static ServiceCallState* acquire();
+    static void ref(ServiceCallState* state);
+    static void deref(ServiceCallState* state);
+
+    bool setResult(const ServiceCallResult& result);
+    quint64 addContinuation(ServiceCallFuture::Continuation callback, const ServiceExecutor& executor);
+    bool removeContinuation(quint64 id);
+    bool isFinished() const { return finished.loadAcquire() != 0; }
+
+    QAtomicInt refCount;
+    QAtomicInt finished;             // 完成后结果只读，可无锁读取
+    ServiceCallResult result;
+    QMutex mutex;                    // 保护续体列表和结果写入
+    QWaitCondition condition;
+    std::vector<Continuation> continuations;
+    quint64 nextContinuationId = 0;  // 复用时不重置，旧的订阅ID不会误删新续体
+
+private:
+    void reset();
+    static void dispatch(const Continuation& continuation, const ServiceCallResult& result);
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // SERVICECALLFUTURE_P_H
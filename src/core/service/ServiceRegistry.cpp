@@ -1,10 +1,17 @@
 #include "eagle/core/ServiceRegistry.h"
 #include "eagle/core/ServiceDescriptor.h"
 #include "ServiceRegistry_p.h"
+#include "Bulkhead_p.h"
 #include "eagle/core/CircuitBreaker.h"
 #include "eagle/core/RetryPolicy.h"
 #include "eagle/core/DegradationPolicy.h"
 #include "eagle/core/LoadBalancer.h"
+#include "eagle/core/ConcurrencyLimiter.h"
+#include "eagle/core/HedgingPolicy.h"
+#include "eagle/core/Bulkhead.h"
+#include "eagle/core/StaleResultCache.h"
+#include "eagle/core/PerformanceMonitor.h"
+#include "eagle/core/WorkStealingExecutor.h"
 #include "eagle/core/AsyncServiceCall.h"
 #include "eagle/core/Framework.h"
 #include "eagle/core/RBAC.h"
@@ -17,11 +24,157 @@
 #include <QtCore/QMutexLocker>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <cmath>
 
 namespace Eagle {
 namespace Core {
 
+namespace {
+
+/**
+ * @brief 通过元对象系统直接调用服务方法（最多3个参数）
+ */
+bool invokeMetaMethod(QObject* provider, const QMetaMethod& metaMethod,
+                      const QVariantList& args, QVariant& returnValue)
+{
+    bool success = false;
+    if (metaMethod.returnType() != QMetaType::Void) {
+        QGenericReturnArgument retArg = Q_RETURN_ARG(QVariant, returnValue);
+        if (args.isEmpty()) {
+            success = metaMethod.invoke(provider, Qt::DirectConnection, retArg);
+        } else {
+            QGenericArgument arg1 = args.size() > 0 ? Q_ARG(QVariant, args[0]) : QGenericArgument();
+            QGenericArgument arg2 = args.size() > 1 ? Q_ARG(QVariant, args[1]) : QGenericArgument();
+            QGenericArgument arg3 = args.size() > 2 ? Q_ARG(QVariant, args[2]) : QGenericArgument();
+            success = metaMethod.invoke(provider, Qt::DirectConnection, retArg, arg1, arg2, arg3);
+        }
+    } else {
+        if (args.isEmpty()) {
+            success = metaMethod.invoke(provider, Qt::DirectConnection);
+        } else {
+            QGenericArgument arg1 = args.size() > 0 ? Q_ARG(QVariant, args[0]) : QGenericArgument();
+            QGenericArgument arg2 = args.size() > 1 ? Q_ARG(QVariant, args[1]) : QGenericArgument();
+            QGenericArgument arg3 = args.size() > 2 ? Q_ARG(QVariant, args[2]) : QGenericArgument();
+            success = metaMethod.invoke(provider, Qt::DirectConnection, arg1, arg2, arg3);
+        }
+    }
+    return success;
+}
+
+/**
+ * @brief 按方法签名查找并调用服务方法
+ */
+bool invokeProviderMethod(QObject* provider, const QString& method,
+                          const QVariantList& args, QVariant& returnValue)
+{
+    const QMetaObject* metaObj = provider->metaObject();
+    int methodIndex = metaObj->indexOfMethod(method.toUtf8().constData());
+    if (methodIndex == -1) {
+        return false;
+    }
+    return invokeMetaMethod(provider, metaObj->method(methodIndex), args, returnValue);
+}
+
+/**
+ * @brief 舱壁名额守卫，离开作用域时归还名额
+ */
+class BulkheadPermit {
+public:
+    BulkheadPermit(BulkheadManager* manager, const QString& name)
+        : manager(manager), name(name) {}
+    ~BulkheadPermit() {
+        if (manager && !name.isEmpty()) {
+            manager->release(name);
+        }
+    }
+    
+private:
+    BulkheadManager* manager;
+    QString name;
+    
+    Q_DISABLE_COPY(BulkheadPermit)
+};
+
+/**
+ * @brief 熔断器探测名额守卫
+ *
+ * 半开状态下allowCall会占用探测名额；一次尝试没有记录成功或失败就结束时
+ * （重试、方法不存在、并发限制拒绝、异常等），下一次allow或离开作用域时归还名额。
+ */
+class CircuitProbe {
+public:
+    explicit CircuitProbe(CircuitBreaker* breaker)
+        : breaker(breaker), held(false) {}
+    ~CircuitProbe() {
+        release();
+    }
+    
+    bool allow() {
+        release();
+        return !breaker || breaker->allowCall(&held);
+    }
+    
+    void recordSuccess(qint64 durationMs) {
+        if (breaker) {
+            breaker->recordSuccess(durationMs);
+        }
+        held = false;
+    }
+    
+    void recordFailure(qint64 durationMs) {
+        if (breaker) {
+            breaker->recordFailure(durationMs);
+        }
+        held = false;
+    }
+    
+private:
+    void release() {
+        if (breaker && held) {
+            breaker->releaseProbe();
+        }
+        held = false;
+    }
+    
+    CircuitBreaker* breaker;
+    bool held;
+    
+    Q_DISABLE_COPY(CircuitProbe)
+};
+
+/**
+ * @brief 服务恢复后每批后台刷新的旧结果数，其余在后续成功调用时继续刷新
+ */
+const int kStaleRevalidationBatch = 16;
+
+/**
+ * @brief 舱壁指标的上报周期（毫秒）：队列深度随入队出队变化，不能只在拒绝时上报
+ */
+const int kBulkheadMetricsIntervalMs = 1000;
+
+/**
+ * @brief 上报舱壁的拒绝数和异步队列深度
+ */
+void reportBulkheadMetrics(const QString& bulkhead, const QVariantMap& stats)
+{
+    Framework* framework = Framework::instance();
+    if (!framework || !framework->performanceMonitor()) {
+        return;
+    }
+    framework->performanceMonitor()->updateMetric(QString("bulkhead.%1.rejected").arg(bulkhead),
+        stats.value("rejected").toDouble() + stats.value("queueRejected").toDouble());
+    framework->performanceMonitor()->updateMetric(QString("bulkhead.%1.queue_depth").arg(bulkhead),
+        stats.value("queueDepth").toDouble());
+}
+
+/**
+ * @brief 当前线程最近一次callService返回值的陈旧信息
+ */
+thread_local StaleResultInfo t_lastStaleness;
+
+} // namespace
+
 ServiceRegistry::ServiceRegistry(QObject* parent)
     : QObject(parent)
     , d_ptr(new ServiceRegistryPrivate)
@@ -30,19 +183,51 @@ ServiceRegistry::ServiceRegistry(QObject* parent)
     d->defaultTimeoutMs = 5000;
     d->enableCircuitBreaker = true;
     d->loadBalancer = new LoadBalancer(this);
+    d->concurrencyLimiter = new ConcurrencyLimiter(this);
+    d->hedgingPolicy = new HedgingPolicy(this);
+    d->hedgePool = new QThreadPool(this);
+    d->hedgePool->setMaxThreadCount(qMax(4, QThread::idealThreadCount() * 2));
+    d->bulkheadManager = new BulkheadManager(this);
+    d->staleResultCache = new StaleResultCache(this);
     d->asyncServiceCall = new AsyncServiceCall(this, this);
+    
+    // 舱壁拒绝计入性能指标（拒绝可能发生在任意线程，直接在拒绝线程上报）
+    connect(d->bulkheadManager, &BulkheadManager::callRejected, this,
+            [this](const QString& bulkhead, const QString& serviceName, const QString& reason) {
+        Q_UNUSED(serviceName);
+        Q_UNUSED(reason);
+        reportBulkheadMetrics(bulkhead, getBulkheadStatistics(bulkhead));
+    }, Qt::DirectConnection);
+    
+    // 队列深度在没有拒绝时也会变化，定期上报所有舱壁的当前值
+    d->bulkheadMetricsTimer = new QTimer(this);
+    d->bulkheadMetricsTimer->setInterval(kBulkheadMetricsIntervalMs);
+    connect(d->bulkheadMetricsTimer, &QTimer::timeout, this, [this]() {
+        auto* d = d_func();
+        for (const QString& bulkhead : d->bulkheadManager->bulkheads()) {
+            reportBulkheadMetrics(bulkhead, getBulkheadStatistics(bulkhead));
+        }
+    });
+    d->bulkheadMetricsTimer->start();
 }
 
 ServiceRegistry::~ServiceRegistry()
 {
     auto* d = d_func();
+    
+    // 先停止异步执行器，保证排队中的调用在注册中心析构前完成
+    if (d->asyncServiceCall) {
+        d->asyncServiceCall->executor()->shutdown();
+    }
+    d->hedgePool->waitForDone();
+    
     QMutexLocker locker(&d->mutex);
     
     // 清理熔断器
-    for (CircuitBreaker* breaker : d->circuitBreakers) {
+    for (CircuitBreaker* breaker : *d->circuitBreakers) {
         delete breaker;
     }
-    d->circuitBreakers.clear();
+    d->circuitBreakers = std::make_shared<const CircuitBreakerTable>();
     
     d->services.clear();
     d->providers.clear();
@@ -74,6 +259,11 @@ bool ServiceRegistry::registerService(const ServiceDescriptor& descriptor, QObje
     d->services[descriptor.serviceName].append(desc);
     d->providers[key] = provider;
     
+    // 插件提供的服务默认归入该插件的舱壁（舱壁配置后生效）
+    if (!descriptor.pluginId.isEmpty()) {
+        d->bulkheadManager->assignService(descriptor.serviceName, "plugin:" + descriptor.pluginId);
+    }
+    
     // 注册到负载均衡器
     if (d->loadBalancer && d->enableLoadBalance) {
         locker.unlock();  // 释放锁，避免死锁
@@ -156,7 +346,7 @@ QObject* ServiceRegistry::findService(const QString& serviceName, const QString&
     
     // 如果启用负载均衡且没有指定版本，使用负载均衡器选择实例
     if (d->enableLoadBalance && d->loadBalancer && version.isEmpty()) {
-        ServiceInstance* instance = d->loadBalancer->selectInstance(serviceName);
+        std::shared_ptr<const ServiceInstance> instance = d->loadBalancer->selectInstance(serviceName);
         if (instance && instance->provider) {
             return instance->provider;
         }
@@ -212,6 +402,8 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
                                      const QVariantList& args,
                                      int timeout)
 {
+    t_lastStaleness = StaleResultInfo();
+    
     // 获取重试策略
     RetryPolicyConfig retryConfig;
     bool retryEnabled = false;
@@ -239,9 +431,45 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
         timeout = d->defaultTimeoutMs;
     }
     
+    // 舱壁隔离：所属舱壁没有空闲名额时拒绝（最多等待maxWaitMs），不进入重试；
+    // 已在舱壁执行器通道中执行的异步调用由通道限制并发，只登记名额
+    QString bulkhead = d->bulkheadManager->bulkheadFor(serviceName);
+    if (!bulkhead.isEmpty() && BulkheadLaneScope::isCurrent(bulkhead)) {
+        d->bulkheadManager->acquireForLane(bulkhead);
+    } else if (!bulkhead.isEmpty() && !d->bulkheadManager->tryAcquire(bulkhead, serviceName)) {
+        QString error = QString("Service bulkhead full: %1 (bulkhead %2)").arg(serviceName, bulkhead);
+        
+        QVariant degradedResult = tryDegrade(serviceName, method, args, DegradationTrigger::BulkheadFull);
+        if (degradedResult.isValid()) {
+            Logger::info("ServiceRegistry", QString("服务降级成功（舱壁已满）: %1::%2").arg(serviceName, method));
+            return degradedResult;
+        }
+        
+        emit serviceCallFailed(serviceName, error);
+        return QVariant();
+    }
+    BulkheadPermit bulkheadPermit(d->bulkheadManager, bulkhead);
+    
+    // 熔断器在调用开始时取一次，重试和记录结果都使用同一个熔断器，不再访问注册表互斥锁
+    CircuitBreaker* breaker = nullptr;
+    if (d->enableCircuitBreaker) {
+        breaker = d->circuitBreaker(serviceName);
+        if (!breaker) {
+            QMutexLocker locker(&d->mutex);
+            breaker = d->circuitBreaker(serviceName);
+            if (!breaker) {
+                // 创建默认熔断器
+                breaker = new CircuitBreaker(serviceName, CircuitBreakerConfig(), this);
+                d->publishCircuitBreaker(serviceName, breaker);
+            }
+        }
+    }
+    CircuitProbe circuitProbe(breaker);
+    
     int attemptCount = 0;
     QString lastError;
     QVariant returnValue;  // 在循环外部定义，保存成功调用的返回值
+    qint64 lastCallMs = 0;  // 最后一次调用的耗时
     
     // 重试循环
     while (true) {
@@ -249,44 +477,31 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
         
         auto* d = d_func();
         
-        // 检查熔断器
-        if (d->enableCircuitBreaker) {
-            QMutexLocker locker(&d->mutex);
-            CircuitBreaker* breaker = d->circuitBreakers.value(serviceName);
-            if (!breaker) {
-                // 创建默认熔断器
-                CircuitBreakerConfig config;
-                breaker = new CircuitBreaker(serviceName, config, this);
-                d->circuitBreakers[serviceName] = breaker;
+        // 检查熔断器（重试时先归还上一次尝试未记录结果的探测名额）
+        if (!circuitProbe.allow()) {
+            QString error = QString("Service circuit breaker is open: %1").arg(serviceName);
+            Logger::warning("ServiceRegistry", error);
+            lastError = error;
+            
+            // 检查是否应该重试
+            if (retryEnabled && attemptCount <= retryConfig.maxRetries && 
+                isRetryableError(serviceName, error, retryConfig)) {
+                int delay = calculateRetryDelay(retryConfig, attemptCount - 1);
+                Logger::info("ServiceRegistry", QString("重试服务调用: %1::%2 (第%3次, 延迟%4ms)")
+                    .arg(serviceName, method).arg(attemptCount).arg(delay));
+                QThread::msleep(delay);
+                continue;
             }
-            locker.unlock();
             
-            if (!breaker->allowCall()) {
-                QString error = QString("Service circuit breaker is open: %1").arg(serviceName);
-                Logger::warning("ServiceRegistry", error);
-                breaker->recordFailure();  // 记录失败
-                lastError = error;
-                
-                // 检查是否应该重试
-                if (retryEnabled && attemptCount <= retryConfig.maxRetries && 
-                    isRetryableError(serviceName, error, retryConfig)) {
-                    int delay = calculateRetryDelay(retryConfig, attemptCount - 1);
-                    Logger::info("ServiceRegistry", QString("重试服务调用: %1::%2 (第%3次, 延迟%4ms)")
-                        .arg(serviceName, method).arg(attemptCount).arg(delay));
-                    QThread::msleep(delay);
-                    continue;
-                }
-                
-                // 检查是否需要降级
-                QVariant degradedResult = tryDegrade(serviceName, method, args, DegradationTrigger::CircuitBreakerOpen);
-                if (degradedResult.isValid()) {
-                    Logger::info("ServiceRegistry", QString("服务降级成功: %1::%2").arg(serviceName, method));
-                    return degradedResult;
-                }
-                
-                emit serviceCallFailed(serviceName, error);
-                return QVariant();
+            // 检查是否需要降级
+            QVariant degradedResult = tryDegrade(serviceName, method, args, DegradationTrigger::CircuitBreakerOpen);
+            if (degradedResult.isValid()) {
+                Logger::info("ServiceRegistry", QString("服务降级成功: %1::%2").arg(serviceName, method));
+                return degradedResult;
             }
+            
+            emit serviceCallFailed(serviceName, error);
+            return QVariant();
         }
         
         // 使用负载均衡器选择服务实例
@@ -296,10 +511,10 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
         {
             auto* d = d_func();
             if (d->enableLoadBalance && d->loadBalancer) {
-                ServiceInstance* instance = d->loadBalancer->selectInstance(serviceName);
+                std::shared_ptr<const ServiceInstance> instance = d->loadBalancer->selectInstance(serviceName);
                 if (instance && instance->provider) {
                     provider = instance->provider;
-                    instanceId = d->loadBalancer->getInstanceIdByProvider(serviceName, provider);
+                    instanceId = instance->instanceId;
                     // 记录服务调用开始
                     if (!instanceId.isEmpty()) {
                         d->loadBalancer->onServiceCallStart(serviceName, instanceId);
@@ -336,13 +551,7 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
             }
             
             // 记录失败
-            if (d->enableCircuitBreaker) {
-                QMutexLocker locker(&d->mutex);
-                CircuitBreaker* breaker = d->circuitBreakers.value(serviceName);
-                if (breaker) {
-                    breaker->recordFailure();
-                }
-            }
+            circuitProbe.recordFailure(0);
             
             emit serviceCallFailed(serviceName, error);
             return QVariant();
@@ -387,36 +596,71 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
             return QVariant();
         }
         
+        // 自适应并发限制：在途调用数达到上限时快速拒绝，不进入重试
+        ConcurrencyLimiter* limiter = d->concurrencyLimiter;
+        if (limiter && !limiter->tryAcquire(serviceName)) {
+            QString error = QString("Service overloaded: %1 (concurrency limit %2 reached)")
+                .arg(serviceName).arg(limiter->limit(serviceName));
+            Logger::warning("ServiceRegistry", error);
+            lastError = error;
+            
+            if (!instanceId.isEmpty() && d->loadBalancer) {
+                d->loadBalancer->onServiceCallEnd(serviceName, instanceId);
+            }
+            
+            QVariant degradedResult = tryDegrade(serviceName, method, args, DegradationTrigger::Overload);
+            if (degradedResult.isValid()) {
+                Logger::info("ServiceRegistry", QString("服务降级成功（过载）: %1::%2").arg(serviceName, method));
+                return degradedResult;
+            }
+            
+            emit serviceCallFailed(serviceName, error);
+            return QVariant();
+        }
+        
         // 使用超时机制调用方法
         bool success = false;
         QElapsedTimer timer;
         timer.start();
         QVariant currentReturnValue;  // 当前尝试的返回值
         
-        // 尝试调用方法（带超时检查）
-        if (metaMethod.returnType() != QMetaType::Void) {
-            QGenericReturnArgument retArg = Q_RETURN_ARG(QVariant, currentReturnValue);
-            if (args.isEmpty()) {
-                success = metaMethod.invoke(provider, Qt::DirectConnection, retArg);
+        // 尝试调用方法（带超时检查）；启用对冲的服务由对冲路径自行管理实例调用计数
+        bool hedged = !instanceId.isEmpty() && d->hedgingPolicy && d->hedgingPolicy->isEnabled(serviceName)
+                      && d->loadBalancer->availableInstanceCount(serviceName) > 1;
+        try {
+            if (hedged) {
+                success = invokeHedged(serviceName, method, args, provider, instanceId, timeout, currentReturnValue);
             } else {
-                QGenericArgument arg1 = args.size() > 0 ? Q_ARG(QVariant, args[0]) : QGenericArgument();
-                QGenericArgument arg2 = args.size() > 1 ? Q_ARG(QVariant, args[1]) : QGenericArgument();
-                QGenericArgument arg3 = args.size() > 2 ? Q_ARG(QVariant, args[2]) : QGenericArgument();
-                success = metaMethod.invoke(provider, Qt::DirectConnection, retArg, arg1, arg2, arg3);
+                success = invokeMetaMethod(provider, metaMethod, args, currentReturnValue);
             }
-        } else {
-            if (args.isEmpty()) {
-                success = metaMethod.invoke(provider, Qt::DirectConnection);
-            } else {
-                QGenericArgument arg1 = args.size() > 0 ? Q_ARG(QVariant, args[0]) : QGenericArgument();
-                QGenericArgument arg2 = args.size() > 1 ? Q_ARG(QVariant, args[1]) : QGenericArgument();
-                QGenericArgument arg3 = args.size() > 2 ? Q_ARG(QVariant, args[2]) : QGenericArgument();
-                success = metaMethod.invoke(provider, Qt::DirectConnection, arg1, arg2, arg3);
+        } catch (...) {
+            // 服务提供者抛出异常：归还并发名额并作为过载信号，归还实例在途计数并计为实例失败，
+            // 异常继续向上传递
+            if (limiter) {
+                limiter->release(serviceName, timer.nsecsElapsed() / 1000, true);
             }
+            if (!instanceId.isEmpty() && d->loadBalancer && !hedged) {
+                d->loadBalancer->onServiceCallEnd(serviceName, instanceId, timer.nsecsElapsed() / 1000, false);
+            }
+            throw;
+        }
+        
+        // 提交延迟样本并释放并发名额；只有超时才是过载信号，
+        // invoke返回false表示参数或类型不匹配等调用方错误，不应收缩上限
+        bool timedOut = timer.elapsed() > timeout;
+        if (limiter) {
+            limiter->release(serviceName, timer.nsecsElapsed() / 1000, timedOut);
+        }
+        
+        // 记录服务调用结束，重试前即归还实例的在途计数，并提交实例延迟样本；
+        // 异常检测只统计超时，invoke返回false（参数或类型不匹配）不是实例的问题
+        if (!instanceId.isEmpty() && d->loadBalancer && !hedged) {
+            d->loadBalancer->onServiceCallEnd(serviceName, instanceId, timer.nsecsElapsed() / 1000,
+                                              !timedOut);
         }
         
         // 检查超时（注意：Qt的invoke是同步的，这里只是检查执行时间）
-        if (timer.elapsed() > timeout) {
+        if (timedOut) {
             QString error = QString("Service call timeout: %1::%2 (耗时: %3ms)").arg(serviceName, method).arg(timer.elapsed());
             Logger::error("ServiceRegistry", error);
             lastError = error;
@@ -432,13 +676,7 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
             }
             
             // 记录失败
-            if (d->enableCircuitBreaker) {
-                QMutexLocker locker(&d->mutex);
-                CircuitBreaker* breaker = d->circuitBreakers.value(serviceName);
-                if (breaker) {
-                    breaker->recordFailure();
-                }
-            }
+            circuitProbe.recordFailure(timer.elapsed());
             
             // 检查是否需要降级
             QVariant degradedResult = tryDegrade(serviceName, method, args, DegradationTrigger::Timeout);
@@ -447,14 +685,6 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
                 return degradedResult;
             }
             
-            // 记录服务调用结束（超时失败）
-            if (!instanceId.isEmpty()) {
-                auto* d = d_func();
-                if (d->loadBalancer) {
-                    d->loadBalancer->onServiceCallEnd(serviceName, instanceId);
-                }
-            }
-            
             emit serviceCallFailed(serviceName, error);
             return QVariant();
         }
@@ -475,13 +705,7 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
             }
             
             // 记录失败
-            if (d->enableCircuitBreaker) {
-                QMutexLocker locker(&d->mutex);
-                CircuitBreaker* breaker = d->circuitBreakers.value(serviceName);
-                if (breaker) {
-                    breaker->recordFailure();
-                }
-            }
+            circuitProbe.recordFailure(timer.elapsed());
             
             // 检查是否需要降级（重试失败后）
             if (attemptCount > retryConfig.maxRetries) {
@@ -492,37 +716,32 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
                 }
             }
             
-            // 记录服务调用结束（调用失败）
-            if (!instanceId.isEmpty()) {
-                auto* d = d_func();
-                if (d->loadBalancer) {
-                    d->loadBalancer->onServiceCallEnd(serviceName, instanceId);
-                }
-            }
-            
             emit serviceCallFailed(serviceName, error);
             return QVariant();
         }
         
         // 调用成功，保存返回值并退出重试循环
         returnValue = currentReturnValue;
-        
-        // 记录服务调用结束（成功）
-        if (!instanceId.isEmpty()) {
-            auto* d = d_func();
-            if (d->loadBalancer) {
-                d->loadBalancer->onServiceCallEnd(serviceName, instanceId);
-            }
-        }
+        lastCallMs = timer.elapsed();
         break;
     }
     
     // 调用成功，记录结果
-    if (d->enableCircuitBreaker) {
+    circuitProbe.recordSuccess(lastCallMs);
+    
+    // 保存成功结果供降级时返回；服务恢复后在后台刷新降级期间返回过旧值的调用
+    int staleCapacity = 0;
+    {
         QMutexLocker locker(&d->mutex);
-        CircuitBreaker* breaker = d->circuitBreakers.value(serviceName);
-        if (breaker) {
-            breaker->recordSuccess();
+        auto it = d->degradationPolicies.constFind(serviceName);
+        if (d->enableDegradation && it != d->degradationPolicies.constEnd() && it->enabled && it->serveStale) {
+            staleCapacity = it->staleCacheCapacity;
+        }
+    }
+    if (staleCapacity > 0) {
+        d->staleResultCache->store(serviceName, method, args, returnValue, staleCapacity);
+        if (d->staleResultCache->hasPendingRevalidation(serviceName)) {
+            revalidateStaleResults(serviceName);
         }
     }
     
@@ -534,6 +753,8 @@ QVariant ServiceRegistry::callService(const QString& serviceName,
         framework->performanceMonitor()->recordServiceCallTime(serviceName, method, 0);
     }
     
+    emit serviceCallSucceeded(serviceName, lastCallMs);
+    
     if (attemptCount > 1) {
         Logger::info("ServiceRegistry", QString("服务调用成功（重试%1次）: %2::%3")
             .arg(attemptCount - 1).arg(serviceName, method));
@@ -577,6 +798,8 @@ void ServiceRegistry::setLoadBalanceAlgorithm(const QString& serviceName, const
         algo = LoadBalanceAlgorithm::Random;
     } else if (algorithm == "ip_hash" || algorithm == "hash") {
         algo = LoadBalanceAlgorithm::IPHash;
+    } else if (algorithm == "p2c_ewma" || algorithm == "latency") {
+        algo = LoadBalanceAlgorithm::P2CEwma;
     }
     
     d->loadBalancer->setAlgorithm(serviceName, algo);
@@ -599,6 +822,8 @@ QString ServiceRegistry::getLoadBalanceAlgorithm(const QString& serviceName) con
         return "random";
     case LoadBalanceAlgorithm::IPHash:
         return "ip_hash";
+    case LoadBalanceAlgorithm::P2CEwma:
+        return "p2c_ewma";
     default:
         return "round_robin";
     }
@@ -611,6 +836,217 @@ LoadBalancer* ServiceRegistry::loadBalancer() const
     return d->loadBalancer;
 }
 
+bool ServiceRegistry::invokeHedged(const QString& serviceName, const QString& method,
+                                   const QVariantList& args, QObject* primary,
+                                   const QString& primaryInstanceId, int timeout, QVariant& returnValue)
+{
+    auto* d = d_func();
+    HedgingPolicy* policy = d->hedgingPolicy;
+    LoadBalancer* loadBalancer = d->loadBalancer;
+    QThreadPool* hedgePool = d->hedgePool;
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    // 调用指定实例，完成时归还实例调用计数并记录延迟样本
+    auto attempt = [=](QObject* provider, const QString& instanceId, const ServicePromise& promise) {
+        QElapsedTimer callTimer;
+        callTimer.start();
+        QVariant value;
+        bool ok = false;
+        bool threw = false;
+        try {
+            ok = invokeProviderMethod(provider, method, args, value);
+        } catch (...) {
+            threw = true;  // 在线程池中运行，异常不能逃出任务
+        }
+        qint64 latencyUs = callTimer.nsecsElapsed() / 1000;
+        
+        // 只有超时和服务提供者异常才算实例失败，方法不存在、参数不匹配是调用方错误
+        bool instanceFailed = threw || latencyUs / 1000 > timeout;
+        loadBalancer->onServiceCallEnd(serviceName, instanceId, latencyUs, !instanceFailed);
+        if (ok) {
+            policy->recordLatency(serviceName, latencyUs);
+        }
+        
+        ServiceCallResult result = ok ? ServiceCallResult(value)
+            : ServiceCallResult(threw ? QString("Service provider threw an exception: %1::%2").arg(serviceName, method)
+                                      : QString("Service call failed: %1::%2").arg(serviceName, method));
+        result.elapsedMs = static_cast<int>(latencyUs / 1000);
+        promise.setResult(result);
+    };
+    
+    // 两路调用都在专用线程池上执行：调用方本身可能运行在异步执行器上，
+    // 在同一个池里嵌套阻塞等待会在高负载时耗尽工作线程。
+    // tryStart不排队，线程池已满时直接返回false
+    auto launch = [=](QObject* provider, const QString& instanceId, const ServicePromise& promise) {
+        return hedgePool->tryStart([=]() {
+            attempt(provider, instanceId, promise);
+        });
+    };
+    
+    policy->recordCall(serviceName);
+    ServicePromise primaryPromise;
+    ServiceCallFuture primaryFuture = primaryPromise.future();
+    if (!launch(primary, primaryInstanceId, primaryPromise)) {
+        // 对冲线程池已满：在调用线程上直接调用，不发起对冲
+        attempt(primary, primaryInstanceId, primaryPromise);
+        ServiceCallResult result = primaryFuture.result();
+        returnValue = result.result;
+        return result.success;
+    }
+    
+    ServiceCallResult result = primaryFuture.wait(qMin(policy->hedgeDelay(serviceName), timeout));
+    if (primaryFuture.isFinished()) {
+        returnValue = result.result;
+        return result.success;
+    }
+    
+    // 原请求超过对冲延迟仍未返回：选择另一个实例发起对冲请求
+    QObject* hedgeProvider = nullptr;
+    QString hedgeInstanceId;
+    for (int attempt = 0; attempt < 3 && !hedgeProvider; ++attempt) {
+        std::shared_ptr<const ServiceInstance> instance = loadBalancer->selectInstance(serviceName);
+        if (instance && instance->provider && instance->provider != primary) {
+            hedgeProvider = instance->provider;
+            hedgeInstanceId = instance->instanceId;
+        }
+    }
+    
+    if (!hedgeProvider || hedgeInstanceId.isEmpty() || !policy->tryAcquireHedge(serviceName)) {
+        result = primaryFuture.wait(qMax(0, timeout - static_cast<int>(timer.elapsed())));
+        returnValue = result.result;
+        return result.success;
+    }
+    
+    Logger::debug("ServiceRegistry", QString("发起对冲请求: %1::%2 -> %3")
+        .arg(serviceName, method, hedgeInstanceId));
+    loadBalancer->onServiceCallStart(serviceName, hedgeInstanceId);
+    ServicePromise hedgePromise;
+    ServiceCallFuture hedgeFuture = hedgePromise.future();
+    if (!launch(hedgeProvider, hedgeInstanceId, hedgePromise)) {
+        // 没有空闲线程发起对冲，只等待原请求
+        loadBalancer->onServiceCallEnd(serviceName, hedgeInstanceId);
+        result = primaryFuture.wait(qMax(0, timeout - static_cast<int>(timer.elapsed())));
+        returnValue = result.result;
+        return result.success;
+    }
+    
+    // 取最先成功的结果，另一路的结果直接忽略
+    QList<ServiceCallFuture> pending;
+    QList<bool> pendingIsHedge;
+    pending << primaryFuture << hedgeFuture;
+    pendingIsHedge << false << true;
+    while (!pending.isEmpty()) {
+        int remaining = timeout - static_cast<int>(timer.elapsed());
+        if (remaining <= 0) {
+            break;
+        }
+        
+        ServiceCallResult any = whenAny(pending).wait(remaining);
+        if (!any.success) {
+            break;  // 等待超时
+        }
+        
+        QVariantMap first = any.result.toMap();
+        int index = first.value("index").toInt();
+        bool isHedge = pendingIsHedge.takeAt(index);
+        pending.removeAt(index);
+        
+        if (first.value("success").toBool()) {
+            if (isHedge) {
+                policy->recordHedgeWon(serviceName);
+            }
+            returnValue = first.value("result");
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+ConcurrencyLimiter* ServiceRegistry::concurrencyLimiter() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->concurrencyLimiter;
+}
+
+void ServiceRegistry::setHedgingPolicy(const QString& serviceName, const HedgingPolicyConfig& config)
+{
+    hedgingPolicy()->setPolicy(serviceName, config);
+}
+
+HedgingPolicyConfig ServiceRegistry::getHedgingPolicy(const QString& serviceName) const
+{
+    return hedgingPolicy()->getPolicy(serviceName);
+}
+
+HedgingPolicy* ServiceRegistry::hedgingPolicy() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->hedgingPolicy;
+}
+
+void ServiceRegistry::setBulkhead(const QString& name, const BulkheadConfig& config)
+{
+    auto* d = d_func();
+    d->bulkheadManager->setBulkhead(name, config);
+    
+    // 异步调用使用同名执行器通道：并发上限限制占用的工作线程，队列容量限制排队任务
+    WorkStealingExecutor* executor = d->asyncServiceCall->executor();
+    executor->setServiceConcurrencyLimit(name, config.maxConcurrentCalls);
+    executor->setServiceQueueCapacity(name, config.maxQueueDepth);
+}
+
+void ServiceRegistry::removeBulkhead(const QString& name)
+{
+    auto* d = d_func();
+    d->bulkheadManager->removeBulkhead(name);
+    
+    WorkStealingExecutor* executor = d->asyncServiceCall->executor();
+    executor->setServiceConcurrencyLimit(name, 0);
+    executor->setServiceQueueCapacity(name, 0);
+}
+
+void ServiceRegistry::assignServiceBulkhead(const QString& serviceName, const QString& bulkheadName)
+{
+    auto* d = d_func();
+    if (bulkheadName.isEmpty()) {
+        d->bulkheadManager->unassignService(serviceName);
+    } else {
+        d->bulkheadManager->assignService(serviceName, bulkheadName);
+    }
+}
+
+QVariantMap ServiceRegistry::getBulkheadStatistics(const QString& name) const
+{
+    const auto* d = d_func();
+    QVariantMap stats = d->bulkheadManager->getStatistics(name);
+    
+    WorkStealingExecutor* executor = d->asyncServiceCall->executor();
+    stats["asyncRunning"] = executor->serviceRunningCount(name);
+    stats["queueDepth"] = executor->serviceQueuedCount(name);
+    return stats;
+}
+
+BulkheadManager* ServiceRegistry::bulkheadManager() const
+{
+    const auto* d = d_func();
+    return d->bulkheadManager;
+}
+
+void ServiceRegistry::setConcurrencyLimitEnabled(bool enabled)
+{
+    concurrencyLimiter()->setEnabled(enabled);
+}
+
+bool ServiceRegistry::isConcurrencyLimitEnabled() const
+{
+    return concurrencyLimiter()->isEnabled();
+}
+
 AsyncServiceCall* ServiceRegistry::asyncServiceCall() const
 {
     const auto* d = d_func();
@@ -618,6 +1054,18 @@ AsyncServiceCall* ServiceRegistry::asyncServiceCall() const
     return d->asyncServiceCall;
 }
 
+ServiceCallFuture ServiceRegistry::callAsync(const QString& serviceName,
+                                             const QString& method,
+                                             const QVariantList& args,
+                                             int timeout)
+{
+    AsyncServiceCall* asyncCall = asyncServiceCall();
+    if (!asyncCall) {
+        return ServiceCallFuture::makeReady(ServiceCallResult(QString("AsyncServiceCall not available")));
+    }
+    return asyncCall->call(serviceName, method, args, timeout);
+}
+
 
 void ServiceRegistry::setDefaultTimeout(int timeoutMs)
 {
@@ -640,14 +1088,14 @@ void ServiceRegistry::setCircuitBreakerConfig(const QString& serviceName, const
     auto* d = d_func();
     QMutexLocker locker(&d->mutex);
     
-    CircuitBreaker* breaker = d->circuitBreakers.value(serviceName);
+    CircuitBreaker* breaker = d->circuitBreaker(serviceName);
     if (breaker) {
         breaker->reset();
         // 注意：CircuitBreakerConfig 在构造时设置，这里简化处理
         Logger::info("ServiceRegistry", QString("设置服务熔断器配置: %1").arg(serviceName));
     } else {
         breaker = new CircuitBreaker(serviceName, config, this);
-        d->circuitBreakers[serviceName] = breaker;
+        d->publishCircuitBreaker(serviceName, breaker);
         Logger::info("ServiceRegistry", QString("创建服务熔断器: %1").arg(serviceName));
     }
 }
@@ -800,6 +1248,22 @@ QVariant ServiceRegistry::tryDegrade(const QString& serviceName, const QString&
         return QVariant();
     }
     
+    // 熔断开启或超时时优先返回最近一次成功结果（stale-while-revalidate）
+    if (policy.serveStale && (trigger == DegradationTrigger::CircuitBreakerOpen || trigger == DegradationTrigger::Timeout)) {
+        StaleResultInfo info;
+        // 只有声明为幂等的方法才在服务恢复后自动重新调用
+        QVariant staleValue = d->staleResultCache->lookup(serviceName, method, args, policy.maxStaleMs,
+                                                          policy.isIdempotent(method), &info);
+        if (staleValue.isValid()) {
+            locker.unlock();
+            t_lastStaleness = info;
+            Logger::info("ServiceRegistry", QString("返回缓存的旧结果: %1::%2 (已缓存%3ms)")
+                .arg(serviceName, method).arg(info.ageMs));
+            emit staleResultServed(serviceName, method, info.ageMs);
+            return staleValue;
+        }
+    }
+    
     // 检查触发条件
     if (policy.trigger != trigger && policy.trigger != DegradationTrigger::Always) {
         return QVariant();
@@ -881,6 +1345,9 @@ void ServiceRegistry::setDegradationPolicy(const QString& serviceName, const Deg
     auto* d = d_func();
     QMutexLocker locker(&d->mutex);
     d->degradationPolicies[serviceName] = config;
+    if (!config.serveStale) {
+        d->staleResultCache->clear(serviceName);
+    }
     Logger::info("ServiceRegistry", QString("设置服务降级策略: %1 - 触发条件: %2, 策略: %3")
         .arg(serviceName)
         .arg(static_cast<int>(config.trigger))
@@ -894,6 +1361,43 @@ DegradationPolicyConfig ServiceRegistry::getDegradationPolicy(const QString& ser
     return d->degradationPolicies.value(serviceName);
 }
 
+StaleResultCache* ServiceRegistry::staleResultCache() const
+{
+    const auto* d = d_func();
+    return d->staleResultCache;
+}
+
+StaleResultInfo ServiceRegistry::lastResultStaleness() const
+{
+    return t_lastStaleness;
+}
+
+void ServiceRegistry::revalidateStaleResults(const QString& serviceName)
+{
+    auto* d = d_func();
+    const QList<QPair<QString, QVariantList>> calls =
+        d->staleResultCache->takePendingRevalidation(serviceName, kStaleRevalidationBatch);
+    if (calls.isEmpty()) {
+        return;
+    }
+    
+    // 标记后策略可能已修改，重新调用前再按当前的幂等方法列表过滤
+    DegradationPolicyConfig policy = getDegradationPolicy(serviceName);
+    int refreshed = 0;
+    
+    // 异步重新调用，成功结果经callService写回缓存；失败时条目保持原样
+    for (const auto& call : calls) {
+        if (policy.isIdempotent(call.first)) {
+            callAsync(serviceName, call.first, call.second, 0);
+            refreshed++;
+        }
+    }
+    
+    if (refreshed > 0) {
+        Logger::info("ServiceRegistry", QString("服务已恢复，后台刷新%1个旧结果: %2").arg(refreshed).arg(serviceName));
+    }
+}
+
 bool ServiceRegistry::checkServiceHealth(const QString& serviceName) const
 {
     auto* d = d_func();
@@ -912,7 +1416,7 @@ bool ServiceRegistry::checkServiceHealth(const QString& serviceName) const
     
     // 检查熔断器状态（如果启用）
     if (d->enableCircuitBreaker) {
-        CircuitBreaker* breaker = d->circuitBreakers.value(serviceName);
+        CircuitBreaker* breaker = d->circuitBreaker(serviceName);
         if (breaker && breaker->state() == CircuitState::Open) {
             return false;  // 熔断器打开，服务不健康
         }
@@ -5,23 +5,39 @@
 #include <QtCore/QStringList>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
 #include "eagle/core/ServiceDescriptor.h"
 #include "eagle/core/RetryPolicy.h"
 #include "eagle/core/DegradationPolicy.h"
 #include "eagle/core/AsyncServiceCall.h"
+#include "eagle/core/ConcurrencyLimiter.h"
+#include "eagle/core/HedgingPolicy.h"
+#include "eagle/core/Bulkhead.h"
+#include "eagle/core/StaleResultCache.h"
+#include <memory>
 
 namespace Eagle {
 namespace Core {
 
+using CircuitBreakerTable = QHash<QString, CircuitBreaker*>;
+
 class ServiceRegistryPrivate {
 public:
     QMap<QString, QList<ServiceDescriptor>> services; // serviceName -> versions
     QMap<QString, QObject*> providers; // serviceName+version -> provider
-    QMap<QString, CircuitBreaker*> circuitBreakers; // serviceName -> circuitBreaker
+    // serviceName -> circuitBreaker，写时复制：调用路径原子读取快照，新建熔断器时在mutex下复制并重新发布
+    std::shared_ptr<const CircuitBreakerTable> circuitBreakers = std::make_shared<const CircuitBreakerTable>();
     QMap<QString, QPair<int, int>> serviceRateLimits; // serviceName -> (maxRequests, windowMs)
     QMap<QString, RetryPolicyConfig> retryPolicies;    // serviceName -> retryPolicy
     QMap<QString, DegradationPolicyConfig> degradationPolicies;  // serviceName -> degradationPolicy
     LoadBalancer* loadBalancer = nullptr;  // 负载均衡器
+    ConcurrencyLimiter* concurrencyLimiter = nullptr;  // 自适应并发限制器
+    HedgingPolicy* hedgingPolicy = nullptr;  // 对冲请求策略
+    QThreadPool* hedgePool = nullptr;  // 对冲调用专用线程池（不占用异步执行器的工作线程）
+    BulkheadManager* bulkheadManager = nullptr;  // 舱壁隔离
+    QTimer* bulkheadMetricsTimer = nullptr;  // 舱壁指标定期上报
+    StaleResultCache* staleResultCache = nullptr;  // 最近一次成功结果缓存
     AsyncServiceCall* asyncServiceCall = nullptr;  // 异步服务调用器
     int defaultTimeoutMs = 5000;  // 默认超时时间
     bool enableCircuitBreaker = true;  // 是否启用熔断器
@@ -31,6 +47,21 @@ public:
     bool enableDegradation = true;  // 是否启用降级
     bool enableLoadBalance = true;  // 是否启用负载均衡
     mutable QMutex mutex;  // mutable 允许在 const 函数中锁定
+
+    CircuitBreaker* circuitBreaker(const QString& serviceName) const
+    {
+        return std::atomic_load(&circuitBreakers)->value(serviceName);
+    }
+
+    /**
+     * @brief 发布新的熔断器，调用方需持有mutex
+     */
+    void publishCircuitBreaker(const QString& serviceName, CircuitBreaker* breaker)
+    {
+        auto table = std::make_shared<CircuitBreakerTable>(*std::atomic_load(&circuitBreakers));
+        table->insert(serviceName, breaker);
+        std::atomic_store(&circuitBreakers, std::shared_ptr<const CircuitBreakerTable>(table));
+    }
 };
 
 } // namespace Core
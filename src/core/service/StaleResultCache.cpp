@@ -0,0 +1,173 @@
+#include "eagle/core/StaleResultCache.h"
+#include "StaleResultCache_p.h"
+#include <QtCore/QMutexLocker>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+
+namespace Eagle {
+namespace Core {
+
+std::shared_ptr<ServiceStaleCache> StaleResultCachePrivate::cache(const QString& serviceName) const
+{
+    QMutexLocker locker(&mutex);
+    return services.value(serviceName);
+}
+
+std::shared_ptr<ServiceStaleCache> StaleResultCachePrivate::ensureCache(const QString& serviceName)
+{
+    QMutexLocker locker(&mutex);
+    std::shared_ptr<ServiceStaleCache>& cache = services[serviceName];
+    if (!cache) {
+        cache = std::make_shared<ServiceStaleCache>();
+    }
+    return cache;
+}
+
+QByteArray StaleResultCachePrivate::cacheKey(const QString& method, const QVariantList& args)
+{
+    // 键为方法名和序列化后的完整参数，不同调用不会因哈希冲突互相覆盖或返回对方的结果
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << method << args;
+    return key;
+}
+
+StaleResultCache::StaleResultCache(QObject* parent)
+    : QObject(parent)
+    , d_ptr(new StaleResultCachePrivate)
+{
+}
+
+StaleResultCache::~StaleResultCache()
+{
+    delete d_ptr;
+}
+
+void StaleResultCache::store(const QString& serviceName, const QString& method, const QVariantList& args,
+                             const QVariant& value, int capacity)
+{
+    if (!value.isValid() || capacity <= 0) {
+        return;
+    }
+
+    auto* d = d_func();
+    std::shared_ptr<ServiceStaleCache> cache = d->ensureCache(serviceName);
+    QByteArray key = StaleResultCachePrivate::cacheKey(method, args);
+
+    StaleCacheEntry* entry = new StaleCacheEntry;
+    entry->method = method;
+    entry->args = args;
+    entry->value = value;
+    entry->storedAtMs = QDateTime::currentMSecsSinceEpoch();
+
+    QMutexLocker locker(&cache->mutex);
+    if (cache->entries.maxCost() != capacity) {
+        cache->entries.setMaxCost(capacity);
+    }
+    cache->entries.insert(key, entry);   // QCache接管entry的所有权
+    cache->pendingRevalidation.remove(key);
+}
+
+QVariant StaleResultCache::lookup(const QString& serviceName, const QString& method, const QVariantList& args,
+                                  int maxStaleMs, bool revalidate, StaleResultInfo* info)
+{
+    auto* d = d_func();
+    std::shared_ptr<ServiceStaleCache> cache = d->cache(serviceName);
+    if (!cache) {
+        return QVariant();
+    }
+
+    QByteArray key = StaleResultCachePrivate::cacheKey(method, args);
+    QMutexLocker locker(&cache->mutex);
+    StaleCacheEntry* entry = cache->entries.object(key);
+    if (!entry) {
+        cache->misses++;
+        return QVariant();
+    }
+
+    qint64 ageMs = QDateTime::currentMSecsSinceEpoch() - entry->storedAtMs;
+    if (maxStaleMs > 0 && ageMs > maxStaleMs) {
+        // 过旧的值不再返回，但保留到被新结果覆盖或淘汰，服务恢复后照常刷新
+        cache->expired++;
+        if (revalidate) {
+            cache->pendingRevalidation.insert(key);
+        }
+        return QVariant();
+    }
+
+    cache->hits++;
+    if (revalidate) {
+        cache->pendingRevalidation.insert(key);
+    }
+    if (info) {
+        info->stale = true;
+        info->ageMs = qMax<qint64>(0, ageMs);
+        info->storedAtMs = entry->storedAtMs;
+    }
+    return entry->value;
+}
+
+QList<QPair<QString, QVariantList>> StaleResultCache::takePendingRevalidation(const QString& serviceName, int maxCount)
+{
+    QList<QPair<QString, QVariantList>> calls;
+    auto* d = d_func();
+    std::shared_ptr<ServiceStaleCache> cache = d->cache(serviceName);
+    if (!cache) {
+        return calls;
+    }
+
+    QMutexLocker locker(&cache->mutex);
+    auto it = cache->pendingRevalidation.begin();
+    while (it != cache->pendingRevalidation.end() && calls.size() < maxCount) {
+        // 已被淘汰的条目无需刷新
+        StaleCacheEntry* entry = cache->entries.object(*it);
+        if (entry) {
+            calls.append(qMakePair(entry->method, entry->args));
+        }
+        it = cache->pendingRevalidation.erase(it);
+    }
+    return calls;
+}
+
+bool StaleResultCache::hasPendingRevalidation(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    std::shared_ptr<ServiceStaleCache> cache = d->cache(serviceName);
+    if (!cache) {
+        return false;
+    }
+    QMutexLocker locker(&cache->mutex);
+    return !cache->pendingRevalidation.isEmpty();
+}
+
+void StaleResultCache::clear(const QString& serviceName)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    d->services.remove(serviceName);
+}
+
+QVariantMap StaleResultCache::getStatistics(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QVariantMap stats;
+    stats["serviceName"] = serviceName;
+
+    std::shared_ptr<ServiceStaleCache> cache = d->cache(serviceName);
+    if (!cache) {
+        stats["size"] = 0;
+        return stats;
+    }
+
+    QMutexLocker locker(&cache->mutex);
+    stats["size"] = cache->entries.size();
+    stats["capacity"] = cache->entries.maxCost();
+    stats["hits"] = cache->hits;
+    stats["misses"] = cache->misses;
+    stats["expired"] = cache->expired;
+    stats["pendingRevalidation"] = cache->pendingRevalidation.size();
+    return stats;
+}
+
+} // namespace Core
+} // namespace Eagle
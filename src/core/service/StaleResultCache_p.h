@@ -0,0 +1,53 @@
+#ifndef STALERESULTCACHE_P_H
+#define STALERESULTCACHE_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QVariant>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include "eagle/core/StaleResultCache.h"
+#include <memory>
+
+namespace Eagle {
+namespace Core {
+
+/**
+ * @brief 缓存条目，保存方法名和参数用于后台重新验证
+ */
+struct StaleCacheEntry {
+    QString method;
+    QVariantList args;
+    QVariant value;
+    qint64 storedAtMs = 0;
+};
+
+/**
+ * @brief 单个服务的缓存，使用独立的锁，不同服务之间互不阻塞
+ */
+struct ServiceStaleCache {
+    QMutex mutex;
+    QCache<QByteArray, StaleCacheEntry> entries;   // key -> entry（LRU，每条代价为1）
+    QSet<QByteArray> pendingRevalidation;          // 返回过旧值、等待服务恢复后刷新的键
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 expired = 0;
+};
+
+class StaleResultCachePrivate {
+public:
+    QHash<QString, std::shared_ptr<ServiceStaleCache>> services;   // serviceName -> cache
+    mutable QMutex mutex;                                         // 保护services表
+
+    std::shared_ptr<ServiceStaleCache> cache(const QString& serviceName) const;
+    std::shared_ptr<ServiceStaleCache> ensureCache(const QString& serviceName);
+
+    static QByteArray cacheKey(const QString& method, const QVariantList& args);
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // STALERESULTCACHE_P_H
@@ -0,0 +1,354 @@
+#include "eagle/core/StateReplication.h"
+#include "StateReplication_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QMutexLocker>
+#include <QtCore/QDateTime>
+#include <QtCore/QRandomGenerator>
+
+namespace Eagle {
+namespace Core {
+
+// ==================== ReplicatedState ====================
+
+void ReplicatedStatePrivate::append(const StateChange& change)
+{
+    log.append(change);
+    while (log.size() > maxLogSize) {
+        log.removeFirst();
+    }
+    version = change.version;
+}
+
+ReplicatedState::ReplicatedState(int maxLogSize, QObject* parent)
+    : QObject(parent)
+    , d_ptr(new ReplicatedStatePrivate)
+{
+    d_ptr->maxLogSize = qMax(1, maxLogSize);
+    d_ptr->epoch = QRandomGenerator::global()->generate64();
+}
+
+ReplicatedState::~ReplicatedState()
+{
+    delete d_ptr;
+}
+
+quint64 ReplicatedState::set(const QString& key, const QVariant& value)
+{
+    auto* d = d_func();
+    quint64 version = 0;
+    {
+        QMutexLocker locker(&d->mutex);
+        StateChange change;
+        change.version = d->version + 1;
+        change.key = key;
+        change.value = value;
+        change.timestampMs = QDateTime::currentMSecsSinceEpoch();
+        d->data.insert(key, value);
+        d->append(change);
+        version = change.version;
+    }
+    emit changed(version);
+    return version;
+}
+
+quint64 ReplicatedState::remove(const QString& key)
+{
+    auto* d = d_func();
+    quint64 version = 0;
+    {
+        QMutexLocker locker(&d->mutex);
+        if (!d->data.contains(key)) {
+            return d->version;
+        }
+        StateChange change;
+        change.version = d->version + 1;
+        change.key = key;
+        change.removed = true;
+        change.timestampMs = QDateTime::currentMSecsSinceEpoch();
+        d->data.remove(key);
+        d->append(change);
+        version = change.version;
+    }
+    emit changed(version);
+    return version;
+}
+
+QVariant ReplicatedState::value(const QString& key, const QVariant& defaultValue) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->data.value(key, defaultValue);
+}
+
+bool ReplicatedState::contains(const QString& key) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->data.contains(key);
+}
+
+QStringList ReplicatedState::keys() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->data.keys();
+}
+
+quint64 ReplicatedState::version() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->version;
+}
+
+quint64 ReplicatedState::epoch() const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    return d->epoch;
+}
+
+QVariantMap ReplicatedState::snapshot(quint64* version) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    if (version) {
+        *version = d->version;
+    }
+
+    QVariantMap snapshot;
+    for (auto it = d->data.constBegin(); it != d->data.constEnd(); ++it) {
+        snapshot.insert(it.key(), it.value());
+    }
+    return snapshot;
+}
+
+bool ReplicatedState::changesSince(quint64 version, int maxCount, QList<StateChange>* changes) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    if (version >= d->version) {
+        return true;
+    }
+    if (d->log.isEmpty() || d->log.first().version > version + 1) {
+        return false;
+    }
+
+    // 日志中的版本连续，直接按偏移定位
+    int index = static_cast<int>(version + 1 - d->log.first().version);
+    int end = qMin(d->log.size(), index + qMax(1, maxCount));
+    for (int i = index; i < end; ++i) {
+        changes->append(d->log.at(i));
+    }
+    return true;
+}
+
+qint64 ReplicatedState::changeTimestamp(quint64 version) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->mutex);
+    if (d->log.isEmpty() || version < d->log.first().version || version > d->version) {
+        return 0;
+    }
+    return d->log.at(static_cast<int>(version - d->log.first().version)).timestampMs;
+}
+
+bool ReplicatedState::applyChanges(const QList<StateChange>& changes)
+{
+    auto* d = d_func();
+    bool contiguous = true;
+    quint64 before = 0;
+    quint64 after = 0;
+    {
+        QMutexLocker locker(&d->mutex);
+        before = d->version;
+        for (const StateChange& change : changes) {
+            if (change.version <= d->version) {
+                continue;   // 重发的旧变更
+            }
+            if (change.version != d->version + 1) {
+                contiguous = false;
+                break;
+            }
+            if (change.removed) {
+                d->data.remove(change.key);
+            } else {
+                d->data.insert(change.key, change.value);
+            }
+            d->append(change);
+        }
+        after = d->version;
+    }
+
+    if (after != before) {
+        emit changed(after);
+    }
+    return contiguous;
+}
+
+void ReplicatedState::applySnapshot(const QVariantMap& snapshot, quint64 version, quint64 epoch)
+{
+    auto* d = d_func();
+    {
+        QMutexLocker locker(&d->mutex);
+        d->data.clear();
+        for (auto it = snapshot.constBegin(); it != snapshot.constEnd(); ++it) {
+            d->data.insert(it.key(), it.value());
+        }
+        d->log.clear();
+        d->version = version;
+        d->epoch = epoch;
+    }
+    emit changed(version);
+}
+
+// ==================== StateReplicaServer ====================
+
+StateReplicaServer::StateReplicaServer(ReplicatedState* state, QObject* parent)
+    : QObject(parent)
+    , d_ptr(new StateReplicaServerPrivate)
+{
+    d_ptr->state = state;
+}
+
+StateReplicaServer::~StateReplicaServer()
+{
+    close();
+    delete d_ptr;
+}
+
+bool StateReplicaServer::listen(const QString& serverName)
+{
+    auto* d = d_func();
+    if (d->server && d->server->isListening()) {
+        return true;
+    }
+
+    if (!d->server) {
+        d->server = new QLocalServer(this);
+        connect(d->server, &QLocalServer::newConnection, this, &StateReplicaServer::onNewConnection);
+    }
+
+    // 清理上次异常退出残留的套接字文件
+    QLocalServer::removeServer(serverName);
+    if (!d->server->listen(serverName)) {
+        Logger::error("StateReplication", QString("状态复制接收端启动失败: %1 - %2")
+            .arg(serverName, d->server->errorString()));
+        return false;
+    }
+
+    Logger::info("StateReplication", QString("状态复制接收端已启动: %1").arg(serverName));
+    return true;
+}
+
+void StateReplicaServer::close()
+{
+    auto* d = d_func();
+    if (d->server && d->server->isListening()) {
+        d->server->close();
+        Logger::info("StateReplication", "状态复制接收端已停止");
+    }
+}
+
+bool StateReplicaServer::isListening() const
+{
+    const auto* d = d_func();
+    return d->server && d->server->isListening();
+}
+
+QString StateReplicaServer::serverName() const
+{
+    const auto* d = d_func();
+    return d->server ? d->server->serverName() : QString();
+}
+
+QVariantMap StateReplicaServer::getStatistics() const
+{
+    const auto* d = d_func();
+    QVariantMap stats;
+    stats["listening"] = isListening();
+    stats["serverName"] = serverName();
+    stats["connections"] = d->buffers.size();
+    stats["deltasApplied"] = d->deltasApplied;
+    stats["snapshotsApplied"] = d->snapshotsApplied;
+    stats["resyncRequests"] = d->resyncRequests;
+    stats["version"] = d->state ? d->state->version() : 0;
+    return stats;
+}
+
+void StateReplicaServer::onNewConnection()
+{
+    auto* d = d_func();
+    while (QLocalSocket* socket = d->server->nextPendingConnection()) {
+        d->buffers.insert(socket, QByteArray());
+        connect(socket, &QLocalSocket::readyRead, this, &StateReplicaServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            d_func()->buffers.remove(socket);
+            socket->deleteLater();
+        });
+
+        // 告知主节点本地的历史标识和版本
+        sendAck(socket, false);
+    }
+}
+
+void StateReplicaServer::sendAck(QLocalSocket* socket, bool resync)
+{
+    auto* d = d_func();
+    if (!d->state) {
+        return;
+    }
+
+    QByteArray ack;
+    QDataStream out(&ack, QIODevice::WriteOnly);
+    out.setVersion(kReplicationStreamVersion);
+    out << static_cast<quint8>(ReplicationMessage::Ack) << d->state->epoch() << d->state->version() << resync;
+    socket->write(frameReplicationMessage(ack));
+}
+
+void StateReplicaServer::onReadyRead()
+{
+    auto* d = d_func();
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket || !d->state) {
+        return;
+    }
+
+    QByteArray& buffer = d->buffers[socket];
+    buffer.append(socket->readAll());
+
+    QByteArray payload;
+    while (takeReplicationMessage(buffer, &payload)) {
+        QDataStream in(payload);
+        in.setVersion(kReplicationStreamVersion);
+        quint8 type = 0;
+        quint64 epoch = 0;
+        in >> type >> epoch;
+
+        bool resync = false;
+        if (type == static_cast<quint8>(ReplicationMessage::Delta)) {
+            QList<StateChange> changes;
+            in >> changes;
+            if (epoch == d->state->epoch() && d->state->applyChanges(changes)) {
+                d->deltasApplied++;
+            } else {
+                // 历史不同或增量与本地版本不连续，回复当前版本让主节点续传或发送快照
+                resync = true;
+                d->resyncRequests++;
+            }
+        } else if (type == static_cast<quint8>(ReplicationMessage::Snapshot)) {
+            quint64 version = 0;
+            QVariantMap snapshot;
+            in >> version >> snapshot;
+            d->state->applySnapshot(snapshot, version, epoch);
+            d->snapshotsApplied++;
+        } else {
+            continue;
+        }
+
+        sendAck(socket, resync);
+    }
+}
+
+} // namespace Core
+} // namespace Eagle
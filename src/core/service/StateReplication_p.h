@@ -0,0 +1,97 @@
+#ifndef STATEREPLICATION_P_H
+#define STATEREPLICATION_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QtEndian>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+#include "eagle/core/StateReplication.h"
+
+namespace Eagle {
+namespace Core {
+
+/**
+ * @brief 复制协议消息类型
+ *
+ * 每条消息为4字节大端长度 + QDataStream编码的负载，负载以消息类型和历史标识开头：
+ * Delta(QList<StateChange>)、Snapshot(版本, QVariantMap)、Ack(已确认版本, 是否需要重新同步)。
+ */
+enum class ReplicationMessage : quint8 {
+    Delta = 1,
+    Snapshot = 2,
+    Ack = 3
+};
+
+inline QDataStream& operator<<(QDataStream& stream, const StateChange& change)
+{
+    return stream << change.version << change.key << change.value << change.removed << change.timestampMs;
+}
+
+inline QDataStream& operator>>(QDataStream& stream, StateChange& change)
+{
+    return stream >> change.version >> change.key >> change.value >> change.removed >> change.timestampMs;
+}
+
+/**
+ * @brief 给负载加上长度前缀
+ */
+inline QByteArray frameReplicationMessage(const QByteArray& payload)
+{
+    QByteArray frame(4, Qt::Uninitialized);
+    qToBigEndian<quint32>(static_cast<quint32>(payload.size()), frame.data());
+    return frame + payload;
+}
+
+/**
+ * @brief 从接收缓冲区取出一条完整消息的负载，数据不足时返回false
+ */
+inline bool takeReplicationMessage(QByteArray& buffer, QByteArray* payload)
+{
+    if (buffer.size() < 4) {
+        return false;
+    }
+    quint32 size = qFromBigEndian<quint32>(buffer.constData());
+    if (static_cast<quint32>(buffer.size() - 4) < size) {
+        return false;
+    }
+    *payload = buffer.mid(4, static_cast<int>(size));
+    buffer.remove(0, static_cast<int>(size) + 4);
+    return true;
+}
+
+/**
+ * @brief 复制协议使用固定的QDataStream版本，保证不同构建之间兼容
+ */
+const QDataStream::Version kReplicationStreamVersion = QDataStream::Qt_5_15;
+
+class ReplicatedStatePrivate {
+public:
+    QHash<QString, QVariant> data;
+    QList<StateChange> log;      // 版本连续的变更日志，log.first().version为最早保留的版本
+    quint64 version = 0;
+    quint64 epoch = 0;
+    int maxLogSize = 10000;
+    mutable QMutex mutex;
+
+    void append(const StateChange& change);
+};
+
+class StateReplicaServerPrivate {
+public:
+    ReplicatedState* state = nullptr;
+    QLocalServer* server = nullptr;
+    QHash<QLocalSocket*, QByteArray> buffers;   // 每个连接未解析完的数据
+    qint64 deltasApplied = 0;
+    qint64 snapshotsApplied = 0;
+    qint64 resyncRequests = 0;
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // STATEREPLICATION_P_H
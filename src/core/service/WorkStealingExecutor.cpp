@@ -0,0 +1,445 @@
+#include "eagle/core/WorkStealingExecutor.h"
+#include "WorkStealingExecutor_p.h"
+#include "eagle/core/Logger.h"
+#include <QtCore/QMutexLocker>
+#include <exception>
+#include <vector>
+
+namespace Eagle {
+namespace Core {
+
+namespace {
+
+// 当前线程所属的执行器和工作线程下标（用于本地提交）
+thread_local WorkStealingExecutorPrivate* currentExecutor = nullptr;
+thread_local int currentWorkerIndex = -1;
+
+} // namespace
+
+// ==================== WorkStealingExecutorPrivate ====================
+
+void WorkStealingExecutorPrivate::enqueue(ExecutorTask task)
+{
+    int index = -1;
+    if (currentExecutor == this) {
+        index = currentWorkerIndex;  // 工作线程内提交：放入本地队列，保持局部性
+    } else {
+        index = static_cast<int>(nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size());
+    }
+
+    ExecutorWorker* worker = workers[static_cast<size_t>(index)].get();
+    {
+        QMutexLocker locker(&worker->mutex);
+        worker->queues[static_cast<int>(task.priority)].push_back(std::move(task));
+    }
+    pendingTasks.fetch_add(1);
+
+    // 只有存在空闲线程时才需要唤醒
+    if (idleWorkers.load() > 0) {
+        QMutexLocker locker(&idleMutex);
+        idleCondition.wakeOne();
+    }
+}
+
+bool WorkStealingExecutorPrivate::takeTask(int workerIndex, ExecutorTask& task)
+{
+    const int count = static_cast<int>(workers.size());
+
+    for (int priority = 0; priority < kTaskPriorityCount; ++priority) {
+        // 先取本地队列尾部
+        ExecutorWorker* own = workers[static_cast<size_t>(workerIndex)].get();
+        {
+            QMutexLocker locker(&own->mutex);
+            std::deque<ExecutorTask>& queue = own->queues[priority];
+            if (!queue.empty()) {
+                task = std::move(queue.back());
+                queue.pop_back();
+                pendingTasks.fetch_sub(1);
+                return true;
+            }
+        }
+
+        // 再从兄弟线程头部窃取同优先级任务
+        for (int offset = 1; offset < count; ++offset) {
+            ExecutorWorker* victim = workers[static_cast<size_t>((workerIndex + offset) % count)].get();
+            QMutexLocker locker(&victim->mutex);
+            std::deque<ExecutorTask>& queue = victim->queues[priority];
+            if (!queue.empty()) {
+                task = std::move(queue.front());
+                queue.pop_front();
+                pendingTasks.fetch_sub(1);
+                own->stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingExecutorPrivate::runTask(ExecutorTask& task)
+{
+    try {
+        if (task.function) {
+            task.function();
+        }
+    } catch (const std::exception& e) {
+        Logger::error("WorkStealingExecutor", QString("任务执行异常: %1").arg(e.what()));
+    } catch (...) {
+        Logger::error("WorkStealingExecutor", "任务执行发生未知异常");
+    }
+
+    if (task.limited) {
+        releaseServiceSlot(task.serviceName);
+    }
+}
+
+void WorkStealingExecutorPrivate::releaseServiceSlot(const QString& serviceName)
+{
+    ExecutorTask next;
+    bool hasNext = false;
+    {
+        QMutexLocker locker(&laneMutex);
+        auto it = lanes.find(serviceName);
+        if (it == lanes.end()) {
+            return;
+        }
+        it->running = qMax(0, it->running - 1);
+        if (!it->parked.empty() && (it->maxConcurrent <= 0 || it->running < it->maxConcurrent)) {
+            next = std::move(it->parked.front());
+            it->parked.pop_front();
+            it->running++;
+            hasNext = true;
+        }
+    }
+
+    if (hasNext) {
+        enqueue(std::move(next));
+    }
+}
+
+void WorkStealingExecutorPrivate::workerLoop(int workerIndex)
+{
+    currentExecutor = this;
+    currentWorkerIndex = workerIndex;
+    ExecutorWorker* self = workers[static_cast<size_t>(workerIndex)].get();
+
+    while (true) {
+        ExecutorTask task;
+        if (takeTask(workerIndex, task)) {
+            runTask(task);
+            self->executed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        QMutexLocker locker(&idleMutex);
+        if (stopping.load() && pendingTasks.load() <= 0) {
+            break;
+        }
+
+        idleWorkers.fetch_add(1);
+        if (pendingTasks.load() <= 0) {
+            // 定时等待兜底，避免极端情况下错过唤醒
+            idleCondition.wait(&idleMutex, 100);
+        }
+        idleWorkers.fetch_sub(1);
+    }
+
+    currentExecutor = nullptr;
+    currentWorkerIndex = -1;
+}
+
+// ==================== WorkStealingExecutor ====================
+
+WorkStealingExecutor::WorkStealingExecutor(int workerCount, QObject* parent)
+    : QObject(parent)
+    , d_ptr(new WorkStealingExecutorPrivate)
+{
+    auto* d = d_func();
+
+    if (workerCount <= 0) {
+        workerCount = qMax(2, QThread::idealThreadCount());
+    }
+
+    d->workers.reserve(static_cast<size_t>(workerCount));
+    for (int i = 0; i < workerCount; ++i) {
+        d->workers.push_back(std::make_unique<ExecutorWorker>());
+    }
+
+    // 所有队列就绪后再启动线程
+    for (int i = 0; i < workerCount; ++i) {
+        QThread* thread = QThread::create([d, i]() {
+            d->workerLoop(i);
+        });
+        thread->setObjectName(QString("EagleWorker-%1").arg(i));
+        d->workers[static_cast<size_t>(i)]->thread = thread;
+        thread->start();
+    }
+
+    Logger::info("WorkStealingExecutor", QString("工作窃取执行器启动，工作线程数: %1").arg(workerCount));
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    shutdown();
+    delete d_ptr;
+}
+
+bool WorkStealingExecutor::submit(std::function<void()> task, TaskPriority priority)
+{
+    auto* d = d_func();
+    // 停止过程中仍接受工作线程内部提交的任务（例如续体），保证已提交的调用能完成
+    if (d->stopping.load() && currentExecutor != d) {
+        Logger::warning("WorkStealingExecutor", "执行器已停止，任务被丢弃");
+        return false;
+    }
+
+    ExecutorTask executorTask;
+    executorTask.function = std::move(task);
+    executorTask.priority = priority;
+    d->enqueue(std::move(executorTask));
+    return true;
+}
+
+bool WorkStealingExecutor::submit(const QString& serviceName, std::function<void()> task)
+{
+    return d_func()->submitToLane(serviceName, std::move(task), false);
+}
+
+bool WorkStealingExecutor::trySubmit(const QString& serviceName, std::function<void()> task)
+{
+    return d_func()->submitToLane(serviceName, std::move(task), true);
+}
+
+bool WorkStealingExecutor::isStopping() const
+{
+    return d_func()->stopping.load();
+}
+
+bool WorkStealingExecutorPrivate::submitToLane(const QString& serviceName, std::function<void()> task, bool bounded)
+{
+    if (stopping.load() && currentExecutor != this) {
+        Logger::warning("WorkStealingExecutor", QString("执行器已停止，任务被丢弃: %1").arg(serviceName));
+        return false;
+    }
+
+    ExecutorTask executorTask;
+    executorTask.function = std::move(task);
+
+    {
+        QMutexLocker locker(&laneMutex);
+        auto it = lanes.find(serviceName);
+        if (it != lanes.end()) {
+            executorTask.priority = it->priority;
+            if (it->maxConcurrent > 0) {
+                executorTask.serviceName = serviceName;
+                executorTask.limited = true;
+                if (it->running >= it->maxConcurrent) {
+                    if (bounded && it->maxQueued > 0 && static_cast<int>(it->parked.size()) >= it->maxQueued) {
+                        it->rejected++;
+                        return false;
+                    }
+                    // 超出并发上限：在服务自己的队列中等待，不占用工作线程
+                    it->parked.push_back(std::move(executorTask));
+                    return true;
+                }
+                it->running++;
+            }
+        }
+    }
+
+    enqueue(std::move(executorTask));
+    return true;
+}
+
+ServiceExecutor WorkStealingExecutor::asServiceExecutor(TaskPriority priority)
+{
+    auto* d = d_func();
+    return [d, priority](std::function<void()> task) {
+        if (d->stopping.load() && currentExecutor != d) {
+            task();  // 已停止：在调用线程内联执行，续体不能丢
+            return;
+        }
+
+        ExecutorTask executorTask;
+        executorTask.function = std::move(task);
+        executorTask.priority = priority;
+        d->enqueue(std::move(executorTask));
+    };
+}
+
+void WorkStealingExecutor::setServicePriority(const QString& serviceName, TaskPriority priority)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->laneMutex);
+    d->lanes[serviceName].priority = priority;
+    Logger::info("WorkStealingExecutor", QString("设置服务优先级: %1 - %2")
+        .arg(serviceName).arg(static_cast<int>(priority)));
+}
+
+TaskPriority WorkStealingExecutor::servicePriority(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->laneMutex);
+    auto it = d->lanes.constFind(serviceName);
+    return it != d->lanes.constEnd() ? it->priority : TaskPriority::Normal;
+}
+
+void WorkStealingExecutor::setServiceConcurrencyLimit(const QString& serviceName, int maxConcurrent)
+{
+    auto* d = d_func();
+    std::vector<ExecutorTask> released;
+    {
+        QMutexLocker locker(&d->laneMutex);
+        ExecutorServiceLane& lane = d->lanes[serviceName];
+        lane.maxConcurrent = maxConcurrent;
+
+        // 放宽上限后立即释放等待中的任务
+        while (!lane.parked.empty() && (lane.maxConcurrent <= 0 || lane.running < lane.maxConcurrent)) {
+            released.push_back(std::move(lane.parked.front()));
+            lane.parked.pop_front();
+            lane.running++;
+        }
+    }
+
+    for (ExecutorTask& task : released) {
+        d->enqueue(std::move(task));
+    }
+
+    Logger::info("WorkStealingExecutor", QString("设置服务并发上限: %1 - %2")
+        .arg(serviceName).arg(maxConcurrent));
+}
+
+void WorkStealingExecutor::setServiceQueueCapacity(const QString& serviceName, int maxQueued)
+{
+    auto* d = d_func();
+    QMutexLocker locker(&d->laneMutex);
+    d->lanes[serviceName].maxQueued = maxQueued;
+}
+
+int WorkStealingExecutor::serviceQueueCapacity(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->laneMutex);
+    auto it = d->lanes.constFind(serviceName);
+    return it != d->lanes.constEnd() ? it->maxQueued : 0;
+}
+
+int WorkStealingExecutor::serviceConcurrencyLimit(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->laneMutex);
+    auto it = d->lanes.constFind(serviceName);
+    return it != d->lanes.constEnd() ? it->maxConcurrent : 0;
+}
+
+int WorkStealingExecutor::serviceRunningCount(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->laneMutex);
+    auto it = d->lanes.constFind(serviceName);
+    return it != d->lanes.constEnd() ? it->running : 0;
+}
+
+int WorkStealingExecutor::serviceQueuedCount(const QString& serviceName) const
+{
+    const auto* d = d_func();
+    QMutexLocker locker(&d->laneMutex);
+    auto it = d->lanes.constFind(serviceName);
+    return it != d->lanes.constEnd() ? static_cast<int>(it->parked.size()) : 0;
+}
+
+int WorkStealingExecutor::workerCount() const
+{
+    return static_cast<int>(d_func()->workers.size());
+}
+
+int WorkStealingExecutor::pendingCount() const
+{
+    return d_func()->pendingTasks.load();
+}
+
+QVariantMap WorkStealingExecutor::getStatistics() const
+{
+    const auto* d = d_func();
+    QVariantMap stats;
+
+    qint64 executed = 0;
+    qint64 stolen = 0;
+    QVariantList workerStats;
+    for (const auto& worker : d->workers) {
+        QVariantMap item;
+        item["executed"] = worker->executed.load(std::memory_order_relaxed);
+        item["stolen"] = worker->stolen.load(std::memory_order_relaxed);
+        workerStats.append(item);
+        executed += worker->executed.load(std::memory_order_relaxed);
+        stolen += worker->stolen.load(std::memory_order_relaxed);
+    }
+
+    stats["workerCount"] = static_cast<int>(d->workers.size());
+    stats["pending"] = d->pendingTasks.load();
+    stats["executed"] = executed;
+    stats["stolen"] = stolen;
+    stats["workers"] = workerStats;
+
+    QVariantMap laneStats;
+    {
+        QMutexLocker locker(&d->laneMutex);
+        for (auto it = d->lanes.constBegin(); it != d->lanes.constEnd(); ++it) {
+            QVariantMap lane;
+            lane["priority"] = static_cast<int>(it->priority);
+            lane["maxConcurrent"] = it->maxConcurrent;
+            lane["running"] = it->running;
+            lane["queued"] = static_cast<int>(it->parked.size());
+            lane["maxQueued"] = it->maxQueued;
+            lane["rejected"] = it->rejected;
+            laneStats[it.key()] = lane;
+        }
+    }
+    stats["services"] = laneStats;
+
+    return stats;
+}
+
+void WorkStealingExecutor::shutdown()
+{
+    auto* d = d_func();
+    if (d->stopping.exchange(true)) {
+        return;
+    }
+
+    // 等待中的受限任务也要执行完，否则其Future永远不会完成
+    std::vector<ExecutorTask> parked;
+    {
+        QMutexLocker locker(&d->laneMutex);
+        for (auto it = d->lanes.begin(); it != d->lanes.end(); ++it) {
+            while (!it->parked.empty()) {
+                ExecutorTask task = std::move(it->parked.front());
+                it->parked.pop_front();
+                task.limited = false;
+                parked.push_back(std::move(task));
+            }
+        }
+    }
+    for (ExecutorTask& task : parked) {
+        d->enqueue(std::move(task));
+    }
+
+    {
+        QMutexLocker locker(&d->idleMutex);
+        d->idleCondition.wakeAll();
+    }
+
+    for (const auto& worker : d->workers) {
+        if (worker->thread) {
+            worker->thread->wait();
+            delete worker->thread;
+            worker->thread = nullptr;
+        }
+    }
+
+    Logger::info("WorkStealingExecutor", "工作窃取执行器已停止");
+}
+
+} // namespace Core
+} // namespace Eagle
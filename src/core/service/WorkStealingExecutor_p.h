@@ -0,0 +1,78 @@
+#ifndef WORKSTEALINGEXECUTOR_P_H
+#define WORKSTEALINGEXECUTOR_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QThread>
+#include "eagle/core/WorkStealingExecutor.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace Eagle {
+namespace Core {
+
+const int kTaskPriorityCount = 3;
+
+/**
+ * @brief 执行器内部任务
+ */
+struct ExecutorTask {
+    std::function<void()> function;
+    QString serviceName;       // 受并发上限约束时记录服务名，完成后释放名额
+    TaskPriority priority = TaskPriority::Normal;
+    bool limited = false;      // 是否占用了服务并发名额
+};
+
+/**
+ * @brief 工作线程及其本地队列
+ */
+struct ExecutorWorker {
+    QMutex mutex;                                   // 保护本地队列（所有者和窃取者竞争很少）
+    std::deque<ExecutorTask> queues[kTaskPriorityCount];
+    QThread* thread = nullptr;
+    std::atomic<qint64> executed{0};
+    std::atomic<qint64> stolen{0};
+};
+
+/**
+ * @brief 服务通道（优先级 + 舱壁）
+ */
+struct ExecutorServiceLane {
+    TaskPriority priority = TaskPriority::Normal;
+    int maxConcurrent = 0;                          // <=0 不限制
+    int maxQueued = 0;                              // 等待队列容量，<=0 不限制（仅对trySubmit生效）
+    int running = 0;
+    qint64 rejected = 0;                            // 等待队列已满被拒绝的任务数
+    std::deque<ExecutorTask> parked;                // 超出并发上限的等待任务
+};
+
+class WorkStealingExecutorPrivate {
+public:
+    std::vector<std::unique_ptr<ExecutorWorker>> workers;
+    std::atomic<unsigned int> nextWorker{0};        // 外部提交时的轮转下标
+    std::atomic<int> pendingTasks{0};               // 已入队未取走的任务数
+    std::atomic<int> idleWorkers{0};
+    std::atomic<bool> stopping{false};
+
+    QMutex idleMutex;
+    QWaitCondition idleCondition;
+
+    QHash<QString, ExecutorServiceLane> lanes;      // serviceName -> lane
+    mutable QMutex laneMutex;
+
+    void enqueue(ExecutorTask task);
+    bool submitToLane(const QString& serviceName, std::function<void()> task, bool bounded);
+    bool takeTask(int workerIndex, ExecutorTask& task);
+    void runTask(ExecutorTask& task);
+    void releaseServiceSlot(const QString& serviceName);
+    void workerLoop(int workerIndex);
+};
+
+} // namespace Core
+} // namespace Eagle
+
+#endif // WORKSTEALINGEXECUTOR_P_H
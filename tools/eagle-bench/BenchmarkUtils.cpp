@@ -0,0 +1,95 @@
+#include "Benchmarks.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtCore/QtMath>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+namespace Eagle {
+namespace Bench {
+
+int BenchmarkOptions::scaled(int count) const
+{
+    return qMax(1, qRound(count * scale));
+}
+
+LatencyRecorder::LatencyRecorder(int expectedSamples)
+    : m_sorted(true)
+{
+    m_samples.reserve(expectedSamples);
+}
+
+void LatencyRecorder::add(qint64 nanos)
+{
+    m_samples.append(nanos);
+    m_sorted = false;
+}
+
+int LatencyRecorder::count() const
+{
+    return m_samples.size();
+}
+
+qint64 LatencyRecorder::percentile(double p) const
+{
+    if (m_samples.isEmpty()) {
+        return 0;
+    }
+    if (!m_sorted) {
+        std::sort(m_samples.begin(), m_samples.end());
+        m_sorted = true;
+    }
+    int index = qBound(0, static_cast<int>(qCeil(p / 100.0 * m_samples.size())) - 1, m_samples.size() - 1);
+    return m_samples[index];
+}
+
+void LatencyRecorder::report(const QString& label) const
+{
+    std::printf("  %-40s n=%-8d p50=%9.1fus p99=%9.1fus p999=%9.1fus max=%9.1fus\n",
+                qPrintable(label), count(),
+                percentile(50) / 1000.0, percentile(99) / 1000.0,
+                percentile(99.9) / 1000.0, percentile(100) / 1000.0);
+}
+
+void printThroughput(const QString& label, qint64 operations, qint64 elapsedNs)
+{
+    double seconds = qMax<qint64>(1, elapsedNs) / 1e9;
+    std::printf("  %-40s %12.0f ops/s  (%lld ops in %.1f ms)\n",
+                qPrintable(label), operations / seconds,
+                static_cast<long long>(operations), elapsedNs / 1e6);
+}
+
+void printDuration(const QString& label, qint64 elapsedNs)
+{
+    std::printf("  %-40s %12.1f ms\n", qPrintable(label), elapsedNs / 1e6);
+}
+
+qint64 runThreads(int threads, int iterations, const std::function<void(int, int)>& body)
+{
+    std::atomic<bool> go(false);
+    std::vector<QThread*> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(QThread::create([&go, &body, t, iterations]() {
+            while (!go.load()) {
+            }
+            for (int i = 0; i < iterations; ++i) {
+                body(t, i);
+            }
+        }));
+        workers.back()->start();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    go.store(true);
+    for (QThread* worker : workers) {
+        worker->wait();
+        delete worker;
+    }
+    return timer.nsecsElapsed();
+}
+
+} // namespace Bench
+} // namespace Eagle
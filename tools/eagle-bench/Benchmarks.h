@@ -0,0 +1,75 @@
+#ifndef EAGLE_BENCH_BENCHMARKS_H
+#define EAGLE_BENCH_BENCHMARKS_H
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <functional>
+
+namespace Eagle {
+namespace Bench {
+
+/**
+ * @brief 基准测试公共参数
+ */
+struct BenchmarkOptions {
+    double scale;        // 负载规模系数，1.0为默认规模（例如100万会话），CI中可调小
+
+    BenchmarkOptions()
+        : scale(1.0)
+    {
+    }
+
+    /**
+     * @brief 按规模系数缩放数量，结果至少为1
+     */
+    int scaled(int count) const;
+};
+
+/**
+ * @brief 延迟采样（纳秒），输出分位数
+ */
+class LatencyRecorder {
+public:
+    explicit LatencyRecorder(int expectedSamples = 0);
+
+    void add(qint64 nanos);
+    int count() const;
+    qint64 percentile(double p) const;
+
+    /**
+     * @brief 打印 count/p50/p99/p999/max
+     */
+    void report(const QString& label) const;
+
+private:
+    mutable QVector<qint64> m_samples;
+    mutable bool m_sorted;
+};
+
+/**
+ * @brief 打印吞吐（次/秒）
+ */
+void printThroughput(const QString& label, qint64 operations, qint64 elapsedNs);
+
+/**
+ * @brief 打印耗时（毫秒）
+ */
+void printDuration(const QString& label, qint64 elapsedNs);
+
+/**
+ * @brief 在threads个线程上同时开始，各执行iterations次body(线程序号, 迭代序号)，返回总耗时（纳秒）
+ */
+qint64 runThreads(int threads, int iterations, const std::function<void(int, int)>& body);
+
+// 各基准入口，返回进程退出码
+int runExecutorBenchmark(const BenchmarkOptions& options);
+int runRateLimiterBenchmark(const BenchmarkOptions& options);
+int runFailoverBenchmark(const BenchmarkOptions& options);
+int runRBACBenchmark(const BenchmarkOptions& options);
+int runSessionBenchmark(const BenchmarkOptions& options);
+int runSessionRestoreBenchmark(const BenchmarkOptions& options);
+
+} // namespace Bench
+} // namespace Eagle
+
+#endif // EAGLE_BENCH_BENCHMARKS_H
@@ -0,0 +1,108 @@
+#include "Benchmarks.h"
+#include "eagle/core/WorkStealingExecutor.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace Eagle {
+namespace Bench {
+
+namespace {
+
+const int kShortTasksPerLong = 100;   // 每个长任务之后提交的短任务数
+const int kShortTaskUs = 20;          // 短任务耗时（微秒，忙等）
+const int kLongTaskMs = 20;           // 长任务耗时（毫秒，休眠模拟阻塞调用）
+
+void busyWait(qint64 micros)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.nsecsElapsed() < micros * 1000) {
+    }
+}
+
+/**
+ * @brief 混合负载：长任务与短任务交错提交，记录短任务从提交到开始执行的排队延迟
+ * @param submit 提交函数，第一个参数表示是否为长任务
+ */
+void runMixedWorkload(const QString& label, int longTasks,
+                      const std::function<void(bool, std::function<void()>)>& submit)
+{
+    const int shortTasks = longTasks * kShortTasksPerLong;
+    std::vector<qint64> queueDelay(static_cast<size_t>(shortTasks), 0);
+    std::atomic<int> remaining(longTasks + shortTasks);
+
+    QElapsedTimer clock;
+    clock.start();
+
+    int shortIndex = 0;
+    for (int i = 0; i < longTasks; ++i) {
+        submit(true, [&remaining]() {
+            QThread::msleep(kLongTaskMs);
+            remaining.fetch_sub(1);
+        });
+        for (int j = 0; j < kShortTasksPerLong; ++j, ++shortIndex) {
+            qint64 submittedAt = clock.nsecsElapsed();
+            qint64* slot = &queueDelay[static_cast<size_t>(shortIndex)];
+            submit(false, [&remaining, &clock, submittedAt, slot]() {
+                *slot = clock.nsecsElapsed() - submittedAt;
+                busyWait(kShortTaskUs);
+                remaining.fetch_sub(1);
+            });
+        }
+    }
+
+    while (remaining.load() > 0) {
+        QThread::msleep(1);
+    }
+    qint64 elapsed = clock.nsecsElapsed();
+
+    LatencyRecorder recorder(shortTasks);
+    for (qint64 delay : queueDelay) {
+        recorder.add(delay);
+    }
+    recorder.report(label + " short-task queue delay");
+    printDuration(label + " total", elapsed);
+}
+
+} // namespace
+
+int runExecutorBenchmark(const BenchmarkOptions& options)
+{
+    const int workers = qMax(2, QThread::idealThreadCount());
+    const int longTasks = options.scaled(workers * 8);
+
+    std::printf("executor: %d workers, %d long (%d ms) + %d short (%d us) tasks\n",
+                workers, longTasks, kLongTaskMs, longTasks * kShortTasksPerLong, kShortTaskUs);
+
+    // 基线：全局FIFO队列，短任务排在所有已提交的长任务之后
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(workers);
+        runMixedWorkload("QThreadPool", longTasks, [&pool](bool, std::function<void()> task) {
+            pool.start(std::move(task));
+        });
+        pool.waitForDone();
+    }
+
+    // 工作窃取执行器：短任务走高优先级通道，长任务走低优先级通道并限制为一半线程
+    {
+        Core::WorkStealingExecutor executor(workers);
+        executor.setServicePriority("bench.short", Core::TaskPriority::High);
+        executor.setServicePriority("bench.long", Core::TaskPriority::Low);
+        executor.setServiceConcurrencyLimit("bench.long", qMax(1, workers / 2));
+        runMixedWorkload("WorkStealingExecutor", longTasks, [&executor](bool isLong, std::function<void()> task) {
+            executor.submit(isLong ? QStringLiteral("bench.long") : QStringLiteral("bench.short"), std::move(task));
+        });
+        executor.shutdown();
+    }
+
+    return 0;
+}
+
+} // namespace Bench
+} // namespace Eagle
@@ -0,0 +1,152 @@
+#include "Benchmarks.h"
+#include "eagle/core/FailoverManager.h"
+#include "eagle/core/ServiceRegistry.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace Eagle {
+namespace Bench {
+
+namespace {
+
+const int kStubServers = 16;            // 桩服务器数（每个主机端口的并发连接数受QNetworkAccessManager限制）
+const int kStubDelayMs = 50;            // 桩服务器每个/health应答的延迟
+const int kCheckIntervalMs = 1000;      // 健康检查间隔
+const int kRunMs = 5000;                // 运行时长
+const int kLagProbeMs = 5;              // 事件循环延迟探测间隔
+
+const char kHealthResponse[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 2\r\nConnection: keep-alive\r\n\r\nOK";
+
+/**
+ * @brief 本地HTTP桩服务器：每个请求延迟kStubDelayMs后返回200，支持keep-alive
+ */
+void serveHealth(QTcpServer* server)
+{
+    QObject::connect(server, &QTcpServer::newConnection, server, [server]() {
+        while (QTcpSocket* socket = server->nextPendingConnection()) {
+            auto buffer = std::make_shared<QByteArray>();
+            QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket, buffer]() {
+                buffer->append(socket->readAll());
+                int end = 0;
+                while ((end = buffer->indexOf("\r\n\r\n")) >= 0) {
+                    buffer->remove(0, end + 4);
+                    QTimer::singleShot(kStubDelayMs, socket, [socket]() {
+                        socket->write(kHealthResponse);
+                    });
+                }
+            });
+            QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+}
+
+} // namespace
+
+int runFailoverBenchmark(const BenchmarkOptions& options)
+{
+    const int nodeCount = qMax(2, options.scaled(200));
+
+    std::vector<std::unique_ptr<QTcpServer>> servers;
+    for (int i = 0; i < kStubServers; ++i) {
+        servers.emplace_back(new QTcpServer);
+        if (!servers.back()->listen(QHostAddress::LocalHost, 0)) {
+            std::printf("failover: cannot start stub server: %s\n", qPrintable(servers.back()->errorString()));
+            return 1;
+        }
+        serveHealth(servers.back().get());
+    }
+
+    Core::ServiceRegistry registry;
+    Core::FailoverManager manager(&registry);
+
+    Core::FailoverConfig config;
+    config.serviceName = "bench.failover";
+    config.mode = Core::FailoverMode::Manual;
+    config.healthCheckIntervalMs = kCheckIntervalMs;
+    config.healthCheckTimeoutMs = 1000;
+    config.phiThreshold = 0;          // 只测量主动健康检查
+    config.enableStateSync = false;
+    config.primaryNodes << "node-0";
+    for (int i = 1; i < nodeCount; ++i) {
+        config.standbyNodes << QString("node-%1").arg(i);
+    }
+    if (!manager.registerService(config)) {
+        return 1;
+    }
+    for (int i = 0; i < nodeCount; ++i) {
+        Core::ServiceNode node;
+        node.id = QString("node-%1").arg(i);
+        node.name = node.id;
+        node.role = i == 0 ? Core::ServiceRole::Primary : Core::ServiceRole::Standby;
+        node.endpoint = QString("http://127.0.0.1:%1").arg(servers[static_cast<size_t>(i % kStubServers)]->serverPort());
+        manager.addNode(config.serviceName, node);
+    }
+
+    std::printf("failover: %d nodes, %d stub servers, %d ms per /health, %d ms interval\n",
+                nodeCount, kStubServers, kStubDelayMs, kCheckIntervalMs);
+
+    QDateTime startedAt = QDateTime::currentDateTime();
+    QElapsedTimer clock;
+    clock.start();
+
+    // 事件循环延迟：健康检查阻塞线程时定时器会明显迟到
+    LatencyRecorder loopLag(kRunMs / kLagProbeMs);
+    qint64 lastTickNs = clock.nsecsElapsed();
+    QTimer lagProbe;
+    lagProbe.setTimerType(Qt::PreciseTimer);
+    lagProbe.setInterval(kLagProbeMs);
+    QObject::connect(&lagProbe, &QTimer::timeout, [&]() {
+        qint64 now = clock.nsecsElapsed();
+        loopLag.add(qMax<qint64>(0, now - lastTickNs - kLagProbeMs * 1000000LL));
+        lastTickNs = now;
+    });
+
+    // 轮询节点的最后检查时间，统计完成的检查数和首轮全部完成的耗时
+    QHash<QString, QDateTime> lastSeen;
+    qint64 checksCompleted = 0;
+    qint64 firstCycleNs = -1;
+    QTimer poll;
+    poll.setInterval(10);
+    QObject::connect(&poll, &QTimer::timeout, [&]() {
+        for (const Core::ServiceNode& node : manager.getNodes(config.serviceName)) {
+            if (node.lastHealthCheck <= startedAt || lastSeen.value(node.id) == node.lastHealthCheck) {
+                continue;
+            }
+            lastSeen.insert(node.id, node.lastHealthCheck);
+            checksCompleted++;
+        }
+        if (firstCycleNs < 0 && lastSeen.size() == nodeCount) {
+            firstCycleNs = clock.nsecsElapsed();
+        }
+    });
+
+    QEventLoop loop;
+    QTimer::singleShot(kRunMs, &loop, &QEventLoop::quit);
+    lagProbe.start();
+    poll.start();
+    loop.exec();
+    qint64 elapsed = clock.nsecsElapsed();
+
+    if (firstCycleNs >= 0) {
+        printDuration("first full check cycle", firstCycleNs);
+    } else {
+        std::printf("  first full check cycle: incomplete (%d of %d nodes checked)\n", lastSeen.size(), nodeCount);
+    }
+    printDuration("serial checking would take", static_cast<qint64>(nodeCount) * kStubDelayMs * 1000000LL);
+    printThroughput("health checks completed", checksCompleted, elapsed);
+    loopLag.report("event loop lag");
+    return 0;
+}
+
+} // namespace Bench
+} // namespace Eagle
@@ -0,0 +1,97 @@
+#include "Benchmarks.h"
+#include "eagle/core/RBAC.h"
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <cstdio>
+
+namespace Eagle {
+namespace Bench {
+
+namespace {
+
+const int kUserCount = 1000;           // 用户数（每个用户独立的缓存项）
+const int kPermissionsPerRole = 4;     // 每层角色的权限数
+
+/**
+ * @brief 构建深度为depth的单链角色继承：level-0为根，用户分配到最深一层
+ */
+void buildHierarchy(Core::RBACManager& rbac, int depth)
+{
+    for (int level = 0; level < depth; ++level) {
+        QString roleName = QString("role.%1").arg(level);
+        rbac.addRole(Core::Role(roleName));
+        for (int k = 0; k < kPermissionsPerRole; ++k) {
+            QString permissionName = QString("level%1.perm%2").arg(level).arg(k);
+            rbac.addPermission(Core::Permission(permissionName));
+            rbac.assignPermissionToRole(roleName, permissionName);
+        }
+        if (level > 0) {
+            rbac.addRoleInheritance(roleName, QString("role.%1").arg(level - 1));
+        }
+    }
+
+    // 存在但未授予测试用户的权限，走完整的拒绝路径
+    rbac.addRole(Core::Role("role.unrelated"));
+    rbac.addPermission(Core::Permission("unrelated.perm"));
+    rbac.assignPermissionToRole("role.unrelated", "unrelated.perm");
+
+    QString leafRole = QString("role.%1").arg(depth - 1);
+    for (int i = 0; i < kUserCount; ++i) {
+        QString userId = QString("user-%1").arg(i);
+        rbac.addUser(Core::User(userId, userId));
+        rbac.assignRoleToUser(userId, leafRole);
+    }
+}
+
+void runDepth(int depth, bool cacheEnabled, int iterations)
+{
+    Core::RBACManager rbac;
+    rbac.setNotificationEnabled(false);
+    rbac.setCacheEnabled(cacheEnabled);
+    buildHierarchy(rbac, depth);
+
+    QStringList users;
+    for (int i = 0; i < kUserCount; ++i) {
+        users.append(QString("user-%1").arg(i));
+    }
+    // 根角色的权限需要沿整条继承链才能解析到
+    const QString inherited = "level0.perm0";
+    const QString denied = "unrelated.perm";
+    QString label = QString("depth %1%2").arg(depth).arg(cacheEnabled ? "" : " nocache");
+
+    const int threadCounts[] = { 1, qMax(2, QThread::idealThreadCount()) };
+    for (int threads : threadCounts) {
+        qint64 elapsed = runThreads(threads, iterations, [&rbac, &users, &inherited](int t, int i) {
+            rbac.checkPermission(users[(i + t * 7919) % kUserCount], inherited);
+        });
+        printThroughput(QString("%1 granted x%2 threads").arg(label).arg(threads),
+                        static_cast<qint64>(threads) * iterations, elapsed);
+
+        elapsed = runThreads(threads, iterations, [&rbac, &users, &denied](int t, int i) {
+            rbac.checkPermission(users[(i + t * 7919) % kUserCount], denied);
+        });
+        printThroughput(QString("%1 denied x%2 threads").arg(label).arg(threads),
+                        static_cast<qint64>(threads) * iterations, elapsed);
+    }
+}
+
+} // namespace
+
+int runRBACBenchmark(const BenchmarkOptions& options)
+{
+    const int iterations = options.scaled(1000000);
+    std::printf("rbac: %d checks per thread over %d users, %d permissions per role\n",
+                iterations, kUserCount, kPermissionsPerRole);
+
+    const int depths[] = { 1, 4, 16, 64 };
+    for (int depth : depths) {
+        runDepth(depth, true, iterations);
+    }
+    for (int depth : depths) {
+        runDepth(depth, false, iterations);
+    }
+    return 0;
+}
+
+} // namespace Bench
+} // namespace Eagle
@@ -0,0 +1,61 @@
+#include "Benchmarks.h"
+#include "eagle/core/RateLimiter.h"
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <cstdio>
+
+namespace Eagle {
+namespace Bench {
+
+namespace {
+
+const int kApiKeyCount = 1000;         // 不同API密钥数（每个密钥独立的限流状态）
+const int kRouteCount = 16;            // 路由数
+
+void runAlgorithm(const QString& label, Core::RateLimitAlgorithm algorithm, int iterations)
+{
+    Core::RateLimiter limiter;
+    // 限额足够大，测量的是检查本身的开销而不是拒绝路径
+    limiter.setLimit("global", 1000000000, 1000, algorithm);
+    limiter.setLimit("apikey:*", 100000000, 1000, algorithm);
+    limiter.setLimit("route:*", 100000000, 1000, algorithm);
+
+    QStringList apiKeys;
+    for (int i = 0; i < kApiKeyCount; ++i) {
+        apiKeys.append(QString("apikey:%1").arg(i));
+    }
+    QVector<QStringList> chains;
+    for (int i = 0; i < kApiKeyCount; ++i) {
+        chains.append(QStringList() << "global" << apiKeys[i] << QString("route:%1").arg(i % kRouteCount));
+    }
+
+    const int threadCounts[] = { 1, qMax(2, QThread::idealThreadCount()) };
+    for (int threads : threadCounts) {
+        qint64 elapsed = runThreads(threads, iterations, [&limiter, &apiKeys](int t, int i) {
+            limiter.allowRequest(apiKeys[(i + t * 7919) % kApiKeyCount]);
+        });
+        printThroughput(QString("%1 allowRequest x%2 threads").arg(label).arg(threads),
+                        static_cast<qint64>(threads) * iterations, elapsed);
+
+        elapsed = runThreads(threads, iterations, [&limiter, &chains](int t, int i) {
+            limiter.allowHierarchical(chains[(i + t * 7919) % kApiKeyCount]);
+        });
+        printThroughput(QString("%1 allowHierarchical(3) x%2 threads").arg(label).arg(threads),
+                        static_cast<qint64>(threads) * iterations, elapsed);
+    }
+}
+
+} // namespace
+
+int runRateLimiterBenchmark(const BenchmarkOptions& options)
+{
+    const int iterations = options.scaled(2000000);
+    std::printf("ratelimiter: %d checks per thread over %d API keys\n", iterations, kApiKeyCount);
+
+    runAlgorithm("TokenBucket", Core::RateLimitAlgorithm::TokenBucket, iterations);
+    runAlgorithm("SlidingWindow", Core::RateLimitAlgorithm::SlidingWindow, iterations);
+    return 0;
+}
+
+} // namespace Bench
+} // namespace Eagle
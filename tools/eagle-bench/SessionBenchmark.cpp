@@ -0,0 +1,153 @@
+#include "Benchmarks.h"
+#include "eagle/core/SessionManager.h"
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStringList>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <cstdio>
+#include <vector>
+
+namespace Eagle {
+namespace Bench {
+
+namespace {
+
+const int kSessionsPerUser = 4;        // 每个用户的会话数，低于默认上限，不触发淘汰
+
+} // namespace
+
+int runSessionBenchmark(const BenchmarkOptions& options)
+{
+    const int sessionCount = options.scaled(1000000);
+    const int iterations = options.scaled(2000000);
+    const int threads = qMax(2, QThread::idealThreadCount());
+    const int userCount = qMax(1, sessionCount / kSessionsPerUser);
+    std::printf("session: %d sessions over %d users, %d validations per thread\n",
+                sessionCount, userCount, iterations);
+
+    Core::SessionManager manager;
+    QStringList users;
+    users.reserve(userCount);
+    for (int i = 0; i < userCount; ++i) {
+        users.append(QString("user-%1").arg(i));
+    }
+
+    // 创建：多线程同时写入各分片和按用户索引
+    std::vector<QStringList> created(static_cast<size_t>(threads));
+    const int perThread = (sessionCount + threads - 1) / threads;
+    qint64 elapsed = runThreads(threads, perThread, [&](int t, int i) {
+        int index = t * perThread + i;
+        if (index < sessionCount) {
+            created[static_cast<size_t>(t)].append(manager.createSession(users[index % userCount]));
+        }
+    });
+    printThroughput(QString("createSession x%1 threads").arg(threads), sessionCount, elapsed);
+
+    QVector<QString> sessionIds;
+    sessionIds.reserve(sessionCount);
+    for (const QStringList& ids : created) {
+        for (const QString& id : ids) {
+            sessionIds.append(id);
+        }
+    }
+
+    // 验证：只持有分片读锁
+    const int threadCounts[] = { 1, threads };
+    for (int workers : threadCounts) {
+        elapsed = runThreads(workers, iterations, [&manager, &sessionIds](int t, int i) {
+            manager.validateSession(sessionIds[(static_cast<qint64>(i) * 7919 + t * 104729) % sessionIds.size()]);
+        });
+        printThroughput(QString("validateSession x%1 threads").arg(workers),
+                        static_cast<qint64>(workers) * iterations, elapsed);
+    }
+
+    // 定时清理在没有到期会话时的开销，与会话总数无关
+    LatencyRecorder sweep(100);
+    for (int i = 0; i < 100; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        manager.cleanupExpiredSessions();
+        sweep.add(timer.nsecsElapsed());
+    }
+    sweep.report("cleanupExpiredSessions (none due)");
+
+    QElapsedTimer timer;
+    timer.start();
+    int active = manager.getActiveSessionCount();
+    printDuration(QString("getActiveSessionCount (%1)").arg(active), timer.nsecsElapsed());
+
+    // 批量移除：cleanupInactiveSessions(0)扫描全部分片并逐个销毁，代表一次大规模过期的移除成本
+    timer.restart();
+    manager.cleanupInactiveSessions(0);
+    elapsed = timer.nsecsElapsed();
+    printThroughput("remove all (cleanupInactiveSessions)", sessionCount, elapsed);
+    return 0;
+}
+
+int runSessionRestoreBenchmark(const BenchmarkOptions& options)
+{
+    const int sessionCount = options.scaled(1000000);
+    const int userCount = qMax(1, sessionCount / kSessionsPerUser);
+    const int probes = qMin(sessionCount, 10000);
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::printf("session-restore: cannot create a temporary directory\n");
+        return 1;
+    }
+    QString filePath = dir.filePath("sessions.log");
+
+    // 写入：上一次运行留下的会话日志
+    QStringList sessionIds;
+    sessionIds.reserve(sessionCount);
+    {
+        Core::SessionManager writer;
+        if (!writer.enablePersistence(filePath)) {
+            std::printf("session-restore: cannot open %s\n", qPrintable(filePath));
+            return 1;
+        }
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < sessionCount; ++i) {
+            sessionIds.append(writer.createSession(QString("user-%1").arg(i % userCount)));
+        }
+        writer.disablePersistence();
+        printThroughput("createSession with persistence", sessionCount, timer.nsecsElapsed());
+    }
+    std::printf("session-restore: %d sessions, %.1f MB log\n",
+                sessionCount, QFileInfo(filePath).size() / (1024.0 * 1024.0));
+
+    // 重启：enablePersistence返回即可服务请求
+    Core::SessionManager reader;
+    QElapsedTimer timer;
+    timer.start();
+    if (!reader.enablePersistence(filePath)) {
+        return 1;
+    }
+    printDuration("time to ready (enablePersistence)", timer.nsecsElapsed());
+
+    timer.restart();
+    int active = reader.getActiveSessionCount();
+    printDuration(QString("getActiveSessionCount (%1)").arg(active), timer.nsecsElapsed());
+
+    // 恢复的会话第一次出示时放回会话表，之后走普通验证路径
+    LatencyRecorder first(probes);
+    LatencyRecorder again(probes);
+    for (int i = 0; i < probes; ++i) {
+        const QString& sessionId = sessionIds[static_cast<int>((static_cast<qint64>(i) * 7919) % sessionCount)];
+        timer.restart();
+        reader.validateSession(sessionId);
+        first.add(timer.nsecsElapsed());
+        timer.restart();
+        reader.validateSession(sessionId);
+        again.add(timer.nsecsElapsed());
+    }
+    first.report("validateSession (first, promotes)");
+    again.report("validateSession (promoted)");
+    return 0;
+}
+
+} // namespace Bench
+} // namespace Eagle
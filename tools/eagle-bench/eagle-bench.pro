@@ -0,0 +1,36 @@
+QT += core network
+QT -= gui
+CONFIG += console c++17 warn_on
+CONFIG -= app_bundle
+
+TARGET = eagle-bench
+TEMPLATE = app
+
+SOURCES += \
+    main.cpp \
+    BenchmarkUtils.cpp \
+    ExecutorBenchmark.cpp \
+    RateLimiterBenchmark.cpp \
+    FailoverBenchmark.cpp \
+    RBACBenchmark.cpp \
+    SessionBenchmark.cpp
+
+HEADERS += \
+    Benchmarks.h
+
+# 包含目录
+INCLUDEPATH += $$PWD/../../include
+
+# 链接库
+LIBS += -L$$PWD/../../lib -lEagleCore
+
+# 输出目录
+DESTDIR = $$PWD/../../bin
+OBJECTS_DIR = $$PWD/../../build/tools/eagle-bench/obj
+MOC_DIR = $$PWD/../../build/tools/eagle-bench/moc
+
+# 版本信息
+VERSION = 1.0.0
+QMAKE_TARGET_PRODUCT = "Eagle Bench Tool"
+QMAKE_TARGET_DESCRIPTION = "Eagle Framework Benchmarks"
+QMAKE_TARGET_COPYRIGHT = "Copyright (c) 2024"
@@ -1610,7 +1610,7 @@ private:
         } else if (subCommand == "set") {
             if (args.size() < 3) {
                 std::cerr << "Usage: eagle-cli loadbalance set <service-name> <algorithm> [--enabled]" << std::endl;
-                std::cerr << "  Algorithms: round_robin, weighted_round_robin, least_connections, random, ip_hash" << std::endl;
+                std::cerr << "  Algorithms: round_robin, weighted_round_robin, least_connections, random, ip_hash, p2c_ewma" << std::endl;
                 return 1;
             }
             
@@ -1881,10 +1881,10 @@ private:
             std::cout << "Calling service asynchronously: " << serviceName.toStdString() 
                       << "::" << method.toStdString() << std::endl;
             
-            Eagle::Core::ServiceFuture* future = asyncCall->callAsync(serviceName, method, callArgs, timeout);
+            Eagle::Core::ServiceCallFuture future = asyncCall->call(serviceName, method, callArgs, timeout);
             
             // 等待结果
-            Eagle::Core::ServiceCallResult result = future->wait();
+            Eagle::Core::ServiceCallResult result = future.wait();
             
             if (result.success) {
                 std::cout << "Result: " << result.result.toString().toStdString() << std::endl;
@@ -1901,14 +1901,7 @@ private:
                 return 1;
             }
             
-            QString futureIdStr = args[1];
-            bool ok;
-            quintptr futurePtr = futureIdStr.toULongLong(&ok, 16);
-            
-            if (!ok) {
-                std::cerr << "Error: Invalid future ID" << std::endl;
-                return 1;
-            }
+            QString futureId = args[1];
             
             int timeout = -1;
             for (int i = 2; i < args.size(); ++i) {
@@ -1917,13 +1910,14 @@ private:
                 }
             }
             
-            Eagle::Core::ServiceFuture* future = reinterpret_cast<Eagle::Core::ServiceFuture*>(futurePtr);
-            if (!future) {
-                std::cerr << "Error: Future not found" << std::endl;
+            // 只能查询本进程结果存储中登记的调用
+            Eagle::Core::ServiceCallFuture future = asyncCall->resultStore()->find(futureId);
+            if (!future.isValid()) {
+                std::cerr << "Error: Future not found or expired" << std::endl;
                 return 1;
             }
             
-            Eagle::Core::ServiceCallResult result = future->wait(timeout);
+            Eagle::Core::ServiceCallResult result = future.wait(timeout);
             
             if (result.success) {
                 std::cout << "Result: " << result.result.toString().toStdString() << std::endl;